@@ -12,10 +12,11 @@ usage () {
     echo "OPTIONS:"
     echo "      -h, --help         Print usage."
     echo "      -c, --coverage     Build mluops with coverage test."
+    echo "      --zstd             Build mluops with zstd to compress gen_case data files."
     echo
 }
 
-cmdline_args=$(getopt -o ch -n 'build.sh' -- "$@")
+cmdline_args=$(getopt -o ch -l coverage,asan,zstd,help -n 'build.sh' -- "$@")
 eval set -- "$cmdline_args"
 
 script_path=`dirname $0`
@@ -40,6 +41,10 @@ if [ $# != 0 ]; then
           shift
           export MLUOP_BUILD_ASAN_CHECK="ON"
           ;;
+      --zstd)
+          shift
+          export MLUOP_BUILD_ZSTD="ON"
+          ;;
       -h | --help)
           usage
           exit 0
@@ -89,12 +94,14 @@ pushd ${BUILD_PATH} > /dev/null
     echo "-- Build cambricon coverage test cases."
     ${CMAKE}  ../ -DNEUWARE_HOME="${NEUWARE_HOME}" \
                   -DMLUOP_BUILD_COVERAGE_TEST="${MLUOP_BUILD_COVERAGE_TEST}" \
+                  -DMLUOP_BUILD_ZSTD="${MLUOP_BUILD_ZSTD}" \
                   -DMLUOPS_TARGET_CPU_ARCH="${MLUOPS_TARGET_CPU_ARCH}"
   else
     echo "-- Build cambricon release test cases."
     ${CMAKE}  ../ -DNEUWARE_HOME="${NEUWARE_HOME}" \
                   -DBUILD_VERSION="${BUILD_VERSION}" \
                   -DMAJOR_VERSION="${MAJOR_VERSION}" \
+                  -DMLUOP_BUILD_ZSTD="${MLUOP_BUILD_ZSTD}" \
                   -DMLUOPS_TARGET_CPU_ARCH="${MLUOPS_TARGET_CPU_ARCH}"
   fi
 
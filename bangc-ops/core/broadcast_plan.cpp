@@ -0,0 +1,99 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "core/broadcast_plan.h"
+
+#include "core/stride_coalesce.h"
+
+namespace mluop {
+
+int64_t BroadcastPlan::getElementNum() const {
+  int64_t num = 1;
+  for (int i = 0; i < dim; ++i) {
+    num *= dims[i];
+  }
+  return num;
+}
+
+bool BroadcastPlan::isElementwise() const {
+  return dim == 1 && x_strides[0] == 1 && y_strides[0] == 1;
+}
+
+bool getBroadcastShape(int a_dim, const int64_t *a_dims, int b_dim,
+                       const int64_t *b_dims, int *out_dim, int64_t *out_dims) {
+  const int dim = a_dim > b_dim ? a_dim : b_dim;
+  if (dim > MLUOP_DIM_MAX) {
+    return false;
+  }
+  for (int i = dim - 1, k = 0; i >= 0; --i, ++k) {
+    const int64_t a = k < a_dim ? a_dims[a_dim - 1 - k] : 1;
+    const int64_t b = k < b_dim ? b_dims[b_dim - 1 - k] : 1;
+    if (a != b && a != 1 && b != 1) {
+      return false;
+    }
+    out_dims[i] = a == 1 ? b : a;
+  }
+  *out_dim = dim;
+  return true;
+}
+
+// Contiguous strides of `in_dims` aligned to the last of `dim` dims, 0 where
+// the input is broadcast.
+static void getBroadcastStrides(int in_dim, const int64_t *in_dims, int dim,
+                                const int64_t *dims, int64_t *strides) {
+  int64_t stride = 1;
+  for (int i = dim - 1, k = 0; i >= 0; --i, ++k) {
+    const int64_t d = k < in_dim ? in_dims[in_dim - 1 - k] : 1;
+    strides[i] = (d == 1 && dims[i] != 1) ? 0 : stride;
+    stride *= d;
+  }
+}
+
+bool planBroadcast(int x_dim, const int64_t *x_dims, int y_dim,
+                   const int64_t *y_dims, BroadcastPlan *plan) {
+  int dim = 0;
+  int64_t dims[MLUOP_DIM_MAX];
+  if (!getBroadcastShape(x_dim, x_dims, y_dim, y_dims, &dim, dims)) {
+    return false;
+  }
+  int64_t z_strides[MLUOP_DIM_MAX];
+  getBroadcastStrides(dim, dims, dim, dims, z_strides);
+  getBroadcastStrides(x_dim, x_dims, dim, dims, plan->x_strides);
+  getBroadcastStrides(y_dim, y_dims, dim, dims, plan->y_strides);
+  // z is contiguous, so dims are merged only when both x and y allow it.
+  int64_t *strides[3] = {plan->x_strides, plan->y_strides, z_strides};
+  dim = coalesceDims(dim, dims, strides, 3);
+  if (dim == 0) {
+    // a single element.
+    dim = 1;
+    dims[0] = 1;
+    plan->x_strides[0] = 1;
+    plan->y_strides[0] = 1;
+  }
+  plan->dim = dim;
+  for (int i = 0; i < dim; ++i) {
+    plan->dims[i] = dims[i];
+  }
+  return true;
+}
+
+}  // namespace mluop
@@ -0,0 +1,119 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef CORE_BROADCAST_PLAN_H_
+#define CORE_BROADCAST_PLAN_H_
+
+#include <cstdint>
+
+#include "mlu_op.h"
+
+namespace mluop {
+
+/******************************************************************************
+ * Broadcast planning
+ * Host side plan of a NumPy-style broadcast binary op z = x op y, where x, y
+ * and z are contiguous. Shapes are aligned from the last dim on, dims of size
+ * 1 or missing in an input are broadcast to the dim of the other input. The
+ * plan is the coalesced shape of z, with the strides of x and y in elements,
+ * 0 on broadcast dims. Runs of broadcast dims and runs of plain dims are
+ * merged, so e.g. [N, C, H, W] / [1, C, 1, 1] is planned as [N, C, H * W]
+ * with x strides [C * H * W, H * W, 1] and y strides [0, 1, 0].
+ ******************************************************************************/
+
+struct BroadcastPlan {
+  // number of dims left after coalescing, at least 1.
+  int dim = 1;
+  int64_t dims[MLUOP_DIM_MAX] = {1};
+  int64_t x_strides[MLUOP_DIM_MAX] = {1};
+  int64_t y_strides[MLUOP_DIM_MAX] = {1};
+
+  int64_t getElementNum() const;
+  // whether x, y and z are visited in the same order, so a plain element-wise
+  // kernel can be used.
+  bool isElementwise() const;
+};
+
+// The broadcast shape of `a_dims` and `b_dims`, of max(a_dim, b_dim) dims.
+// Returns false if a dim is neither equal in both shapes nor 1 in one of them.
+bool getBroadcastShape(int a_dim, const int64_t *a_dims, int b_dim,
+                       const int64_t *b_dims, int *out_dim, int64_t *out_dims);
+
+// Plans z = x op y. Returns false if the shapes can not be broadcast.
+bool planBroadcast(int x_dim, const int64_t *x_dims, int y_dim,
+                   const int64_t *y_dims, BroadcastPlan *plan);
+
+/******************************************************************************
+ * mluOp FUNC: launchBroadcastInChunks
+ * Splits `plan` into sub plans of at most `max_chunk_num` elements, along dim 0
+ * first and along the next dims when one index of dim 0 is still too large.
+ * `launch(chunk, x_offset, y_offset, z_offset)` is called for each sub plan
+ * in the order of z, offsets are in elements. Returns the first status which
+ * is not MLUOP_STATUS_SUCCESS, remaining chunks are not launched then.
+ ******************************************************************************/
+template <typename LaunchFunc>
+mluOpStatus_t launchBroadcastInChunks(const BroadcastPlan &plan,
+                                      int64_t max_chunk_num, LaunchFunc launch,
+                                      int64_t x_offset = 0,
+                                      int64_t y_offset = 0,
+                                      int64_t z_offset = 0) {
+  const int64_t total_num = plan.getElementNum();
+  if (total_num <= max_chunk_num) {
+    return total_num > 0 ? launch(plan, x_offset, y_offset, z_offset)
+                         : MLUOP_STATUS_SUCCESS;
+  }
+  // elements of z per index of dim 0.
+  const int64_t row_num = total_num / plan.dims[0];
+  BroadcastPlan chunk = plan;
+  if (row_num > max_chunk_num) {
+    chunk.dim = plan.dim - 1;
+    for (int i = 0; i < chunk.dim; ++i) {
+      chunk.dims[i] = plan.dims[i + 1];
+      chunk.x_strides[i] = plan.x_strides[i + 1];
+      chunk.y_strides[i] = plan.y_strides[i + 1];
+    }
+    for (int64_t r = 0; r < plan.dims[0]; ++r) {
+      mluOpStatus_t status = launchBroadcastInChunks(
+          chunk, max_chunk_num, launch, x_offset + r * plan.x_strides[0],
+          y_offset + r * plan.y_strides[0], z_offset + r * row_num);
+      if (status != MLUOP_STATUS_SUCCESS) {
+        return status;
+      }
+    }
+    return MLUOP_STATUS_SUCCESS;
+  }
+  const int64_t rows = max_chunk_num / row_num;
+  for (int64_t r = 0; r < plan.dims[0]; r += rows) {
+    chunk.dims[0] = plan.dims[0] - r < rows ? plan.dims[0] - r : rows;
+    mluOpStatus_t status =
+        launch(chunk, x_offset + r * plan.x_strides[0],
+               y_offset + r * plan.y_strides[0], z_offset + r * row_num);
+    if (status != MLUOP_STATUS_SUCCESS) {
+      return status;
+    }
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
+}  // namespace mluop
+
+#endif  // CORE_BROADCAST_PLAN_H_
@@ -23,7 +23,14 @@
 #include <string>
 #include <mutex>  // NOLINT
 #include <algorithm>
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
 #include <map>
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 #include "iostream"
 #include "fstream"
 #include "sstream"
@@ -77,6 +84,12 @@ __attribute__((__unused__)) bool g_color_print =
     getBoolEnvVar("MLUOP_LOG_COLOR_PRINT", true);  // whether print with color
 __attribute__((__unused__)) const std::map<std::string, bool> module_print_map =
     {{"MLUOP", getBoolEnvVar("MLUOP_LOG_PRINT", true)}};
+#ifndef ANDROID_LOG
+std::atomic<bool> log_async(
+    getBoolEnvVar("MLUOP_LOG_ASYNC", false));  // whether write in background.
+#else
+std::atomic<bool> log_async(false);
+#endif
 
 bool isPrintToScreen() {
   if (userStream.rdbuf() == std::cout.rdbuf()) {
@@ -96,6 +109,19 @@ bool releasePrint(std::string module_name) {
   return module_print;
 }
 
+bool isLogOff(int severity, const char *module_name) {
+  if (!is_open_log || severity < logLevel) {
+    return true;
+  }
+  // compare with the const char * directly, no std::string is built.
+  for (const auto &module : module_print_map) {
+    if (module.first == module_name) {
+      return !module.second;
+    }
+  }
+  return true;
+}
+
 LogMessage::LogMessage(std::string file, int line, int module, int severity,
                        std::string module_name, bool is_print_head,
                        bool is_print_tail, bool is_clear_endl,
@@ -108,7 +134,11 @@ LogMessage::LogMessage(std::string file, int line, int module, int severity,
       is_print_head_(is_print_head),
       is_print_tail_(is_print_tail),
       is_clear_endl_(is_clear_endl),
-      release_can_print_(release_can_print) {
+      release_can_print_(release_can_print),
+      is_on_(!isLogOff(severity, module_name_.c_str())) {
+  if (!is_on_) {
+    return;
+  }
   if (g_color_print) {
     g_color_print = isPrintToScreen();
   }
@@ -162,10 +192,315 @@ void clearEnter(std::string *ss) {
 
 std::mutex log_mutex;  // to protect write to file.
 
+/**
+ * @brief: a formatted message waiting to be written.
+ */
+struct LogRecord {
+  int severity = LOG_INFO;
+  int log_module = LOG_SAVE_AND_SHOW;
+  bool clear_endl = false;
+  std::string file_str;
+  std::string cout_str;
+};
+
+/**
+ * @brief: write one message to the file or screen, log_mutex must be held.
+ *         the streams are flushed after every message when flush_now is set,
+ *         otherwise the caller flushes them after a batch of messages.
+ */
+static void writeLogRecord(const LogRecord &record, bool flush_now) {
+  switch (record.severity) {
+    case LOG_WARNING: {
+      warningCnt++;
+      break;
+    }
+    case LOG_ERROR: {
+      errorCnt++;
+      break;
+    }
+    case LOG_FATAL: {
+      fatalCnt++;
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+#ifndef ANDROID_LOG
+  if ((record.log_module == LOG_SAVE_ONLY) ||
+      (record.log_module == LOG_SAVE_AND_SHOW)) {
+    if (!is_only_show) {
+      logFile << record.file_str;
+      if (record.clear_endl) {
+        logFile << '\n';
+        if (flush_now) {
+          logFile.flush();
+        }
+      }
+    }
+  }
+  if ((record.log_module == LOG_SHOW_ONLY) ||
+      (record.log_module == LOG_SAVE_AND_SHOW)) {
+    userStream << record.cout_str;
+    if (record.clear_endl) {
+      userStream << '\n';
+      if (flush_now) {
+        userStream.flush();
+      }
+    }
+  }
+#else
+  switch (record.severity) {
+    case LOG_INFO: {
+      LOGI("%s", record.file_str.c_str());
+      break;
+    }
+    case LOG_WARNING: {
+      LOGW("%s", record.file_str.c_str());
+      break;
+    }
+    case LOG_ERROR: {
+    }
+    case LOG_FATAL: {
+      LOGE("%s", record.file_str.c_str());
+      break;
+    }
+    case LOG_VLOG: {
+      LOGD("%s", record.file_str.c_str());
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+#endif
+}
+
+/**
+ * @brief: a single-producer single-consumer ring of LOG_ASYNC_RING_SIZE
+ *         messages. the producer is the logging thread which owns the ring,
+ *         the consumer is the writer thread of AsyncLogger.
+ */
+class AsyncLogRing {
+ public:
+  bool push(LogRecord *record) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == LOG_ASYNC_RING_SIZE) {
+      return false;
+    }
+    slots_[tail % LOG_ASYNC_RING_SIZE] = std::move(*record);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(LogRecord *record) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    *record = std::move(slots_[head % LOG_ASYNC_RING_SIZE]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // called by the consumer, does not take any message.
+  bool empty() const {
+    return head_.load(std::memory_order_relaxed) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+  std::atomic<uint64_t> dropped{0};  // messages dropped since the last drain
+  std::atomic<bool> orphaned{false};  // the owner thread has exited
+
+ private:
+  std::atomic<size_t> head_{0};  // next slot to pop, written by the consumer
+  std::atomic<size_t> tail_{0};  // next slot to push, written by the producer
+  LogRecord slots_[LOG_ASYNC_RING_SIZE];
+};
+
+/**
+ * @brief: the background writer of the asynchronous mode. every logging
+ *         thread pushes into its own ring without locking, the writer thread
+ *         polls all rings and writes the messages in batches.
+ */
+class AsyncLogger {
+ public:
+  static AsyncLogger &instance() {
+    static AsyncLogger logger;
+    return logger;
+  }
+
+  ~AsyncLogger() {
+    // later messages are written synchronously.
+    log_async = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_cv_.notify_one();
+    writer_.join();
+  }
+
+  /**
+   * @brief: push a message into the ring of the calling thread, return false
+   *         if it should be written synchronously instead.
+   */
+  bool push(LogRecord *record) {
+    AsyncLogRing *ring = localRing();
+    if (ring->push(record)) {
+      return true;
+    }
+    if (record->severity != LOG_ERROR && record->severity != LOG_FATAL) {
+      ring->dropped.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    wake_cv_.notify_one();
+    while (!ring->push(record)) {
+      if (!log_async.load(std::memory_order_relaxed)) {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+    return true;
+  }
+
+  void flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t ticket = ++flush_request_;
+    wake_cv_.notify_one();
+    flush_cv_.wait(lock, [&] { return flush_done_ >= ticket; });
+  }
+
+ private:
+  struct RingHolder {
+    std::shared_ptr<AsyncLogRing> ring;
+    ~RingHolder() {
+      if (ring != nullptr) {
+        ring->orphaned.store(true, std::memory_order_release);
+      }
+    }
+  };
+
+  AsyncLogger() : writer_(&AsyncLogger::run, this) {}
+
+  AsyncLogRing *localRing() {
+    thread_local RingHolder holder;
+    if (holder.ring == nullptr) {
+      holder.ring = std::make_shared<AsyncLogRing>();
+      std::lock_guard<std::mutex> lock(mutex_);
+      rings_.push_back(holder.ring);
+    }
+    return holder.ring.get();
+  }
+
+  // write everything in the rings, return the number of written messages.
+  size_t drain(const std::vector<std::shared_ptr<AsyncLogRing>> &rings) {
+    size_t written = 0;
+    LogRecord record;
+    std::lock_guard<std::mutex> lock(log_mutex);
+    for (const auto &ring : rings) {
+      while (ring->pop(&record)) {
+        writeLogRecord(record, false);
+        ++written;
+      }
+      uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+      if (dropped > 0) {
+        LogRecord notice;
+        notice.severity = LOG_INFO;
+        notice.clear_endl = true;
+        notice.file_str = "[MLUOP] [Warning]: " + std::to_string(dropped) +
+                          " log messages are dropped since the log ring "
+                          "buffer is full.";
+        notice.cout_str = notice.file_str;
+        writeLogRecord(notice, false);
+        ++written;
+      }
+    }
+    if (written > 0) {
+      if (!is_only_show && logFile.is_open()) {
+        logFile.flush();
+      }
+      userStream.flush();
+    }
+    return written;
+  }
+
+  void run() {
+    std::vector<std::shared_ptr<AsyncLogRing>> rings;
+    std::vector<AsyncLogRing *> orphans;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      // messages pushed before a flush request are visible after this point.
+      uint64_t request = flush_request_;
+      bool stopping = stop_;
+      rings = rings_;
+      lock.unlock();
+      // nothing is pushed into a ring after it is orphaned, so a ring seen
+      // orphaned here holds its last messages and is empty after the drain.
+      orphans.clear();
+      for (const auto &ring : rings) {
+        if (ring->orphaned.load(std::memory_order_acquire)) {
+          orphans.push_back(ring.get());
+        }
+      }
+      size_t written = drain(rings);
+      lock.lock();
+      // the ring of an exited thread is released once it is drained.
+      rings_.erase(
+          std::remove_if(rings_.begin(), rings_.end(),
+                         [&](const std::shared_ptr<AsyncLogRing> &r) {
+                           return std::find(orphans.begin(), orphans.end(),
+                                            r.get()) != orphans.end() &&
+                                  r->empty() && r->dropped.load() == 0;
+                         }),
+          rings_.end());
+      if (request > flush_done_) {
+        flush_done_ = request;
+        flush_cv_.notify_all();
+      }
+      if (stopping) {
+        break;
+      }
+      if (written == 0 && flush_request_ == flush_done_ && !stop_) {
+        wake_cv_.wait_for(lock, std::chrono::milliseconds(2));
+      }
+    }
+  }
+
+  std::mutex mutex_;  // protect the members below
+  std::condition_variable wake_cv_;
+  std::condition_variable flush_cv_;
+  std::vector<std::shared_ptr<AsyncLogRing>> rings_;
+  uint64_t flush_request_ = 0;
+  uint64_t flush_done_ = 0;
+  bool stop_ = false;
+  std::thread writer_;
+};
+
+void setAsync(bool async) {
+#ifndef ANDROID_LOG
+  if (!async) {
+    flushLog();
+  }
+  log_async = async;
+#endif
+}
+
+void flushLog() {
+#ifndef ANDROID_LOG
+  if (log_async.load(std::memory_order_relaxed)) {
+    AsyncLogger::instance().flush();
+  }
+#endif
+}
+
 /*
  * @brief: the destructor that output the string to the file or screen.
  */
 LogMessage::~LogMessage() {
+  if (!is_on_) {
+    return;
+  }
   int log_level = LOG_INFO;
 #ifdef NDEBUG
   if (!releasePrint(module_name_)) {
@@ -198,73 +533,23 @@ LogMessage::~LogMessage() {
 #endif
   }
   if (is_open_log) {
-    std::string file_ss = file_str_.str();
-    std::string cout_ss = cout_str_.str();
+    LogRecord record;
+    record.severity = logSeverity_;
+    record.log_module = log_module_;
+    record.clear_endl = is_clear_endl_;
+    record.file_str = file_str_.str();
+    record.cout_str = cout_str_.str();
     if (is_clear_endl_) {
-      clearEnter(&file_ss);
-      clearEnter(&cout_ss);
+      clearEnter(&record.file_str);
+      clearEnter(&record.cout_str);
     }
     if (logSeverity_ >= log_level) {
-      std::lock_guard<std::mutex> lock(log_mutex);
-      switch (logSeverity_) {
-        case LOG_WARNING: {
-          warningCnt++;
-          break;
-        }
-        case LOG_ERROR: {
-          errorCnt++;
-          break;
-        }
-        case LOG_FATAL: {
-          fatalCnt++;
-          break;
-        }
-        default: {
-          break;
-        }
+      if (log_async.load(std::memory_order_relaxed) &&
+          AsyncLogger::instance().push(&record)) {
+        return;
       }
-#ifndef ANDROID_LOG
-      if ((log_module_ == LOG_SAVE_ONLY) ||
-          (log_module_ == LOG_SAVE_AND_SHOW)) {
-        if (!is_only_show) {
-          logFile << file_ss;
-          if (is_clear_endl_) {
-            logFile << std::endl;
-          }
-        }
-      }
-      if ((log_module_ == LOG_SHOW_ONLY) ||
-          (log_module_ == LOG_SAVE_AND_SHOW)) {
-        userStream << cout_ss;
-        if (is_clear_endl_) {
-          userStream << std::endl;
-        }
-      }
-#else
-      switch (logSeverity_) {
-        case LOG_INFO: {
-          LOGI("%s", file_ss.c_str());
-          break;
-        }
-        case LOG_WARNING: {
-          LOGW("%s", file_ss.c_str());
-          break;
-        }
-        case LOG_ERROR: {
-        }
-        case LOG_FATAL: {
-          LOGE("%s", file_ss.c_str());
-          break;
-        }
-        case LOG_VLOG: {
-          LOGD("%s", file_ss.c_str());
-          break;
-        }
-        default: {
-          break;
-        }
-      }
-#endif
+      std::lock_guard<std::mutex> lock(log_mutex);
+      writeLogRecord(record, true);
     }
   }
 }
@@ -293,6 +578,12 @@ std::string LogMessage::getTime() {
   time_t g_time;
   time(&g_time);
   g_time = g_time + HOURS_DIFFERENCE * SECONDS_PER_HOUR;
+  // the time stamp is built once per second for each thread.
+  thread_local time_t cached_time = 0;
+  thread_local std::string cached_time_stamp;
+  if (g_time == cached_time && !cached_time_stamp.empty()) {
+    return cached_time_stamp;
+  }
   tm general_time;
   if (NULL == gmtime_r(&g_time, &general_time)) {
     return "";
@@ -305,6 +596,8 @@ std::string LogMessage::getTime() {
   std::string second = std::to_string(general_time.tm_sec);
   std::string time_stamp = "[" + year + "-" + month + "-" + day + " " + hour +
                            ":" + min + ":" + second + "] ";
+  cached_time = g_time;
+  cached_time_stamp = time_stamp;
   return time_stamp;
 #endif
 #endif
@@ -484,6 +777,7 @@ int initLogOnlyShow() {
  *         or shown on screen.
  */
 void endLog() {
+  flushLog();
 #ifndef ANDROID_LOG
   if (!is_only_show) {
     if (logFile.is_open()) {
@@ -78,38 +78,46 @@ namespace cnlog {
 #define LOG_FATAL 3
 #define LOG_VLOG 4
 
+#define LOG_ASYNC_RING_SIZE 1024
+
 /**
  * @brief: define the interface of the log system.
+ *         messages filtered out by isLogOff are never formatted, so the
+ *         operands after "<<" are not evaluated either.
+ */
+#define CNLOG_MESSAGE(module, severity, file, line, head, tail, clear_endl,  \
+                      release_can_print)                                     \
+  isLogOff(LOG_##severity, #module)                                          \
+      ? (void)0                                                              \
+      : ::cnlog::LogMessageVoidify() &                                       \
+            ::cnlog::LogMessage(file, line, LOG_SAVE_AND_SHOW, LOG_##severity, \
+                                #module, head, tail, clear_endl,             \
+                                release_can_print)                           \
+                .stream()
+
+#define CLOG(module, severity) \
+  CNLOG_MESSAGE(module, severity, __FILE__, __LINE__, true, true, true, true)
+
+#define DCLOG(module, severity) \
+  CNLOG_MESSAGE(module, severity, __FILE__, __LINE__, true, true, true, false)
+
+#define PLOG(module, severity) \
+  CNLOG_MESSAGE(module, severity, "", 0, false, false, true, true)
+
+#define DPLOG(module, severity) \
+  CNLOG_MESSAGE(module, severity, "", 0, false, false, true, false)
+
+#define SCOUT(module, severity) \
+  CNLOG_MESSAGE(module, severity, "", 0, false, false, false, true)
+
+#define DSCOUT(module, severity) \
+  CNLOG_MESSAGE(module, severity, "", 0, false, false, false, false)
+
+/**
+ * @brief: whether a message of the severity and module would be discarded,
+ *         checked before the message is formatted.
  */
-#define CLOG(module, severity)                                               \
-  LogMessage(__FILE__, __LINE__, LOG_SAVE_AND_SHOW, LOG_##severity, #module, \
-             true, true, true, true)                                         \
-      .stream()
-
-#define DCLOG(module, severity)                                              \
-  LogMessage(__FILE__, __LINE__, LOG_SAVE_AND_SHOW, LOG_##severity, #module, \
-             true, true, true, false)                                        \
-      .stream()
-
-#define PLOG(module, severity)                                                \
-  LogMessage("", 0, LOG_SAVE_AND_SHOW, LOG_##severity, #module, false, false, \
-             true, true)                                                      \
-      .stream()
-
-#define DPLOG(module, severity)                                               \
-  LogMessage("", 0, LOG_SAVE_AND_SHOW, LOG_##severity, #module, false, false, \
-             true, false)                                                     \
-      .stream()
-
-#define SCOUT(module, severity)                                               \
-  LogMessage("", 0, LOG_SAVE_AND_SHOW, LOG_##severity, #module, false, false, \
-             false, true)                                                     \
-      .stream()
-
-#define DSCOUT(module, severity)                                              \
-  LogMessage("", 0, LOG_SAVE_AND_SHOW, LOG_##severity, #module, false, false, \
-             false, false)                                                    \
-      .stream()
+bool isLogOff(int severity, const char *module_name);
 
 /**
  * @brief: the log class to realize the log system.
@@ -136,6 +144,7 @@ class LogMessage {
   bool is_print_tail_;            // whether print log tail or not
   bool is_clear_endl_;            // whether clear endl int the string context
   bool release_can_print_;        // whether can print in release mode
+  bool is_on_;                    // passed the severity and module filter
   std::stringstream contex_str_;  // the context behind "<<"
   std::stringstream cout_str_;    // the context to show in the screen
   std::stringstream file_str_;    // the context to save in the file
@@ -190,6 +199,23 @@ int initLogOnlyShow(int log_level);
  */
 void endLog(void);
 
+/*
+ * @brief: switch the asynchronous mode, it is off by default and can be
+ *         turned on by the environment variable MLUOP_LOG_ASYNC.
+ *         in the asynchronous mode, messages are formatted by the logging
+ *         thread into its own ring buffer of LOG_ASYNC_RING_SIZE messages, and
+ *         written by a background thread. when the ring buffer is full, info,
+ *         warning and vlog messages are dropped and counted, error and fatal
+ *         messages wait for free space.
+ */
+void setAsync(bool async);
+
+/*
+ * @brief: wait until all messages logged before are written, it is called by
+ *         endLog and does nothing in the synchronous mode.
+ */
+void flushLog(void);
+
 /*
  * @brief: set the log levels.
  *         only the message level higher than this can be print.
@@ -113,6 +113,35 @@ mluOpStatus_t mluOpCheckDependency(bool need_check_min, bool need_check_max,
   return MLUOP_STATUS_SUCCESS;
 }
 
+// a context without MLU device, only host side work of ops can run on it.
+static mluOpContext *createVirtualContext(
+    const mluop::runtime::DeviceProfile &profile) {
+  mluOpContext *ctx = new (std::nothrow) mluOpContext();
+  if (ctx == NULL) {
+    return NULL;
+  }
+  char device_name[CONTEXT_DEVICENAME_BUFFER_SIZE] = "";
+  strncpy(device_name, profile.name.c_str(),
+          CONTEXT_DEVICENAME_BUFFER_SIZE - 1);
+  ctx->device = -1;
+  ctx->is_virtual_device = true;
+  ctx->cluster_num = profile.cluster_num;
+  ctx->core_num_per_cluster = profile.core_num_per_cluster;
+  ctx->nram_size = profile.nram_size - REM_FOR_STACK;
+  ctx->wram_size = profile.wram_size;
+  ctx->sram_size = profile.sram_size - REM_FOR_STACK;
+  ctx->capability_cluster_num = profile.capability_cluster_num;
+  ctx->capability_job_limit = profile.capability_job_limit;
+  ctx->initJobNum(profile);
+  ctx->arch = convertDeviceName(device_name);
+  ctx->launch_plan_cache = new (std::nothrow) mluop::runtime::LaunchPlanCache(
+      getUintEnvVar("MLUOP_LAUNCH_PLAN_CACHE_CAPACITY",
+                    LAUNCH_PLAN_CACHE_DEFAULT_CAPACITY));
+  VLOG(5) << "[mluOpCreate] Create a handle on virtual device " << device_name
+          << ".";
+  return ctx;
+}
+
 mluOpStatus_t mluOpCreate(mluOpHandle_t *handle) {
   PARAM_CHECK("[mluOpCreate]", handle != NULL);
 
@@ -121,6 +150,12 @@ mluOpStatus_t mluOpCreate(mluOpHandle_t *handle) {
     return MLUOP_STATUS_NOT_INITIALIZED;
   }
 
+  mluop::runtime::DeviceProfile profile;
+  if (mluop::runtime::getVirtualDevice(&profile)) {
+    *handle = createVirtualContext(profile);
+    return *handle == NULL ? MLUOP_STATUS_ALLOC_FAILED : MLUOP_STATUS_SUCCESS;
+  }
+
   CNdev mlu_dev;
   int32_t cluster_num = 0;
   int32_t core_num_per_cluster = 0;
@@ -183,12 +218,19 @@ mluOpStatus_t mluOpCreate(mluOpHandle_t *handle) {
   ctx->sram_size = sram_size - REM_FOR_STACK;
   ctx->arch =
       convertDeviceName(device_name);  // warning: possible return unknown.
+  ctx->launch_plan_cache = new (std::nothrow) mluop::runtime::LaunchPlanCache(
+      getUintEnvVar("MLUOP_LAUNCH_PLAN_CACHE_CAPACITY",
+                    LAUNCH_PLAN_CACHE_DEFAULT_CAPACITY));
   *handle = ctx;
   return MLUOP_STATUS_SUCCESS;
 }
 
 mluOpStatus_t mluOpUpdateContextInformation(mluOpHandle_t handle) {
   PARAM_CHECK("[mluOpUpdateContextInformation]", handle != NULL);
+  if (handle->is_virtual_device) {
+    // the limits of a virtual device only come from its profile.
+    return MLUOP_STATUS_SUCCESS;
+  }
   CNctxConfigParam ctx_conf_param;
   CNcontext drv_ctx;
   INTERNAL_CHECK(
@@ -220,15 +262,34 @@ mluOpStatus_t mluOpSetAtomicsMode(mluOpHandle_t handle,
 mluOpStatus_t mluOpDestroy(mluOpHandle_t handle) {
   PARAM_CHECK("[mluOpDestroy]", handle != NULL);
 
+  // the handle is freed even if releasing the workspace arena fails, it can
+  // not be destroyed again by the caller.
+  mluOpStatus_t status = MLUOP_STATUS_SUCCESS;
+  if (handle->workspace_arena != NULL) {
+    status = handle->workspace_arena->release(handle->queue);
+    if (status != MLUOP_STATUS_SUCCESS) {
+      LOG(ERROR) << "[mluOpDestroy] Release workspace arena failed.";
+    }
+    delete handle->workspace_arena;
+    handle->workspace_arena = NULL;
+  }
+  delete handle->launch_plan_cache;
   delete handle;
 
-  return MLUOP_STATUS_SUCCESS;
+  return status;
 }
 
 mluOpStatus_t mluOpSetQueue(mluOpHandle_t handle, cnrtQueue_t queue) {
   PARAM_CHECK("[mluOpSetQueue]", handle != NULL);
   PARAM_CHECK("[mluOpSetQueue]", queue != NULL);
 
+  // kernels on the old queue may still use the workspace arena, which will be
+  // reused by kernels on the new queue without any synchronization.
+  if (handle->workspace_arena != NULL && handle->queue != NULL &&
+      handle->queue != queue) {
+    INTERNAL_CHECK("[mluOpSetQueue]",
+                   cnrtSuccess == cnrtQueueSync(handle->queue));
+  }
   handle->queue = queue;
 
   return MLUOP_STATUS_SUCCESS;
@@ -293,6 +354,95 @@ mluOpStatus_t mluOpGetReservedMemSize(uint64_t *mem_size) {
   return MLUOP_STATUS_SUCCESS;
 }
 
+mluOpStatus_t mluOpEnableWorkspaceArena(mluOpHandle_t handle,
+                                        size_t reserved_size) {
+  const std::string api = "[mluOpEnableWorkspaceArena]";
+  PARAM_CHECK(api, handle != NULL);
+
+  uint64_t capacity_limit = 0;
+  CHECK_RETURN(api, mluOpGetReservedMemSize(&capacity_limit));
+  PARAM_CHECK_LE(api, reserved_size, capacity_limit);
+
+  if (handle->workspace_arena == NULL) {
+    handle->workspace_arena = new (std::nothrow) mluop::runtime::WorkspaceArena(
+        mluop::runtime::DeviceAllocator::Default(), capacity_limit);
+    if (handle->workspace_arena == NULL) {
+      LOG(ERROR) << api << " Create workspace arena failed.";
+      return MLUOP_STATUS_ALLOC_FAILED;
+    }
+  }
+  if (reserved_size > 0) {
+    CHECK_RETURN(api,
+                 handle->workspace_arena->reserve(reserved_size, handle->queue));
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t mluOpDisableWorkspaceArena(mluOpHandle_t handle) {
+  const std::string api = "[mluOpDisableWorkspaceArena]";
+  PARAM_CHECK(api, handle != NULL);
+
+  if (handle->workspace_arena != NULL) {
+    CHECK_RETURN(api, handle->workspace_arena->release(handle->queue));
+    delete handle->workspace_arena;
+    handle->workspace_arena = NULL;
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t mluOpGetWorkspaceArenaInfo(mluOpHandle_t handle,
+                                         size_t *capacity,
+                                         size_t *high_water_mark) {
+  const std::string api = "[mluOpGetWorkspaceArenaInfo]";
+  PARAM_CHECK(api, handle != NULL);
+  PARAM_CHECK(api, capacity != NULL);
+  PARAM_CHECK(api, high_water_mark != NULL);
+
+  if (handle->workspace_arena == NULL) {
+    *capacity = 0;
+    *high_water_mark = 0;
+  } else {
+    *capacity = handle->workspace_arena->capacity();
+    *high_water_mark = handle->workspace_arena->highWaterMark();
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t mluOpSetLaunchPlanCacheCapacity(mluOpHandle_t handle,
+                                              size_t capacity) {
+  PARAM_CHECK("[mluOpSetLaunchPlanCacheCapacity]", handle != NULL);
+  if (handle->launch_plan_cache == NULL) {
+    handle->launch_plan_cache =
+        new (std::nothrow) mluop::runtime::LaunchPlanCache(capacity);
+    if (handle->launch_plan_cache == NULL) {
+      LOG(ERROR) << "[mluOpSetLaunchPlanCacheCapacity] Create launch plan "
+                    "cache failed.";
+      return MLUOP_STATUS_ALLOC_FAILED;
+    }
+  } else {
+    handle->launch_plan_cache->setCapacity(capacity);
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t mluOpGetLaunchPlanCacheInfo(mluOpHandle_t handle, size_t *size,
+                                          uint64_t *hits, uint64_t *misses) {
+  PARAM_CHECK("[mluOpGetLaunchPlanCacheInfo]", handle != NULL);
+  PARAM_CHECK("[mluOpGetLaunchPlanCacheInfo]", size != NULL);
+  PARAM_CHECK("[mluOpGetLaunchPlanCacheInfo]", hits != NULL);
+  PARAM_CHECK("[mluOpGetLaunchPlanCacheInfo]", misses != NULL);
+  if (handle->launch_plan_cache == NULL) {
+    *size = 0;
+    *hits = 0;
+    *misses = 0;
+  } else {
+    *size = handle->launch_plan_cache->size();
+    *hits = handle->launch_plan_cache->hits();
+    *misses = handle->launch_plan_cache->misses();
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
 mluOpStatus_t mluOpGetContextParam(mluOpHandle_t handle,
                                    CNctxConfigParamType type,
                                    CNctxConfigParam *param) {
@@ -318,3 +468,9 @@ void mluOpGetLibVersion(int *major, int *minor, int *patch) {
   *minor = MLUOP_MINOR;
   *patch = MLUOP_PATCHLEVEL;
 }
+
+mluOpStatus_t mluOpSetVirtualDevice(const char *profile) {
+  CHECK_RETURN("[mluOpSetVirtualDevice]",
+               mluop::runtime::setVirtualDevice(profile == NULL ? "" : profile));
+  return MLUOP_STATUS_SUCCESS;
+}
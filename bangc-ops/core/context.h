@@ -27,6 +27,9 @@
 
 #include "cn_api.h"
 #include "core/logging.h"
+#include "core/runtime/launch_plan_cache.h"
+#include "core/runtime/virtual_device.h"
+#include "core/runtime/workspace_arena.h"
 #include "mlu_op.h"
 
 #define CONTEXT_DEVICENAME_BUFFER_SIZE 64
@@ -77,6 +80,12 @@ struct mluOpContext {
   int32_t capability_job_limit;
   mluOpQuantizeRoundMode_t round_mode;
   mluOpAtomicsMode_t atomics_mode;
+  // opt-in device memory arena for op workspaces, see mluOpEnableWorkspaceArena
+  mluop::runtime::WorkspaceArena *workspace_arena = nullptr;
+  // launch plans of recent op calls, see mluOpSetLaunchPlanCacheCapacity
+  mluop::runtime::LaunchPlanCache *launch_plan_cache = nullptr;
+  // filled from a device profile instead of CNDrv, see mluOpSetVirtualDevice
+  bool is_virtual_device = false;
 
   int32_t getJobNum(cnrtFunctionType_t function_type) {
     switch (function_type) {
@@ -125,9 +134,14 @@ struct mluOpContext {
     job_num[5] = number;
     return MLUOP_STATUS_SUCCESS;
   }
+  void initJobNum(const mluop::runtime::DeviceProfile &profile) {
+    for (int i = 0; i < VIRTUAL_DEVICE_JOB_TYPE_NUM; ++i) {
+      job_num[i] = profile.job_num[i];
+    }
+  }
 
  private:
-  int32_t job_num[6] = {0};
+  int32_t job_num[VIRTUAL_DEVICE_JOB_TYPE_NUM] = {0};
 };
 
 typedef enum {
@@ -22,6 +22,13 @@
  *************************************************************************/
 #include "core/gen_case.h"
 
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <thread>  // NOLINT
+
+#include "core/tensor.h"
+#include "core/tensor_file.h"
+
 namespace mluop {
 namespace gen_case {
 
@@ -29,16 +36,26 @@ namespace gen_case {
 #define IS_DUMP_DATA (genCaseModeGet(false) == 2)
 #define IS_ONLY_SHOW (genCaseModeGet(false) == 3)
 
-// mode_stacks_ is used for eliminate internal prototxt in mluOp interface
-__attribute__((__unused__)) std::unordered_map<std::string, std::vector<int>>
-    mode_stacks_;
-// nodes_ is like mode_stacks, keep nodes_vector for each thread
-__attribute__((__unused__)) std::unordered_map<std::string, std::vector<PbNode>>
-    nodes_;
-
-// create directory and modify mode_stacks_ should be thread-safe
+// the max number of captured cases waiting for the writer, the caller waits
+// when it is reached, so that host copies of tensors do not pile up.
+#define GEN_CASE_QUEUE_SIZE 64
+
+// gen_case state of each thread, it needs no lock.
+struct GenCaseThreadState {
+  // mode_stack is used for eliminate internal prototxt in mluOp interface
+  std::vector<int> mode_stack;
+  // nodes is like mode_stack, a deque keeps the nodes of outer calls in place
+  std::deque<PbNode> nodes;
+  // the mode_epoch_ when mode_stack was last updated
+  uint64_t mode_epoch = 0;
+};
+
+// create directory should be thread-safe
 __attribute__((__unused__)) std::mutex stacks_mutex_;
 
+// bumped by genCaseModeSet, each thread then resets its mode_stack
+__attribute__((__unused__)) std::atomic<uint64_t> mode_epoch_(0);
+
 // details of environment description can be found on Wiki
 
 // Get MLUOP_GEN_CASE from env.
@@ -46,8 +63,8 @@ __attribute__((__unused__)) std::mutex stacks_mutex_;
 // MLUOP_GEN_CASE=1: Generate gen_case file without input data
 // MLUOP_GEN_CASE=2: Generate gen_case file with input data
 // MLUOP_GEN_CASE=3: Print gen_case simple infomation on screen
-__attribute__((__unused__)) int gen_case_mode_ =
-    getUintEnvVar("MLUOP_GEN_CASE", 0);
+__attribute__((__unused__)) std::atomic<int> gen_case_mode_(
+    getUintEnvVar("MLUOP_GEN_CASE", 0));
 
 // MLUOP_GEN_CASE_DUMP_INTERNAL control whether dump internal mluOpapi call
 __attribute__((__unused__)) bool dump_internal_ =
@@ -74,9 +91,30 @@ __attribute__((__unused__)) int dump_data_output_ =
 // MLUOP_GEN_CASE_DUMP_DATA_FILE control whether dump data file separately
 // 0 : means not dump file
 // 1 : means dump file
+// 2 : means dump chunked file, compressed if the library is built with
+//     MLUOP_BUILD_ZSTD=ON, see core/tensor_file.h
 __attribute__((__unused__)) int dump_data_file_ =
     getUintEnvVar("MLUOP_GEN_CASE_DUMP_DATA_FILE", 0);
 
+// MLUOP_GEN_CASE_ASYNC control whether prototxt is written by a background
+// thread, 1 is default value. the caller only copies the tensors it dumps,
+// formatting and file writing are done by the writer thread.
+__attribute__((__unused__)) std::atomic<bool> async_serialize_(
+    getBoolEnvVar("MLUOP_GEN_CASE_ASYNC", true));
+
+static GenCaseThreadState &threadState() {
+  thread_local GenCaseThreadState state;
+  uint64_t epoch = mode_epoch_.load(std::memory_order_acquire);
+  if (state.mode_epoch != epoch) {
+    // genCaseModeSet was called, use the new mode in all levels
+    for (auto &mode : state.mode_stack) {
+      mode = gen_case_mode_;
+    }
+    state.mode_epoch = epoch;
+  }
+  return state;
+}
+
 bool isGenCaseOn() { return gen_case_mode_ > 0; }
 
 int genCaseModeGet(bool first) {
@@ -85,26 +123,16 @@ int genCaseModeGet(bool first) {
     if (!first) {
       return gen_case_mode_;
     }
-    std::lock_guard<std::mutex> guard(stacks_mutex_);
-    std::string tid(std::to_string(syscall(SYS_gettid)));
-    int mode = dump_internal_ ? gen_case_mode_ : 0;
-    auto it = mode_stacks_.find(tid);
-    if (it != mode_stacks_.end()) {
-      auto &mode_stack = it->second;
-      // the top of mode_stack store the gen_case mode for current thread
-      if (first) {
-        mode_stack.push_back(mode_stack.front());
-        mode_stack.front() = mode;
-      }
-      // during current mluOpapi, gen_case mode is on the bottom
-      return mode_stack.back();
-    } else {
-      std::vector<int> mode_stack(1, gen_case_mode_);
-      mode_stack.push_back(mode_stack.front());
-      mode_stack.front() = mode;
-      mode_stacks_.emplace(tid, mode_stack);
-      return gen_case_mode_;
+    auto &mode_stack = threadState().mode_stack;
+    int mode = dump_internal_ ? gen_case_mode_.load() : 0;
+    if (mode_stack.empty()) {
+      mode_stack.push_back(gen_case_mode_);
     }
+    // the top of mode_stack store the gen_case mode for current thread
+    mode_stack.push_back(mode_stack.front());
+    mode_stack.front() = mode;
+    // during current mluOpapi, gen_case mode is on the bottom
+    return mode_stack.back();
   } else {
     return 0;
   }
@@ -112,11 +140,8 @@ int genCaseModeGet(bool first) {
 
 void genCaseModeRestore() {
   if (gen_case_mode_ > 0) {
-    std::lock_guard<std::mutex> guard(stacks_mutex_);
-    std::string tid(std::to_string(syscall(SYS_gettid)));
-    auto it = mode_stacks_.find(tid);
-    if (it != mode_stacks_.end()) {
-      auto &mode_stack = it->second;
+    auto &mode_stack = threadState().mode_stack;
+    if (!mode_stack.empty()) {
       // use gen_case mode of current mluOpapi to restore current thread
       mode_stack.front() = mode_stack.back();
       mode_stack.pop_back();
@@ -126,74 +151,69 @@ void genCaseModeRestore() {
   }
 }
 
-// should update mode in mode_stacks_
+// the mode_stack of each thread is updated when the thread uses it next time
 void genCaseModeSet(int mode) {
-  if (mode < 0 && mode > 4) {
+  if (mode < 0 || mode > 4) {
     mode = 0;
   }
-  std::lock_guard<std::mutex> guard(stacks_mutex_);
-  for (auto &mode_stacks_it : mode_stacks_) {
-    auto &mode_stack = mode_stacks_it.second;
-    for (int i = 0; i < mode_stack.size(); i++) {
-      mode_stack[i] = mode;
-    }
-  }
   gen_case_mode_ = mode;
+  mode_epoch_.fetch_add(1, std::memory_order_release);
   LOG(INFO) << "[gen_case] Set GEN_CASE mode to " << mode << ".";
 }
 
-// TO DO: can use regex and global variable for efficiency
-inline bool getOpNameMask(const std::string op_name_,
-                          const std::string op_name) {
-  if (op_name_ == "all") {
-    return true;
-  }
-  std::unordered_map<std::string, int> op_name_mask;
-  std::regex re(";");
-  std::vector<std::string> split(
-      std::sregex_token_iterator(op_name_.begin(), op_name_.end(), re, -1),
-      std::sregex_token_iterator());
+// MLUOP_GEN_CASE_OP_NAME split by ";" once.
+struct OpNameFilter {
+  bool all = false;
   bool has_minus = false;
-  for (auto &name : split) {
-    if (name[0] == '-') {
-      has_minus = true;
-      op_name_mask.emplace(name.substr(1, name.size() - 1), -1);
-    } else {
-      op_name_mask.emplace(name, 1);
+  std::unordered_map<std::string, int> mask;
+
+  explicit OpNameFilter(const std::string &names) {
+    if (names == "all") {
+      all = true;
+      return;
     }
+    size_t begin = 0;
+    while (begin <= names.size()) {
+      size_t end = std::min(names.find(';', begin), names.size());
+      std::string name = names.substr(begin, end - begin);
+      if (!name.empty() && name[0] == '-') {
+        has_minus = true;
+        mask.emplace(name.substr(1), -1);
+      } else {
+        mask.emplace(name, 1);
+      }
+      begin = end + 1;
+    }
+  }
+};
+
+bool getOpNameMask(const std::string &op_name) {
+  static const OpNameFilter filter(op_name_);
+  if (filter.all) {
+    return true;
   }
-  if (op_name_mask.find(op_name) != op_name_mask.end()) {
-    return op_name_mask[op_name] == 1;
+  auto it = filter.mask.find(op_name);
+  if (it != filter.mask.end()) {
+    return it->second == 1;
   } else {
-    return has_minus;
+    return filter.has_minus;
   }
 }
 
 PbNode *genCaseStart(std::string op_name) {
-  std::lock_guard<std::mutex> guard(stacks_mutex_);
-  std::string tid(std::to_string(syscall(SYS_gettid)));
-  auto it = nodes_.find(tid);
-  if (it != nodes_.end()) {
-    auto &nodes_vector = it->second;
-    // find empty slot of node
-    for (int i = 0; i < nodes_vector.size(); i++) {
-      // so after serialization, node should be reset
-      if (nodes_vector[i].op_name == "") {
-        nodes_vector[i].setOpNameAndType(op_name);
-        return &nodes_vector[i];
-      }
+  auto &nodes = threadState().nodes;
+  // find empty slot of node
+  for (auto &node : nodes) {
+    // so after serialization, node should be reset
+    if (node.op_name == "") {
+      node.setOpNameAndType(op_name);
+      return &node;
     }
-    // if there is no empty node, should new PbNode
-    nodes_vector.push_back(PbNode());
-    nodes_vector.back().setOpNameAndType(op_name);
-    return &nodes_vector.back();
-  } else {
-    // first call in this thread, just set a vector of PbNode
-    nodes_.emplace(tid, std::vector<PbNode>(1));
-    PbNode &node = nodes_[tid].front();
-    node.setOpNameAndType(op_name);
-    return &node;
   }
+  // if there is no empty node, should new PbNode
+  nodes.emplace_back();
+  nodes.back().setOpNameAndType(op_name);
+  return &nodes.back();
 }
 
 void genCaseData(PbNode *node, bool is_input, std::string id,
@@ -275,21 +295,19 @@ void genCaseHandleParam(PbNode *node) {
 void genCaseEnd() {
   // serialize protxt and restore gen case mode
   if (gen_case_mode_ > 0) {
-    std::string tid(std::to_string(syscall(SYS_gettid)));
-    auto it = mode_stacks_.find(tid);
-    auto &mode_stack = it->second;
-    if (mode_stack.back() > 0) {
-      auto nodes_it = nodes_.find(tid);
-      auto &nodes_vector = nodes_it->second;
+    auto &state = threadState();
+    if (!state.mode_stack.empty() && state.mode_stack.back() > 0) {
       // find the last used slot
       int slot_num = 0;
-      for (int i = 0; i < nodes_vector.size(); i++) {
-        if (nodes_vector[i].op_name != "") {
+      for (auto &node : state.nodes) {
+        if (node.op_name != "") {
           slot_num++;
         }
       }
-      nodes_vector[slot_num - 1].serialize();
-      nodes_vector[slot_num - 1].reset();
+      if (slot_num > 0) {
+        state.nodes[slot_num - 1].serialize();
+        state.nodes[slot_num - 1].reset();
+      }
     }
   }
   genCaseModeRestore();
@@ -381,7 +399,7 @@ int PbNode::mkdir() {
 }
 
 void PbNode::serialize() {
-  if (getOpNameMask(op_name_, op_name)) {
+  if (getOpNameMask(op_name)) {
     if (IS_ONLY_SHOW) {
       printOnScreen();
     } else {
@@ -406,217 +424,366 @@ void PbNode::printOnScreen() {
   LOG(INFO) << print_info.str() << "\n";
 }
 
-void PbNode::dumpToFile() {
-  std::string folder_name = getFolderName();
-  int error_number = mkdir();
-  // use lock to ensure mkdir not conflict
-  if (error_number != 0) {
-    LOG(ERROR) << "[gen_case]: mkdir folder failed for " << folder_name
-               << " ! (" << errno << ": " << strerror(errno) << ")";
-    return;
+// a piece of prototxt, the text is followed by the values of a tensor.
+struct GenCaseSegment {
+  std::string text;
+  void *data = nullptr;  // host copy of the tensor, owned by the segment
+  bool pinned = false;   // data is from cnrtHostMalloc
+  mluOpDataType_t dtype = MLUOP_DTYPE_INVALID;
+  uint64_t total_num = 0;
+  int dump_mode = 0;      // 2 means dump hex value for float types
+  std::string data_file;  // dump the values into this file instead
+};
+
+struct GenCaseJob {
+  std::string folder_name;
+  std::string file_name;
+  std::vector<GenCaseSegment> segments;
+  // placed on the queue after the copies of outputs, nullptr if no output is
+  // copied asynchronously.
+  cnrtNotifier_t outputs_ready = nullptr;
+
+  ~GenCaseJob() {
+    for (auto &segment : segments) {
+      if (segment.pinned) {
+        cnrtFreeHost(segment.data);
+      } else {
+        free(segment.data);
+      }
+    }
+    if (outputs_ready != nullptr) {
+      cnrtNotifierDestroy(outputs_ready);
+    }
   }
-  std::string file_name = getFileName();
-  std::string case_file_name = folder_name + "/" + file_name + ".prototxt";
-  LOG(INFO) << "[gen_case] Generate " + case_file_name;
-  std::ofstream case_file;
-  if (!case_file.is_open()) {
-    case_file.open(case_file_name.c_str(), std::ios::app);
-    if (case_file) {
-      case_file << "op_name: \"" + op_name + "\"\n";
-      for (int i = 0; i < tensors.size(); i++) {
-        if (tensors[i].is_input) {
-          case_file << "input {\n  id: \"" << tensors[i].id << "\"\n";
+};
+
+static int dtypeRatio(mluOpDataType_t dtype) {
+  switch (dtype) {
+    // case MLUOP_DTYPE_INT31:
+    case MLUOP_DTYPE_COMPLEX_HALF:
+    case MLUOP_DTYPE_COMPLEX_FLOAT:
+      return 2;
+    default:
+      return 1;
+  }
+}
+
+static bool dtypeFloat(mluOpDataType_t dtype) {
+  switch (dtype) {
+    case MLUOP_DTYPE_HALF:
+    case MLUOP_DTYPE_FLOAT:
+    case MLUOP_DTYPE_DOUBLE:
+    case MLUOP_DTYPE_COMPLEX_HALF:
+    case MLUOP_DTYPE_COMPLEX_FLOAT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// attach the host copy of tensor index to the last segment, and start a new
+// segment for the text after it.
+static void appendTensorData(GenCaseJob *job, PbNode *node, int index,
+                             void *data, bool pinned, int dump_mode) {
+  auto &segment = job->segments.back();
+  segment.data = data;
+  segment.pinned = pinned;
+  segment.total_num = node->getTensorSize(index);
+  mluOpGetTensorDescriptor(node->tensors[index].desc, nullptr, &segment.dtype,
+                           nullptr, nullptr);
+  segment.dump_mode = dump_mode;
+  if (dump_data_file_ == 1 || dump_data_file_ == 2) {
+    segment.data_file = job->file_name + "_data" + std::to_string(index);
+  }
+  job->segments.emplace_back();
+}
+
+void PbNode::capture(GenCaseJob *job) {
+  job->folder_name = getFolderName();
+  job->file_name = getFileName();
+  job->segments.emplace_back();
+  job->segments.back().text = "op_name: \"" + op_name + "\"\n";
+  cnrtQueue_t queue = nullptr;
+  for (int i = 0; i < tensors.size(); i++) {
+    std::string text;
+    if (tensors[i].is_input) {
+      text = "input {\n  id: \"" + tensors[i].id + "\"\n";
+    } else {
+      text = "output {\n  id: \"" + tensors[i].id + "\"\n";
+    }
+    job->segments.back().text += text + descToString(tensors[i].desc, '\n');
+    if (tensors[i].is_input) {
+      // TO DO : can be more elegant
+      void *data = nullptr;
+      if (IS_DUMP_DATA && (tensors[i].dump_data || dump_data_ > 0) &&
+          tensors[i].device_ptr != nullptr) {
+        // TO DO : should consider malloc failure
+        data = getDeviceData(i);
+      }
+      if (data != nullptr) {
+        appendTensorData(job, this, i, data, false, dump_data_);
+      } else {
+        job->segments.back().text += get_tensor_random_string(i);
+      }
+    } else if (dump_data_output_) {
+      if (queue == nullptr) {
+        mluOpGetQueue(handle, &queue);
+      }
+      uint64_t total_num = getTensorSize(i);
+      mluOpDataType_t dtype;
+      mluOpGetTensorDescriptor(tensors[i].desc, nullptr, &dtype, nullptr,
+                               nullptr);
+      uint64_t data_size = total_num * getSizeOfDataType(dtype);
+      void *data = nullptr;
+      if (async_serialize_) {
+        // copy after the kernel on the queue instead of syncing the queue,
+        // the writer waits for outputs_ready before reading the copy.
+        if (cnrtSuccess != cnrtHostMalloc(&data, data_size) ||
+            cnrtSuccess !=
+                cnrtMemcpyAsync(data, const_cast<void *>(tensors[i].device_ptr),
+                                data_size, queue,
+                                CNRT_MEM_TRANS_DIR_DEV2HOST)) {
+          LOG(ERROR) << "[gen_case] Dump data failed! cnrtMemcpyAsync data "
+                        "size is "
+                     << data_size << " byte.";
+          cnrtFreeHost(data);
+          data = nullptr;
         } else {
-          case_file << "output {\n  id: \"" << tensors[i].id << "\"\n";
+          appendTensorData(job, this, i, data, true, dump_data_output_);
         }
-        case_file << descToString(tensors[i].desc, '\n');
-        // helper function for dtype
-        auto dtypeRatio = [](mluOpDataType_t dtype) {
-          switch (dtype) {
-            // case MLUOP_DTYPE_INT31:
-            case MLUOP_DTYPE_COMPLEX_HALF:
-            case MLUOP_DTYPE_COMPLEX_FLOAT:
-              return 2;
-            default:
-              return 1;
-          }
-        };
-        auto dtypeFloat = [](mluOpDataType_t dtype) {
-          switch (dtype) {
-            case MLUOP_DTYPE_HALF:
-            case MLUOP_DTYPE_FLOAT:
-            case MLUOP_DTYPE_DOUBLE:
-            case MLUOP_DTYPE_COMPLEX_HALF:
-            case MLUOP_DTYPE_COMPLEX_FLOAT:
-              return true;
-            default:
-              return false;
-          }
-        };
-        if (tensors[i].is_input) {
-          // TO DO : can be more elegant
-          if (IS_DUMP_DATA) {
-            if ((tensors[i].dump_data || dump_data_ > 0) &&
-                tensors[i].device_ptr != nullptr) {
-              uint64_t total_num = getTensorSize(i);
-              mluOpDataType_t dtype;
-              mluOpGetTensorDescriptor(tensors[i].desc, nullptr, &dtype,
-                                       nullptr, nullptr);
-              // TO DO : should consider malloc failure
-              void *data = getDeviceData(i);
-              if (data != nullptr) {
-                if (dump_data_file_ == 1) {
-                  std::string tensor_file_suffix =
-                      file_name + "_data" + std::to_string(i);
-                  std::string tensor_file_name =
-                      folder_name + "/" + tensor_file_suffix;
-                  std::ofstream tensor_file;
-                  tensor_file.open(tensor_file_name.c_str(), std::ios::binary);
-                  tensor_file.write(reinterpret_cast<const char *>(data),
-                                    total_num * getSizeOfDataType(dtype));
-                  tensor_file.close();
-                  case_file << "  path: \"" << tensor_file_suffix << "\"\n";
-                } else {
-                  total_num *= dtypeRatio(dtype);
-                  for (uint64_t j = 0; j < total_num; ++j) {
-                    if (dump_data_ == 2 && dtypeFloat(dtype)) {
-                      case_file << "  value_h: "
-                                << get_data_hex_string(dtype, data, j) << "\n";
-                    } else {
-                      case_file << get_dtype_value_string(dtype)
-                                << get_data_string(dtype, data, j) << "\n";
-                    }
-                  }
-                }
-                // free resources to avoid memeory leak
-                free(data);
-              } else {
-                case_file << get_tensor_random_string(i);
-              }
-            } else {
-              case_file << get_tensor_random_string(i);
-            }
-          } else {
-            case_file << get_tensor_random_string(i);
-          }
-        } else {
-          // sync queue to dump output if necessary
-          if (dump_data_output_) {
-            cnrtQueue_t queue;
-            mluOpGetQueue(handle, &queue);
-            if (cnrtSuccess != cnrtQueueSync(queue)) {
-              LOG(ERROR) << "[gen_case] syncQueue failed!";
-            } else {
-              uint64_t total_num = getTensorSize(i);
-              mluOpDataType_t dtype;
-              mluOpGetTensorDescriptor(tensors[i].desc, nullptr, &dtype,
-                                       nullptr, nullptr);
-              // TO DO : should consider malloc failure
-              void *data = getDeviceData(i);
-              if (data != nullptr) {
-                if (dump_data_file_ == 1) {
-                  std::string tensor_file_suffix =
-                      file_name + "_data" + std::to_string(i);
-                  std::string tensor_file_name =
-                      folder_name + "/" + tensor_file_suffix;
-                  std::ofstream tensor_file;
-                  tensor_file.open(tensor_file_name.c_str(), std::ios::binary);
-                  tensor_file.write(reinterpret_cast<const char *>(data),
-                                    total_num * getSizeOfDataType(dtype));
-                  tensor_file.close();
-                  case_file << "  path: \"" << tensor_file_suffix << "\"\n";
-                } else {
-                  total_num *= dtypeRatio(dtype);
-                  for (uint64_t j = 0; j < total_num; ++j) {
-                    if (dump_data_output_ == 2 && dtypeFloat(dtype)) {
-                      case_file << "  value_h: "
-                                << get_data_hex_string(dtype, data, j) << "\n";
-                    } else {
-                      case_file << get_dtype_value_string(dtype)
-                                << get_data_string(dtype, data, j) << "\n";
-                    }
-                  }
-                }
-                // free resources to avoid memeory leak
-                free(data);
-              }
-            }
-          }
+      } else if (cnrtSuccess != cnrtQueueSync(queue)) {
+        // sync queue to dump output if necessary
+        LOG(ERROR) << "[gen_case] syncQueue failed!";
+      } else {
+        data = getDeviceData(i);
+        if (data != nullptr) {
+          appendTensorData(job, this, i, data, false, dump_data_output_);
         }
-        case_file << "}\n";
       }
-      // TO DO : can support child of child
-      if (op_param.name != "") {
-        case_file << op_param.name << " {\n";
-        for (int i = 0; i < op_param.params.size(); i++) {
-          case_file << "  " << op_param.params[i].first << ": "
-                    << op_param.params[i].second << "\n";
-        }
-        for (int i = 0; i < op_param.childs.size(); i++) {
-          case_file << "  " << op_param.childs[i].name << " {\n";
-          for (int j = 0; j < op_param.childs[i].params.size(); j++) {
-            case_file << "    " << op_param.childs[i].params[j].first << ": "
-                      << op_param.childs[i].params[j].second << "\n";
-          }
-          case_file << "  }\n";
-        }
-        case_file << "}\n";
+    }
+    job->segments.back().text += "}\n";
+  }
+  bool has_async_output = false;
+  for (auto &segment : job->segments) {
+    has_async_output = has_async_output || segment.pinned;
+  }
+  if (has_async_output) {
+    if (cnrtSuccess != cnrtNotifierCreate(&job->outputs_ready) ||
+        cnrtSuccess != cnrtPlaceNotifier(job->outputs_ready, queue)) {
+      LOG(ERROR) << "[gen_case] place notifier failed, sync queue instead.";
+      cnrtQueueSync(queue);
+      if (job->outputs_ready != nullptr) {
+        cnrtNotifierDestroy(job->outputs_ready);
+        job->outputs_ready = nullptr;
       }
-      if (handle_param.name != "") {
-        case_file << handle_param.name << " {\n";
-        for (int i = 0; i < handle_param.params.size(); i++) {
-          case_file << "  " << handle_param.params[i].first << ": "
-                    << handle_param.params[i].second << "\n";
-        }
-        case_file << "}\n";
+    }
+  }
+
+  std::stringstream case_file;
+  // TO DO : can support child of child
+  if (op_param.name != "") {
+    case_file << op_param.name << " {\n";
+    for (int i = 0; i < op_param.params.size(); i++) {
+      case_file << "  " << op_param.params[i].first << ": "
+                << op_param.params[i].second << "\n";
+    }
+    for (int i = 0; i < op_param.childs.size(); i++) {
+      case_file << "  " << op_param.childs[i].name << " {\n";
+      for (int j = 0; j < op_param.childs[i].params.size(); j++) {
+        case_file << "    " << op_param.childs[i].params[j].first << ": "
+                  << op_param.childs[i].params[j].second << "\n";
       }
-      case_file << "test_param {\n";
-      for (int i = 0; i < criterions.size(); i++) {
-        case_file << "  error_func: " << criterions[i] << "\n";
+      case_file << "  }\n";
+    }
+    case_file << "}\n";
+  }
+  if (handle_param.name != "") {
+    case_file << handle_param.name << " {\n";
+    for (int i = 0; i < handle_param.params.size(); i++) {
+      case_file << "  " << handle_param.params[i].first << ": "
+                << handle_param.params[i].second << "\n";
+    }
+    case_file << "}\n";
+  }
+  case_file << "test_param {\n";
+  for (int i = 0; i < criterions.size(); i++) {
+    case_file << "  error_func: " << criterions[i] << "\n";
+  }
+  for (int i = 0; i < criterions.size(); i++) {
+    case_file << "  error_threshold: " << thresholds[i] << "\n";
+    if (thresholds_imag[i] >= 0) {
+      case_file << "  error_threshold_imag: " << thresholds_imag[i] << "\n";
+    }
+  }
+  case_file << "  baseline_device: CPU\n}";
+  job->segments.back().text += case_file.str();
+}
+
+static void writeCaseJob(const GenCaseJob &job) {
+  const std::string &folder_name = job.folder_name;
+  int error_number = 0;
+  {
+    // use lock to ensure mkdir not conflict
+    std::lock_guard<std::mutex> guard(stacks_mutex_);
+    error_number = mkdirRecursive(folder_name.c_str());
+  }
+  if (error_number != 0) {
+    LOG(ERROR) << "[gen_case]: mkdir folder failed for " << folder_name
+               << " ! (" << errno << ": " << strerror(errno) << ")";
+    return;
+  }
+  std::string case_file_name = folder_name + "/" + job.file_name + ".prototxt";
+  LOG(INFO) << "[gen_case] Generate " + case_file_name;
+  if (job.outputs_ready != nullptr &&
+      cnrtSuccess != cnrtWaitNotifier(job.outputs_ready)) {
+    LOG(ERROR) << "[gen_case] wait notifier failed!";
+  }
+  std::ofstream case_file;
+  case_file.open(case_file_name.c_str(), std::ios::app);
+  if (!case_file) {
+    return;
+  }
+  for (const auto &segment : job.segments) {
+    case_file << segment.text;
+    if (segment.data == nullptr) {
+      continue;
+    }
+    if (!segment.data_file.empty()) {
+      std::string tensor_file_name = folder_name + "/" + segment.data_file;
+      size_t data_size = segment.total_num * getSizeOfDataType(segment.dtype);
+      if (dump_data_file_ == 2) {
+        writeTensorFile(tensor_file_name, segment.data, data_size, true);
+      } else {
+        std::ofstream tensor_file;
+        tensor_file.open(tensor_file_name.c_str(), std::ios::binary);
+        tensor_file.write(reinterpret_cast<const char *>(segment.data),
+                          data_size);
+        tensor_file.close();
       }
-      for (int i = 0; i < criterions.size(); i++) {
-        case_file << "  error_threshold: " << thresholds[i] << "\n";
-        if (thresholds_imag[i] >= 0) {
-          case_file << "  error_threshold_imag: " << thresholds_imag[i] << "\n";
+      case_file << "  path: \"" << segment.data_file << "\"\n";
+    } else {
+      uint64_t total_num = segment.total_num * dtypeRatio(segment.dtype);
+      bool is_hex = segment.dump_mode == 2 && dtypeFloat(segment.dtype);
+      std::string value_prefix = PbNode::get_dtype_value_string(segment.dtype);
+      for (uint64_t j = 0; j < total_num; ++j) {
+        if (is_hex) {
+          case_file << "  value_h: "
+                    << PbNode::get_data_hex_string(segment.dtype, segment.data,
+                                                   j)
+                    << "\n";
+        } else {
+          case_file << value_prefix
+                    << PbNode::get_data_string(segment.dtype, segment.data, j)
+                    << "\n";
         }
       }
-      case_file << "  baseline_device: CPU\n}";
     }
-    case_file.close();
   }
+  case_file.close();
 }
 
-// Check if tensor need stride process.
-// should be same with tensor_stride_process_host.mlu
-bool ifNeedTensorStrideProcess(const mluOpTensorDescriptor_t desc) {
-  bool needStrideProcess = false;
-  int tensor_dim;
-  int dims[MLUOP_DIM_MAX];
-  int strides[MLUOP_DIM_MAX];
-  mluOpTensorLayout_t layout;
-  mluOpDataType_t dtype;
-  mluOpGetTensorDescriptorEx(desc, &layout, &dtype, &tensor_dim, dims, strides);
-  int stride_base = 1;
-  for (int i = tensor_dim - 1; i >= 0; i--) {
-    if (dims[i] != 1) {
-      if (strides[i] == stride_base) {
-        stride_base *= dims[i];
-      } else {
-        needStrideProcess = true;
+/******************************************************************************
+ * GenCaseWriter
+ * Writes captured cases on a background thread in the order they are pushed.
+ * At most GEN_CASE_QUEUE_SIZE cases are pending, a case is never dropped.
+ ******************************************************************************/
+class GenCaseWriter {
+ public:
+  static GenCaseWriter &instance() {
+    static GenCaseWriter writer;
+    return writer;
+  }
+
+  ~GenCaseWriter() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_cv_.notify_one();
+    thread_.join();
+  }
+
+  void push(std::unique_ptr<GenCaseJob> job) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    caller_cv_.wait(lock, [&] { return jobs_.size() < GEN_CASE_QUEUE_SIZE; });
+    jobs_.push_back(std::move(job));
+    ++pushed_;
+    work_cv_.notify_one();
+  }
+
+  void flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t target = pushed_;
+    caller_cv_.wait(lock, [&] { return written_ >= target; });
+  }
+
+ private:
+  GenCaseWriter() : thread_(&GenCaseWriter::run, this) {}
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      work_cv_.wait(lock, [&] { return stop_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
         break;
       }
+      std::unique_ptr<GenCaseJob> job = std::move(jobs_.front());
+      jobs_.pop_front();
+      lock.unlock();
+      writeCaseJob(*job);
+      job.reset();
+      lock.lock();
+      ++written_;
+      caller_cv_.notify_all();
     }
   }
-  return needStrideProcess;
+
+  std::mutex mutex_;  // protect the members below
+  std::condition_variable work_cv_;
+  std::condition_variable caller_cv_;
+  std::deque<std::unique_ptr<GenCaseJob>> jobs_;
+  uint64_t pushed_ = 0;
+  uint64_t written_ = 0;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+void genCaseAsyncSet(bool async) {
+  if (!async) {
+    genCaseFlush();
+  }
+  async_serialize_ = async;
+}
+
+void genCaseFlush() {
+  if (async_serialize_) {
+    GenCaseWriter::instance().flush();
+  }
+}
+
+void PbNode::dumpToFile() {
+  std::unique_ptr<GenCaseJob> job(new GenCaseJob);
+  capture(job.get());
+  if (async_serialize_) {
+    GenCaseWriter::instance().push(std::move(job));
+  } else {
+    writeCaseJob(*job);
+  }
+}
+
+// Check if tensor need stride process.
+// The stride facts are cached in the descriptor by the setters.
+bool ifNeedTensorStrideProcess(const mluOpTensorDescriptor_t desc) {
+  return !desc->is_contiguous;
 }
 
 std::string descToString(mluOpTensorDescriptor_t desc, char delimiter) {
-  int dims[MLUOP_DIM_MAX];
-  int strides[MLUOP_DIM_MAX];
+  int64_t dims[MLUOP_DIM_MAX];
+  int64_t strides[MLUOP_DIM_MAX];
   int dim;
   mluOpTensorLayout_t layout;
   mluOpDataType_t dtype;
-  mluOpGetTensorDescriptorEx(desc, &layout, &dtype, &dim, dims, strides);
+  mluOpGetTensorDescriptorEx_v2(desc, &layout, &dtype, &dim, dims, strides);
   mluOpDataType_t onchip_dtype;
   mluOpGetTensorDescriptorOnchipDataType(desc, &onchip_dtype);
   int position, offset;
@@ -30,13 +30,14 @@
 #include <stdio.h>
 #include <error.h>
 #include <iomanip>
+#include <atomic>
+#include <deque>
 #include <unordered_map>
 #include <vector>
 #include <algorithm>
 #include <string>
 #include <iostream>
 #include <fstream>
-#include <regex>  // NOLINT
 #include <mutex>  // NOLINT
 #include <iterator>
 #include <utility>
@@ -116,7 +117,9 @@
                                     diff1_threshold, diff2_threshold,          \
                                     diff3_threshold, ##__VA_ARGS__)
 
-#define GEN_CASE_END() mluop::gen_case::genCaseEnd()
+#define GEN_CASE_END()                                  \
+  (MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE), \
+   mluop::gen_case::genCaseEnd())
 
 namespace mluop {
 namespace gen_case {
@@ -130,6 +133,9 @@ struct ParamNode {
   std::vector<ParamNode> childs;
 };
 
+// a case captured on the calling thread and written by the gen_case writer.
+struct GenCaseJob;
+
 struct TensorNode {
   bool is_input;
   std::string id;
@@ -241,7 +247,7 @@ class PbNode {
     }
     return random_str.str();
   }
-  inline std::string get_dtype_value_string(mluOpDataType_t dtype) {
+  static inline std::string get_dtype_value_string(mluOpDataType_t dtype) {
     switch (dtype) {
       case MLUOP_DTYPE_HALF:
       case MLUOP_DTYPE_FLOAT:
@@ -266,8 +272,8 @@ class PbNode {
         return "  value_i: ";
     }
   }
-  inline std::string get_data_string(mluOpDataType_t dtype, void *data,
-                                     uint64_t offset) {
+  static inline std::string get_data_string(mluOpDataType_t dtype, void *data,
+                                            uint64_t offset) {
     switch (dtype) {
       case MLUOP_DTYPE_HALF:
         return std::to_string(castHalfToFloat32(((int16_t *)data)[offset]));
@@ -301,8 +307,8 @@ class PbNode {
         return std::to_string(((int8_t *)data)[offset]);
     }
   }
-  inline std::string get_data_hex_string(mluOpDataType_t dtype, void *data,
-                                         uint64_t offset) {
+  static inline std::string get_data_hex_string(mluOpDataType_t dtype,
+                                                void *data, uint64_t offset) {
     std::stringstream s;
     switch (dtype) {
       case MLUOP_DTYPE_HALF:
@@ -327,13 +333,13 @@ class PbNode {
     return "\"" + s.str() + "\"";
   }
   inline uint64_t getTensorSize(int index) {
-    int dims[MLUOP_DIM_MAX];
-    int strides[MLUOP_DIM_MAX];
+    int64_t dims[MLUOP_DIM_MAX];
+    int64_t strides[MLUOP_DIM_MAX];
     int dim;
     mluOpTensorLayout_t layout;
     mluOpDataType_t dtype;
-    mluOpGetTensorDescriptorEx(tensors[index].desc, &layout, &dtype, &dim, dims,
-                               strides);
+    mluOpGetTensorDescriptorEx_v2(tensors[index].desc, &layout, &dtype, &dim,
+                                  dims, strides);
     // if tensor not be set, total_element_num will be 0
     uint64_t count = 1;
     for (int i = 0; i < dim; i++) {
@@ -380,6 +386,9 @@ class PbNode {
   int mkdir();
   void setHandle(mluOpHandle_t handle) { this->handle = handle; }
   void getHandleParam();
+  // copy everything the prototxt needs, so the writer does not touch the
+  // descriptors or device memory of the caller.
+  void capture(GenCaseJob *job);
   void dumpToFile();
   void printOnScreen();
   void serialize();
@@ -468,8 +477,12 @@ bool isGenCaseOn();
 int genCaseModeGet(bool first);
 void genCaseModeRestore();
 void genCaseModeSet(int mode);
-inline bool getOpNameMask(const std::string op_name_,
-                          const std::string op_name);
+// whether MLUOP_GEN_CASE_OP_NAME selects op_name
+bool getOpNameMask(const std::string &op_name);
+// whether prototxt files are written by the background writer thread
+void genCaseAsyncSet(bool async);
+// wait until every captured case is written
+void genCaseFlush();
 
 PbNode *genCaseStart(std::string op_name);
 void genCaseData(PbNode *node, bool is_input, std::string id,
@@ -29,6 +29,7 @@
 #include <sstream>
 #include "core/macros.h"
 #include "core/cnlog.h"
+#include "core/runtime/op_profiler.h"
 #include "mlu_op.h"
 
 #define LARGE_TENSOR_NUM ((uint64_t)2147483648)
@@ -87,8 +88,11 @@
 // return if found cnrt error.
 #define KERNEL_CHECK(kernel...)                                    \
   {                                                                \
+    int __profile_phase =                                          \
+        MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_KERNEL_ENQUEUE); \
     cnrtGetLastError();                                            \
     kernel;                                                        \
+    MLUOP_PROFILE_PHASE(__profile_phase);                          \
     cnrtRet_t ret = cnrtPeekAtLastError();                         \
     if (MLUOP_PREDICT_FALSE(CNRT_RET_SUCCESS != ret)) {            \
       LOG(ERROR) << "Check failed: Found " << cnrtGetErrorStr(ret) \
@@ -105,13 +109,13 @@
   }
 
 // CHECK if return value equals MLUOP_STATUS_SUCCESS
-#define CHECK_RETURN(api, status, ...)                                     \
+#define CHECK_RETURN(api, status)                                          \
   {                                                                        \
     mluOpStatus_t __status__ = (status);                                   \
     if ((__status__) != MLUOP_STATUS_SUCCESS) {                            \
       LOG(ERROR) << api << "BAD return status: " << #status << " returns " \
                  << (__status__) << " (FILE: " << __FILE__                 \
-                 << ", LINE: " << __LINE__ "). " __VA_ARGS__;              \
+                 << ", LINE: " << __LINE__ << ").";                        \
       return (__status__);                                                 \
     }                                                                      \
   }
@@ -252,9 +256,7 @@ class LogMessageFatal : public LogMessage {
     return vmodule_activated;                                          \
   })(lvl, __FILE__))
 
-#define VLOG(level)                      \
-  MLUOP_PREDICT_TRUE(!VLOG_IS_ON(level)) \
-  ? (void)0 : ::mluop::internal::Voidifier() & LOG(VLOG)
+#define VLOG(level) MLUOP_PREDICT_TRUE(!VLOG_IS_ON(level)) ? (void)0 : LOG(VLOG)
 
 // This formats a value for a failing CHECK_XX statement.  Ordinarily,
 // it uses the definition for operator<<, with a few special cases below.
@@ -0,0 +1,103 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef CORE_RUNTIME_CHUNKED_LAUNCH_H_
+#define CORE_RUNTIME_CHUNKED_LAUNCH_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "mlu_op.h"
+
+// Element-wise kernels take the element number as int, a tensor with more
+// elements is processed by several launches of at most LAUNCH_CHUNK_MAX_NUM
+// elements. Chunks are multiples of LAUNCH_CHUNK_ALIGN_NUM elements, so every
+// chunk starts at an address as aligned as the tensor itself.
+#define LAUNCH_CHUNK_ALIGN_NUM ((int64_t)1 << 16)
+#define LAUNCH_CHUNK_MAX_NUM (((int64_t)1 << 31) - LAUNCH_CHUNK_ALIGN_NUM)
+
+namespace mluop {
+namespace runtime {
+
+// The elements of every chunk of launchInChunks but the last one.
+inline int64_t getChunkNum(int64_t total_num, int64_t max_chunk_num) {
+  if (total_num <= max_chunk_num) {
+    return total_num;
+  }
+  const int64_t chunk_count = (total_num + max_chunk_num - 1) / max_chunk_num;
+  int64_t chunk_num = (total_num + chunk_count - 1) / chunk_count;
+  chunk_num = (chunk_num + LAUNCH_CHUNK_ALIGN_NUM - 1) /
+              LAUNCH_CHUNK_ALIGN_NUM * LAUNCH_CHUNK_ALIGN_NUM;
+  return std::min(chunk_num, max_chunk_num);
+}
+
+// The number of launches launchInChunks makes for `total_num` elements.
+inline int64_t getChunkCount(int64_t total_num, int64_t max_chunk_num) {
+  if (total_num <= 0) {
+    return 0;
+  }
+  const int64_t chunk_num = getChunkNum(total_num, max_chunk_num);
+  return (total_num + chunk_num - 1) / chunk_num;
+}
+
+/******************************************************************************
+ * mluOp FUNC: launchInChunks
+ * Splits `total_num` elements into the fewest chunks of at most
+ * `max_chunk_num` elements, chunks are of equal size except the last one.
+ * `launch(offset, num)` is called for each chunk in order, `offset` is the
+ * index of the first element of the chunk. Returns the first status which is
+ * not MLUOP_STATUS_SUCCESS, remaining chunks are not launched then.
+ * `max_chunk_num` should be a multiple of LAUNCH_CHUNK_ALIGN_NUM.
+ ******************************************************************************/
+template <typename LaunchFunc>
+mluOpStatus_t launchInChunks(int64_t total_num, int64_t max_chunk_num,
+                             LaunchFunc launch) {
+  if (total_num <= max_chunk_num) {
+    return total_num > 0 ? launch((int64_t)0, total_num)
+                         : MLUOP_STATUS_SUCCESS;
+  }
+  const int64_t chunk_num = getChunkNum(total_num, max_chunk_num);
+  for (int64_t offset = 0; offset < total_num; offset += chunk_num) {
+    mluOpStatus_t status =
+        launch(offset, std::min(chunk_num, total_num - offset));
+    if (status != MLUOP_STATUS_SUCCESS) {
+      return status;
+    }
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
+// Returns `ptr` advanced by `offset` elements of `dtype_size` bytes.
+inline const void *elementOffset(const void *ptr, int64_t offset,
+                                 size_t dtype_size) {
+  return (const char *)ptr + offset * (int64_t)dtype_size;
+}
+
+inline void *elementOffset(void *ptr, int64_t offset, size_t dtype_size) {
+  return (char *)ptr + offset * (int64_t)dtype_size;
+}
+
+}  // namespace runtime
+}  // namespace mluop
+
+#endif  // CORE_RUNTIME_CHUNKED_LAUNCH_H_
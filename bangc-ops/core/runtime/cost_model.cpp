@@ -0,0 +1,184 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "core/runtime/cost_model.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "core/context.h"
+#include "core/logging.h"
+#include "core/runtime/chunked_launch.h"
+#include "core/runtime/device.h"
+#include "core/tensor.h"
+
+namespace mluop {
+namespace runtime {
+
+namespace {
+// DRAM bandwidth in GB/s.
+constexpr double kIoBandwidthMLU220 = 25.6;
+constexpr double kIoBandwidthMLU270 = 102.4;
+constexpr double kIoBandwidthMLU290 = 1024;
+constexpr double kIoBandwidthMLU370 = 307.2;
+// ops per cycle of the computing unit of a core, at 1 GHz.
+constexpr double kPeakFloat16ComputeForce = 64;
+constexpr double kPeakFloat32ComputeForce = 32;
+constexpr double kCoreFrequency = 1e9;
+// host enqueue to kernel start of one launch.
+constexpr double kKernelLaunchUs = 5;
+
+struct OpCostEntry {
+  int desc_num;
+  OpCostFunc func;
+};
+
+// registrars run before main, the map is leaked so that it outlives them.
+std::map<std::string, OpCostEntry> &registry() {
+  static auto *instance = new std::map<std::string, OpCostEntry>();
+  return *instance;
+}
+}  // namespace
+
+OpCostRegistrar::OpCostRegistrar(const char *op_name, int desc_num,
+                                 OpCostFunc func) {
+  registry()[op_name] = {desc_num, func};
+}
+
+mluOpStatus_t getOpCost(mluOpHandle_t handle, const char *op_name,
+                        const mluOpTensorDescriptor_t *descs, int desc_num,
+                        OpCost *cost) {
+  auto entry = registry().find(op_name);
+  if (entry == registry().end()) {
+    LOG(ERROR) << "[mluOpGetOpCostModel] " << op_name
+               << " has no cost model.";
+    return MLUOP_STATUS_NOT_SUPPORTED;
+  }
+  if (desc_num != entry->second.desc_num) {
+    LOG(ERROR) << "[mluOpGetOpCostModel] " << op_name << " takes "
+               << entry->second.desc_num << " tensor descriptors, but "
+               << desc_num << " are given.";
+    return MLUOP_STATUS_BAD_PARAM;
+  }
+  *cost = OpCost();
+  return entry->second.func(handle, descs, desc_num, cost);
+}
+
+double getPeakComputeForce(mluOpHandle_t handle, mluOpDataType_t dtype) {
+  double core_num = (double)getClusterLimitCapability(handle) *
+                    handle->core_num_per_cluster;
+  switch (dtype) {
+    case MLUOP_DTYPE_HALF:
+    case MLUOP_DTYPE_INT16:
+      return kPeakFloat16ComputeForce * core_num * kCoreFrequency;
+    default:
+      return kPeakFloat32ComputeForce * core_num * kCoreFrequency;
+  }
+}
+
+double getIoBandwidth(mluOpHandle_t handle) {
+  switch (handle->arch) {
+    case MLUOP_MLU220:
+      return kIoBandwidthMLU220;
+    case MLUOP_MLU270:
+      return kIoBandwidthMLU270;
+    case MLUOP_MLU290:
+      return kIoBandwidthMLU290;
+    case MLUOP_MLU370:
+      return kIoBandwidthMLU370;
+    default:
+      return -1;
+  }
+}
+
+double estimateLatency(mluOpHandle_t handle, const OpCost &cost) {
+  const double io_bandwidth = getIoBandwidth(handle);
+  if (io_bandwidth <= 0) {
+    return -1;
+  }
+  const int64_t cluster_num = getClusterLimitCapability(handle);
+  const int64_t core_num_per_cluster = handle->core_num_per_cluster;
+  const int64_t task_num =
+      (int64_t)cost.k_dim.x * cost.k_dim.y * cost.k_dim.z;
+  // tasks beyond the cores of the device run in waves at the same rate.
+  const int64_t core_num = cluster_num * core_num_per_cluster;
+  const int64_t used_cores =
+      std::max<int64_t>(1, std::min(task_num, core_num));
+  const int64_t used_clusters =
+      (used_cores + core_num_per_cluster - 1) / core_num_per_cluster;
+
+  const double core_ratio = (double)used_cores / core_num;
+  const double cluster_ratio =
+      std::min(1.0, (double)used_clusters / cluster_num);
+  const double compute_us =
+      cost.theory_ops /
+      (getPeakComputeForce(handle, cost.compute_dtype) * core_ratio) * 1e6;
+  // GB/s is bytes per ns, 1e3 bytes per us.
+  const double io_us =
+      cost.theory_io_bytes / (io_bandwidth * cluster_ratio * 1e3);
+  return std::max(compute_us, io_us) + cost.kernel_num * kKernelLaunchUs;
+}
+
+int64_t getTensorsBytes(const mluOpTensorDescriptor_t *descs, int desc_num) {
+  int64_t bytes = 0;
+  for (int i = 0; i < desc_num; ++i) {
+    if (descs[i] != NULL) {
+      bytes += descs[i]->total_tensor_size;
+    }
+  }
+  return bytes;
+}
+
+void setElementwiseCost(const mluOpTensorDescriptor_t *descs, int desc_num,
+                        int64_t element_num, int64_t ops_per_element,
+                        OpCost *cost) {
+  cost->theory_ops = element_num * ops_per_element;
+  cost->theory_io_bytes = getTensorsBytes(descs, desc_num);
+  cost->kernel_num = getChunkCount(element_num, LAUNCH_CHUNK_MAX_NUM);
+  cost->compute_dtype = descs[0]->dtype;
+}
+
+}  // namespace runtime
+}  // namespace mluop
+
+mluOpStatus_t MLUOP_WIN_API mluOpGetOpCostModel(
+    mluOpHandle_t handle, const char *op_name, int desc_num,
+    const mluOpTensorDescriptor_t descs[], mluOpOpCost_t *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", handle != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", op_name != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", desc_num >= 0);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs != NULL || desc_num == 0);
+  PARAM_CHECK("[mluOpGetOpCostModel]", cost != NULL);
+  mluop::runtime::OpCost op_cost;
+  CHECK_RETURN("[mluOpGetOpCostModel]",
+               mluop::runtime::getOpCost(handle, op_name, descs, desc_num,
+                                         &op_cost));
+  cost->theory_ops = op_cost.theory_ops;
+  cost->theory_io_bytes = op_cost.theory_io_bytes;
+  cost->k_dim = op_cost.k_dim;
+  cost->k_type = op_cost.k_type;
+  cost->kernel_num = op_cost.kernel_num;
+  cost->latency_us = mluop::runtime::estimateLatency(handle, op_cost);
+  return MLUOP_STATUS_SUCCESS;
+}
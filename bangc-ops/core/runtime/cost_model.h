@@ -0,0 +1,99 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef CORE_RUNTIME_COST_MODEL_H_
+#define CORE_RUNTIME_COST_MODEL_H_
+
+#include <cstdint>
+
+#include "mlu_op.h"
+
+namespace mluop {
+namespace runtime {
+
+// The estimate of one op call made by the cost function of the op, from
+// which the cost model derives the latency.
+struct OpCost {
+  int64_t theory_ops = 0;
+  int64_t theory_io_bytes = 0;
+  // the task dimension of the main kernel, the one doing most of the work.
+  cnrtDim3_t k_dim = {1, 1, 1};
+  cnrtFunctionType_t k_type = CNRT_FUNC_TYPE_BLOCK;
+  int kernel_num = 1;
+  // the dtype deciding the peak compute force.
+  mluOpDataType_t compute_dtype = MLUOP_DTYPE_FLOAT;
+};
+
+// `descs` are the `desc_num` tensor descriptors of the op API, in the order
+// of its parameters. Optional tensors may be NULL. The descriptors are not
+// validated by the cost model, a cost function checks what it reads.
+typedef mluOpStatus_t (*OpCostFunc)(mluOpHandle_t handle,
+                                    const mluOpTensorDescriptor_t *descs,
+                                    int desc_num, OpCost *cost);
+
+/******************************************************************************
+ * OpCostRegistrar
+ * Registers the cost function of an op under the name the op uses for gen
+ * case and the test harness, e.g. "abs" or "ball_query". Cost functions live
+ * next to the policy functions of their op, see MLUOP_REGISTER_OP_COST.
+ ******************************************************************************/
+class OpCostRegistrar {
+ public:
+  OpCostRegistrar(const char *op_name, int desc_num, OpCostFunc func);
+};
+
+#define MLUOP_REGISTER_OP_COST(op_name, desc_num, func)         \
+  static mluop::runtime::OpCostRegistrar __mluop_op_cost_##func( \
+      op_name, desc_num, func)
+
+/******************************************************************************
+ * mluOp FUNC: getOpCost
+ * Runs the cost function of `op_name`. Returns MLUOP_STATUS_NOT_SUPPORTED if
+ * the op has none, MLUOP_STATUS_BAD_PARAM if `desc_num` does not match it.
+ ******************************************************************************/
+mluOpStatus_t getOpCost(mluOpHandle_t handle, const char *op_name,
+                        const mluOpTensorDescriptor_t *descs, int desc_num,
+                        OpCost *cost);
+
+// The roofline of the device of `handle`. The peak compute force of the
+// computing units of all cores in op/s, and the DRAM bandwidth in GB/s.
+double getPeakComputeForce(mluOpHandle_t handle, mluOpDataType_t dtype);
+double getIoBandwidth(mluOpHandle_t handle);
+
+// The latency of `cost` in us: the slower of its compute and IO bound on the
+// cores its main kernel occupies, plus the launch overhead of its kernels.
+double estimateLatency(mluOpHandle_t handle, const OpCost &cost);
+
+// The bytes of all non NULL descriptors, what an op reads and writes at least.
+int64_t getTensorsBytes(const mluOpTensorDescriptor_t *descs, int desc_num);
+
+// Fills `cost` of an element-wise op doing `ops_per_element` ops on each of
+// `element_num` elements, launched by launchInChunks. The task dimension is
+// left to the policy function of the op.
+void setElementwiseCost(const mluOpTensorDescriptor_t *descs, int desc_num,
+                        int64_t element_num, int64_t ops_per_element,
+                        OpCost *cost);
+
+}  // namespace runtime
+}  // namespace mluop
+
+#endif  // CORE_RUNTIME_COST_MODEL_H_
@@ -0,0 +1,58 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "core/runtime/foreach_launch.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace mluop {
+namespace runtime {
+
+std::vector<ForeachLaunch> planForeachLaunches(
+    const std::vector<int64_t> &element_nums, int64_t max_launch_num,
+    int max_segment_num) {
+  std::vector<ForeachLaunch> launches;
+  ForeachLaunch launch;
+  for (int i = 0; i < (int)element_nums.size(); ++i) {
+    int64_t offset = 0;
+    while (offset < element_nums[i]) {
+      if (launch.num == max_launch_num ||
+          (int)launch.segments.size() == max_segment_num) {
+        launches.push_back(launch);
+        launch = ForeachLaunch();
+      }
+      const int64_t num =
+          std::min(element_nums[i] - offset, max_launch_num - launch.num);
+      launch.segments.push_back({i, offset, num});
+      launch.num += num;
+      offset += num;
+    }
+  }
+  if (launch.num > 0) {
+    launches.push_back(launch);
+  }
+  return launches;
+}
+
+}  // namespace runtime
+}  // namespace mluop
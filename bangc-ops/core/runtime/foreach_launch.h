@@ -0,0 +1,63 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef CORE_RUNTIME_FOREACH_LAUNCH_H_
+#define CORE_RUNTIME_FOREACH_LAUNCH_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace mluop {
+namespace runtime {
+
+/******************************************************************************
+ * Foreach launch planning
+ * A foreach op applies one element-wise op to a list of tensors. The tensors
+ * are seen as one concatenated run of elements, which is cut into launches of
+ * at most `max_launch_num` elements made of at most `max_segment_num`
+ * segments. A segment is a contiguous part of one tensor, so a tensor larger
+ * than what is left of a launch continues in the next one. The segments of a
+ * launch are passed to the kernel in a table, see mluOpForeachUnaryTable_t.
+ ******************************************************************************/
+struct ForeachSegment {
+  int tensor_index;
+  // the first element of the segment in its tensor.
+  int64_t offset;
+  int64_t num;
+};
+
+struct ForeachLaunch {
+  // the elements of all segments.
+  int64_t num = 0;
+  std::vector<ForeachSegment> segments;
+};
+
+// Packs the tensors of `element_nums` in order into the fewest launches.
+// Tensors of zero elements are skipped, no launch is planned for them.
+std::vector<ForeachLaunch> planForeachLaunches(
+    const std::vector<int64_t> &element_nums, int64_t max_launch_num,
+    int max_segment_num);
+
+}  // namespace runtime
+}  // namespace mluop
+
+#endif  // CORE_RUNTIME_FOREACH_LAUNCH_H_
@@ -0,0 +1,206 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "core/runtime/launch_plan_cache.h"
+
+#include <cstring>
+#include <string>
+
+#include "core/context.h"
+#include "core/logging.h"
+#include "core/tensor.h"
+
+namespace mluop {
+namespace runtime {
+
+constexpr size_t LaunchPlanKey::kMaxSize;
+
+LaunchPlanKey::LaunchPlanKey(const char *op_name) {
+  // the terminating null separates the name from the fields after it.
+  append(op_name, strlen(op_name) + 1);
+}
+
+LaunchPlanKey &LaunchPlanKey::add(const mluOpHandle_t handle) {
+  if (handle == NULL) {
+    valid_ = false;
+    return *this;
+  }
+  add(handle->arch);
+  add(handle->core_num_per_cluster);
+  add(handle->nram_size);
+  add(handle->capability_cluster_num);
+  add(handle->capability_job_limit);
+  add(handle->round_mode);
+  return *this;
+}
+
+LaunchPlanKey &LaunchPlanKey::add(const mluOpTensorDescriptor_t desc) {
+  if (desc == NULL) {
+    valid_ = false;
+    return *this;
+  }
+  add(desc->dtype);
+  add(desc->onchip_dtype);
+  add(desc->layout);
+  add(desc->dim);
+  add(desc->position);
+  add(desc->scale);
+  add(desc->offset);
+  if (MLUOP_PREDICT_FALSE(desc->dims_overflow_int32)) {
+    // the int views are clamped, only the 64-bit ones identify the shape.
+    add(desc->dims_overflow_int32);
+    append(desc->dims_int64, desc->dim * sizeof(int64_t));
+    append(desc->strides_int64, desc->dim * sizeof(int64_t));
+  } else {
+    append(desc->dims, desc->dim * sizeof(int));
+    append(desc->strides, desc->dim * sizeof(int));
+  }
+  return *this;
+}
+
+void LaunchPlanKey::append(const void *ptr, size_t n) {
+  if (!valid_ || size_ + n > kMaxSize) {
+    valid_ = false;
+    return;
+  }
+  memcpy(data_ + size_, ptr, n);
+  size_ += n;
+}
+
+uint64_t LaunchPlanKey::hash() const {
+  // keys are a few hundred bytes at most, mix them 8 bytes at a time.
+  const uint64_t kMul = 0x9e3779b97f4a7c15ULL;
+  uint64_t h = size_ * kMul;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size_; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data_ + i, sizeof(uint64_t));
+    h = ((h << 5) | (h >> 59)) ^ word;
+    h *= kMul;
+  }
+  if (i < size_) {
+    uint64_t word = 0;
+    memcpy(&word, data_ + i, size_ - i);
+    h = ((h << 5) | (h >> 59)) ^ word;
+    h *= kMul;
+  }
+  return h ^ (h >> 32);
+}
+
+bool LaunchPlanCache::lookup(const LaunchPlanKey &key, LaunchPlan *plan) {
+  if (!key.valid()) {
+    return false;
+  }
+  const uint64_t hash = key.hash();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(hash);
+  if (it == index_.end() || it->second->key.size() != key.size() ||
+      memcmp(it->second->key.data(), key.data(), key.size()) != 0) {
+    misses_++;
+    return false;
+  }
+  if (it->second != lru_.begin()) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+  }
+  *plan = it->second->plan;
+  hits_++;
+  return true;
+}
+
+void LaunchPlanCache::insert(const LaunchPlanKey &key,
+                             const LaunchPlan &plan) {
+  if (!key.valid()) {
+    return;
+  }
+  const uint64_t hash = key.hash();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (capacity_ == 0) {
+    return;
+  }
+  auto it = index_.find(hash);
+  if (it != index_.end()) {
+    // same key inserted again, or a hash collision, keep the latest one.
+    lru_.erase(it->second);
+    index_.erase(it);
+  }
+  lru_.push_front(Entry{hash, std::string(key.data(), key.size()), plan});
+  index_[hash] = lru_.begin();
+  evict();
+}
+
+void LaunchPlanCache::evict() {
+  while (lru_.size() > capacity_) {
+    index_.erase(lru_.back().hash);
+    lru_.pop_back();
+  }
+}
+
+void LaunchPlanCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  lru_.clear();
+  index_.clear();
+}
+
+void LaunchPlanCache::setCapacity(size_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = capacity;
+  evict();
+}
+
+size_t LaunchPlanCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lru_.size();
+}
+
+size_t LaunchPlanCache::capacity() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return capacity_;
+}
+
+uint64_t LaunchPlanCache::hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+uint64_t LaunchPlanCache::misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+bool lookupLaunchPlan(const mluOpHandle_t handle, const LaunchPlanKey &key,
+                      LaunchPlan *plan) {
+  if (handle == NULL || handle->launch_plan_cache == NULL) {
+    return false;
+  }
+  return handle->launch_plan_cache->lookup(key, plan);
+}
+
+void insertLaunchPlan(const mluOpHandle_t handle, const LaunchPlanKey &key,
+                      const LaunchPlan &plan) {
+  if (handle == NULL || handle->launch_plan_cache == NULL) {
+    return;
+  }
+  handle->launch_plan_cache->insert(key, plan);
+}
+
+}  // namespace runtime
+}  // namespace mluop
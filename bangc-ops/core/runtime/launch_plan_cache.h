@@ -0,0 +1,140 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef CORE_RUNTIME_LAUNCH_PLAN_CACHE_H_
+#define CORE_RUNTIME_LAUNCH_PLAN_CACHE_H_
+
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <mutex>  // NOLINT
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+#include "mlu_op.h"
+
+namespace mluop {
+namespace runtime {
+
+#define LAUNCH_PLAN_TILING_NUM (2 * MLUOP_DIM_MAX + 4)
+
+// The result of the host side work of an op call: parameter checks, policy
+// function and kernel selection. Ops cast `kernel` back to the type of the
+// kernel launch function they chose, and use `tiling` for op specific sizes.
+struct LaunchPlan {
+  cnrtDim3_t k_dim = {1, 1, 1};
+  cnrtFunctionType_t k_type = CNRT_FUNC_TYPE_BLOCK;
+  void (*kernel)() = nullptr;
+  int64_t tiling[LAUNCH_PLAN_TILING_NUM] = {0};
+};
+
+// Serializes everything a launch plan depends on: op name, device limits of
+// the handle, descriptors and scalar parameters. Keys are built on the stack
+// for every call, so nothing is allocated unless the plan is inserted.
+class LaunchPlanKey {
+ public:
+  explicit LaunchPlanKey(const char *op_name);
+
+  // cluster/job limits, core number, nram size and round mode of the handle.
+  LaunchPlanKey &add(const mluOpHandle_t handle);
+  // dtype, layout, quantization params, dims and strides of the descriptor.
+  LaunchPlanKey &add(const mluOpTensorDescriptor_t desc);
+  // arithmetic or enum scalar parameters.
+  template <typename T>
+  LaunchPlanKey &add(const T &value) {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                  "only scalars can be added to a launch plan key");
+    append(&value, sizeof(T));
+    return *this;
+  }
+
+  // a key which overflows the buffer is never cached.
+  bool valid() const { return valid_; }
+  uint64_t hash() const;
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  static constexpr size_t kMaxSize = 512;
+  void append(const void *ptr, size_t n);
+
+  char data_[kMaxSize];
+  size_t size_ = 0;
+  bool valid_ = true;
+};
+
+/******************************************************************************
+ * LaunchPlanCache
+ * A LRU cache of launch plans owned by mluOpHandle_t. An op looks up the key
+ * of a call before doing any host side work. On a hit, the descriptors were
+ * validated by an earlier call with identical content, so the op only checks
+ * its data pointers and launches the cached plan.
+ ******************************************************************************/
+class LaunchPlanCache {
+ public:
+  explicit LaunchPlanCache(size_t capacity) : capacity_(capacity) {}
+
+  bool lookup(const LaunchPlanKey &key, LaunchPlan *plan);
+  void insert(const LaunchPlanKey &key, const LaunchPlan &plan);
+  void clear();
+
+  void setCapacity(size_t capacity);
+
+  size_t size() const;
+  size_t capacity() const;
+  uint64_t hits() const;
+  uint64_t misses() const;
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    std::string key;
+    LaunchPlan plan;
+  };
+  void evict();
+
+  mutable std::mutex mutex_;
+  size_t capacity_;
+  std::list<Entry> lru_;  // the most recently used entry first
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+};
+
+#define LAUNCH_PLAN_CACHE_DEFAULT_CAPACITY 128
+
+/******************************************************************************
+ * mluOp FUNC: lookupLaunchPlan / insertLaunchPlan
+ * Shortcuts to the launch plan cache of a handle. lookupLaunchPlan returns
+ * false if the handle is NULL or its cache is disabled, and insertLaunchPlan
+ * does nothing in that case.
+ ******************************************************************************/
+bool lookupLaunchPlan(const mluOpHandle_t handle, const LaunchPlanKey &key,
+                      LaunchPlan *plan);
+void insertLaunchPlan(const mluOpHandle_t handle, const LaunchPlanKey &key,
+                      const LaunchPlan &plan);
+
+}  // namespace runtime
+}  // namespace mluop
+
+#endif  // CORE_RUNTIME_LAUNCH_PLAN_CACHE_H_
@@ -0,0 +1,299 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "core/runtime/op_profiler.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+
+#include "core/logging.h"
+#include "core/tool.h"
+
+namespace mluop {
+namespace runtime {
+
+std::atomic<bool> profiling_enabled(getBoolEnvVar("MLUOP_PROFILING_ENABLE",
+                                                  false));
+
+namespace {
+// Log-linear buckets as in HdrHistogram: values below 16 ns have a bucket
+// each, larger values have 16 buckets per power of 2, so a bucket is at most
+// 1/16 of its values wide. Values from 2^41 ns on share the last bucket.
+constexpr int kSubBits = 4;
+constexpr int kSubCount = 1 << kSubBits;
+constexpr int kMaxExp = 40;
+constexpr int kBucketNum = (kMaxExp - kSubBits + 2) * kSubCount;
+
+int bucketIndex(uint64_t value) {
+  if (value < kSubCount) {
+    return value;
+  }
+  int exp = 63 - __builtin_clzll(value);
+  if (exp > kMaxExp) {
+    return kBucketNum - 1;
+  }
+  int sub = (value >> (exp - kSubBits)) & (kSubCount - 1);
+  return (exp - kSubBits + 1) * kSubCount + sub;
+}
+
+// the middle of the values falling in bucket `index`.
+uint64_t bucketValue(int index) {
+  if (index < kSubCount) {
+    return index;
+  }
+  int exp = index / kSubCount + kSubBits - 1;
+  uint64_t sub = index % kSubCount;
+  uint64_t width = (uint64_t)1 << (exp - kSubBits);
+  return (kSubCount + sub) * width + width / 2;
+}
+
+uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct Histogram {
+  std::atomic<uint64_t> sum{0};
+  std::atomic<uint64_t> max{0};
+  std::atomic<uint64_t> counts[kBucketNum];
+
+  Histogram() { reset(); }
+
+  void record(uint64_t value) {
+    sum.fetch_add(value, std::memory_order_relaxed);
+    uint64_t old_max = max.load(std::memory_order_relaxed);
+    while (value > old_max &&
+           !max.compare_exchange_weak(old_max, value,
+                                      std::memory_order_relaxed)) {
+    }
+    counts[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // the value below which a `quantile` of the recorded values fall.
+  uint64_t percentile(double quantile) const {
+    uint64_t total = 0;
+    for (int i = 0; i < kBucketNum; ++i) {
+      total += counts[i].load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+      return 0;
+    }
+    uint64_t rank = std::max<uint64_t>((uint64_t)(quantile * total + 0.5), 1);
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketNum; ++i) {
+      seen += counts[i].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        return std::min(bucketValue(i), max.load(std::memory_order_relaxed));
+      }
+    }
+    return max.load(std::memory_order_relaxed);
+  }
+
+  void reset() {
+    sum.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < kBucketNum; ++i) {
+      counts[i].store(0, std::memory_order_relaxed);
+    }
+  }
+};
+
+thread_local OpProfileScope *current_scope = nullptr;
+}  // namespace
+
+struct OpProfileStats {
+  std::string op_name;
+  std::atomic<uint64_t> call_count{0};
+  std::atomic<uint64_t> bytes{0};
+  Histogram phases[MLUOP_PROFILING_PHASE_NUM];
+};
+
+namespace {
+// Stats are never freed, a reset only zeroes them, so the op names returned
+// by snapshots and the pointers cached by threads stay valid.
+struct ProfileRegistry {
+  std::mutex mutex;
+  std::map<std::string, std::unique_ptr<OpProfileStats>> stats;
+  mluOpProfilingCallback_t callback = nullptr;
+  void *user_data = nullptr;
+};
+
+ProfileRegistry &registry() {
+  static ProfileRegistry *instance = new ProfileRegistry();
+  return *instance;
+}
+
+OpProfileStats *findStats(const char *op_name) {
+  // op names are string literals, each thread maps them to the stats once.
+  thread_local std::unordered_map<const char *, OpProfileStats *> cache;
+  auto cached = cache.find(op_name);
+  if (cached != cache.end()) {
+    return cached->second;
+  }
+  ProfileRegistry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  std::unique_ptr<OpProfileStats> &stats = reg.stats[op_name];
+  if (stats == nullptr) {
+    stats.reset(new OpProfileStats());
+    stats->op_name = op_name;
+  }
+  cache[op_name] = stats.get();
+  return stats.get();
+}
+}  // namespace
+
+OpProfileScope *OpProfileScope::current() { return current_scope; }
+
+void OpProfileScope::begin(const char *op_name) {
+  stats_ = findStats(op_name);
+  op_name_ = stats_->op_name.c_str();
+  parent_ = current_scope;
+  current_scope = this;
+  start_ns_ = nowNs();
+  last_ns_ = start_ns_;
+}
+
+int OpProfileScope::switchPhase(int phase) {
+  uint64_t now = nowNs();
+  phase_ns_[phase_] += now - last_ns_;
+  last_ns_ = now;
+  int previous = phase_;
+  if (phase > MLUOP_PROFILING_PHASE_TOTAL &&
+      phase < MLUOP_PROFILING_PHASE_NUM) {
+    phase_ = phase;
+  }
+  return previous;
+}
+
+void OpProfileScope::end() {
+  switchPhase(phase_);
+  phase_ns_[MLUOP_PROFILING_PHASE_TOTAL] = last_ns_ - start_ns_;
+  current_scope = parent_;
+
+  stats_->call_count.fetch_add(1, std::memory_order_relaxed);
+  stats_->bytes.fetch_add(bytes_, std::memory_order_relaxed);
+  for (int i = 0; i < MLUOP_PROFILING_PHASE_NUM; ++i) {
+    stats_->phases[i].record(phase_ns_[i]);
+  }
+
+  ProfileRegistry &reg = registry();
+  mluOpProfilingCallback_t callback;
+  void *user_data;
+  {
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    callback = reg.callback;
+    user_data = reg.user_data;
+  }
+  if (callback != nullptr) {
+    mluOpProfilingRecord_t record;
+    record.op_name = op_name_;
+    record.bytes = bytes_;
+    for (int i = 0; i < MLUOP_PROFILING_PHASE_NUM; ++i) {
+      record.phase_ns[i] = phase_ns_[i];
+    }
+    callback(&record, user_data);
+  }
+}
+
+int switchProfilePhase(int phase) {
+  OpProfileScope *scope = current_scope;
+  if (scope == nullptr || phase < 0) {
+    return -1;
+  }
+  return scope->switchPhase(phase);
+}
+
+void addProfileBytes(uint64_t bytes) {
+  if (current_scope != nullptr) {
+    current_scope->addBytes(bytes);
+  }
+}
+
+}  // namespace runtime
+}  // namespace mluop
+
+mluOpStatus_t mluOpSetProfilingEnabled(bool enabled) {
+  mluop::runtime::profiling_enabled.store(enabled);
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t mluOpSetProfilingCallback(mluOpProfilingCallback_t callback,
+                                        void *user_data) {
+  auto &reg = mluop::runtime::registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.callback = callback;
+  reg.user_data = user_data;
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t mluOpGetProfilingSnapshot(mluOpProfilingOpStats_t *stats,
+                                        int stats_num, int *op_num) {
+  PARAM_CHECK("[mluOpGetProfilingSnapshot]", op_num != NULL);
+  PARAM_CHECK("[mluOpGetProfilingSnapshot]", stats_num >= 0);
+  PARAM_CHECK("[mluOpGetProfilingSnapshot]", stats != NULL || stats_num == 0);
+  auto &reg = mluop::runtime::registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  int count = 0;
+  for (const auto &entry : reg.stats) {
+    const mluop::runtime::OpProfileStats &op = *entry.second;
+    uint64_t call_count = op.call_count.load(std::memory_order_relaxed);
+    if (call_count == 0) {
+      continue;
+    }
+    if (count < stats_num) {
+      mluOpProfilingOpStats_t &out = stats[count];
+      out.op_name = op.op_name.c_str();
+      out.call_count = call_count;
+      out.bytes = op.bytes.load(std::memory_order_relaxed);
+      for (int i = 0; i < MLUOP_PROFILING_PHASE_NUM; ++i) {
+        const auto &hist = op.phases[i];
+        out.sum_ns[i] = hist.sum.load(std::memory_order_relaxed);
+        out.max_ns[i] = hist.max.load(std::memory_order_relaxed);
+        out.p50_ns[i] = hist.percentile(0.5);
+        out.p90_ns[i] = hist.percentile(0.9);
+        out.p99_ns[i] = hist.percentile(0.99);
+      }
+    }
+    ++count;
+  }
+  *op_num = count;
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t mluOpResetProfiling() {
+  auto &reg = mluop::runtime::registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  for (auto &entry : reg.stats) {
+    entry.second->call_count.store(0, std::memory_order_relaxed);
+    entry.second->bytes.store(0, std::memory_order_relaxed);
+    for (auto &hist : entry.second->phases) {
+      hist.reset();
+    }
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
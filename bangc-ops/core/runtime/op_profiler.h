@@ -0,0 +1,116 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef CORE_RUNTIME_OP_PROFILER_H_
+#define CORE_RUNTIME_OP_PROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "core/macros.h"
+#include "mlu_op.h"
+
+namespace mluop {
+namespace runtime {
+
+/******************************************************************************
+ * Op profiler
+ * Opt-in host side instrumentation of the op APIs, enabled with
+ * mluOpSetProfilingEnabled or MLUOP_PROFILING_ENABLE=ON. An op API opens an
+ * OpProfileScope at its entry, the host time of the call is split into the
+ * phases of mluOpProfilingPhase_t by MLUOP_PROFILE_PHASE marks, KERNEL_CHECK
+ * and GEN_CASE_END. Every call is added to the per op counters and latency
+ * histograms returned by mluOpGetProfilingSnapshot, and passed to the
+ * callback set by mluOpSetProfilingCallback.
+ * When profiling is disabled, every hook is a single load and branch.
+ ******************************************************************************/
+extern std::atomic<bool> profiling_enabled;
+
+inline bool profilingEnabled() {
+  return profiling_enabled.load(std::memory_order_relaxed);
+}
+
+struct OpProfileStats;
+
+class OpProfileScope {
+ public:
+  explicit OpProfileScope(const char *op_name) {
+    if (MLUOP_PREDICT_FALSE(profilingEnabled())) {
+      begin(op_name);
+    }
+  }
+  ~OpProfileScope() {
+    if (MLUOP_PREDICT_FALSE(stats_ != nullptr)) {
+      end();
+    }
+  }
+  OpProfileScope(const OpProfileScope &) = delete;
+  OpProfileScope &operator=(const OpProfileScope &) = delete;
+
+  // the innermost scope of the calling thread, nullptr if none is recording.
+  static OpProfileScope *current();
+
+  // attributes the time since the last switch to the current phase, and
+  // makes `phase` the current one. Returns the previous phase.
+  int switchPhase(int phase);
+  void addBytes(uint64_t bytes) { bytes_ += bytes; }
+
+ private:
+  void begin(const char *op_name);
+  void end();
+
+  OpProfileStats *stats_ = nullptr;
+  OpProfileScope *parent_ = nullptr;
+  const char *op_name_ = nullptr;
+  int phase_ = MLUOP_PROFILING_PHASE_PARAM_CHECK;
+  uint64_t start_ns_ = 0;
+  uint64_t last_ns_ = 0;
+  uint64_t bytes_ = 0;
+  uint64_t phase_ns_[MLUOP_PROFILING_PHASE_NUM] = {0};
+};
+
+// Switches the phase of the innermost scope, returns the previous phase or -1
+// when no scope is recording. A negative `phase` is ignored.
+int switchProfilePhase(int phase);
+void addProfileBytes(uint64_t bytes);
+
+}  // namespace runtime
+}  // namespace mluop
+
+// Opens the profiling scope of an op API, at most once per function.
+#define MLUOP_PROFILE_OP(op_name) \
+  mluop::runtime::OpProfileScope __mluop_profile_scope(op_name)
+
+// The host work after this mark belongs to `phase`, a mluOpProfilingPhase_t.
+#define MLUOP_PROFILE_PHASE(phase)                               \
+  (MLUOP_PREDICT_FALSE(mluop::runtime::profilingEnabled())       \
+       ? mluop::runtime::switchProfilePhase(phase)               \
+       : -1)
+
+// Adds the bytes of a tensor read or written by the op call.
+#define MLUOP_PROFILE_TENSOR(desc)                                   \
+  if (MLUOP_PREDICT_FALSE(mluop::runtime::profilingEnabled()) &&    \
+      (desc) != NULL) {                                              \
+    mluop::runtime::addProfileBytes((desc)->total_tensor_size);     \
+  }
+
+#endif  // CORE_RUNTIME_OP_PROFILER_H_
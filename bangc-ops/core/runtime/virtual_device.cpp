@@ -0,0 +1,282 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "core/runtime/virtual_device.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+
+#include "cn_api.h"
+#include "core/logging.h"
+#include "core/tool.h"
+#include "kernels/kernel.h"
+
+namespace mluop {
+namespace runtime {
+
+namespace {
+struct JobType {
+  const char *name;
+  KernelClass kernel_class;
+  int32_t cluster_num;  // clusters used by one task
+};
+
+// the order is the same as mluOpContext::job_num.
+const JobType job_types[VIRTUAL_DEVICE_JOB_TYPE_NUM] = {
+    {"BLOCK", CN_KERNEL_CLASS_BLOCK, 1},
+    {"UNION1", CN_KERNEL_CLASS_UNION, 1},
+    {"UNION2", CN_KERNEL_CLASS_UNION2, 2},
+    {"UNION4", CN_KERNEL_CLASS_UNION4, 4},
+    {"UNION8", CN_KERNEL_CLASS_UNION8, 8},
+    {"UNION16", CN_KERNEL_CLASS_UNION16, 16},
+};
+
+struct Preset {
+  const char *name;
+  int32_t cluster_num;
+  int32_t core_num_per_cluster;
+  int32_t nram_size;
+  int32_t wram_size;
+  int32_t sram_size;
+};
+
+// attributes of the full chip of each device, as reported by CNDrv.
+const Preset presets[] = {
+    {"MLU220", 1, 4, 512 * 1024, 512 * 1024, 2 * 1024 * 1024},
+    {"MLU270", 4, 4, 512 * 1024, 1024 * 1024, 2 * 1024 * 1024},
+    {"MLU290", 16, 4, 512 * 1024, 512 * 1024, 2 * 1024 * 1024},
+    {"MLU370", 8, 4, 768 * 1024, 1024 * 1024, 4 * 1024 * 1024},
+};
+
+std::string toUpper(std::string str) {
+  std::transform(str.begin(), str.end(), str.begin(), ::toupper);
+  return str;
+}
+
+std::string trim(const std::string &str) {
+  size_t begin = str.find_first_not_of(" \t\r\n");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  size_t end = str.find_last_not_of(" \t\r\n");
+  return str.substr(begin, end - begin + 1);
+}
+
+bool findPreset(const std::string &name, DeviceProfile *device_profile) {
+  for (const auto &preset : presets) {
+    if (toUpper(name) == preset.name) {
+      *device_profile = DeviceProfile();
+      device_profile->name = preset.name;
+      device_profile->cluster_num = preset.cluster_num;
+      device_profile->core_num_per_cluster = preset.core_num_per_cluster;
+      device_profile->nram_size = preset.nram_size;
+      device_profile->wram_size = preset.wram_size;
+      device_profile->sram_size = preset.sram_size;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool parseInt(const std::string &str, int32_t *value) {
+  char *end = nullptr;
+  int64_t result = strtoll(str.c_str(), &end, 10);
+  if (str.empty() || *end != '\0' || result < 0 || result > INT32_MAX) {
+    return false;
+  }
+  *value = (int32_t)result;
+  return true;
+}
+
+bool parseJobLimit(const std::string &str, int32_t *value) {
+  for (const auto &job_type : job_types) {
+    if (toUpper(str) == job_type.name) {
+      *value = job_type.kernel_class;
+      return true;
+    }
+  }
+  return parseInt(str, value);
+}
+
+// fills the limits which were not given with the values of a physical device
+// which is not restricted by cnSetCtxConfigParam.
+mluOpStatus_t completeProfile(const std::string &api,
+                              DeviceProfile *device_profile) {
+  PARAM_CHECK(api, !device_profile->name.empty());
+  PARAM_CHECK(api, device_profile->cluster_num > 0);
+  PARAM_CHECK(api, device_profile->core_num_per_cluster > 0);
+  PARAM_CHECK(api, device_profile->nram_size > REM_FOR_STACK);
+  if (device_profile->capability_cluster_num == 0) {
+    device_profile->capability_cluster_num = device_profile->cluster_num;
+  }
+  PARAM_CHECK_LE(api, device_profile->capability_cluster_num,
+                 device_profile->cluster_num);
+  if (device_profile->capability_job_limit == 0) {
+    for (const auto &job_type : job_types) {
+      if (job_type.cluster_num <= device_profile->capability_cluster_num) {
+        device_profile->capability_job_limit = job_type.kernel_class;
+      }
+    }
+  }
+  for (int i = 0; i < VIRTUAL_DEVICE_JOB_TYPE_NUM; ++i) {
+    if (device_profile->job_num[i] != 0) {
+      continue;
+    }
+    if (job_types[i].kernel_class == CN_KERNEL_CLASS_BLOCK) {
+      device_profile->job_num[i] = device_profile->capability_cluster_num *
+                                   device_profile->core_num_per_cluster;
+    } else {
+      device_profile->job_num[i] =
+          device_profile->capability_cluster_num / job_types[i].cluster_num;
+    }
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t loadProfileFile(const std::string &api, const std::string &path,
+                              DeviceProfile *device_profile) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    LOG(ERROR) << api << " " << path
+               << " is neither a device preset nor a readable profile file. "
+                  "The presets are MLU220, MLU270, MLU290 and MLU370.";
+    return MLUOP_STATUS_BAD_PARAM;
+  }
+  *device_profile = DeviceProfile();
+  std::string line;
+  int line_num = 0;
+  while (std::getline(file, line)) {
+    line_num++;
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty()) {
+      continue;
+    }
+    size_t pos = line.find('=');
+    std::string key = trim(line.substr(0, pos));
+    std::string value =
+        pos == std::string::npos ? "" : trim(line.substr(pos + 1));
+    bool parsed = !value.empty();
+    if (!parsed) {
+      // leave it to the error below.
+    } else if (key == "preset") {
+      parsed = findPreset(value, device_profile);
+    } else if (key == "name") {
+      device_profile->name = value;
+    } else if (key == "cluster_num") {
+      parsed = parseInt(value, &device_profile->cluster_num);
+    } else if (key == "core_num_per_cluster") {
+      parsed = parseInt(value, &device_profile->core_num_per_cluster);
+    } else if (key == "nram_size") {
+      parsed = parseInt(value, &device_profile->nram_size);
+    } else if (key == "wram_size") {
+      parsed = parseInt(value, &device_profile->wram_size);
+    } else if (key == "sram_size") {
+      parsed = parseInt(value, &device_profile->sram_size);
+    } else if (key == "capability_cluster_num") {
+      parsed = parseInt(value, &device_profile->capability_cluster_num);
+    } else if (key == "capability_job_limit") {
+      parsed = parseJobLimit(value, &device_profile->capability_job_limit);
+    } else {
+      parsed = false;
+      for (int i = 0; i < VIRTUAL_DEVICE_JOB_TYPE_NUM; ++i) {
+        if (toUpper(key) == "JOB_NUM_" + std::string(job_types[i].name)) {
+          parsed = parseInt(value, &device_profile->job_num[i]);
+        }
+      }
+    }
+    if (!parsed) {
+      LOG(ERROR) << api << " " << path << ":" << line_num
+                 << " cannot be parsed: " << line;
+      return MLUOP_STATUS_BAD_PARAM;
+    }
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
+std::mutex virtual_device_mutex;
+bool virtual_device_inited = false;
+std::unique_ptr<DeviceProfile> virtual_device;
+}  // namespace
+
+mluOpStatus_t loadDeviceProfile(const std::string &profile,
+                                DeviceProfile *device_profile) {
+  const std::string api = "[mluOpVirtualDevice]";
+  PARAM_CHECK(api, device_profile != NULL);
+  PARAM_CHECK(api, !profile.empty());
+  if (!findPreset(profile, device_profile)) {
+    CHECK_RETURN(api, loadProfileFile(api, profile, device_profile));
+  }
+  CHECK_RETURN(api, completeProfile(api, device_profile));
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t setVirtualDevice(const std::string &profile) {
+  std::unique_ptr<DeviceProfile> device_profile;
+  if (!profile.empty()) {
+    device_profile.reset(new DeviceProfile);
+    CHECK_RETURN("[mluOpVirtualDevice]",
+                 loadDeviceProfile(profile, device_profile.get()));
+    VLOG(5) << "[mluOpVirtualDevice] Use virtual device "
+            << device_profile->name << " loaded from " << profile << ".";
+  }
+  std::lock_guard<std::mutex> lock(virtual_device_mutex);
+  virtual_device = std::move(device_profile);
+  virtual_device_inited = true;
+  return MLUOP_STATUS_SUCCESS;
+}
+
+bool getVirtualDevice(DeviceProfile *device_profile) {
+  std::unique_lock<std::mutex> lock(virtual_device_mutex);
+  if (!virtual_device_inited) {
+    lock.unlock();
+    std::string profile = getStringEnvVar("MLUOP_VIRTUAL_DEVICE", "");
+    std::unique_ptr<DeviceProfile> env_profile;
+    if (!profile.empty()) {
+      env_profile.reset(new DeviceProfile);
+      if (MLUOP_STATUS_SUCCESS !=
+          loadDeviceProfile(profile, env_profile.get())) {
+        LOG(ERROR) << "[mluOpVirtualDevice] MLUOP_VIRTUAL_DEVICE=" << profile
+                   << " is ignored.";
+        env_profile.reset();
+      }
+    }
+    lock.lock();
+    // setVirtualDevice may have been called in the meantime.
+    if (!virtual_device_inited) {
+      virtual_device = std::move(env_profile);
+      virtual_device_inited = true;
+    }
+  }
+  if (virtual_device == nullptr) {
+    return false;
+  }
+  *device_profile = *virtual_device;
+  return true;
+}
+
+}  // namespace runtime
+}  // namespace mluop
@@ -0,0 +1,90 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef CORE_RUNTIME_VIRTUAL_DEVICE_H_
+#define CORE_RUNTIME_VIRTUAL_DEVICE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "mlu_op.h"
+
+namespace mluop {
+namespace runtime {
+
+#define VIRTUAL_DEVICE_JOB_TYPE_NUM 6
+
+// Device attributes which mluOpCreate queries from CNDrv. The sizes are the
+// raw values of cnDeviceGetAttribute, the stack reservation is subtracted by
+// mluOpCreate as for a physical device.
+struct DeviceProfile {
+  std::string name;  // device name, e.g. "MLU370"
+  int32_t cluster_num = 0;
+  int32_t core_num_per_cluster = 0;
+  int32_t nram_size = 0;
+  int32_t wram_size = 0;
+  int32_t sram_size = 0;
+  int32_t capability_cluster_num = 0;
+  int32_t capability_job_limit = 0;
+  // max parallel tasks of BLOCK, UNION1, UNION2, UNION4, UNION8 and UNION16
+  int32_t job_num[VIRTUAL_DEVICE_JOB_TYPE_NUM] = {0};
+};
+
+/******************************************************************************
+ * mluOp FUNC: loadDeviceProfile
+ * Loads a device profile. `profile` is either the name of a preset (MLU220,
+ * MLU270, MLU290 or MLU370, case insensitive) or the path of a profile file.
+ * A profile file has one "key = value" per line, '#' starts a comment:
+ *
+ *   preset = MLU370          # optional, start from a preset
+ *   name = MLU370
+ *   cluster_num = 8
+ *   core_num_per_cluster = 4
+ *   nram_size = 786432       # bytes per core
+ *   wram_size = 1048576      # bytes per core
+ *   sram_size = 4194304      # bytes per cluster
+ *   capability_cluster_num = 8
+ *   capability_job_limit = UNION8
+ *   job_num_union1 = 8       # also job_num_block/union2/union4/union8/union16
+ *
+ * capability_cluster_num defaults to cluster_num, capability_job_limit to the
+ * largest union which fits into the device, and job_num_* to the number of
+ * such tasks which can run at the same time.
+ ******************************************************************************/
+mluOpStatus_t loadDeviceProfile(const std::string &profile,
+                                DeviceProfile *device_profile);
+
+/******************************************************************************
+ * mluOp FUNC: setVirtualDevice / getVirtualDevice
+ * The virtual device used by mluOpCreate instead of the current MLU device.
+ * It is read from the environment variable MLUOP_VIRTUAL_DEVICE the first
+ * time it is needed, and can be replaced by setVirtualDevice. An empty
+ * `profile` disables the virtual device. getVirtualDevice returns false if no
+ * virtual device is set.
+ ******************************************************************************/
+mluOpStatus_t setVirtualDevice(const std::string &profile);
+bool getVirtualDevice(DeviceProfile *device_profile);
+
+}  // namespace runtime
+}  // namespace mluop
+
+#endif  // CORE_RUNTIME_VIRTUAL_DEVICE_H_
@@ -0,0 +1,206 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "core/runtime/workspace_arena.h"
+
+#include <algorithm>
+#include <string>
+
+#include "core/context.h"
+#include "core/logging.h"
+#include "kernels/kernel.h"
+
+namespace mluop {
+namespace runtime {
+
+class CnrtDeviceAllocator : public DeviceAllocator {
+ public:
+  CnrtDeviceAllocator() {}
+
+  mluOpStatus_t allocate(size_t size, void **ptr) override {
+    if (cnrtSuccess != cnrtMalloc(ptr, size)) {
+      LOG(ERROR) << "[WorkspaceArena] cnrtMalloc failed, size is " << size
+                 << " bytes.";
+      *ptr = nullptr;
+      return MLUOP_STATUS_ALLOC_FAILED;
+    }
+    return MLUOP_STATUS_SUCCESS;
+  }
+
+  mluOpStatus_t deallocate(void *ptr) override {
+    if (cnrtSuccess != cnrtFree(ptr)) {
+      LOG(ERROR) << "[WorkspaceArena] cnrtFree failed.";
+      return MLUOP_STATUS_INTERNAL_ERROR;
+    }
+    return MLUOP_STATUS_SUCCESS;
+  }
+
+  mluOpStatus_t synchronize(cnrtQueue_t queue) override {
+    if (queue != nullptr && cnrtSuccess != cnrtQueueSync(queue)) {
+      LOG(ERROR) << "[WorkspaceArena] cnrtQueueSync failed.";
+      return MLUOP_STATUS_EXECUTION_FAILED;
+    }
+    return MLUOP_STATUS_SUCCESS;
+  }
+};
+
+DeviceAllocator *DeviceAllocator::Default() {
+  static DeviceAllocator *default_allocator = new CnrtDeviceAllocator;
+  return default_allocator;
+}
+
+WorkspaceArena::WorkspaceArena(DeviceAllocator *allocator,
+                               size_t capacity_limit)
+    : allocator_(allocator), capacity_limit_(capacity_limit) {}
+
+WorkspaceArena::~WorkspaceArena() {
+  // release() should have been called with the queue of the owner handle,
+  // here is only a fallback to avoid leaking device memory.
+  for (auto &block : retired_) {
+    allocator_->deallocate(block.ptr);
+  }
+  if (current_.ptr != nullptr) {
+    allocator_->deallocate(current_.ptr);
+  }
+}
+
+mluOpStatus_t WorkspaceArena::freeRetiredBlocks(cnrtQueue_t queue) {
+  if (retired_.empty()) {
+    return MLUOP_STATUS_SUCCESS;
+  }
+  const std::string api = "[WorkspaceArena]";
+  // kernels enqueued before may still access the retired blocks.
+  CHECK_RETURN(api, allocator_->synchronize(queue));
+  for (auto &block : retired_) {
+    CHECK_RETURN(api, allocator_->deallocate(block.ptr));
+  }
+  retired_.clear();
+  retired_bytes_ = 0;
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t WorkspaceArena::grow(size_t size, cnrtQueue_t queue) {
+  const std::string api = "[WorkspaceArena]";
+  if (current_.ptr != nullptr) {
+    retired_.push_back(current_);
+    retired_bytes_ += current_.size;
+    current_ = Block();
+    offset_ = 0;
+  }
+  if (used_ == 0) {
+    // nothing handed out since the last reset is alive.
+    CHECK_RETURN(api, freeRetiredBlocks(queue));
+  }
+  if (retired_bytes_ + size > capacity_limit_) {
+    LOG(ERROR) << api << " Overflow the reserved memory size "
+               << capacity_limit_ << " bytes, " << retired_bytes_
+               << " bytes are held and " << size
+               << " bytes are requested. Please enlarge MLUOP_MEM_POOL_SIZE.";
+    return MLUOP_STATUS_ALLOC_FAILED;
+  }
+  void *ptr = nullptr;
+  CHECK_RETURN(api, allocator_->allocate(size, &ptr));
+  current_.ptr = ptr;
+  current_.size = size;
+  VLOG(5) << api << " Reserve a new block of " << size << " bytes.";
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t WorkspaceArena::reserve(size_t size, cnrtQueue_t queue) {
+  size = CEIL_ALIGN(size, WORKSPACE_ARENA_ALIGN_SIZE);
+  if (size <= current_.size - offset_) {
+    return MLUOP_STATUS_SUCCESS;
+  }
+  return grow(size, queue);
+}
+
+mluOpStatus_t WorkspaceArena::allocate(size_t size, void **ptr,
+                                       cnrtQueue_t queue) {
+  *ptr = nullptr;
+  if (size == 0) {
+    return MLUOP_STATUS_SUCCESS;
+  }
+  size_t aligned_size = CEIL_ALIGN(size, WORKSPACE_ARENA_ALIGN_SIZE);
+  if (offset_ + aligned_size > current_.size) {
+    // double the block to amortize growth, fall back to the exact size if
+    // the doubled block does not fit into the reserved memory.
+    size_t new_size = std::max(aligned_size, current_.size * 2);
+    if (retired_bytes_ + current_.size + new_size > capacity_limit_) {
+      new_size = aligned_size;
+    }
+    CHECK_RETURN("[WorkspaceArena]", grow(new_size, queue));
+  }
+  *ptr = (void *)((char *)current_.ptr + offset_);
+  offset_ += aligned_size;
+  used_ += aligned_size;
+  high_water_mark_ = std::max(high_water_mark_, used_);
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t WorkspaceArena::reset(cnrtQueue_t queue) {
+  const std::string api = "[WorkspaceArena]";
+  offset_ = 0;
+  used_ = 0;
+  if (retired_.empty()) {
+    return MLUOP_STATUS_SUCCESS;
+  }
+  // the arena was split into several blocks, merge them into one block that
+  // is large enough for the high-water mark.
+  CHECK_RETURN(api, freeRetiredBlocks(queue));
+  if (current_.size < high_water_mark_) {
+    CHECK_RETURN(api, grow(high_water_mark_, queue));
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t WorkspaceArena::release(cnrtQueue_t queue) {
+  const std::string api = "[WorkspaceArena]";
+  if (current_.ptr != nullptr) {
+    retired_.push_back(current_);
+    retired_bytes_ += current_.size;
+    current_ = Block();
+  }
+  CHECK_RETURN(api, freeRetiredBlocks(queue));
+  offset_ = 0;
+  used_ = 0;
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t getWorkspaceFromArena(mluOpHandle_t handle,
+                                    const std::string &api,
+                                    size_t required_size, void **workspace,
+                                    size_t *workspace_size) {
+  if (*workspace != nullptr || handle->workspace_arena == nullptr ||
+      required_size == 0) {
+    return MLUOP_STATUS_SUCCESS;
+  }
+  WorkspaceArena *arena = handle->workspace_arena;
+  CHECK_RETURN(api, arena->reset(handle->queue));
+  CHECK_RETURN(api, arena->allocate(required_size, workspace, handle->queue));
+  *workspace_size = required_size;
+  VLOG(5) << api << " Use " << required_size
+          << " bytes workspace from the handle arena.";
+  return MLUOP_STATUS_SUCCESS;
+}
+
+}  // namespace runtime
+}  // namespace mluop
@@ -0,0 +1,128 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef CORE_RUNTIME_WORKSPACE_ARENA_H_
+#define CORE_RUNTIME_WORKSPACE_ARENA_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "mlu_op.h"
+
+namespace mluop {
+namespace runtime {
+
+// An interface used by WorkspaceArena to obtain and release device memory.
+// The arena only does host-side bookkeeping, so the allocator can be replaced
+// by a fake one to test bump/reset/growth behaviour without an MLU device.
+class DeviceAllocator {
+ public:
+  DeviceAllocator() {}
+  virtual ~DeviceAllocator() = default;
+
+  // Returns an allocator backed by cnrtMalloc/cnrtFree on the current device.
+  // The result of Default() belongs to this library and must never be deleted.
+  static DeviceAllocator *Default();
+
+  virtual mluOpStatus_t allocate(size_t size, void **ptr) = 0;
+  virtual mluOpStatus_t deallocate(void *ptr) = 0;
+
+  // Waits until every kernel already enqueued on `queue` has finished, so that
+  // memory they may still access can be released.
+  virtual mluOpStatus_t synchronize(cnrtQueue_t queue) = 0;
+};
+
+/******************************************************************************
+ * WorkspaceArena
+ * A growable device memory region owned by mluOpHandle_t. Workspaces are
+ * sub-allocated from the region by bumping an offset, and the whole region is
+ * rewound by reset(). All kernels of a handle are launched on handle->queue,
+ * so a workspace handed out for one call can be reused by the next call
+ * without synchronization.
+ *
+ * When a request does not fit, a new block is allocated and the old one is
+ * retired. Retired blocks are freed on the next reset() after synchronizing
+ * the queue, and the arena is then re-reserved as one block as large as the
+ * high-water mark, so steady-state workloads allocate device memory once.
+ ******************************************************************************/
+class WorkspaceArena {
+ public:
+  // `capacity_limit` bounds the total device memory held by the arena,
+  // it is usually the value returned by mluOpGetReservedMemSize.
+  WorkspaceArena(DeviceAllocator *allocator, size_t capacity_limit);
+  ~WorkspaceArena();
+
+  // Makes sure at least `size` bytes can be allocated after the next reset.
+  mluOpStatus_t reserve(size_t size, cnrtQueue_t queue);
+
+  // Bump-allocates `size` bytes aligned to WORKSPACE_ARENA_ALIGN_SIZE.
+  mluOpStatus_t allocate(size_t size, void **ptr, cnrtQueue_t queue);
+
+  // Rewinds the bump offset. Memory handed out before is invalid afterwards.
+  mluOpStatus_t reset(cnrtQueue_t queue);
+
+  // Releases all device memory held by the arena.
+  mluOpStatus_t release(cnrtQueue_t queue);
+
+  size_t used() const { return used_; }
+  size_t capacity() const { return current_.size; }
+  size_t highWaterMark() const { return high_water_mark_; }
+  size_t capacityLimit() const { return capacity_limit_; }
+
+ private:
+  struct Block {
+    void *ptr = nullptr;
+    size_t size = 0;
+  };
+  mluOpStatus_t grow(size_t size, cnrtQueue_t queue);
+  mluOpStatus_t freeRetiredBlocks(cnrtQueue_t queue);
+
+  DeviceAllocator *allocator_;
+  size_t capacity_limit_;
+  Block current_;
+  std::vector<Block> retired_;
+  size_t retired_bytes_ = 0;
+  size_t offset_ = 0;           // bump offset inside current_
+  size_t used_ = 0;             // bytes handed out since the last reset
+  size_t high_water_mark_ = 0;  // the max of used_ ever observed
+};
+
+#define WORKSPACE_ARENA_ALIGN_SIZE 128
+
+/******************************************************************************
+ * mluOp FUNC: getWorkspaceFromArena
+ * Resolves the workspace of an op call. If the caller passed a null workspace
+ * and the handle owns an arena, `required_size` bytes are drawn from the arena
+ * and `workspace`/`workspace_size` are updated. Otherwise both are left as
+ * they are, so the usual workspace checks of the op still apply.
+ * The workspace stays valid until the next op call on the same handle.
+ ******************************************************************************/
+mluOpStatus_t getWorkspaceFromArena(mluOpHandle_t handle,
+                                    const std::string &api,
+                                    size_t required_size, void **workspace,
+                                    size_t *workspace_size);
+
+}  // namespace runtime
+}  // namespace mluop
+
+#endif  // CORE_RUNTIME_WORKSPACE_ARENA_H_
@@ -0,0 +1,100 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "core/stride_coalesce.h"
+
+#include <utility>
+
+namespace mluop {
+
+int coalesceDims(int dim, int64_t *dims, int64_t *const *strides,
+                 int operand_num) {
+  for (int i = 0; i < dim; ++i) {
+    if (dims[i] == 0) {
+      dims[0] = 0;
+      for (int k = 0; k < operand_num; ++k) {
+        strides[k][0] = 0;
+      }
+      return 1;
+    }
+  }
+  // `out` is the number of dims kept, dims are visited from the lowest one
+  // and compacted towards the end of the arrays, then moved to the front.
+  int out = 0;
+  for (int i = dim - 1; i >= 0; --i) {
+    if (dims[i] == 1) {
+      continue;
+    }
+    const int last = dim - out;  // the highest dim kept so far
+    bool mergeable = out > 0;
+    for (int k = 0; k < operand_num && mergeable; ++k) {
+      mergeable = strides[k][i] == strides[k][last] * dims[last];
+    }
+    if (mergeable) {
+      dims[last] *= dims[i];
+      continue;
+    }
+    ++out;
+    dims[dim - out] = dims[i];
+    for (int k = 0; k < operand_num; ++k) {
+      strides[k][dim - out] = strides[k][i];
+    }
+  }
+  for (int i = 0; i < out; ++i) {
+    dims[i] = dims[dim - out + i];
+    for (int k = 0; k < operand_num; ++k) {
+      strides[k][i] = strides[k][dim - out + i];
+    }
+  }
+  return out;
+}
+
+void sortDimsByStride(int dim, int64_t *dims, int64_t *const *strides,
+                      int operand_num) {
+  // whether dim a should be visited before dim b.
+  auto outer = [&](int a, int b) {
+    for (int k = 0; k < operand_num; ++k) {
+      if (strides[k][a] != strides[k][b]) {
+        return strides[k][a] > strides[k][b];
+      }
+    }
+    return false;
+  };
+  // insertion sort, stable and the fastest for so few dims.
+  for (int i = 1; i < dim; ++i) {
+    for (int j = i; j > 0 && outer(j, j - 1); --j) {
+      std::swap(dims[j], dims[j - 1]);
+      for (int k = 0; k < operand_num; ++k) {
+        std::swap(strides[k][j], strides[k][j - 1]);
+      }
+    }
+  }
+}
+
+int canonicalizeDims(int dim, int64_t *dims, int64_t *const *strides,
+                     int operand_num) {
+  dim = coalesceDims(dim, dims, strides, operand_num);
+  sortDimsByStride(dim, dims, strides, operand_num);
+  return coalesceDims(dim, dims, strides, operand_num);
+}
+
+}  // namespace mluop
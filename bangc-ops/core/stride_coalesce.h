@@ -0,0 +1,66 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef CORE_STRIDE_COALESCE_H_
+#define CORE_STRIDE_COALESCE_H_
+
+#include <cstdint>
+
+namespace mluop {
+
+/******************************************************************************
+ * Stride coalescing
+ * Host side canonicalisation of a shape shared by `operand_num` operands, each
+ * with its own strides, e.g. the input and the output of a strided copy.
+ * `dims` has `dim` values, `strides[k]` has the `dim` strides of operand k.
+ * All arrays are updated in place, only the first `returned dim` values are
+ * meaningful afterwards.
+ ******************************************************************************/
+
+// Drops dims of size 1 and merges dim i with dim i + 1 when
+// strides[k][i] == strides[k][i + 1] * dims[i + 1] for every operand. The
+// order in which elements are visited is kept, so operands may be coalesced
+// one by one when they only share the element number, not the shape.
+// Returns the number of dims left, 0 when all dims are of size 1. A shape with
+// a dim of size 0 is coalesced to the single dim 0 with stride 0.
+int coalesceDims(int dim, int64_t *dims, int64_t *const *strides,
+                 int operand_num);
+
+inline int coalesceDims(int dim, int64_t *dims, int64_t *strides) {
+  return coalesceDims(dim, dims, &strides, 1);
+}
+
+// Stable sort of the dims from the largest stride of operand 0 to the
+// smallest, ties are ordered by the strides of the next operands. Permuting
+// the dims of every operand the same way keeps the element mapping between
+// the operands, so it is only valid for operands of the same shape.
+void sortDimsByStride(int dim, int64_t *dims, int64_t *const *strides,
+                      int operand_num);
+
+// coalesceDims, then sortDimsByStride and coalesceDims again, the smallest
+// rank a same shaped multi operand access can be described with.
+int canonicalizeDims(int dim, int64_t *dims, int64_t *const *strides,
+                     int operand_num);
+
+}  // namespace mluop
+
+#endif  // CORE_STRIDE_COALESCE_H_
@@ -22,6 +22,7 @@
  *************************************************************************/
 #include <iomanip>
 #include <algorithm>
+#include <cstdint>
 #include "core/tensor.h"
 #include "core/logging.h"
 #include "core/type.h"
@@ -153,10 +154,138 @@ mluOpStatus_t mluOpGetSizeOfDataType(mluOpDataType_t data_type, size_t *size) {
   }
 }
 
+/* mluOpTensorDescriptorQueueStruct */
+#if MLUOP_TENSOR_QUEUE_ENABLE
+constexpr uint32_t mluOpTensorDescriptorQueueStruct::kSlabSize;
+constexpr uint32_t mluOpTensorDescriptorQueueStruct::kMaxSlabNum;
+constexpr int mluOpTensorDescriptorQueueStruct::kBatchSize;
+constexpr int mluOpTensorDescriptorQueueStruct::kCacheCapacity;
+
+mluOpTensorDescriptorQueueStruct *mluOpTensorDescriptorQueueStruct::instance() {
+  static mluOpTensorDescriptorQueueStruct *queue =
+      new mluOpTensorDescriptorQueueStruct();
+  return queue;
+}
+
+mluOpTensorDescriptorQueueStruct::ThreadCache &
+mluOpTensorDescriptorQueueStruct::threadCache() {
+  static thread_local ThreadCache cache;
+  return cache;
+}
+
+mluOpTensorDescriptorQueueStruct::ThreadCache::~ThreadCache() {
+  if (num > 0) {
+    instance()->push(slots, num);
+    num = 0;
+  }
+}
+
+mluOpTensorDescriptorQueueStruct::Slot *
+mluOpTensorDescriptorQueueStruct::pop() {
+  uint64_t old_head = head.load(std::memory_order_acquire);
+  while (true) {
+    uint32_t index = static_cast<uint32_t>(old_head);
+    if (index == 0) {
+      return NULL;
+    }
+    Slot *top = slot(index);
+    // may read a stale value if top is popped by another thread meanwhile,
+    // then the tag has changed and the CAS below fails.
+    uint64_t next = top->next.load(std::memory_order_relaxed);
+    uint64_t new_head = (((old_head >> 32) + 1) << 32) | next;
+    if (head.compare_exchange_weak(old_head, new_head,
+                                   std::memory_order_acq_rel,
+                                   std::memory_order_acquire)) {
+      return top;
+    }
+  }
+}
+
+void mluOpTensorDescriptorQueueStruct::push(Slot *const *slots, int n) {
+  for (int i = 0; i < n - 1; ++i) {
+    slots[i]->next.store(slots[i + 1]->index, std::memory_order_relaxed);
+  }
+  uint64_t old_head = head.load(std::memory_order_relaxed);
+  uint64_t new_head = 0;
+  do {
+    slots[n - 1]->next.store(static_cast<uint32_t>(old_head),
+                             std::memory_order_relaxed);
+    new_head = (((old_head >> 32) + 1) << 32) | slots[0]->index;
+  } while (!head.compare_exchange_weak(old_head, new_head,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed));
+}
+
+bool mluOpTensorDescriptorQueueStruct::refill(ThreadCache *cache) {
+  while (cache->num < kBatchSize) {
+    Slot *free_slot = pop();
+    if (free_slot == NULL) {
+      break;
+    }
+    cache->slots[cache->num++] = free_slot;
+  }
+  if (cache->num > 0) {
+    return true;
+  }
+
+  // the global freelist is empty, carve a new slab.
+  uint32_t slab_id = slab_num.fetch_add(1, std::memory_order_relaxed);
+  if (slab_id >= kMaxSlabNum) {
+    slab_num.fetch_sub(1, std::memory_order_relaxed);
+    LOG(ERROR) << "[mluOpCreateTensorDescriptor] Too many tensor descriptors "
+               << "are alive, the limit is " << kSlabSize * kMaxSlabNum << ".";
+    return false;
+  }
+  Slab *slab = new (std::nothrow) Slab();
+  if (slab == NULL) {
+    slab_num.fetch_sub(1, std::memory_order_relaxed);
+    return false;
+  }
+  Slot *new_slots[kSlabSize];
+  for (uint32_t i = 0; i < kSlabSize; ++i) {
+    slab->slots[i].index = slab_id * kSlabSize + i + 1;
+    new_slots[i] = &(slab->slots[i]);
+  }
+  slabs[slab_id].store(slab, std::memory_order_release);
+  for (int i = 0; i < kBatchSize; ++i) {
+    cache->slots[cache->num++] = new_slots[i];
+  }
+  push(new_slots + kBatchSize, kSlabSize - kBatchSize);
+  return true;
+}
+
+mluOpTensorDescriptor_t mluOpTensorDescriptorQueueStruct::get() {
+  ThreadCache &cache = threadCache();
+  if (MLUOP_PREDICT_FALSE(cache.num == 0) && !refill(&cache)) {
+    return NULL;
+  }
+  Slot *free_slot = cache.slots[--cache.num];
+  return new (&(free_slot->storage)) mluOpTensorStruct();
+}
+
+void mluOpTensorDescriptorQueueStruct::put(mluOpTensorDescriptor_t desc) {
+  desc->reset();
+  desc->~mluOpTensorStruct();
+  ThreadCache &cache = threadCache();
+  if (MLUOP_PREDICT_FALSE(cache.num == kCacheCapacity)) {
+    // give the older half back, keep the recently used ones hot.
+    push(cache.slots, kBatchSize);
+    std::memmove(cache.slots, cache.slots + kBatchSize,
+                 (kCacheCapacity - kBatchSize) * sizeof(Slot *));
+    cache.num -= kBatchSize;
+  }
+  cache.slots[cache.num++] = reinterpret_cast<Slot *>(desc);
+}
+#endif
+
 /* MLUOP interface */
 mluOpStatus_t mluOpCreateTensorDescriptor(mluOpTensorDescriptor_t *desc) {
   PARAM_CHECK("[mluOpCreateTensorDescriptor]", desc != NULL);
+#if MLUOP_TENSOR_QUEUE_ENABLE
+  mluOpTensorStruct *ts = mluOpTensorDescriptorQueueStruct::instance()->get();
+#else
   mluOpTensorStruct *ts = new (std::nothrow) mluOpTensorStruct();
+#endif
   *desc = ts;
   return MLUOP_STATUS_SUCCESS;
 }
@@ -165,13 +294,175 @@ mluOpStatus_t mluOpCreateGroupTensorDescriptors(
     mluOpTensorDescriptor_t *group_desc[], const int desc_num) {
   PARAM_CHECK("[mluOpCreateGroupTensorDescriptors]", group_desc != NULL);
   PARAM_CHECK("[mluOpCreateGroupTensorDescriptors]", desc_num > 0);
+#if MLUOP_TENSOR_QUEUE_ENABLE
+  auto queue = mluOpTensorDescriptorQueueStruct::instance();
+#endif
   for (int i = 0; i < desc_num; ++i) {
+#if MLUOP_TENSOR_QUEUE_ENABLE
+    mluOpTensorStruct *ts = queue->get();
+#else
     mluOpTensorStruct *ts = new (std::nothrow) mluOpTensorStruct();
+#endif
     *(group_desc[i]) = ts;
   }
   return MLUOP_STATUS_SUCCESS;
 }
 
+namespace {
+// Points dims/strides of desc and their 64-bit views to storage of `dimNb`
+// elements, the storage left by a previous shape with more dims is released.
+inline void setTensorDimNb(mluOpTensorDescriptor_t desc, int dimNb) {
+  desc->dim = dimNb;
+  if (MLUOP_PREDICT_FALSE(desc->larger_dims != NULL)) {
+    delete[] desc->larger_dims;
+    desc->larger_dims = NULL;
+  }
+  if (MLUOP_PREDICT_FALSE(desc->larger_strides != NULL)) {
+    delete[] desc->larger_strides;
+    desc->larger_strides = NULL;
+  }
+  if (MLUOP_PREDICT_FALSE(desc->larger_dims_int64 != NULL)) {
+    delete[] desc->larger_dims_int64;
+    desc->larger_dims_int64 = NULL;
+  }
+  if (MLUOP_PREDICT_FALSE(desc->larger_strides_int64 != NULL)) {
+    delete[] desc->larger_strides_int64;
+    desc->larger_strides_int64 = NULL;
+  }
+
+  if (MLUOP_PREDICT_FALSE(dimNb > MLUOP_DIM_MAX)) {
+    desc->larger_dims = new (std::nothrow) int[dimNb];
+    desc->larger_strides = new (std::nothrow) int[dimNb];
+    desc->larger_dims_int64 = new (std::nothrow) int64_t[dimNb];
+    desc->larger_strides_int64 = new (std::nothrow) int64_t[dimNb];
+    desc->dims = desc->larger_dims;
+    desc->strides = desc->larger_strides;
+    desc->dims_int64 = desc->larger_dims_int64;
+    desc->strides_int64 = desc->larger_strides_int64;
+  } else {
+    desc->dims = desc->normal_dims;
+    desc->strides = desc->normal_strides;
+    desc->dims_int64 = desc->normal_dims_int64;
+    desc->strides_int64 = desc->normal_strides_int64;
+  }
+}
+
+inline int clampToInt(int64_t value, bool &overflow) {
+  if (MLUOP_PREDICT_FALSE(value > INT32_MAX || value < INT32_MIN)) {
+    overflow = true;
+    return value > 0 ? INT32_MAX : INT32_MIN;
+  }
+  return (int)value;
+}
+
+// Fills the int views from the 64-bit dims and strides.
+inline void setIntDimsView(mluOpTensorDescriptor_t desc) {
+  bool overflow = false;
+  for (int i = 0; i < desc->dim; ++i) {
+    desc->dims[i] = clampToInt(desc->dims_int64[i], overflow);
+    desc->strides[i] = clampToInt(desc->strides_int64[i], overflow);
+  }
+  desc->dims_overflow_int32 = overflow;
+}
+
+// Infers the contiguous strides from the 64-bit dims, and computes
+// total_element_num and total_tensor_size.
+inline void setContiguousStrides(mluOpTensorDescriptor_t desc) {
+  uint64_t stride_base = 1;
+  for (int i = desc->dim - 1; i >= 0; --i) {
+    desc->strides_int64[i] = stride_base;
+    stride_base *= desc->dims_int64[i];
+  }
+  desc->total_element_num = stride_base;
+  desc->total_tensor_size =
+      desc->total_element_num * getSizeOfDataType(desc->dtype);
+}
+
+// Stride facts of a tensor with the default strides.
+inline void setContiguousFacts(mluOpTensorDescriptor_t desc) {
+  desc->is_contiguous = true;
+  desc->is_dense = true;
+  desc->has_broadcast_dims = false;
+  desc->coalesced_dim = 1;
+  const int perm_num = std::min(desc->dim, MLUOP_DIM_MAX);
+  for (int i = 0; i < perm_num; ++i) {
+    desc->dense_perm[i] = i;
+  }
+}
+
+// Computes the stride facts of a tensor with user specified strides.
+void setStrideFacts(mluOpTensorDescriptor_t desc) {
+  const int dim = desc->dim;
+  const int64_t *dims = desc->dims_int64;
+  const int64_t *strides = desc->strides_int64;
+
+  // contiguous and coalesced dim, from the lowest dim to the highest.
+  bool is_contiguous = true;
+  bool has_broadcast_dims = false;
+  int coalesced_dim = 0;
+  int64_t stride_base = 1;
+  int64_t merged_end = 0;  // stride right after the current merged dim
+  for (int i = dim - 1; i >= 0; --i) {
+    if (dims[i] == 1) {
+      continue;
+    }
+    if (strides[i] != stride_base) {
+      is_contiguous = false;
+    }
+    stride_base *= dims[i];
+    has_broadcast_dims |= (dims[i] > 1 && strides[i] == 0);
+    if (coalesced_dim == 0 || strides[i] != merged_end) {
+      ++coalesced_dim;
+    }
+    merged_end = strides[i] * dims[i];
+  }
+  desc->is_contiguous = is_contiguous;
+  desc->has_broadcast_dims = has_broadcast_dims;
+  desc->coalesced_dim = std::max(coalesced_dim, 1);
+
+  // dense_perm is a stable sort by stride from the largest to the smallest,
+  // insertion sort is the fastest for so few dims.
+  std::vector<int> larger_perm;
+  int *perm = desc->dense_perm;
+  if (MLUOP_PREDICT_FALSE(dim > MLUOP_DIM_MAX)) {
+    larger_perm.resize(dim);
+    perm = larger_perm.data();
+  }
+  for (int i = 0; i < dim; ++i) {
+    int j = i;
+    for (; j > 0 && strides[perm[j - 1]] < strides[i]; --j) {
+      perm[j] = perm[j - 1];
+    }
+    perm[j] = i;
+  }
+
+  // dense if dims larger than 1 tile the memory from the smallest stride.
+  bool is_dense = true;
+  int64_t require_stride = 1;
+  for (int i = dim - 1; i >= 0; --i) {
+    const int64_t dim_size = dims[perm[i]];
+    if (dim_size < 2) {
+      continue;
+    }
+    if (strides[perm[i]] != require_stride) {
+      is_dense = false;
+      break;
+    }
+    require_stride *= dim_size;
+  }
+  desc->is_dense = is_dense;
+}
+
+inline void setTotalNum(mluOpTensorDescriptor_t desc) {
+  desc->total_element_num = 1;
+  for (int i = 0; i < desc->dim; ++i) {
+    desc->total_element_num *= desc->dims_int64[i];
+  }
+  desc->total_tensor_size =
+      desc->total_element_num * getSizeOfDataType(desc->dtype);
+}
+}  // namespace
+
 mluOpStatus_t mluOpSetTensorDescriptor(mluOpTensorDescriptor_t desc,
                                        mluOpTensorLayout_t layout,
                                        mluOpDataType_t dtype, int dimNb,
@@ -188,49 +479,47 @@ mluOpStatus_t mluOpSetTensorDescriptor(mluOpTensorDescriptor_t desc,
   return mluOpSetTensorDescriptorDim(desc, dimNb, dimSize);
 }
 
+mluOpStatus_t mluOpSetTensorDescriptor_v2(mluOpTensorDescriptor_t desc,
+                                          mluOpTensorLayout_t layout,
+                                          mluOpDataType_t dtype, int dimNb,
+                                          const int64_t dimSize[]) {
+  PARAM_CHECK("[mluOpSetTensorDescriptor_v2]", desc != NULL);
+  PARAM_CHECK("[mluOpSetTensorDescriptor_v2]", dimNb > 0);
+  PARAM_CHECK("[mluOpSetTensorDescriptor_v2]", dimSize != NULL);
+  PARAM_CHECK("[mluOpSetTensorDescriptor_v2]", layout >= 0);
+  PARAM_CHECK("[mluOpSetTensorDescriptor_v2]", dtype >= 0);
+
+  desc->dtype = dtype;
+  desc->layout = layout;
+
+  return mluOpSetTensorDescriptorDim_v2(desc, dimNb, dimSize);
+}
+
 mluOpStatus_t mluOpSetTensorDescriptorDim(mluOpTensorDescriptor_t desc,
                                           int dimNb, const int *dimSize) {
   PARAM_CHECK("[mluOpSetTensorDescriptor]", desc != NULL);
   PARAM_CHECK("[mluOpSetTensorDescriptor]", dimNb > 0);
   PARAM_CHECK("[mluOpSetTensorDescriptor]", dimSize != NULL);
 
-  desc->dim = dimNb;
-  if (MLUOP_PREDICT_FALSE(desc->larger_dims != NULL)) {
-    delete[] desc->larger_dims;
-    desc->larger_dims = NULL;
-  }
-
-  if (MLUOP_PREDICT_FALSE(desc->larger_strides != NULL)) {
-    delete[] desc->larger_strides;
-    desc->larger_strides = NULL;
-  }
-
-  if (MLUOP_PREDICT_FALSE(dimNb > MLUOP_DIM_MAX)) {
-    desc->larger_dims = new (std::nothrow) int[dimNb];
-    desc->larger_strides = new (std::nothrow) int[dimNb];
-    desc->dims = desc->larger_dims;
-    desc->strides = desc->larger_strides;
-  } else {
-    desc->dims = desc->normal_dims;
-    desc->strides = desc->normal_strides;
-  }
+  setTensorDimNb(desc, dimNb);
   memcpy(desc->dims, dimSize, dimNb * sizeof(int));
 
   // infer strides of dimNb dimensions and compute total_num & total_size
   uint64_t stride_base = 1;
   bool is_overflow = false;
-  int tmp_num = 0;
   for (int i = dimNb - 1; i >= 0; --i) {
-    desc->strides[i] = stride_base;
-    is_overflow |=
-        __builtin_smul_overflow(stride_base, desc->dims[i], &tmp_num);
-    stride_base *= desc->dims[i];
+    desc->dims_int64[i] = dimSize[i];
+    desc->strides_int64[i] = stride_base;
+    desc->strides[i] = clampToInt(stride_base, is_overflow);
+    stride_base *= dimSize[i];
   }
+  desc->dims_overflow_int32 = is_overflow;
+  setContiguousFacts(desc);
   desc->total_element_num = stride_base;
   desc->total_tensor_size =
       desc->total_element_num * getSizeOfDataType(desc->dtype);
   // judge int overflow situation
-  if (MLUOP_PREDICT_FALSE(is_overflow)) {
+  if (MLUOP_PREDICT_FALSE(desc->total_element_num > INT32_MAX)) {
     std::stringstream tensor_info;
     tensor_info << "dims:(";
     for (int i = 0; i < dimNb - 1; ++i) {
@@ -246,6 +535,21 @@ mluOpStatus_t mluOpSetTensorDescriptorDim(mluOpTensorDescriptor_t desc,
   return MLUOP_STATUS_SUCCESS;
 }
 
+mluOpStatus_t mluOpSetTensorDescriptorDim_v2(mluOpTensorDescriptor_t desc,
+                                             int dimNb,
+                                             const int64_t *dimSize) {
+  PARAM_CHECK("[mluOpSetTensorDescriptorDim_v2]", desc != NULL);
+  PARAM_CHECK("[mluOpSetTensorDescriptorDim_v2]", dimNb > 0);
+  PARAM_CHECK("[mluOpSetTensorDescriptorDim_v2]", dimSize != NULL);
+
+  setTensorDimNb(desc, dimNb);
+  memcpy(desc->dims_int64, dimSize, dimNb * sizeof(int64_t));
+  setContiguousStrides(desc);
+  setIntDimsView(desc);
+  setContiguousFacts(desc);
+  return MLUOP_STATUS_SUCCESS;
+}
+
 mluOpStatus_t mluOpSetGroupTensorDescriptors(
     mluOpTensorDescriptor_t **group_desc,
     const mluOpTensorLayout_t *group_layout, const mluOpDataType_t *group_dtype,
@@ -259,33 +563,20 @@ mluOpStatus_t mluOpSetGroupTensorDescriptors(
 
   int group_dimSize_iterator = 0;
   for (int i = 0; i < desc_num; ++i) {
-    (*(group_desc[i]))->dim = group_dimNb[i];
-    (*(group_desc[i]))->dtype = group_dtype[i];
-    (*(group_desc[i]))->layout = group_layout[i];
-
-    if (MLUOP_PREDICT_FALSE(group_dimNb[i] > MLUOP_DIM_MAX)) {
-      (*(group_desc[i]))->larger_dims = new (std::nothrow) int[group_dimNb[i]];
-      (*(group_desc[i]))->larger_strides =
-          new (std::nothrow) int[group_dimNb[i]];
-      (*(group_desc[i]))->dims = (*(group_desc[i]))->larger_dims;
-      (*(group_desc[i]))->strides = (*(group_desc[i]))->larger_strides;
-    } else {
-      (*(group_desc[i]))->dims = (*(group_desc[i]))->normal_dims;
-      (*(group_desc[i]))->strides = (*(group_desc[i]))->normal_strides;
+    mluOpTensorDescriptor_t desc = *(group_desc[i]);
+    desc->dtype = group_dtype[i];
+    desc->layout = group_layout[i];
+
+    setTensorDimNb(desc, group_dimNb[i]);
+    const int *dimSize = group_dimSize + group_dimSize_iterator;
+    for (int j = 0; j < group_dimNb[i]; ++j) {
+      desc->dims_int64[j] = dimSize[j];
     }
-    memcpy((*(group_desc[i]))->dims, group_dimSize + group_dimSize_iterator,
-           group_dimNb[i] * sizeof(int));
 
     // infer strides of dimNb dimensions and compute total_num and total_size
-    int strideBase = 1;
-    for (int j = group_dimNb[i] - 1; j >= 0; --j) {
-      (*(group_desc[i]))->strides[j] = strideBase;
-      strideBase *= (*(group_desc[i]))->dims[j];
-    }
-    (*(group_desc[i]))->total_element_num = strideBase;
-    (*(group_desc[i]))->total_tensor_size =
-        (*(group_desc[i]))->total_element_num *
-        getSizeOfDataType(group_dtype[i]);
+    setContiguousStrides(desc);
+    setIntDimsView(desc);
+    setContiguousFacts(desc);
 
     // compute new iterator for next loop.
     group_dimSize_iterator += group_dimNb[i];
@@ -313,19 +604,45 @@ mluOpStatus_t mluOpSetTensorDescriptorEx(mluOpTensorDescriptor_t desc,
   PARAM_CHECK("[mluOpSetTensorDescriptorEx]", dtype >= 0);
   PARAM_CHECK("[mluOpSetTensorDescriptorEx]", dimNb > 0);
 
-  desc->dim = dimNb;
+  desc->dtype = dtype;
+  desc->layout = layout;
+  setTensorDimNb(desc, dimNb);
   memcpy(desc->dims, dimSize, dimNb * sizeof(int));
   memcpy(desc->strides, dimStride, dimNb * sizeof(int));
-
-  // assign total_element_num and total_tensor_size
-  desc->total_element_num = 1;
   for (int i = 0; i < dimNb; ++i) {
-    desc->total_element_num *= dimSize[i];
+    desc->dims_int64[i] = dimSize[i];
+    desc->strides_int64[i] = dimStride[i];
   }
-  desc->total_tensor_size = desc->total_element_num * getSizeOfDataType(dtype);
+  desc->dims_overflow_int32 = false;
+  setStrideFacts(desc);
+
+  // assign total_element_num and total_tensor_size
+  setTotalNum(desc);
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t mluOpSetTensorDescriptorEx_v2(mluOpTensorDescriptor_t desc,
+                                            mluOpTensorLayout_t layout,
+                                            mluOpDataType_t dtype, int dimNb,
+                                            const int64_t dimSize[],
+                                            const int64_t dimStride[]) {
+  PARAM_CHECK("[mluOpSetTensorDescriptorEx_v2]", desc != NULL);
+  PARAM_CHECK("[mluOpSetTensorDescriptorEx_v2]", dimSize != NULL);
+  PARAM_CHECK("[mluOpSetTensorDescriptorEx_v2]", dimStride != NULL);
+  PARAM_CHECK("[mluOpSetTensorDescriptorEx_v2]", layout >= 0);
+  PARAM_CHECK("[mluOpSetTensorDescriptorEx_v2]", dtype >= 0);
+  PARAM_CHECK("[mluOpSetTensorDescriptorEx_v2]", dimNb > 0);
 
   desc->dtype = dtype;
   desc->layout = layout;
+  setTensorDimNb(desc, dimNb);
+  memcpy(desc->dims_int64, dimSize, dimNb * sizeof(int64_t));
+  memcpy(desc->strides_int64, dimStride, dimNb * sizeof(int64_t));
+  setIntDimsView(desc);
+  setStrideFacts(desc);
+
+  // assign total_element_num and total_tensor_size
+  setTotalNum(desc);
   return MLUOP_STATUS_SUCCESS;
 }
 
@@ -374,6 +691,12 @@ mluOpStatus_t mluOpGetTensorDescriptorEx(const mluOpTensorDescriptor_t desc,
   PARAM_CHECK("[mluOpGetTensorDescriptorEx]", dimNb != NULL);
   PARAM_CHECK("[mluOpGetTensorDescriptorEx]", dimSize != NULL);
   PARAM_CHECK("[mluOpGetTensorDescriptorEx]", dimStride != NULL);
+  if (MLUOP_PREDICT_FALSE(desc->dims_overflow_int32)) {
+    LOG(ERROR) << "[mluOpGetTensorDescriptorEx] dims or strides of the tensor"
+               << " do not fit in int, please use"
+               << " mluOpGetTensorDescriptorEx_v2.";
+    return MLUOP_STATUS_NOT_SUPPORTED;
+  }
 
   *layout = desc->layout;
   *dtype = desc->dtype;
@@ -386,6 +709,26 @@ mluOpStatus_t mluOpGetTensorDescriptorEx(const mluOpTensorDescriptor_t desc,
   return MLUOP_STATUS_SUCCESS;
 }
 
+mluOpStatus_t mluOpGetTensorDescriptorEx_v2(
+    const mluOpTensorDescriptor_t desc, mluOpTensorLayout_t *layout,
+    mluOpDataType_t *dtype, int *dimNb, int64_t dimSize[],
+    int64_t dimStride[]) {
+  PARAM_CHECK("[mluOpGetTensorDescriptorEx_v2]", desc != NULL);
+  PARAM_CHECK("[mluOpGetTensorDescriptorEx_v2]", layout != NULL);
+  PARAM_CHECK("[mluOpGetTensorDescriptorEx_v2]", dtype != NULL);
+  PARAM_CHECK("[mluOpGetTensorDescriptorEx_v2]", dimNb != NULL);
+  PARAM_CHECK("[mluOpGetTensorDescriptorEx_v2]", dimSize != NULL);
+  PARAM_CHECK("[mluOpGetTensorDescriptorEx_v2]", dimStride != NULL);
+
+  *layout = desc->layout;
+  *dtype = desc->dtype;
+  *dimNb = desc->dim;
+  memcpy(dimSize, desc->dims_int64, desc->dim * sizeof(int64_t));
+  memcpy(dimStride, desc->strides_int64, desc->dim * sizeof(int64_t));
+
+  return MLUOP_STATUS_SUCCESS;
+}
+
 mluOpStatus_t mluOpGetTensorDescriptor(const mluOpTensorDescriptor_t desc,
                                        mluOpTensorLayout_t *layout,
                                        mluOpDataType_t *dtype, int *dimNb,
@@ -402,13 +745,39 @@ mluOpStatus_t mluOpGetTensorDescriptor(const mluOpTensorDescriptor_t desc,
     *dimNb = desc->dim;
   }
   if (dimSize != nullptr) {
-    for (int i = 0; i < *dimNb; ++i) {
+    for (int i = 0; i < desc->dim; ++i) {
+      if (MLUOP_PREDICT_FALSE(desc->dims[i] != desc->dims_int64[i])) {
+        LOG(ERROR) << "[mluOpGetTensorDescriptor] dims of the tensor do not"
+                   << " fit in int, please use mluOpGetTensorDescriptor_v2.";
+        return MLUOP_STATUS_NOT_SUPPORTED;
+      }
       dimSize[i] = desc->dims[i];
     }
   }
   return MLUOP_STATUS_SUCCESS;
 }
 
+mluOpStatus_t mluOpGetTensorDescriptor_v2(const mluOpTensorDescriptor_t desc,
+                                          mluOpTensorLayout_t *layout,
+                                          mluOpDataType_t *dtype, int *dimNb,
+                                          int64_t dimSize[]) {
+  PARAM_CHECK("[mluOpGetTensorDescriptor_v2]", desc != NULL);
+
+  if (layout != nullptr) {
+    *layout = desc->layout;
+  }
+  if (dtype != nullptr) {
+    *dtype = desc->dtype;
+  }
+  if (dimNb != nullptr) {
+    *dimNb = desc->dim;
+  }
+  if (dimSize != nullptr) {
+    memcpy(dimSize, desc->dims_int64, desc->dim * sizeof(int64_t));
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
 mluOpStatus_t mluOpGetTensorDescriptorOnchipDataType(
     const mluOpTensorDescriptor_t desc, mluOpDataType_t *onchip_dtype) {
   PARAM_CHECK("[mluOpGetTensorDescriptorOnchipDataType]", desc != NULL);
@@ -457,8 +826,12 @@ mluOpStatus_t mluOpGetTensorDescriptorPositionScaleAndOffset(
 
 mluOpStatus_t mluOpDestroyTensorDescriptor(mluOpTensorDescriptor_t desc) {
   PARAM_CHECK("[mluOpDestroyTensorDescriptor]", desc != NULL);
+#if MLUOP_TENSOR_QUEUE_ENABLE
+  mluOpTensorDescriptorQueueStruct::instance()->put(desc);
+#else
   desc->reset();
   delete desc;
+#endif
   return MLUOP_STATUS_SUCCESS;
 }
 
@@ -466,9 +839,16 @@ mluOpStatus_t mluOpDestroyGroupTensorDescriptors(
     mluOpTensorDescriptor_t **group_desc, const int desc_num) {
   PARAM_CHECK("[mluOpDestroyGroupTensorDescriptors]", group_desc != NULL);
   PARAM_CHECK("[mluOpDestroyGroupTensorDescriptors]", desc_num > 0);
+#if MLUOP_TENSOR_QUEUE_ENABLE
+  auto queue = mluOpTensorDescriptorQueueStruct::instance();
+#endif
   for (int i = 0; i < desc_num; ++i) {
+#if MLUOP_TENSOR_QUEUE_ENABLE
+    queue->put(*(group_desc[i]));
+#else
     (*(group_desc[i]))->reset();
     delete (*(group_desc[i]));
+#endif
   }
 
   return MLUOP_STATUS_SUCCESS;
@@ -535,6 +915,7 @@ mluOpStatus_t mluOpInitTensorSetMemberDescriptor(
   PARAM_CHECK("[mluOpInitTensorSetMemberDescriptor]",
               tensorSet->dim_num == tensorSetDimNb);
   auto ts = tensorSet->getTensor(tensorIndex);
+  tensorSet->invalidateSizePrefix();
   PARAM_CHECK("[mluOpInitTensorSetMemberDescriptor]",
               MLUOP_STATUS_SUCCESS ==
                   mluOpSetTensorDescriptor(ts, layout, dtype, dimNb, dimSize));
@@ -559,7 +940,13 @@ mluOpStatus_t mluOpGetTensorSetDescriptorSize(
     mluOpTensorSetDescriptor_t tensorSet, int *sizeInBytes) {
   PARAM_CHECK("[mluOpGetTensorSetDescriptorSize]", tensorSet != NULL);
 
-  int tensor_set_size = tensorSet->getSize();
+  size_t tensor_set_size = tensorSet->getSize();
+  if (tensor_set_size > INT32_MAX) {
+    LOG(ERROR) << "[mluOpGetTensorSetDescriptorSize] the size of the tensor "
+               << "set is " << tensor_set_size << " bytes, which does not fit "
+               << "in int.";
+    return MLUOP_STATUS_NOT_SUPPORTED;
+  }
   *sizeInBytes = tensor_set_size;
   return MLUOP_STATUS_SUCCESS;
 }
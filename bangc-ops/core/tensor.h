@@ -23,11 +23,13 @@
 #ifndef CORE_TENSOR_H_
 #define CORE_TENSOR_H_
 
+#include <algorithm>
 #include <vector>
 #include <list>
 #include <memory>
 #include <queue>
 #include <thread>  // NOLINT
+#include <type_traits>
 #include <atomic>
 #include <cstring>
 
@@ -81,6 +83,36 @@ struct mluOpTensorStruct {
   int *larger_strides = NULL;
   int *strides = normal_strides;  // point the normal strides as default
 
+  // 64-bit dims and strides, always set together with dims and strides above.
+  // dims and strides are int views of them for kernels taking int shapes,
+  // values that do not fit in int are clamped to INT32_MAX there and
+  // dims_overflow_int32 is set. Only the first `dim` values are meaningful,
+  // so they are left uninitialized to keep creating descriptors cheap.
+  int64_t normal_dims_int64[MLUOP_DIM_MAX];
+  int64_t *larger_dims_int64 = NULL;
+  int64_t *dims_int64 = normal_dims_int64;
+
+  int64_t normal_strides_int64[MLUOP_DIM_MAX];
+  int64_t *larger_strides_int64 = NULL;
+  int64_t *strides_int64 = normal_strides_int64;
+  bool dims_overflow_int32 = false;
+
+  // stride facts computed once by the setters, stride aware ops read them
+  // instead of scanning dims and strides on every call.
+  // is_contiguous: strides are the default ones, dims of size 1 are ignored.
+  // is_dense: elements cover a block without gaps or overlaps, i.e. the
+  //   tensor is contiguous once its dims are permuted by dense_perm.
+  // has_broadcast_dims: some dim larger than 1 has stride 0.
+  // coalesced_dim: the number of dims left after dropping dims of size 1 and
+  //   merging adjacent dims which are contiguous to each other, at least 1.
+  // dense_perm: dims from the largest stride to the smallest, dims with the
+  //   same stride keep their order. Only set when dim <= MLUOP_DIM_MAX.
+  bool is_contiguous = true;
+  bool is_dense = true;
+  bool has_broadcast_dims = false;
+  int coalesced_dim = 1;
+  int dense_perm[MLUOP_DIM_MAX];
+
   mluOpDataType_t dtype;
   mluOpDataType_t onchip_dtype;
   mluOpTensorLayout_t layout;
@@ -96,12 +128,21 @@ struct mluOpTensorStruct {
     // if not, when call reset() will free invalid pointer.
     larger_dims = NULL;
     larger_strides = NULL;
+    larger_dims_int64 = NULL;
+    larger_strides_int64 = NULL;
 
     dim = 0;
     total_element_num = 0;
     total_tensor_size = 0;
     dims = normal_dims;
     strides = normal_strides;
+    dims_int64 = normal_dims_int64;
+    strides_int64 = normal_strides_int64;
+    dims_overflow_int32 = false;
+    is_contiguous = true;
+    is_dense = true;
+    has_broadcast_dims = false;
+    coalesced_dim = 1;
   }
   inline void reset() {  // reset variable as default.
     if (MLUOP_PREDICT_FALSE(larger_dims != NULL)) {
@@ -112,8 +153,23 @@ struct mluOpTensorStruct {
       delete[] larger_strides;
       larger_strides = NULL;
     }
+    if (MLUOP_PREDICT_FALSE(larger_dims_int64 != NULL)) {
+      delete[] larger_dims_int64;
+      larger_dims_int64 = NULL;
+    }
+    if (MLUOP_PREDICT_FALSE(larger_strides_int64 != NULL)) {
+      delete[] larger_strides_int64;
+      larger_strides_int64 = NULL;
+    }
     dims = normal_dims;
     strides = normal_strides;
+    dims_int64 = normal_dims_int64;
+    strides_int64 = normal_strides_int64;
+    dims_overflow_int32 = false;
+    is_contiguous = true;
+    is_dense = true;
+    has_broadcast_dims = false;
+    coalesced_dim = 1;
     dtype = MLUOP_DTYPE_FLOAT;
     onchip_dtype = MLUOP_DTYPE_INVALID;
     layout = MLUOP_LAYOUT_ARRAY;
@@ -147,13 +203,7 @@ struct mluOpTensorSetStruct {
   /* methods */
   inline size_t getSize() {
     CHECK(!this->tensor_set.empty());
-    size_t tensor_set_size = 0;
-    for (int i = 0; i < tensor_set.size(); i++) {
-      size_t size = 0;
-      tensor_set[i]->tensorSize(size);
-      tensor_set_size += size;
-    }
-    return tensor_set_size;
+    return this->getSizePrefix()[tensor_num];
   }
   // tensor set (eg: rnn)
   inline int getIndex(const int tensorIndex[]) const {
@@ -165,17 +215,30 @@ struct mluOpTensorSetStruct {
   }
 
   inline size_t getOffset(const int tensorIndex[]) {
-    int64_t offset = 0;
     int index = this->getIndex(tensorIndex);
-    for (int i = 0; i < index; i++) {
-      size_t ts_size = 0;
-      this->tensor_set[i]->tensorSize(ts_size);
-      offset += ts_size;
-    }
+    size_t offset = this->getSizePrefix()[index];
     data_offset[index] = offset;
     return offset;
   }
 
+  // size_prefix[i] is the sum of the sizes of the first i members, built on
+  // the first lookup after a member changes.
+  inline const std::vector<size_t> &getSizePrefix() {
+    if (!size_prefix_valid) {
+      size_prefix.resize(tensor_num + 1);
+      size_prefix[0] = 0;
+      for (int i = 0; i < tensor_num; i++) {
+        size_t ts_size = 0;
+        this->tensor_set[i]->tensorSize(ts_size);
+        size_prefix[i + 1] = size_prefix[i] + ts_size;
+      }
+      size_prefix_valid = true;
+    }
+    return size_prefix;
+  }
+
+  inline void invalidateSizePrefix() { size_prefix_valid = false; }
+
   inline mluOpTensorDescriptor_t getTensor(const int tensorIndex[]) const {
     auto index = this->getIndex(tensorIndex);
     auto ts = this->tensor_set[index].get();
@@ -210,14 +273,9 @@ struct mluOpTensorSetStruct {
     if (data_offset.size() == 0) {
       return data_offset;
     }
-    int offset = 0;
-    data_offset[0] = offset;
-    for (int i = 0; i < tensor_num - 1; i++) {
-      size_t ts_size = 0;
-      this->tensor_set[i]->tensorSize(ts_size);
-      offset += ts_size;
-      data_offset[i + 1] = offset;
-    }
+    const std::vector<size_t> &prefix = this->getSizePrefix();
+    std::copy(prefix.begin(), prefix.begin() + tensor_num,
+              data_offset.begin());
     return data_offset;
   }
   /* struct */
@@ -230,6 +288,8 @@ struct mluOpTensorSetStruct {
 
   std::vector<std::vector<int>> user_indices;  // releated tensor's index
   std::vector<size_t> data_offset;             // data's offset
+  std::vector<size_t> size_prefix;             // see getSizePrefix
+  bool size_prefix_valid = false;
 };
 
 #ifndef MLUOP_TENSOR_QUEUE_ENABLE
@@ -237,40 +297,62 @@ struct mluOpTensorSetStruct {
 #endif
 
 #if MLUOP_TENSOR_QUEUE_ENABLE
+// A pool of mluOpTensorStruct used by mluOpCreateTensorDescriptor and
+// mluOpDestroyTensorDescriptor, so that creating descriptors per op call does
+// not go through the heap.
+//
+// Descriptors are carved out of slabs which are never returned to the heap.
+// Each thread keeps a small cache of free descriptors, and exchanges them in
+// batches with a global freelist. The global freelist is a lock-free stack
+// whose head packs a 32-bit slot index with a 32-bit tag, the tag is bumped on
+// every update to avoid the ABA problem.
 struct mluOpTensorDescriptorQueueStruct {
-  mluOpTensorDescriptorQueueStruct() {
-    extend(extend_num);
-    extend_num *= 2;
-  }
-  explicit mluOpTensorDescriptorQueueStruct(size_t n) {
-    extend_num = n;
-    extend(extend_num);
-    extend_num *= 2;
-  }
-  ~mluOpTensorDescriptorQueueStruct() {
-    for (auto it : this->headers) {
-      delete[] it;
-    }
-  }
-  std::queue<mluOpTensorDescriptor_t> queue;
-  std::list<mluOpTensorStruct *> headers;
-  std::atomic_flag flag = ATOMIC_FLAG_INIT;
-  inline void lock() {
-    while (flag.test_and_set(std::memory_order_acquire)) {
-      std::this_thread::yield();
-    }
-  }
-  inline void unlock() { flag.clear(std::memory_order_release); }
-  inline void extend(size_t n) {
-    mluOpTensorStruct *header = new (std::nothrow) mluOpTensorStruct[n];
-    headers.emplace_back(header);
-    for (size_t i = 0; i < n; ++i) {
-      mluOpTensorStruct *desc = header + i;
-      desc->init();  // reset random value.
-      queue.emplace(desc);
-    }
+  static constexpr uint32_t kSlabSize = 256;
+  static constexpr uint32_t kMaxSlabNum = 1 << 15;
+  static constexpr int kBatchSize = 32;
+  static constexpr int kCacheCapacity = 2 * kBatchSize;
+
+  struct Slot {
+    // must be the first member, so that a descriptor can be cast to its slot.
+    typename std::aligned_storage<sizeof(mluOpTensorStruct),
+                                  alignof(mluOpTensorStruct)>::type storage;
+    std::atomic<uint32_t> next;  // index of the next free slot, 0 for null
+    uint32_t index;              // 1-based global index of this slot
+  };
+  struct Slab {
+    Slot slots[kSlabSize];
+  };
+  struct ThreadCache {
+    ~ThreadCache();
+    Slot *slots[kCacheCapacity];
+    int num = 0;
+  };
+
+  // The result of instance() belongs to this library and is never deleted,
+  // it must outlive the thread caches which are flushed at thread exit.
+  static mluOpTensorDescriptorQueueStruct *instance();
+
+  // Returns a default constructed descriptor, or NULL if out of memory.
+  mluOpTensorDescriptor_t get();
+  // Destructs the descriptor and gives its storage back to the pool.
+  void put(mluOpTensorDescriptor_t desc);
+
+ private:
+  mluOpTensorDescriptorQueueStruct() = default;
+  static ThreadCache &threadCache();
+  inline Slot *slot(uint32_t index) const {
+    return &(slabs[(index - 1) / kSlabSize].load(std::memory_order_acquire)
+                 ->slots[(index - 1) % kSlabSize]);
   }
-  size_t extend_num = 100;
+  Slot *pop();
+  // pushes slots[0], ..., slots[n - 1] with a single CAS on the head.
+  void push(Slot *const *slots, int n);
+  // refills an empty cache from the global freelist or a new slab.
+  bool refill(ThreadCache *cache);
+
+  std::atomic<uint64_t> head{0};
+  std::atomic<uint32_t> slab_num{0};
+  std::atomic<Slab *> slabs[kMaxSlabNum] = {};
 };
 #endif
 
@@ -0,0 +1,215 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "core/tensor_file.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#ifdef MLUOP_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include "core/logging.h"
+
+namespace mluop {
+
+namespace {
+struct TensorFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t codec;
+  uint64_t size;
+  uint64_t chunk_size;
+};
+
+struct TensorFileChunkHeader {
+  uint32_t raw_bytes;
+  uint32_t stored_bytes;
+};
+
+// level 1 is several hundred MB/s per thread, tensors are dumped for replay
+// rather than archived.
+const int kZstdLevel = 1;
+}  // namespace
+
+bool tensorFileCompressionSupported() {
+#ifdef MLUOP_WITH_ZSTD
+  return true;
+#else
+  return false;
+#endif
+}
+
+mluOpStatus_t writeTensorFile(const std::string &file_name, const void *data,
+                              size_t size, bool compress) {
+  const std::string api = "[writeTensorFile]";
+  std::ofstream file(file_name.c_str(), std::ios::binary);
+  if (!file) {
+    LOG(ERROR) << api << " open " << file_name << " failed.";
+    return MLUOP_STATUS_EXECUTION_FAILED;
+  }
+  TensorFileHeader header;
+  memcpy(header.magic, TENSOR_FILE_MAGIC, sizeof(header.magic));
+  header.version = TENSOR_FILE_VERSION;
+  header.codec = (compress && tensorFileCompressionSupported())
+                     ? TENSOR_FILE_CODEC_ZSTD
+                     : TENSOR_FILE_CODEC_NONE;
+  header.size = size;
+  header.chunk_size = TENSOR_FILE_CHUNK_SIZE;
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  std::vector<char> buffer;
+#ifdef MLUOP_WITH_ZSTD
+  ZSTD_CCtx *cctx = nullptr;
+  if (header.codec == TENSOR_FILE_CODEC_ZSTD) {
+    buffer.resize(ZSTD_compressBound(TENSOR_FILE_CHUNK_SIZE));
+    cctx = ZSTD_createCCtx();
+  }
+#endif
+  const char *src = static_cast<const char *>(data);
+  for (size_t offset = 0; offset < size; offset += TENSOR_FILE_CHUNK_SIZE) {
+    TensorFileChunkHeader chunk;
+    chunk.raw_bytes = std::min<size_t>(TENSOR_FILE_CHUNK_SIZE, size - offset);
+    chunk.stored_bytes = chunk.raw_bytes;
+    const char *payload = src + offset;
+#ifdef MLUOP_WITH_ZSTD
+    if (cctx != nullptr) {
+      size_t stored = ZSTD_compressCCtx(cctx, buffer.data(), buffer.size(),
+                                        payload, chunk.raw_bytes, kZstdLevel);
+      if (!ZSTD_isError(stored) && stored < chunk.raw_bytes) {
+        chunk.stored_bytes = stored;
+        payload = buffer.data();
+      }
+    }
+#endif
+    file.write(reinterpret_cast<const char *>(&chunk), sizeof(chunk));
+    file.write(payload, chunk.stored_bytes);
+  }
+#ifdef MLUOP_WITH_ZSTD
+  ZSTD_freeCCtx(cctx);
+#endif
+  file.close();
+  if (!file) {
+    LOG(ERROR) << api << " write " << file_name << " failed.";
+    return MLUOP_STATUS_EXECUTION_FAILED;
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t readTensorFile(const std::string &file_name, void *data,
+                             size_t size) {
+  const std::string api = "[readTensorFile]";
+  std::ifstream file(file_name.c_str(), std::ios::binary);
+  if (!file) {
+    LOG(ERROR) << api << " open " << file_name << " failed.";
+    return MLUOP_STATUS_EXECUTION_FAILED;
+  }
+  TensorFileHeader header;
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (!file || memcmp(header.magic, TENSOR_FILE_MAGIC, sizeof(header.magic))) {
+    // a plain binary file
+    file.clear();
+    file.seekg(0);
+    file.read(static_cast<char *>(data), size);
+    if (!file) {
+      LOG(ERROR) << api << " " << file_name << " has less than " << size
+                 << " bytes.";
+      return MLUOP_STATUS_EXECUTION_FAILED;
+    }
+    return MLUOP_STATUS_SUCCESS;
+  }
+  if (header.version != TENSOR_FILE_VERSION || header.size < size) {
+    LOG(ERROR) << api << " " << file_name << " of version " << header.version
+               << " holds " << header.size << " bytes, but " << size
+               << " bytes of version " << TENSOR_FILE_VERSION
+               << " are required.";
+    return MLUOP_STATUS_EXECUTION_FAILED;
+  }
+  if (header.codec != TENSOR_FILE_CODEC_NONE &&
+      !(header.codec == TENSOR_FILE_CODEC_ZSTD &&
+        tensorFileCompressionSupported())) {
+    LOG(ERROR) << api << " " << file_name << " is compressed by codec "
+               << header.codec
+               << ", please build the library with MLUOP_BUILD_ZSTD=ON.";
+    return MLUOP_STATUS_NOT_SUPPORTED;
+  }
+
+  char *dst = static_cast<char *>(data);
+  std::vector<char> buffer;
+  std::vector<char> tail;  // the last chunk may be needed only partly
+#ifdef MLUOP_WITH_ZSTD
+  ZSTD_DCtx *dctx = ZSTD_createDCtx();
+#endif
+  mluOpStatus_t status = MLUOP_STATUS_SUCCESS;
+  for (size_t offset = 0; offset < size;) {
+    TensorFileChunkHeader chunk;
+    file.read(reinterpret_cast<char *>(&chunk), sizeof(chunk));
+    if (!file || chunk.raw_bytes > header.chunk_size ||
+        chunk.stored_bytes > chunk.raw_bytes) {
+      status = MLUOP_STATUS_EXECUTION_FAILED;
+      break;
+    }
+    size_t need = std::min<size_t>(chunk.raw_bytes, size - offset);
+    char *out = dst + offset;
+    if (need < chunk.raw_bytes) {
+      tail.resize(chunk.raw_bytes);
+      out = tail.data();
+    }
+    if (chunk.stored_bytes == chunk.raw_bytes) {
+      file.read(out, chunk.raw_bytes);
+    } else {
+      buffer.resize(chunk.stored_bytes);
+      file.read(buffer.data(), chunk.stored_bytes);
+#ifdef MLUOP_WITH_ZSTD
+      if (file) {
+        size_t raw = ZSTD_decompressDCtx(dctx, out, chunk.raw_bytes,
+                                         buffer.data(), chunk.stored_bytes);
+        if (ZSTD_isError(raw) || raw != chunk.raw_bytes) {
+          status = MLUOP_STATUS_EXECUTION_FAILED;
+          break;
+        }
+      }
+#endif
+    }
+    if (!file) {
+      status = MLUOP_STATUS_EXECUTION_FAILED;
+      break;
+    }
+    if (out != dst + offset) {
+      memcpy(dst + offset, out, need);
+    }
+    offset += need;
+  }
+#ifdef MLUOP_WITH_ZSTD
+  ZSTD_freeDCtx(dctx);
+#endif
+  if (status != MLUOP_STATUS_SUCCESS) {
+    LOG(ERROR) << api << " " << file_name << " is broken.";
+  }
+  return status;
+}
+
+}  // namespace mluop
@@ -0,0 +1,70 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef CORE_TENSOR_FILE_H_
+#define CORE_TENSOR_FILE_H_
+
+#include <string>
+
+#include "mlu_op.h"
+
+// The first bytes of a chunked tensor file. A file without it is a plain
+// binary file of the tensor.
+#define TENSOR_FILE_MAGIC "MLUOPTF1"
+#define TENSOR_FILE_VERSION 1
+#define TENSOR_FILE_CHUNK_SIZE (4 << 20)
+
+namespace mluop {
+
+/******************************************************************************
+ * Chunked tensor file
+ * The tensor data dumped by gen_case when MLUOP_GEN_CASE_DUMP_DATA_FILE=2.
+ * The layout, in host byte order, is
+ *   magic[8] | version(u32) | codec(u32) | size(u64) | chunk_size(u64)
+ * followed by chunks of
+ *   raw_bytes(u32) | stored_bytes(u32) | payload
+ * A chunk is compressed by the codec unless stored_bytes equals raw_bytes,
+ * which means compression did not pay off and the payload is raw.
+ ******************************************************************************/
+enum TensorFileCodec {
+  TENSOR_FILE_CODEC_NONE = 0,
+  TENSOR_FILE_CODEC_ZSTD = 1,
+};
+
+// Whether chunks can be compressed, it needs the library to be built with
+// MLUOP_BUILD_ZSTD=ON.
+bool tensorFileCompressionSupported();
+
+// Writes `size` bytes of host data as a chunked tensor file. When `compress`
+// is set but compression is not supported, chunks are stored raw.
+mluOpStatus_t writeTensorFile(const std::string &file_name, const void *data,
+                              size_t size, bool compress);
+
+// Reads `size` bytes of a chunked or a plain binary tensor file into `data`.
+// Chunks are read and decompressed one by one, so only one chunk of the file
+// is held in memory.
+mluOpStatus_t readTensorFile(const std::string &file_name, void *data,
+                             size_t size);
+
+}  // namespace mluop
+
+#endif  // CORE_TENSOR_FILE_H_
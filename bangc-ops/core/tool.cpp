@@ -26,9 +26,338 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <thread>  // NOLINT
+#include <vector>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #define INT31_BITWIDTH 31
 #define INT16_BITWIDTH 16
 
+/*
+ * Host side quantization scans, shared by castFloat32ToInt31 and
+ * getPosition*. Large inputs are split into chunks scanned by several
+ * threads, and every chunk is scanned with AVX2 on x86_64 CPUs that support
+ * it or NEON on aarch64. Max and min do not depend on the scan order unless
+ * there is a nan, whose result depends on where it is in the serial loops, so
+ * inputs containing nan are scanned again serially.
+ */
+#define QUANT_PARALLEL_MIN_NUM (1 << 20)  // elements per thread at least
+#define QUANT_PARALLEL_MAX_THREADS 16
+
+// the number of chunks parallelChunks splits `num` elements into.
+static size_t parallelChunkNum(size_t num) {
+  size_t thread_num = std::min<size_t>(std::thread::hardware_concurrency(),
+                                       QUANT_PARALLEL_MAX_THREADS);
+  return std::max<size_t>(1, std::min(thread_num, num / QUANT_PARALLEL_MIN_NUM));
+}
+
+// calls func(begin, end, chunk_index) on every chunk, each in its own thread.
+template <typename Func>
+static void parallelChunks(size_t num, Func func) {
+  size_t chunk_num = parallelChunkNum(num);
+  size_t chunk = (num + chunk_num - 1) / chunk_num;
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < chunk_num; ++t) {
+    size_t begin = std::min(num, t * chunk);
+    size_t end = std::min(num, begin + chunk);
+    threads.emplace_back(func, begin, end, t);
+  }
+  func(0, std::min(num, chunk), 0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+struct QuantRange {
+  float min = 0.0f;  // of the elements that are not nan
+  float max = 0.0f;
+  bool has_nan = false;
+};
+
+static void absMaxScalar(const float *src, size_t num, QuantRange *range) {
+  for (size_t i = 0; i < num; ++i) {
+    float value = std::fabs(src[i]);
+    if (value != value) {
+      range->has_nan = true;
+    } else if (value > range->max) {
+      range->max = value;
+    }
+  }
+}
+
+static void minMaxScalar(const float *src, size_t num, QuantRange *range) {
+  for (size_t i = 0; i < num; ++i) {
+    float value = src[i];
+    if (value != value) {
+      range->has_nan = true;
+    } else {
+      range->max = range->max > value ? range->max : value;
+      range->min = range->min < value ? range->min : value;
+    }
+  }
+}
+
+#if defined(__x86_64__)
+// maxps and minps return the second operand if either one is nan, so nan
+// elements never get into the accumulators.
+__attribute__((target("avx2"))) static void absMaxAvx2(const float *src,
+                                                       size_t num,
+                                                       QuantRange *range) {
+  const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  __m256 max0 = _mm256_set1_ps(range->max);
+  __m256 max1 = max0;
+  __m256 nan = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= num; i += 16) {
+    __m256 value0 = _mm256_and_ps(_mm256_loadu_ps(src + i), abs_mask);
+    __m256 value1 = _mm256_and_ps(_mm256_loadu_ps(src + i + 8), abs_mask);
+    max0 = _mm256_max_ps(value0, max0);
+    max1 = _mm256_max_ps(value1, max1);
+    nan = _mm256_or_ps(nan, _mm256_cmp_ps(value0, value1, _CMP_UNORD_Q));
+  }
+  float lanes[8];
+  _mm256_storeu_ps(lanes, _mm256_max_ps(max0, max1));
+  for (int l = 0; l < 8; ++l) {
+    range->max = std::max(range->max, lanes[l]);
+  }
+  range->has_nan |= !_mm256_testz_ps(nan, nan);
+  absMaxScalar(src + i, num - i, range);
+}
+
+__attribute__((target("avx2"))) static void minMaxAvx2(const float *src,
+                                                       size_t num,
+                                                       QuantRange *range) {
+  __m256 max = _mm256_set1_ps(range->max);
+  __m256 min = _mm256_set1_ps(range->min);
+  __m256 nan = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= num; i += 8) {
+    __m256 value = _mm256_loadu_ps(src + i);
+    max = _mm256_max_ps(value, max);
+    min = _mm256_min_ps(value, min);
+    nan = _mm256_or_ps(nan, _mm256_cmp_ps(value, value, _CMP_UNORD_Q));
+  }
+  float max_lanes[8];
+  float min_lanes[8];
+  _mm256_storeu_ps(max_lanes, max);
+  _mm256_storeu_ps(min_lanes, min);
+  for (int l = 0; l < 8; ++l) {
+    range->max = std::max(range->max, max_lanes[l]);
+    range->min = std::min(range->min, min_lanes[l]);
+  }
+  range->has_nan |= !_mm256_testz_ps(nan, nan);
+  minMaxScalar(src + i, num - i, range);
+}
+
+static bool cpuSupportsAvx2() { return __builtin_cpu_supports("avx2"); }
+#elif defined(__aarch64__)
+// fmax and fmin would return nan, so nan lanes are replaced before.
+static void absMaxNeon(const float *src, size_t num, QuantRange *range) {
+  float32x4_t max = vdupq_n_f32(range->max);
+  uint32x4_t not_nan = vdupq_n_u32(0xffffffff);
+  size_t i = 0;
+  for (; i + 4 <= num; i += 4) {
+    float32x4_t value = vabsq_f32(vld1q_f32(src + i));
+    uint32x4_t is_num = vceqq_f32(value, value);
+    not_nan = vandq_u32(not_nan, is_num);
+    max = vmaxq_f32(max, vbslq_f32(is_num, value, max));
+  }
+  range->max = std::max(range->max, vmaxvq_f32(max));
+  range->has_nan |= vminvq_u32(not_nan) == 0;
+  absMaxScalar(src + i, num - i, range);
+}
+
+static void minMaxNeon(const float *src, size_t num, QuantRange *range) {
+  float32x4_t max = vdupq_n_f32(range->max);
+  float32x4_t min = vdupq_n_f32(range->min);
+  uint32x4_t not_nan = vdupq_n_u32(0xffffffff);
+  size_t i = 0;
+  for (; i + 4 <= num; i += 4) {
+    float32x4_t value = vld1q_f32(src + i);
+    uint32x4_t is_num = vceqq_f32(value, value);
+    not_nan = vandq_u32(not_nan, is_num);
+    max = vmaxq_f32(max, vbslq_f32(is_num, value, max));
+    min = vminq_f32(min, vbslq_f32(is_num, value, min));
+  }
+  range->max = std::max(range->max, vmaxvq_f32(max));
+  range->min = std::min(range->min, vminvq_f32(min));
+  range->has_nan |= vminvq_u32(not_nan) == 0;
+  minMaxScalar(src + i, num - i, range);
+}
+#endif
+
+static void absMaxChunk(const float *src, size_t num, QuantRange *range) {
+#if defined(__x86_64__)
+  static const bool use_avx2 = cpuSupportsAvx2();
+  if (use_avx2) {
+    absMaxAvx2(src, num, range);
+    return;
+  }
+#elif defined(__aarch64__)
+  absMaxNeon(src, num, range);
+  return;
+#endif
+  absMaxScalar(src, num, range);
+}
+
+static void minMaxChunk(const float *src, size_t num, QuantRange *range) {
+#if defined(__x86_64__)
+  static const bool use_avx2 = cpuSupportsAvx2();
+  if (use_avx2) {
+    minMaxAvx2(src, num, range);
+    return;
+  }
+#elif defined(__aarch64__)
+  minMaxNeon(src, num, range);
+  return;
+#endif
+  minMaxScalar(src, num, range);
+}
+
+// the same as
+//   absmax = fabs(src[0]);
+//   for (i = 0; i < num; ++i) if (fabs(src[i]) > absmax) absmax = fabs(src[i]);
+static float getAbsMax(const float *src, size_t num) {
+  std::vector<QuantRange> ranges(parallelChunkNum(num));
+  parallelChunks(num, [&](size_t begin, size_t end, size_t chunk) {
+    absMaxChunk(src + begin, end - begin, &ranges[chunk]);
+  });
+  float absmax = std::fabs(src[0]);
+  bool has_nan = false;
+  for (const auto &range : ranges) {
+    absmax = std::max(absmax, range.max);
+    has_nan |= range.has_nan;
+  }
+  if (has_nan) {
+    absmax = std::fabs(src[0]);
+    for (size_t i = 0; i < num; ++i) {
+      if (std::fabs(src[i]) > absmax) absmax = std::fabs(src[i]);
+    }
+  }
+  return absmax;
+}
+
+// the same as
+//   max = min = src[0];
+//   for (i = 0; i < num; ++i) {
+//     max = max > src[i] ? max : src[i];
+//     min = min < src[i] ? min : src[i];
+//   }
+static void getMinMax(const float *src, size_t num, float *min, float *max) {
+  std::vector<QuantRange> ranges(parallelChunkNum(num));
+  for (auto &range : ranges) {
+    range.min = src[0];
+    range.max = src[0];
+  }
+  if (src[0] != src[0]) {
+    ranges[0].has_nan = true;
+  } else {
+    parallelChunks(num, [&](size_t begin, size_t end, size_t chunk) {
+      minMaxChunk(src + begin, end - begin, &ranges[chunk]);
+    });
+  }
+  *min = src[0];
+  *max = src[0];
+  bool has_nan = false;
+  for (const auto &range : ranges) {
+    *max = std::max(*max, range.max);
+    *min = std::min(*min, range.min);
+    has_nan |= range.has_nan;
+  }
+  if (has_nan) {
+    *min = src[0];
+    *max = src[0];
+    for (size_t i = 0; i < num; ++i) {
+      *max = *max > src[i] ? *max : src[i];
+      *min = *min < src[i] ? *min : src[i];
+    }
+  }
+}
+
+// Formula: f = (high * 2^15 + low) * 2^position. `scale` is 2^position.
+static void splitFloat32ToInt31Scalar(const float *src, size_t num,
+                                      double scale, int16_t *low,
+                                      int16_t *high) {
+  const int var = 1 << (INT16_BITWIDTH - 1);
+  for (size_t i = 0; i < num; ++i) {
+    float temp = src[i] / scale;
+    temp = (temp >= 0) ? (temp + 0.5f) : (temp - 0.5f);
+    // high int16 data
+    float temp_high = temp / var;
+    high[i] = static_cast<int16_t>(temp_high);
+    // low int16 data
+    float temp_low = temp - high[i] * var;
+    low[i] = static_cast<int16_t>(temp_low);
+  }
+}
+
+#if defined(__x86_64__)
+// float to int16 casts are done by cvttss2si to int32 and keeping the low
+// 16 bits, which are what the vector cast and the shuffle below do.
+__attribute__((target("avx2"))) static void splitFloat32ToInt31Avx2(
+    const float *src, size_t num, double scale, int16_t *low,
+    int16_t *high) {
+  const int var = 1 << (INT16_BITWIDTH - 1);
+  const __m256d scale_pd = _mm256_set1_pd(scale);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 var_ps = _mm256_set1_ps((float)var);
+  const __m256i low16 = _mm256_setr_epi8(
+      0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, 0, 1, 4, 5, 8,
+      9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+  size_t i = 0;
+  for (; i + 8 <= num; i += 8) {
+    __m256 value = _mm256_loadu_ps(src + i);
+    // src / 2^position is computed in double as the scalar code does.
+    __m128 temp_lo = _mm256_cvtpd_ps(
+        _mm256_div_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(value)),
+                      scale_pd));
+    __m128 temp_hi = _mm256_cvtpd_ps(
+        _mm256_div_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(value, 1)),
+                      scale_pd));
+    __m256 temp = _mm256_insertf128_ps(_mm256_castps128_ps256(temp_lo),
+                                       temp_hi, 1);
+    __m256 ge_zero = _mm256_cmp_ps(temp, _mm256_setzero_ps(), _CMP_GE_OQ);
+    temp = _mm256_blendv_ps(_mm256_sub_ps(temp, half),
+                            _mm256_add_ps(temp, half), ge_zero);
+    __m256i high32 = _mm256_cvttps_epi32(_mm256_div_ps(temp, var_ps));
+    // sign extend the low 16 bits as the int16 value stored by the scalar.
+    high32 = _mm256_srai_epi32(_mm256_slli_epi32(high32, 16), 16);
+    __m256 temp_low =
+        _mm256_sub_ps(temp, _mm256_cvtepi32_ps(_mm256_mullo_epi32(
+                                high32, _mm256_set1_epi32(var))));
+    __m256i low32 = _mm256_cvttps_epi32(temp_low);
+    __m256i high_packed = _mm256_permute4x64_epi64(
+        _mm256_shuffle_epi8(high32, low16), _MM_SHUFFLE(3, 1, 2, 0));
+    __m256i low_packed = _mm256_permute4x64_epi64(
+        _mm256_shuffle_epi8(low32, low16), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(high + i),
+                     _mm256_castsi256_si128(high_packed));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(low + i),
+                     _mm256_castsi256_si128(low_packed));
+  }
+  splitFloat32ToInt31Scalar(src + i, num - i, scale, low + i, high + i);
+}
+#endif
+
+static void splitFloat32ToInt31(const float *src, size_t num, double scale,
+                                int16_t *low, int16_t *high) {
+#if defined(__x86_64__)
+  static const bool use_avx2 = cpuSupportsAvx2();
+  if (use_avx2) {
+    splitFloat32ToInt31Avx2(src, num, scale, low, high);
+    return;
+  }
+#endif
+  splitFloat32ToInt31Scalar(src, num, scale, low, high);
+}
+
+
 mluOpStatus_t castFloat32ToInt31(float *src, size_t num, void *dst) {
   if (src == NULL) {
     LOG(ERROR) << "[castFloat32ToInt31]:The pointer of src is NULL.";
@@ -45,16 +374,9 @@ mluOpStatus_t castFloat32ToInt31(float *src, size_t num, void *dst) {
   }
 
   int position = 0;
-  int var = std::pow(2, INT31_BITWIDTH - 1) - 1;
-  float temp = 0.0f;
-  float temp_high = 0.0f;
-  float temp_low = 0.0f;
 
   // get absmax of the float data
-  float absmax = std::fabs(src[0]);
-  for (size_t i = 0; i < num; ++i) {
-    if (std::fabs(src[i]) > absmax) absmax = std::fabs(src[i]);
-  }
+  float absmax = getAbsMax(src, num);
 
   // Formula: int31 , position = floor(log2(absmax) - 29))
   if (absmax == 0) {
@@ -63,27 +385,17 @@ mluOpStatus_t castFloat32ToInt31(float *src, size_t num, void *dst) {
     position = static_cast<int>(std::floor(std::log2(absmax)) - 29);
   }
 
+  int16_t *low = (int16_t *)dst;
+  int16_t *high = low + num;
   if (absmax == 0) {
-    for (size_t i = 0; i < num; ++i) {
-      // low int16 data
-      ((int16_t *)dst)[i] = 0;
-      // high int16 data
-      ((int16_t *)dst)[i + num] = 0;
-    }
+    // low and high int16 data
+    memset(dst, 0, 2 * num * sizeof(int16_t));
   } else {
-    // Formula: f = (high * 2^15 + low) * 2^position.
-    var = std::pow(2, INT16_BITWIDTH - 1);
-    for (size_t i = 0; i < num; ++i) {
-      temp = src[i] / (std::pow(2, position));
-      temp = (temp >= 0) ? (temp + 0.5f) : (temp - 0.5f);
-
-      // high int16 data
-      temp_high = temp / var;
-      ((int16_t *)dst)[i + num] = static_cast<int16_t>(temp_high);
-      // low int16 data
-      temp_low = temp - ((int16_t *)dst)[i + num] * var;
-      ((int16_t *)dst)[i] = static_cast<int16_t>(temp_low);
-    }
+    const double scale = std::pow(2, position);
+    parallelChunks(num, [&](size_t begin, size_t end, size_t chunk) {
+      splitFloat32ToInt31(src + begin, end - begin, scale, low + begin,
+                          high + begin);
+    });
   }
 
   return MLUOP_STATUS_SUCCESS;
@@ -116,10 +428,7 @@ mluOpStatus_t getPosition(float *input, size_t num, mluOpDataType_t datatype,
   }
 
   // Formula: position = floor(log2(absmax) - (bitwidth - 2)))
-  float absmax = std::fabs(input[0]);
-  for (size_t index = 0; index < num; ++index) {
-    if (std::fabs(input[index]) > absmax) absmax = std::fabs(input[index]);
-  }
+  float absmax = getAbsMax(input, num);
 
   if (absmax == 0) {
     *position = 0;
@@ -163,10 +472,7 @@ mluOpStatus_t getPositionAndScale(float *input, size_t num,
   }
 
   int scale_var = std::pow(2, bitwidth - 1) - 1;
-  float max_data = std::fabs(input[0]);
-  for (size_t index = 0; index < num; ++index) {
-    if (std::fabs(input[index]) > max_data) max_data = std::fabs(input[index]);
-  }
+  float max_data = getAbsMax(input, num);
   if (max_data == 0) {
     *position = 0;
     *scale = 1.0;
@@ -221,10 +527,7 @@ mluOpStatus_t getPositionScaleAndOffset(float *input, size_t num,
   }
   float max_data = input[0];
   float min_data = input[0];
-  for (size_t i = 0; i < num; ++i) {
-    max_data = max_data > input[i] ? max_data : input[i];
-    min_data = min_data < input[i] ? min_data : input[i];
-  }
+  getMinMax(input, num, &min_data, &max_data);
 
   max_data = max_data > 0 ? max_data : 0;
   min_data = min_data < 0 ? min_data : 0;
@@ -264,11 +567,13 @@ mluOpStatus_t castInt31ToFloat32(void *src, float *dst, size_t num,
   // Formula: f = (high * 2^15 + low) * 2^position.
   int16_t *low = (int16_t *)src;
   int16_t *high = (int16_t *)(low + num);
+  const double high_scale = std::pow(2, INT16_BITWIDTH - 1);
+  const double scale = std::pow(2, position);
   float tmp = 0.0f;
   for (size_t i = 0; i < num; i++) {
-    tmp = high[i] * std::pow(2, INT16_BITWIDTH - 1);
+    tmp = high[i] * high_scale;
     tmp = tmp + low[i];
-    dst[i] = tmp * std::pow(2, position);
+    dst[i] = tmp * scale;
   }
 
   return MLUOP_STATUS_SUCCESS;
@@ -309,7 +614,7 @@ int16_t castFloat32ToHalf(float src) {
   } else {
     exp = 0;
     denorm = 1;
-    eff = in ? 1 : 0;
+    eff = (in & 0x7fffffff) ? 1 : 0;
   }
   eff += g;  // round
   exp = (denorm == 1) ? exp : (exp + 15);
@@ -357,6 +662,212 @@ float castHalfToFloat32(int16_t src) {
   }
 }
 
+/*
+ * The array casts below compute castFloat32ToHalf and castHalfToFloat32 lane
+ * by lane. castFloat32ToHalf rounds half away from zero and saturates inf and
+ * nan to +/-65504, which differs from the IEEE conversion of F16C and NEON,
+ * so float32 to half is done with integer instructions:
+ *   biased exp >= 143:        0x7bff
+ *   biased exp in [113, 142]: (abs >> 13) - (112 << 10) + round bit
+ *   biased exp in [103, 112]: (mantissa | 0x800000) >> (126 - exp) + round bit
+ *   otherwise:                abs != 0
+ * and the sign bit is or-ed into the result. Half to float32 is exact for
+ * finite numbers, only inf and nan are patched after the hardware conversion.
+ */
+static void arrayCastFloat32ToHalfScalar(const float *src, int16_t *dst,
+                                         size_t num) {
+  for (size_t i = 0; i < num; ++i) {
+    dst[i] = castFloat32ToHalf(src[i]);
+  }
+}
+
+static void arrayCastHalfToFloat32Scalar(const int16_t *src, float *dst,
+                                         size_t num) {
+  for (size_t i = 0; i < num; ++i) {
+    dst[i] = castHalfToFloat32(src[i]);
+  }
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) static inline __m256i castFloat32ToHalfAvx2(
+    __m256i in) {
+  const __m256i abs = _mm256_and_si256(in, _mm256_set1_epi32(0x7fffffff));
+  const __m256i exp = _mm256_srli_epi32(abs, 23);
+  const __m256i one = _mm256_set1_epi32(1);
+  // normal
+  __m256i normal = _mm256_sub_epi32(_mm256_srli_epi32(abs, 13),
+                                    _mm256_set1_epi32(112 << 10));
+  normal = _mm256_add_epi32(
+      normal, _mm256_and_si256(_mm256_srli_epi32(abs, 12), one));
+  // denormal, the shift of other lanes is out of range and gives 0.
+  const __m256i mant = _mm256_or_si256(
+      _mm256_and_si256(abs, _mm256_set1_epi32(0x7fffff)),
+      _mm256_set1_epi32(0x800000));
+  const __m256i shift = _mm256_sub_epi32(_mm256_set1_epi32(126), exp);
+  __m256i denorm = _mm256_srlv_epi32(mant, shift);
+  denorm = _mm256_add_epi32(
+      denorm, _mm256_and_si256(
+                  _mm256_srlv_epi32(mant, _mm256_sub_epi32(shift, one)), one));
+  // too small to be a denormal half
+  const __m256i tiny =
+      _mm256_andnot_si256(_mm256_cmpeq_epi32(abs, _mm256_setzero_si256()), one);
+
+  __m256i result = tiny;
+  result = _mm256_blendv_epi8(
+      result, denorm, _mm256_cmpgt_epi32(exp, _mm256_set1_epi32(102)));
+  result = _mm256_blendv_epi8(
+      result, normal, _mm256_cmpgt_epi32(exp, _mm256_set1_epi32(112)));
+  result = _mm256_blendv_epi8(result, _mm256_set1_epi32(0x7bff),
+                              _mm256_cmpgt_epi32(exp, _mm256_set1_epi32(142)));
+  const __m256i sign = _mm256_and_si256(_mm256_srli_epi32(in, 16),
+                                        _mm256_set1_epi32(0x8000));
+  return _mm256_or_si256(result, sign);
+}
+
+__attribute__((target("avx2"))) static void arrayCastFloat32ToHalfAvx2(
+    const float *src, int16_t *dst, size_t num) {
+  size_t i = 0;
+  for (; i + 16 <= num; i += 16) {
+    __m256i lo = castFloat32ToHalfAvx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)));
+    __m256i hi = castFloat32ToHalfAvx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 8)));
+    // results are in [0, 0xffff], so the saturation of packus never happens.
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi),
+                                              _MM_SHUFFLE(3, 1, 2, 0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), packed);
+  }
+  arrayCastFloat32ToHalfScalar(src + i, dst + i, num - i);
+}
+
+__attribute__((target("avx2,f16c"))) static void arrayCastHalfToFloat32F16c(
+    const int16_t *src, float *dst, size_t num) {
+  const __m256i exp_mask = _mm256_set1_epi32(0x7c00);
+  const __m256i abs_mask = _mm256_set1_epi32(0x7fff);
+  size_t i = 0;
+  for (; i + 8 <= num; i += 8) {
+    __m128i half =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m256i result = _mm256_castps_si256(_mm256_cvtph_ps(half));
+    __m256i in = _mm256_cvtepu16_epi32(half);
+    __m256i special =
+        _mm256_cmpeq_epi32(_mm256_and_si256(in, exp_mask), exp_mask);
+    if (!_mm256_testz_si256(special, special)) {
+      __m256i sign = _mm256_slli_epi32(
+          _mm256_and_si256(in, _mm256_set1_epi32(0x8000)), 16);
+      // +/-65504 for inf, 0xffffffff for +nan and 0x7fffffff for -nan.
+      __m256i inf = _mm256_or_si256(_mm256_set1_epi32(0x477fe000), sign);
+      __m256i nan = _mm256_xor_si256(_mm256_set1_epi32(-1), sign);
+      __m256i is_nan =
+          _mm256_cmpgt_epi32(_mm256_and_si256(in, abs_mask), exp_mask);
+      result = _mm256_blendv_epi8(result, _mm256_blendv_epi8(inf, nan, is_nan),
+                                  special);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), result);
+  }
+  arrayCastHalfToFloat32Scalar(src + i, dst + i, num - i);
+}
+
+static bool cpuSupportsF16c() {
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  return cpuSupportsAvx2() && __get_cpuid(1, &eax, &ebx, &ecx, &edx) &&
+         (ecx & bit_F16C);
+}
+#elif defined(__aarch64__)
+static inline uint32x4_t castFloat32ToHalfNeon(uint32x4_t in) {
+  const uint32x4_t abs = vandq_u32(in, vdupq_n_u32(0x7fffffff));
+  const uint32x4_t exp = vshrq_n_u32(abs, 23);
+  const uint32x4_t one = vdupq_n_u32(1);
+  uint32x4_t normal =
+      vsubq_u32(vshrq_n_u32(abs, 13), vdupq_n_u32(112 << 10));
+  normal = vaddq_u32(normal, vandq_u32(vshrq_n_u32(abs, 12), one));
+  const uint32x4_t mant = vorrq_u32(vandq_u32(abs, vdupq_n_u32(0x7fffff)),
+                                    vdupq_n_u32(0x800000));
+  // vshlq shifts right by negative counts, out of range counts give 0.
+  const int32x4_t shift =
+      vsubq_s32(vreinterpretq_s32_u32(exp), vdupq_n_s32(126));
+  uint32x4_t denorm = vshlq_u32(mant, shift);
+  denorm = vaddq_u32(
+      denorm, vandq_u32(vshlq_u32(mant, vaddq_s32(shift, vdupq_n_s32(1))),
+                        one));
+  const uint32x4_t tiny = vandq_u32(vtstq_u32(abs, abs), one);
+
+  uint32x4_t result = tiny;
+  result = vbslq_u32(vcgtq_u32(exp, vdupq_n_u32(102)), denorm, result);
+  result = vbslq_u32(vcgtq_u32(exp, vdupq_n_u32(112)), normal, result);
+  result = vbslq_u32(vcgtq_u32(exp, vdupq_n_u32(142)), vdupq_n_u32(0x7bff),
+                     result);
+  const uint32x4_t sign =
+      vandq_u32(vshrq_n_u32(in, 16), vdupq_n_u32(0x8000));
+  return vorrq_u32(result, sign);
+}
+
+static void arrayCastFloat32ToHalfNeon(const float *src, int16_t *dst,
+                                       size_t num) {
+  const uint32_t *in = reinterpret_cast<const uint32_t *>(src);
+  size_t i = 0;
+  for (; i + 8 <= num; i += 8) {
+    uint32x4_t lo = castFloat32ToHalfNeon(vld1q_u32(in + i));
+    uint32x4_t hi = castFloat32ToHalfNeon(vld1q_u32(in + i + 4));
+    uint16x8_t packed = vcombine_u16(vmovn_u32(lo), vmovn_u32(hi));
+    vst1q_s16(dst + i, vreinterpretq_s16_u16(packed));
+  }
+  arrayCastFloat32ToHalfScalar(src + i, dst + i, num - i);
+}
+
+static void arrayCastHalfToFloat32Neon(const int16_t *src, float *dst,
+                                       size_t num) {
+  const uint32x4_t exp_mask = vdupq_n_u32(0x7c00);
+  size_t i = 0;
+  for (; i + 4 <= num; i += 4) {
+    uint16x4_t half = vreinterpret_u16_s16(vld1_s16(src + i));
+    uint32x4_t result = vreinterpretq_u32_f32(
+        vcvt_f32_f16(vreinterpret_f16_u16(half)));
+    uint32x4_t in = vmovl_u16(half);
+    uint32x4_t special = vceqq_u32(vandq_u32(in, exp_mask), exp_mask);
+    if (vmaxvq_u32(special) != 0) {
+      uint32x4_t sign = vshlq_n_u32(vandq_u32(in, vdupq_n_u32(0x8000)), 16);
+      // +/-65504 for inf, 0xffffffff for +nan and 0x7fffffff for -nan.
+      uint32x4_t inf = vorrq_u32(vdupq_n_u32(0x477fe000), sign);
+      uint32x4_t nan = veorq_u32(vdupq_n_u32(0xffffffff), sign);
+      uint32x4_t is_nan =
+          vcgtq_u32(vandq_u32(in, vdupq_n_u32(0x7fff)), exp_mask);
+      result = vbslq_u32(special, vbslq_u32(is_nan, nan, inf), result);
+    }
+    vst1q_f32(dst + i, vreinterpretq_f32_u32(result));
+  }
+  arrayCastHalfToFloat32Scalar(src + i, dst + i, num - i);
+}
+#endif
+
+void arrayCastFloat32ToHalf(const float *src, int16_t *dst, size_t num) {
+#if defined(__x86_64__)
+  static const bool use_avx2 = cpuSupportsAvx2();
+  if (use_avx2) {
+    arrayCastFloat32ToHalfAvx2(src, dst, num);
+    return;
+  }
+#elif defined(__aarch64__)
+  arrayCastFloat32ToHalfNeon(src, dst, num);
+  return;
+#endif
+  arrayCastFloat32ToHalfScalar(src, dst, num);
+}
+
+void arrayCastHalfToFloat32(const int16_t *src, float *dst, size_t num) {
+#if defined(__x86_64__)
+  static const bool use_f16c = cpuSupportsF16c();
+  if (use_f16c) {
+    arrayCastHalfToFloat32F16c(src, dst, num);
+    return;
+  }
+#elif defined(__aarch64__)
+  arrayCastHalfToFloat32Neon(src, dst, num);
+  return;
+#endif
+  arrayCastHalfToFloat32Scalar(src, dst, num);
+}
+
 int mkdirIfNotExist(const char *pathname) {
   struct stat dir_stat = {};
   if (stat(pathname, &dir_stat) != 0) {
@@ -79,6 +79,34 @@ mluOpStatus_t castInt31ToFloat32(void *src, float *dst, size_t num,
 
 int16_t castFloat32ToHalf(float src);
 float castHalfToFloat32(int16_t src);
+
+/**
+ * @brief Casts an array of float32 data to half. Every element is converted
+ *        the same as castFloat32ToHalf, with AVX2 on x86_64 CPUs that support
+ *        it and NEON on aarch64.
+ *
+ * @param[in] src
+ *   Input. Pointer to float32 data.
+ * @param[out] dst
+ *   Output. Pointer to half data, it must not overlap with src.
+ * @param[in] num
+ *   Input. The number of elements.
+ */
+void arrayCastFloat32ToHalf(const float *src, int16_t *dst, size_t num);
+
+/**
+ * @brief Casts an array of half data to float32. Every element is converted
+ *        the same as castHalfToFloat32, with F16C on x86_64 CPUs that support
+ *        it and NEON on aarch64.
+ *
+ * @param[in] src
+ *   Input. Pointer to half data.
+ * @param[out] dst
+ *   Output. Pointer to float32 data, it must not overlap with src.
+ * @param[in] num
+ *   Input. The number of elements.
+ */
+void arrayCastHalfToFloat32(const int16_t *src, float *dst, size_t num);
 size_t getMemorySize(const void *ptr);
 mluOpStatus_t checkMemorySize(mluOpTensorDescriptor_t tensor, const void *ptr);
 
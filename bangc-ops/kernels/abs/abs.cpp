@@ -23,6 +23,8 @@
 #include "core/context.h"
 #include "core/gen_case.h"
 #include "core/logging.h"
+#include "core/runtime/chunked_launch.h"
+#include "core/runtime/cost_model.h"
 #include "core/runtime/device.h"
 #include "core/tensor.h"
 #include "core/type.h"
@@ -49,6 +51,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpAbs(mluOpHandle_t handle,
                                      const void *x,
                                      const mluOpTensorDescriptor_t y_desc,
                                      void *y) {
+  MLUOP_PROFILE_OP("mluOpAbs");
   mluOpDataType_t support_type[2] = {MLUOP_DTYPE_HALF, MLUOP_DTYPE_FLOAT};
   bool zero_element = false;
   mluOpStatus_t param_check =
@@ -61,6 +64,9 @@ mluOpStatus_t MLUOP_WIN_API mluOpAbs(mluOpHandle_t handle,
     return param_check;
   }
 
+  MLUOP_PROFILE_TENSOR(x_desc);
+  MLUOP_PROFILE_TENSOR(y_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("abs");
     GEN_CASE_HANDLE(handle);
@@ -68,13 +74,15 @@ mluOpStatus_t MLUOP_WIN_API mluOpAbs(mluOpHandle_t handle,
     GEN_CASE_DATA(false, "y", y, y_desc, 0, 0);
     GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
   }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
 
   // Choose the best task dimension.
   cnrtDim3_t k_dim;
   cnrtFunctionType_t k_type;
   policyFunc(handle, x_desc, &k_dim, &k_type);
 
-  int element_num = mluOpGetTensorElementNum(x_desc);
+  int64_t element_num = mluOpGetTensorElementNum(x_desc);
+  size_t dtype_size = getSizeOfDataType(x_desc->dtype);
   void (*mluOpBlockKernelUnary)(cnrtDim3_t k_dim, cnrtFunctionType_t k_type,
                                 cnrtQueue_t queue, const void *x, void *y,
                                 int num);
@@ -86,8 +94,27 @@ mluOpStatus_t MLUOP_WIN_API mluOpAbs(mluOpHandle_t handle,
     VLOG(5) << "kernel mluOpBlockKernel3StagePipelineAbsFloatFast";
     mluOpBlockKernelUnary = mluOpBlockKernel3StagePipelineAbsFloatFast;
   }
-  KERNEL_CHECK(
-      (mluOpBlockKernelUnary(k_dim, k_type, handle->queue, x, y, element_num)));
+  auto launch = [&](int64_t offset, int64_t num) {
+    KERNEL_CHECK((mluOpBlockKernelUnary(
+        k_dim, k_type, handle->queue,
+        mluop::runtime::elementOffset(x, offset, dtype_size),
+        mluop::runtime::elementOffset(y, offset, dtype_size), num)));
+    return MLUOP_STATUS_SUCCESS;
+  };
+  CHECK_RETURN("[mluOpAbs]", mluop::runtime::launchInChunks(
+                                 element_num, LAUNCH_CHUNK_MAX_NUM, launch));
   GEN_CASE_END();
   return MLUOP_STATUS_SUCCESS;
 }
+
+// One op per element of x.
+static mluOpStatus_t costAbs(mluOpHandle_t handle,
+                             const mluOpTensorDescriptor_t *descs,
+                             int desc_num, mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  mluop::runtime::setElementwiseCost(descs, desc_num,
+                                     descs[0]->total_element_num, 1, cost);
+  policyFunc(handle, descs[0], &cost->k_dim, &cost->k_type);
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("abs", 2, costAbs);
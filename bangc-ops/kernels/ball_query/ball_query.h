@@ -29,4 +29,31 @@ __mlu_global__ void MLUUnion1KernelBallQuery(
     const int b, const int n, const int m, const float min_radius,
     const float max_radius, const int nsample, const T *new_xyz, const T *xyz,
     int32_t *idx);
+
+// The grid query folds the cells of the points into 2^grid_bits buckets per
+// axis, see ball_query_grid.mlu.
+#define BALL_QUERY_GRID_MIN_BITS 2
+#define BALL_QUERY_GRID_MAX_BITS 5
+// the first nsample indices of a query are kept in NRAM.
+#define BALL_QUERY_GRID_MAX_NSAMPLE 4096
+
+template <typename T>
+__mlu_global__ void MLUBlockKernelBallQueryGridCount(
+    const int b, const int n, const float cell_size, const int grid_bits,
+    const T *xyz, int32_t *point_bucket, int32_t *bucket_start);
+
+template <typename T>
+__mlu_global__ void MLUBlockKernelBallQueryGridScatter(
+    const int b, const int n, const int grid_bits, const int window_num,
+    const T *xyz, const int32_t *point_bucket, const int32_t *bucket_start,
+    T *sorted_xyz, int32_t *sorted_index);
+
+template <typename T>
+__mlu_global__ void MLUUnion1KernelBallQueryGrid(
+    const int b, const int m, const int n, const float min_radius,
+    const float max_radius, const int nsample, const int grid_bits,
+    const T *query_xyz, const int32_t *query_index,
+    const int32_t *query_bucket_start, const T *point_xyz,
+    const int32_t *point_index, const int32_t *point_bucket_start,
+    int32_t *idx);
 #endif  // KERNEL_BALL_QUERY_BALL_QUERY_H
@@ -24,6 +24,7 @@
 #define KERNELS_BINARY_OP_BINARY_OP_3PIPELINE_H_
 
 #include "kernels/kernel.h"
+#include "mlu_op_kernel.h"
 #define BINARY_ALIGN_NUM 64
 
 #define BINARY_OP_3PIPELINE_DECLARE(Op, Dtype, Prefer)                 \
@@ -49,6 +50,26 @@
         (Dtype *)nram_aux3, nram_limit, pong_x, pong_y, data_num);        \
   }
 
+#define BINARY_OP_BROADCAST_3PIPELINE_IMPLE(Op, Dtype, Prefer)              \
+  __mlu_global__ void                                                       \
+      MLUBlockKernel3StagePipelineBroadcast##Op##Dtype##Prefer(             \
+          void *x, void *y, void *z, mluOpBinaryBroadcastPlan_t plan) {     \
+    int32_t nram_limit = 0;                                                 \
+    int32_t pong_x = 0;                                                     \
+    int32_t pong_y = 0;                                                     \
+    Dtype *nram_x = NULL;                                                   \
+    Dtype *nram_y = NULL;                                                   \
+    Dtype *nram_aux1 = NULL;                                                \
+    Dtype *nram_aux2 = NULL;                                                \
+    Dtype *nram_aux3 = NULL;                                                \
+    get3Offset##Op##Prefer(nram_limit, pong_x, pong_y, nram_x, nram_y,      \
+                           nram_aux1, nram_aux2, nram_aux3, nram_buffer);   \
+    processBinaryBroadcastPipe3<Dtype, compute##Op##Prefer>(                \
+        (Dtype *)x, (Dtype *)y, (Dtype *)z, plan, (Dtype *)nram_x,          \
+        (Dtype *)nram_y, (Dtype *)nram_aux1, (Dtype *)nram_aux2,            \
+        (Dtype *)nram_aux3, nram_limit, pong_x, pong_y);                    \
+  }
+
 template <typename Dtype, void (*OpFunc)(Dtype *, Dtype *, Dtype *, Dtype *,
                                          Dtype *, int32_t, int32_t)>
 __mlu_func__ void processBinaryPipe3(const Dtype *x, const Dtype *y, Dtype *z,
@@ -160,4 +181,175 @@ __mlu_func__ void processBinaryPipe3(const Dtype *x, const Dtype *y, Dtype *z,
   }
 }
 
+// Loads the elements `begin` to `begin + num` of z, in the order of z, of the
+// input with `strides` in `plan`. Every piece of a row of z is one copy, a
+// broadcast row repeats one element, and full rows of a plain input are
+// gathered by one strided copy.
+template <typename T>
+__mlu_func__ void broadcastLoad(T *nram, const T *base, const int32_t *strides,
+                                const mluOpBinaryBroadcastPlan_t &plan,
+                                int32_t begin, int32_t num) {
+  const int32_t last = plan.dim - 1;
+  int32_t index[MLUOP_BINARY_BROADCAST_MAX_DIM];
+  int32_t offset = 0;
+  for (int32_t i = last; i >= 0; --i) {
+    index[i] = begin % plan.dims[i];
+    begin /= plan.dims[i];
+    offset += index[i] * strides[i];
+  }
+  const int32_t row = plan.dims[last];
+  while (num > 0) {
+    int32_t row_num = 1;
+    int32_t cur_num = row - index[last];
+    if (cur_num > num) {
+      cur_num = num;
+    }
+    if (strides[last] == 0) {
+      __memcpy_async(nram, base + offset, sizeof(T), GDRAM2NRAM, sizeof(T), 0,
+                     cur_num - 1);
+    } else if (index[last] == 0 && last > 0 && num >= 2 * row) {
+      row_num = num / row;
+      if (row_num > plan.dims[last - 1] - index[last - 1]) {
+        row_num = plan.dims[last - 1] - index[last - 1];
+      }
+      cur_num = row_num * row;
+      __memcpy_async(nram, base + offset, row * sizeof(T), GDRAM2NRAM,
+                     row * sizeof(T), strides[last - 1] * sizeof(T),
+                     row_num - 1);
+    } else {
+      __memcpy_async(nram, base + offset, cur_num * sizeof(T), GDRAM2NRAM);
+    }
+    nram += cur_num;
+    num -= cur_num;
+    if (num == 0) {
+      break;
+    }
+    // move to the first element of the row after the last one loaded.
+    offset -= index[last] * strides[last];
+    index[last] = 0;
+    for (int32_t r = 0; r < row_num; ++r) {
+      for (int32_t i = last - 1; i >= 0; --i) {
+        offset += strides[i];
+        if (++index[i] < plan.dims[i]) {
+          break;
+        }
+        offset -= index[i] * strides[i];
+        index[i] = 0;
+      }
+    }
+  }
+}
+
+// processBinaryPipe3 with x and y broadcast to z by `plan`. z is split by
+// cores and tiles as in processBinaryPipe3, x and y tiles are gathered by
+// broadcastLoad, so the broadcast inputs are never materialised in GDRAM.
+template <typename Dtype, void (*OpFunc)(Dtype *, Dtype *, Dtype *, Dtype *,
+                                         Dtype *, int32_t, int32_t)>
+__mlu_func__ void processBinaryBroadcastPipe3(
+    const Dtype *x, const Dtype *y, Dtype *z,
+    const mluOpBinaryBroadcastPlan_t &plan, Dtype *nram_x, Dtype *nram_y,
+    Dtype *nram_aux1, Dtype *nram_aux2, Dtype *nram_aux3,
+    const int32_t nram_limit, const int32_t pong_x, const int32_t pong_y) {
+  if (coreId == 0x80) {
+    return;
+  }
+  int32_t data_num = 1;
+  for (int32_t i = 0; i < plan.dim; ++i) {
+    data_num *= plan.dims[i];
+  }
+  // split data by cores
+  int32_t num_per_core = data_num / taskDim;
+  int32_t rem_for_all = data_num % taskDim;
+  const int32_t core_begin = taskId * num_per_core;
+  Dtype *base_addr_z = z + core_begin;
+  if (rem_for_all > 0 && taskId == (taskDim - 1)) {
+    num_per_core = num_per_core + rem_for_all;
+  }
+
+  int32_t repeat = num_per_core / nram_limit;
+  int32_t rem = num_per_core % nram_limit;
+  int32_t align_rem = CEIL_ALIGN(rem, BINARY_ALIGN_NUM);
+
+  int32_t span_handle_size = nram_limit * sizeof(Dtype);
+  int32_t rem_size = rem * sizeof(Dtype);
+
+  if (repeat > 0) {
+    // L
+    broadcastLoad(nram_x, x, plan.x_strides, plan, core_begin, nram_limit);
+    broadcastLoad(nram_y, y, plan.y_strides, plan, core_begin, nram_limit);
+    __asm__ volatile("sync;");
+  }
+  if (repeat > 1) {
+    // L
+    broadcastLoad(nram_x + pong_x, x, plan.x_strides, plan,
+                  core_begin + nram_limit, nram_limit);
+    broadcastLoad(nram_y + pong_y, y, plan.y_strides, plan,
+                  core_begin + nram_limit, nram_limit);
+    // C
+    OpFunc(nram_x, nram_y, nram_aux1, nram_aux2, nram_aux3, nram_limit,
+           nram_limit);
+    __asm__ volatile("sync;");
+  }
+
+  for (int32_t i = 0; i < repeat - 2; i++) {
+    // S
+    pvLock();
+    __memcpy_async(base_addr_z + i * nram_limit, nram_x + (i % 2) * pong_x,
+                   span_handle_size, NRAM2GDRAM);
+    pvUnlock();
+    // L
+    broadcastLoad(nram_x + (i % 2) * pong_x, x, plan.x_strides, plan,
+                  core_begin + (i + 2) * nram_limit, nram_limit);
+    broadcastLoad(nram_y + (i % 2) * pong_y, y, plan.y_strides, plan,
+                  core_begin + (i + 2) * nram_limit, nram_limit);
+    // C
+    OpFunc(nram_x + ((i + 1) % 2) * pong_x, nram_y + ((i + 1) % 2) * pong_y,
+           nram_aux1, nram_aux2, nram_aux3, nram_limit, nram_limit);
+    __asm__ volatile("sync;");
+  }
+
+  if (repeat >= 2) {
+    // S
+    pvLock();
+    __memcpy_async(base_addr_z + (repeat - 2) * nram_limit,
+                   nram_x + (repeat % 2) * pong_x, span_handle_size,
+                   NRAM2GDRAM);
+    pvUnlock();
+  }
+  if (rem > 0) {
+    // L
+    broadcastLoad(nram_x + (repeat % 2) * pong_x, x, plan.x_strides, plan,
+                  core_begin + repeat * nram_limit, rem);
+    broadcastLoad(nram_y + (repeat % 2) * pong_y, y, plan.y_strides, plan,
+                  core_begin + repeat * nram_limit, rem);
+  }
+  if (repeat > 0) {
+    // C
+    OpFunc(nram_x + ((repeat - 1) % 2) * pong_x,
+           nram_y + ((repeat - 1) % 2) * pong_y, nram_aux1, nram_aux2,
+           nram_aux3, nram_limit, nram_limit);
+  }
+  __asm__ volatile("sync;");
+
+  if (repeat > 0) {
+    // S
+    pvLock();
+    __memcpy_async(base_addr_z + (repeat - 1) * nram_limit,
+                   nram_x + ((repeat - 1) % 2) * pong_x, span_handle_size,
+                   NRAM2GDRAM);
+    pvUnlock();
+  }
+  if (rem > 0) {
+    // C
+    OpFunc(nram_x + (repeat % 2) * pong_x, nram_y + (repeat % 2) * pong_y,
+           nram_aux1, nram_aux2, nram_aux3, rem, align_rem);
+    __asm__ volatile("sync;");
+    // S
+    pvLock();
+    __memcpy_async(base_addr_z + repeat * nram_limit,
+                   nram_x + (repeat % 2) * pong_x, rem_size, NRAM2GDRAM);
+    pvUnlock();
+  }
+}
+
 #endif  // KERNELS_BINARY_OP_BINARY_OP_3PIPELINE_H_
@@ -25,6 +25,7 @@
 #include "kernels/kernel.h"
 #include "core/tensor.h"
 #include "core/type.h"
+#include "core/broadcast_plan.h"
 #include "core/context.h"
 #include "core/logging.h"
 #include "core/runtime/device.h"
@@ -39,10 +40,10 @@ void binaryOpPolicyFunc(const mluOpHandle_t &handle,
   int core_dim = handle->core_num_per_cluster;
   int core_number = union_number * core_dim;
 
-  int element_num = mluOpGetTensorElementNum(desc);
-  int size =
+  uint64_t element_num = mluOpGetTensorElementNum(desc);
+  uint64_t size =
       CEIL_ALIGN(element_num * getSizeOfDataType(desc->dtype), align_param);
-  int core_used = CEIL_ALIGN(size / align_param, core_dim);
+  uint64_t core_used = CEIL_ALIGN(size / align_param, core_dim);
   core_used = core_used > core_number ? core_number : core_used;
 
   *k_type = CNRT_FUNC_TYPE_UNION1;  // default func type
@@ -67,7 +68,8 @@ mluOpStatus_t binaryOpParamCheck(
     const mluOpTensorDescriptor_t &input1_desc, const void *input1,
     const mluOpTensorDescriptor_t &input2_desc, const void *input2,
     const mluOpTensorDescriptor_t &output_desc, const void *output,
-    const mluOpDataType_t support_type[], const int &len, bool &zero_element) {
+    const mluOpDataType_t support_type[], const int &len, bool &zero_element,
+    const bool broadcast) {
   // check descriptor
   PARAM_CHECK(op_name, handle != NULL);
   PARAM_CHECK(op_name, input1_desc != NULL);
@@ -84,16 +86,37 @@ mluOpStatus_t binaryOpParamCheck(
   PARAM_CHECK_LE(op_name, output_desc->dim, MLUOP_DIM_MAX);
 
   // check dims
-  for (int i = 0; i < input1_desc->dim; ++i) {
-    if (input1_desc->dims[i] != input2_desc->dims[i]) {
-      LOG(ERROR) << op_name << ":Check failed: input1_desc->dims[" << i
-                 << "] should be equal to input2_desc->dims[" << i << "].";
+  if (broadcast) {
+    int dim = 0;
+    int64_t dims[MLUOP_DIM_MAX];
+    if (!mluop::getBroadcastShape(input1_desc->dim, input1_desc->dims_int64,
+                                  input2_desc->dim, input2_desc->dims_int64,
+                                  &dim, dims)) {
+      LOG(ERROR) << op_name << ":Check failed: input1_desc and input2_desc "
+                 << "can not be broadcast.";
       return MLUOP_STATUS_BAD_PARAM;
     }
-    if (input1_desc->dims[i] != output_desc->dims[i]) {
-      LOG(ERROR) << op_name << ":Check failed: input1_desc->dims[" << i
-                 << "] should be equal to output_desc->dims[" << i << "].";
-      return MLUOP_STATUS_BAD_PARAM;
+    PARAM_CHECK_EQ(op_name, output_desc->dim, dim);
+    for (int i = 0; i < dim; ++i) {
+      if (output_desc->dims_int64[i] != dims[i]) {
+        LOG(ERROR) << op_name << ":Check failed: output_desc->dims[" << i
+                   << "] should be equal to the broadcast dim " << dims[i]
+                   << ".";
+        return MLUOP_STATUS_BAD_PARAM;
+      }
+    }
+  } else {
+    for (int i = 0; i < input1_desc->dim; ++i) {
+      if (input1_desc->dims_int64[i] != input2_desc->dims_int64[i]) {
+        LOG(ERROR) << op_name << ":Check failed: input1_desc->dims[" << i
+                   << "] should be equal to input2_desc->dims[" << i << "].";
+        return MLUOP_STATUS_BAD_PARAM;
+      }
+      if (input1_desc->dims_int64[i] != output_desc->dims_int64[i]) {
+        LOG(ERROR) << op_name << ":Check failed: input1_desc->dims[" << i
+                   << "] should be equal to output_desc->dims[" << i << "].";
+        return MLUOP_STATUS_BAD_PARAM;
+      }
     }
   }
 
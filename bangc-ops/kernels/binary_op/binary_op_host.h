@@ -35,11 +35,14 @@ void binaryOpPolicyFunc(const mluOpHandle_t &handle,
 /* user param check
  * step1:check desc and data ptr is not nullptr_t
  * step2:check shape and data type
+ * with `broadcast`, input1 and input2 may be of any NumPy broadcastable shapes
+ * and output should be of the broadcast shape, otherwise all shapes are equal.
  * */
 mluOpStatus_t binaryOpParamCheck(
     const std::string &op_name, const mluOpHandle_t &handle,
     const mluOpTensorDescriptor_t &input1_desc, const void *input1,
     const mluOpTensorDescriptor_t &input2_desc, const void *input2,
     const mluOpTensorDescriptor_t &output_desc, const void *output,
-    const mluOpDataType_t support_type[], const int &len, bool &zero_element);
+    const mluOpDataType_t support_type[], const int &len, bool &zero_element,
+    const bool broadcast = false);
 #endif  //  KERNELS_BINARY_OP_BINARY_OP_HOST_H_
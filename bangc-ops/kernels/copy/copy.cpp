@@ -20,14 +20,18 @@
  * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  *************************************************************************/
+#include <algorithm>
 #include <string>
 
 #include "core/gen_case.h"
 #include "core/logging.h"
+#include "core/runtime/chunked_launch.h"
+#include "core/runtime/cost_model.h"
 #include "core/runtime/device.h"
 #include "core/tensor.h"
 #include "core/type.h"
 #include "copy_mlu.h"
+#include "kernels/copy/copy_with_cast_host.h"
 #include "kernels/tensor_stride_process/tensor_stride_process.h"
 
 // According to test, the threshold is about 4KB.
@@ -60,11 +64,11 @@ static mluOpStatus_t policyFunc(mluOpHandle_t handle, cnrtDim3_t *k_dim,
 static size_t shapeStrideCount(const mluOpTensorDescriptor_t desc) {
   size_t total = 1;
   for (int i = 0; i < desc->dim; ++i) {
-    if (desc->dims[i] == 0) {
+    if (desc->dims_int64[i] == 0) {
       total = 0;
       break;
     }
-    total += (desc->dims[i] - 1) * desc->strides[i];
+    total += (desc->dims_int64[i] - 1) * desc->strides_int64[i];
   }
   return total;
 }
@@ -87,6 +91,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpCopy(mluOpHandle_t handle,
                                       const void *input,
                                       const mluOpTensorDescriptor_t output_desc,
                                       void *output) {
+  MLUOP_PROFILE_OP("mluOpCopy");
   PARAM_CHECK("[mluOpCopy]", handle != NULL);
   PARAM_CHECK("[mluOpCopy]", input_desc != NULL);
   PARAM_CHECK("[mluOpCopy]", output_desc != NULL);
@@ -106,8 +111,6 @@ mluOpStatus_t MLUOP_WIN_API mluOpCopy(mluOpHandle_t handle,
                       "input tensor size is too large. ");
     TENSOR_SIZE_CHECK("[mluOpCopy]", size_output, LARGE_TENSOR_SIZE,
                       "output tensor size is too large. ");
-  } else {
-    TENSOR_NUM_CHECK("[mluOpCopy]", num_input, LARGE_TENSOR_NUM, "");
   }
   if (num_input != num_output) {
     LOG(ERROR) << "[mluOpCopy] the size of input should be the same as output"
@@ -131,6 +134,9 @@ mluOpStatus_t MLUOP_WIN_API mluOpCopy(mluOpHandle_t handle,
   total_num = num_input * kDTypeSize;
 
   // generate copy prototxt start!
+  MLUOP_PROFILE_TENSOR(input_desc);
+  MLUOP_PROFILE_TENSOR(output_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("copy");
     GEN_CASE_HANDLE(handle);
@@ -144,6 +150,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpCopy(mluOpHandle_t handle,
       GEN_CASE_TEST_PARAM_NEW(false, false, true, 0, 0, 0);
     }
   }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
   // generate copy prototxt end!
 
   // dimxyz policy
@@ -154,11 +161,11 @@ mluOpStatus_t MLUOP_WIN_API mluOpCopy(mluOpHandle_t handle,
   policyFunc(handle, &k_dim, &k_type, total_num);
 
   if (stride_kernel) {
-    PARAM_CHECK("[mluOpCopy]", input_desc->dim <= MLUOP_DIM_MAX);
     TensorShape input_shape;
     TensorShape output_shape;
-    getTensorShape(input_desc, &input_shape);
-    getTensorShape(output_desc, &output_shape);
+    CHECK_RETURN("[mluOpCopy]",
+                 getCopyTensorShape(input_desc, output_desc, &input_shape,
+                                    &output_shape));
     VLOG(5) << "Launch Kernel mluOpUnion1KernelCopyWithStride <<<Union1"
             << ", Dim3{" << k_dim.x << ", " << k_dim.y << ", " << k_dim.z
             << "} >>>";
@@ -194,10 +201,172 @@ mluOpStatus_t MLUOP_WIN_API mluOpCopy(mluOpHandle_t handle,
     VLOG(5) << "Launch Kernel mluOpUnion1KernelCopy <<<Union1"
             << ", Dim3{" << k_dim.x << ", " << k_dim.y << ", " << k_dim.z
             << "} >>>";
-    KERNEL_CHECK((mluOpUnion1KernelCopy(k_dim, k_type, handle->queue, input,
-                                        output, num_input, kDTypeSize)));
+    // tensors with 2^31 or more elements are copied by several launches.
+    auto launch = [&](int64_t offset, int64_t num) {
+      KERNEL_CHECK((mluOpUnion1KernelCopy(
+          k_dim, k_type, handle->queue,
+          mluop::runtime::elementOffset(input, offset, kDTypeSize),
+          mluop::runtime::elementOffset(output, offset, kDTypeSize), num,
+          kDTypeSize)));
+      return MLUOP_STATUS_SUCCESS;
+    };
+    CHECK_RETURN("[mluOpCopy]", mluop::runtime::launchInChunks(
+                                    num_input, LAUNCH_CHUNK_MAX_NUM, launch));
   }
 
   GEN_CASE_END();
   return MLUOP_STATUS_SUCCESS;
 }
+
+// The shape of `num` contiguous elements, as filled by getTensorShape.
+static void getContiguousShape(const int64_t num, TensorShape *shape) {
+  for (int i = 0; i < MLUOP_DIM_MAX; ++i) {
+    shape->tensor_dims[i] = 1;
+    shape->tensor_strides[i] = 0;
+  }
+  shape->tensor_dims[MLUOP_DIM_MAX - 1] = num;
+  shape->tensor_strides[MLUOP_DIM_MAX - 1] = 1;
+  shape->total_num = num;
+  shape->is_contiguous = true;
+}
+
+/* The API for mluOpCopyWithCast. This operator copies a tensor to a tensor of
+ *  another data type, converting every element on the way. Tensors of the same
+ *  data type are copied by mluOpCopy. Strided tensors are gathered and
+ *  scattered by the cast kernel itself, so the cast takes one pass over
+ *  memory whatever the layouts.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpCopyWithCast(
+    mluOpHandle_t handle, const mluOpTensorDescriptor_t input_desc,
+    const void *input, const mluOpTensorDescriptor_t output_desc,
+    void *output) {
+  PARAM_CHECK("[mluOpCopyWithCast]", handle != NULL);
+  PARAM_CHECK("[mluOpCopyWithCast]", input_desc != NULL);
+  PARAM_CHECK("[mluOpCopyWithCast]", output_desc != NULL);
+  if (input_desc->dtype == output_desc->dtype) {
+    VLOG(5) << "[mluOpCopyWithCast] same data type, call mluOpCopy.";
+    return mluOpCopy(handle, input_desc, input, output_desc, output);
+  }
+  MLUOP_PROFILE_OP("mluOpCopyWithCast");
+  if (!copyWithCastIsSupported(input_desc->dtype, output_desc->dtype)) {
+    LOG(ERROR) << "[mluOpCopyWithCast] casting "
+               << getNameOfDataType(input_desc->dtype) << " to "
+               << getNameOfDataType(output_desc->dtype)
+               << " is not supported.";
+    return MLUOP_STATUS_BAD_PARAM;
+  }
+  if (handle->arch < MLUOP_MLU370) {
+    LOG(ERROR) << "[mluOpCopyWithCast] only supports MLU300 series and above.";
+    return MLUOP_STATUS_ARCH_MISMATCH;
+  }
+  const size_t num_input = mluOpGetTensorElementNum(input_desc);
+  const size_t num_output = mluOpGetTensorElementNum(output_desc);
+  if (num_input != num_output) {
+    LOG(ERROR) << "[mluOpCopyWithCast] the size of input should be the same "
+               << "as output. But now the size of input is " << num_input
+               << ", and the size of output is " << num_output << ".";
+    return MLUOP_STATUS_BAD_PARAM;
+  }
+  if (num_input == 0) {
+    VLOG(5) << "mluOpCopyWithCast skip zero element tensor.";
+    return MLUOP_STATUS_SUCCESS;
+  }
+  const bool stride_kernel =
+      strideCaseWithNotConsistentDense(2, input_desc, output_desc);
+  if (stride_kernel) {
+    TENSOR_SIZE_CHECK(
+        "[mluOpCopyWithCast]",
+        shapeStrideCount(input_desc) * getSizeOfDataType(input_desc->dtype),
+        LARGE_TENSOR_SIZE, "input tensor size is too large. ");
+    TENSOR_SIZE_CHECK(
+        "[mluOpCopyWithCast]",
+        shapeStrideCount(output_desc) * getSizeOfDataType(output_desc->dtype),
+        LARGE_TENSOR_SIZE, "output tensor size is too large. ");
+  }
+  PARAM_CHECK("[mluOpCopyWithCast]", input != NULL);
+  PARAM_CHECK("[mluOpCopyWithCast]", output != NULL);
+
+  const bool exact =
+      copyWithCastIsExact(input_desc->dtype, output_desc->dtype);
+  MLUOP_PROFILE_TENSOR(input_desc);
+  MLUOP_PROFILE_TENSOR(output_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
+  if (MLUOP_GEN_CASE_ON_NEW) {
+    GEN_CASE_START("copy_with_cast");
+    GEN_CASE_HANDLE(handle);
+    GEN_CASE_DATA(true, "input", input, input_desc, 100, 0);
+    GEN_CASE_DATA(false, "output", output, output_desc, 0, 0);
+    if (exact) {
+      GEN_CASE_TEST_PARAM_NEW(false, false, true, 0, 0, 0);
+    } else {
+      GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
+    }
+  }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
+
+  cnrtFunctionType_t k_type = CNRT_FUNC_TYPE_BLOCK;
+  cnrtDim3_t k_dim;
+  const size_t dtype_size =
+      std::max(getSizeOfDataType(input_desc->dtype),
+               getSizeOfDataType(output_desc->dtype));
+  policyFunc(handle, &k_dim, &k_type, num_input * dtype_size);
+  VLOG(5) << "Launch Kernel mluOpUnion1KernelCopyWithCast <<<Union1"
+          << ", Dim3{" << k_dim.x << ", " << k_dim.y << ", " << k_dim.z
+          << "} >>>";
+  if (stride_kernel) {
+    TensorShape input_shape;
+    TensorShape output_shape;
+    CHECK_RETURN("[mluOpCopyWithCast]",
+                 getCopyTensorShape(input_desc, output_desc, &input_shape,
+                                    &output_shape));
+    KERNEL_CHECK((mluOpUnion1KernelCopyWithCast(
+        k_dim, k_type, handle->queue, input, input_shape, input_desc->dtype,
+        output, output_shape, output_desc->dtype, handle->round_mode)));
+  } else {
+    // tensors with 2^31 or more elements are cast by several launches.
+    auto launch = [&](int64_t offset, int64_t num) {
+      TensorShape shape;
+      getContiguousShape(num, &shape);
+      KERNEL_CHECK((mluOpUnion1KernelCopyWithCast(
+          k_dim, k_type, handle->queue,
+          mluop::runtime::elementOffset(input, offset,
+                                        getSizeOfDataType(input_desc->dtype)),
+          shape, input_desc->dtype,
+          mluop::runtime::elementOffset(output, offset,
+                                        getSizeOfDataType(output_desc->dtype)),
+          shape, output_desc->dtype, handle->round_mode)));
+      return MLUOP_STATUS_SUCCESS;
+    };
+    CHECK_RETURN("[mluOpCopyWithCast]",
+                 mluop::runtime::launchInChunks(num_input,
+                                                LAUNCH_CHUNK_MAX_NUM, launch));
+  }
+  GEN_CASE_END();
+  return MLUOP_STATUS_SUCCESS;
+}
+
+// One op per element, strided copies take a single launch.
+static mluOpStatus_t costCopy(mluOpHandle_t handle,
+                              const mluOpTensorDescriptor_t *descs,
+                              int desc_num, mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[1] != NULL);
+  const int64_t num_input = descs[0]->total_element_num;
+  mluop::runtime::setElementwiseCost(descs, desc_num, num_input, 1, cost);
+  if (strideCaseWithNotConsistentDense(2, descs[0], descs[1])) {
+    cost->kernel_num = num_input > 0 ? 1 : 0;
+  }
+  policyFunc(handle, &cost->k_dim, &cost->k_type,
+             num_input * getSizeOfDataType(descs[0]->dtype));
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("copy", 2, costCopy);
+
+// One conversion per element, launched as copy.
+static mluOpStatus_t costCopyWithCast(mluOpHandle_t handle,
+                                      const mluOpTensorDescriptor_t *descs,
+                                      int desc_num,
+                                      mluop::runtime::OpCost *cost) {
+  return costCopy(handle, descs, desc_num, cost);
+}
+MLUOP_REGISTER_OP_COST("copy_with_cast", 2, costCopyWithCast);
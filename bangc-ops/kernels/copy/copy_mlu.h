@@ -39,4 +39,10 @@ void MLUOP_WIN_API mluOpUnion1KernelCopyWithStride(
     TensorShape output_shape, const size_t num_element, const int dtype_size,
     const bool use_SMC);
 
+void MLUOP_WIN_API mluOpUnion1KernelCopyWithCast(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const void *input, TensorShape input_shape, mluOpDataType_t input_dtype,
+    void *output, TensorShape output_shape, mluOpDataType_t output_dtype,
+    const int round_mode);
+
 #endif  // KERNELS_COPY_COPY_MLU_H_
@@ -0,0 +1,71 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "kernels/copy/copy_with_cast_host.h"
+
+#include "mlu_op.h"
+
+// The dtypes converted by mluOpCopyWithCast, every pair of different dtypes
+// is supported. `mantissa` is the number of significant bits of the dtype,
+// a conversion is exact when the destination holds at least as many bits and
+// the source range.
+struct CopyCastType {
+  mluOpDataType_t dtype;
+  int mantissa;
+  bool is_integer;
+};
+
+static const CopyCastType copy_cast_table[] = {
+    {MLUOP_DTYPE_INT8, 7, true},   {MLUOP_DTYPE_INT16, 15, true},
+    {MLUOP_DTYPE_INT32, 31, true}, {MLUOP_DTYPE_HALF, 11, false},
+    {MLUOP_DTYPE_FLOAT, 24, false},
+};
+
+static const CopyCastType *findCopyCastType(const mluOpDataType_t dtype) {
+  for (const CopyCastType &type : copy_cast_table) {
+    if (type.dtype == dtype) {
+      return &type;
+    }
+  }
+  return nullptr;
+}
+
+bool copyWithCastIsSupported(const mluOpDataType_t src_dtype,
+                             const mluOpDataType_t dst_dtype) {
+  return findCopyCastType(src_dtype) != nullptr &&
+         findCopyCastType(dst_dtype) != nullptr;
+}
+
+bool copyWithCastIsExact(const mluOpDataType_t src_dtype,
+                         const mluOpDataType_t dst_dtype) {
+  const CopyCastType *src = findCopyCastType(src_dtype);
+  const CopyCastType *dst = findCopyCastType(dst_dtype);
+  if (src == nullptr || dst == nullptr) {
+    return false;
+  }
+  if (src->dtype == dst->dtype) {
+    return true;
+  }
+  // integers fit in floats of as many bits, floats never fit in integers.
+  return dst->mantissa >= src->mantissa &&
+         (src->is_integer || !dst->is_integer);
+}
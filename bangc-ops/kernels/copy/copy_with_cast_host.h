@@ -0,0 +1,38 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_COPY_COPY_WITH_CAST_HOST_H_
+#define KERNELS_COPY_COPY_WITH_CAST_HOST_H_
+#include "mlu_op.h"
+
+/* whether mluOpCopyWithCast converts src_dtype to dst_dtype,
+ * see the conversion table in copy_with_cast_host.cpp.
+ * */
+bool copyWithCastIsSupported(const mluOpDataType_t src_dtype,
+                             const mluOpDataType_t dst_dtype);
+
+/* whether every src_dtype value is exactly representable in dst_dtype,
+ * lossy conversions are rounded by the round mode of the handle.
+ * */
+bool copyWithCastIsExact(const mluOpDataType_t src_dtype,
+                         const mluOpDataType_t dst_dtype);
+#endif  // KERNELS_COPY_COPY_WITH_CAST_HOST_H_
@@ -20,9 +20,12 @@
  * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  *************************************************************************/
+#include "core/broadcast_plan.h"
 #include "core/context.h"
 #include "core/gen_case.h"
 #include "core/logging.h"
+#include "core/runtime/chunked_launch.h"
+#include "core/runtime/cost_model.h"
 #include "core/runtime/device.h"
 #include "core/tensor.h"
 #include "core/type.h"
@@ -39,12 +42,13 @@ mluOpDiv(mluOpHandle_t handle, const mluOpComputationPreference_t prefer,
          const mluOpTensorDescriptor_t x_desc, const void *x,
          const mluOpTensorDescriptor_t y_desc, const void *y,
          const mluOpTensorDescriptor_t z_desc, void *z) {
+  MLUOP_PROFILE_OP("mluOpDiv");
   mluOpDataType_t support_type[2] = {MLUOP_DTYPE_HALF, MLUOP_DTYPE_FLOAT};
   int number_of_supported_types = 2;
   bool zero_element = false;
-  mluOpStatus_t param_check =
-      binaryOpParamCheck("mluOpDiv", handle, x_desc, x, y_desc, y, z_desc, z,
-                         support_type, number_of_supported_types, zero_element);
+  mluOpStatus_t param_check = binaryOpParamCheck(
+      "mluOpDiv", handle, x_desc, x, y_desc, y, z_desc, z, support_type,
+      number_of_supported_types, zero_element, true);
   if (param_check != MLUOP_STATUS_SUCCESS) {
     return param_check;
   }
@@ -52,6 +56,10 @@ mluOpDiv(mluOpHandle_t handle, const mluOpComputationPreference_t prefer,
     return MLUOP_STATUS_SUCCESS;
   }
 
+  MLUOP_PROFILE_TENSOR(x_desc);
+  MLUOP_PROFILE_TENSOR(y_desc);
+  MLUOP_PROFILE_TENSOR(z_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("div");
     GEN_CASE_HANDLE(handle);
@@ -60,30 +68,101 @@ mluOpDiv(mluOpHandle_t handle, const mluOpComputationPreference_t prefer,
     GEN_CASE_DATA(false, "z", z, z_desc, 0, 0);
     GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
   }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
 
   cnrtDim3_t k_dim;
   cnrtFunctionType_t k_type;
-  binaryOpPolicyFunc(handle, x_desc, THRESHOLD_SIZE, &k_dim, &k_type);
+  binaryOpPolicyFunc(handle, z_desc, THRESHOLD_SIZE, &k_dim, &k_type);
 
-  int element_num = mluOpGetTensorElementNum(x_desc);
-  void (*mluOpBlockKernelBinary)(cnrtDim3_t k_dim, cnrtFunctionType_t k_type,
-                                 cnrtQueue_t queue, const void *x,
-                                 const void *y, void *z, int element_num);
-  mluOpBlockKernelBinary = nullptr;
-  if (x_desc->dtype == MLUOP_DTYPE_HALF) {
-    if (prefer == MLUOP_COMPUTATION_HIGH_PRECISION) {
-      VLOG(5) << "kernel mluOpKernel3StagePipelineDivHalfHighAcc";
-      mluOpBlockKernelBinary = mluOpBlockKernel3StagePipelineDivHalfHighAcc;
+  mluop::BroadcastPlan broadcast;
+  mluop::planBroadcast(x_desc->dim, x_desc->dims_int64, y_desc->dim,
+                       y_desc->dims_int64, &broadcast);
+  const bool high_acc = x_desc->dtype == MLUOP_DTYPE_HALF &&
+                        prefer == MLUOP_COMPUTATION_HIGH_PRECISION;
+  int64_t element_num = mluOpGetTensorElementNum(z_desc);
+  size_t dtype_size = getSizeOfDataType(x_desc->dtype);
+  if (broadcast.isElementwise()) {
+    void (*mluOpBlockKernelBinary)(cnrtDim3_t k_dim, cnrtFunctionType_t k_type,
+                                   cnrtQueue_t queue, const void *x,
+                                   const void *y, void *z, int element_num);
+    mluOpBlockKernelBinary = nullptr;
+    if (x_desc->dtype == MLUOP_DTYPE_HALF) {
+      if (high_acc) {
+        VLOG(5) << "kernel mluOpKernel3StagePipelineDivHalfHighAcc";
+        mluOpBlockKernelBinary = mluOpBlockKernel3StagePipelineDivHalfHighAcc;
+      } else {
+        VLOG(5) << "kernel mluOpKernel3StagePipelineDivHalfFast";
+        mluOpBlockKernelBinary = mluOpBlockKernel3StagePipelineDivHalfFast;
+      }
     } else {
-      VLOG(5) << "kernel mluOpKernel3StagePipelineDivHalfFast";
-      mluOpBlockKernelBinary = mluOpBlockKernel3StagePipelineDivHalfFast;
+      VLOG(5) << "kernel mluOpKernel3StagePipelineDivFloatFast";
+      mluOpBlockKernelBinary = mluOpBlockKernel3StagePipelineDivFloatFast;
     }
+    auto launch = [&](int64_t offset, int64_t num) {
+      KERNEL_CHECK((mluOpBlockKernelBinary(
+          k_dim, k_type, handle->queue,
+          mluop::runtime::elementOffset(x, offset, dtype_size),
+          mluop::runtime::elementOffset(y, offset, dtype_size),
+          mluop::runtime::elementOffset(z, offset, dtype_size), num)));
+      return MLUOP_STATUS_SUCCESS;
+    };
+    CHECK_RETURN("mluOpDiv", mluop::runtime::launchInChunks(
+                                 element_num, LAUNCH_CHUNK_MAX_NUM, launch));
   } else {
-    VLOG(5) << "kernel mluOpKernel3StagePipelineDivFloatFast";
-    mluOpBlockKernelBinary = mluOpBlockKernel3StagePipelineDivFloatFast;
+    void (*mluOpBlockKernelBroadcast)(
+        cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+        const void *x, const void *y, void *z,
+        const mluOpBinaryBroadcastPlan_t *plan);
+    mluOpBlockKernelBroadcast = nullptr;
+    if (x_desc->dtype == MLUOP_DTYPE_HALF) {
+      if (high_acc) {
+        VLOG(5) << "kernel mluOpKernel3StagePipelineBroadcastDivHalfHighAcc";
+        mluOpBlockKernelBroadcast =
+            mluOpBlockKernel3StagePipelineBroadcastDivHalfHighAcc;
+      } else {
+        VLOG(5) << "kernel mluOpKernel3StagePipelineBroadcastDivHalfFast";
+        mluOpBlockKernelBroadcast =
+            mluOpBlockKernel3StagePipelineBroadcastDivHalfFast;
+      }
+    } else {
+      VLOG(5) << "kernel mluOpKernel3StagePipelineBroadcastDivFloatFast";
+      mluOpBlockKernelBroadcast =
+          mluOpBlockKernel3StagePipelineBroadcastDivFloatFast;
+    }
+    auto launch = [&](const mluop::BroadcastPlan &chunk, int64_t x_offset,
+                      int64_t y_offset, int64_t z_offset) {
+      mluOpBinaryBroadcastPlan_t kernel_plan;
+      kernel_plan.dim = chunk.dim;
+      for (int i = 0; i < chunk.dim; ++i) {
+        kernel_plan.dims[i] = chunk.dims[i];
+        kernel_plan.x_strides[i] = chunk.x_strides[i];
+        kernel_plan.y_strides[i] = chunk.y_strides[i];
+      }
+      KERNEL_CHECK((mluOpBlockKernelBroadcast(
+          k_dim, k_type, handle->queue,
+          mluop::runtime::elementOffset(x, x_offset, dtype_size),
+          mluop::runtime::elementOffset(y, y_offset, dtype_size),
+          mluop::runtime::elementOffset(z, z_offset, dtype_size),
+          &kernel_plan)));
+      return MLUOP_STATUS_SUCCESS;
+    };
+    CHECK_RETURN("mluOpDiv", mluop::launchBroadcastInChunks(
+                                 broadcast, LAUNCH_CHUNK_MAX_NUM, launch));
   }
-  KERNEL_CHECK((mluOpBlockKernelBinary(k_dim, k_type, handle->queue, x, y, z,
-                                       element_num)));
   GEN_CASE_END();
   return MLUOP_STATUS_SUCCESS;
 }
+
+// One op per element of z.
+static mluOpStatus_t costDiv(mluOpHandle_t handle,
+                             const mluOpTensorDescriptor_t *descs,
+                             int desc_num, mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[2] != NULL);
+  mluop::runtime::setElementwiseCost(descs, desc_num,
+                                     descs[2]->total_element_num, 1, cost);
+  binaryOpPolicyFunc(handle, descs[2], THRESHOLD_SIZE, &cost->k_dim,
+                     &cost->k_type);
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("div", 3, costDiv);
@@ -24,6 +24,7 @@
 
 #include "core/gen_case.h"
 #include "core/logging.h"
+#include "core/runtime/cost_model.h"
 #include "core/runtime/device.h"
 #include "core/tensor.h"
 #include "core/type.h"
@@ -42,37 +43,25 @@ static mluOpStatus_t policyFunc(mluOpHandle_t handle, cnrtDim3_t *k_dim,
   return MLUOP_STATUS_SUCCESS;
 }
 
-mluOpStatus_t MLUOP_WIN_API
-mluOpExpand(mluOpHandle_t handle, const mluOpTensorDescriptor_t input_desc,
-            const void *input, const mluOpTensorDescriptor_t output_desc,
-            void *output) {
-  PARAM_CHECK("[mluOpExpand]", handle != NULL);
-  PARAM_CHECK("[mluOpExpand]", input_desc != NULL);
-  PARAM_CHECK("[mluOpExpand]", output_desc != NULL);
-  PARAM_CHECK("[mluOpExpand]", input_desc->dtype != MLUOP_DTYPE_INVALID);
-  PARAM_CHECK("[mluOpExpand]", input_desc->dtype == output_desc->dtype);
-  PARAM_CHECK("[mluOpExpand]", input_desc->dim <= MLUOP_DIM_MAX);
-  PARAM_CHECK("[mluOpExpand]", output_desc->dim <= MLUOP_DIM_MAX);
+// the kernel chosen by an expand launch plan, in plan.tiling[0].
+enum ExpandMode {
+  EXPAND_COPY = 0,
+  EXPAND_ONE_DIM = 1,
+  EXPAND_TENSOR = 2,
+};
+
+// Validates the descriptors of mluOpExpand and folds the dims, fills `plan`
+// with the kernel to launch and its arguments:
+// EXPAND_ONE_DIM: tiling[1, 2, 3, 4] = high_num, expand_num, low_num, dtype
+//                 size.
+// EXPAND_TENSOR:  tiling[1 ... 8] = input dims, tiling[9 ... 16] = output
+//                 dims.
+static mluOpStatus_t expandPlan(mluOpHandle_t handle,
+                                const mluOpTensorDescriptor_t input_desc,
+                                const mluOpTensorDescriptor_t output_desc,
+                                mluop::runtime::LaunchPlan *plan) {
   size_t input_num = mluOpGetTensorElementNum(input_desc);
   size_t output_num = mluOpGetTensorElementNum(output_desc);
-  if (getSizeOfDataType(input_desc->dtype) ==
-      getSizeOfDataType(MLUOP_DTYPE_INT64)) {
-    auto statement_error = "the data type is int64 or complex, ";
-    TENSOR_NUM_CHECK("[mluOpExpand]", input_num, INT64_LARGE_TENSOR_NUM,
-                     statement_error);
-    TENSOR_NUM_CHECK("[mluOpExpand]", output_num, INT64_LARGE_TENSOR_NUM,
-                     statement_error);
-  } else {
-    TENSOR_NUM_CHECK("[mluOpExpand]", input_num, LARGE_TENSOR_NUM, "");
-    TENSOR_NUM_CHECK("[mluOpExpand]", output_num, LARGE_TENSOR_NUM, "");
-  }
-  if (mluOpGetTensorElementNum(input_desc) == 0) {
-    VLOG(5) << "mluOpExpand skip zero element tensor.";
-    return MLUOP_STATUS_SUCCESS;
-  }
-  PARAM_CHECK("[mluOpExpand]", input != NULL);
-  PARAM_CHECK("[mluOpExpand]", output != NULL);
-
   int dims_input[MLUOP_DIM_MAX];
   int dims_output[MLUOP_DIM_MAX];
   int32_t redims_input[MLUOP_DIM_MAX + 1];
@@ -137,36 +126,18 @@ mluOpExpand(mluOpHandle_t handle, const mluOpTensorDescriptor_t input_desc,
     }
   }
 
-  // generate mluOpExpand prototxt start!
-  if (MLUOP_GEN_CASE_ON_NEW) {
-    GEN_CASE_START("expand");
-    GEN_CASE_HANDLE(handle);
-    GEN_CASE_DATA(true, "input", input, input_desc, 10, 0);
-    GEN_CASE_DATA(false, "output", output, output_desc, 0, 0);
-    GEN_CASE_TEST_PARAM_NEW(false, false, true, 0, 0, 0);
-  }
-  // generate mluOpExpand prototxt end!
-
   if (count_flag == 0) {
-    auto status_copy =
-        mluOpCopy(handle, input_desc, input, output_desc, output);
-    if (status_copy != MLUOP_STATUS_SUCCESS) {
-      KERNEL_CALL_CHECK("mluOpExpand", "mluOpCopy", status_copy, "");
-    }
-    GEN_CASE_END();
+    plan->tiling[0] = EXPAND_COPY;
     return MLUOP_STATUS_SUCCESS;
   }
 
   // Choose best task dimension
-  cnrtDim3_t k_dim;
-  cnrtFunctionType_t k_type;
-
-  k_type = CNRT_FUNC_TYPE_UNION1;
+  plan->k_type = CNRT_FUNC_TYPE_UNION1;
   int core_dim = mluop::runtime::getCoreNumOfEachUnionCapability(handle);
   int32_t union_number = mluop::runtime::getClusterLimitCapability(handle);
-  k_dim.x = core_dim;
-  k_dim.y = union_number;
-  k_dim.z = 1;
+  plan->k_dim.x = core_dim;
+  plan->k_dim.y = union_number;
+  plan->k_dim.z = 1;
   mluOpDataType_t data_type = input_desc->dtype;
 
   if (getSizeOfDataType(input_desc->dtype) ==
@@ -192,15 +163,103 @@ mluOpExpand(mluOpHandle_t handle, const mluOpTensorDescriptor_t input_desc,
     if (redims_input[count_index[0]] != 1) {
       low_num *= redims_input[count_index[0]];
     }
+    plan->tiling[0] = EXPAND_ONE_DIM;
+    plan->tiling[1] = high_num;
+    plan->tiling[2] = expand_num;
+    plan->tiling[3] = low_num;
+    plan->tiling[4] = mluOpDataTypeBytes(data_type);
+  } else {
+    INTERNAL_CHECK("mluOpExpand", MLUOP_STATUS_SUCCESS ==
+                                      policyFunc(handle, &(plan->k_dim),
+                                                 &(plan->k_type)));
+    plan->tiling[0] = EXPAND_TENSOR;
+    for (int i = 0; i < MLUOP_DIM_MAX; i++) {
+      plan->tiling[1 + i] = dims_input[i];
+      plan->tiling[1 + MLUOP_DIM_MAX + i] = dims_output[i];
+    }
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t MLUOP_WIN_API
+mluOpExpand(mluOpHandle_t handle, const mluOpTensorDescriptor_t input_desc,
+            const void *input, const mluOpTensorDescriptor_t output_desc,
+            void *output) {
+  MLUOP_PROFILE_OP("mluOpExpand");
+  mluop::runtime::LaunchPlanKey key("[mluOpExpand]");
+  key.add(handle).add(input_desc).add(output_desc);
+  mluop::runtime::LaunchPlan plan;
+  bool plan_cached = mluop::runtime::lookupLaunchPlan(handle, key, &plan);
+  if (!plan_cached) {
+    PARAM_CHECK("[mluOpExpand]", handle != NULL);
+    PARAM_CHECK("[mluOpExpand]", input_desc != NULL);
+    PARAM_CHECK("[mluOpExpand]", output_desc != NULL);
+    PARAM_CHECK("[mluOpExpand]", input_desc->dtype != MLUOP_DTYPE_INVALID);
+    PARAM_CHECK("[mluOpExpand]", input_desc->dtype == output_desc->dtype);
+    PARAM_CHECK("[mluOpExpand]", input_desc->dim <= MLUOP_DIM_MAX);
+    PARAM_CHECK("[mluOpExpand]", output_desc->dim <= MLUOP_DIM_MAX);
+    size_t input_num = mluOpGetTensorElementNum(input_desc);
+    size_t output_num = mluOpGetTensorElementNum(output_desc);
+    if (getSizeOfDataType(input_desc->dtype) ==
+        getSizeOfDataType(MLUOP_DTYPE_INT64)) {
+      auto statement_error = "the data type is int64 or complex, ";
+      TENSOR_NUM_CHECK("[mluOpExpand]", input_num, INT64_LARGE_TENSOR_NUM,
+                       statement_error);
+      TENSOR_NUM_CHECK("[mluOpExpand]", output_num, INT64_LARGE_TENSOR_NUM,
+                       statement_error);
+    } else {
+      TENSOR_NUM_CHECK("[mluOpExpand]", input_num, LARGE_TENSOR_NUM, "");
+      TENSOR_NUM_CHECK("[mluOpExpand]", output_num, LARGE_TENSOR_NUM, "");
+    }
+    if (mluOpGetTensorElementNum(input_desc) == 0) {
+      VLOG(5) << "mluOpExpand skip zero element tensor.";
+      return MLUOP_STATUS_SUCCESS;
+    }
+  }
+  PARAM_CHECK("[mluOpExpand]", input != NULL);
+  PARAM_CHECK("[mluOpExpand]", output != NULL);
+
+  if (!plan_cached) {
+    mluOpStatus_t status = expandPlan(handle, input_desc, output_desc, &plan);
+    if (status != MLUOP_STATUS_SUCCESS) {
+      return status;
+    }
+    mluop::runtime::insertLaunchPlan(handle, key, plan);
+  }
+
+  // generate mluOpExpand prototxt start!
+  MLUOP_PROFILE_TENSOR(input_desc);
+  MLUOP_PROFILE_TENSOR(output_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
+  if (MLUOP_GEN_CASE_ON_NEW) {
+    GEN_CASE_START("expand");
+    GEN_CASE_HANDLE(handle);
+    GEN_CASE_DATA(true, "input", input, input_desc, 10, 0);
+    GEN_CASE_DATA(false, "output", output, output_desc, 0, 0);
+    GEN_CASE_TEST_PARAM_NEW(false, false, true, 0, 0, 0);
+  }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
+  // generate mluOpExpand prototxt end!
+
+  cnrtDim3_t k_dim = plan.k_dim;
+  cnrtFunctionType_t k_type = plan.k_type;
+  const int64_t *tiling = plan.tiling;
+  if (tiling[0] == EXPAND_COPY) {
+    auto status_copy =
+        mluOpCopy(handle, input_desc, input, output_desc, output);
+    if (status_copy != MLUOP_STATUS_SUCCESS) {
+      KERNEL_CALL_CHECK("mluOpExpand", "mluOpCopy", status_copy, "");
+    }
+  } else if (tiling[0] == EXPAND_ONE_DIM) {
     VLOG(5) << "Launch Kernel MLUUnion1KernelExpandOneDim<<<Union"
             << k_type / CORE_DIM << ", " << k_dim.x << ", " << k_dim.y << ", "
             << k_dim.z << ">>>";
     KERNEL_CHECK((mluOpUnion1KernelExpandOneDim(
-        k_dim, k_type, handle->queue, (void *)input, output, high_num,
-        expand_num, low_num, mluOpDataTypeBytes(data_type))));
+        k_dim, k_type, handle->queue, (void *)input, output, tiling[1],
+        tiling[2], tiling[3], tiling[4])));
   } else {
-    INTERNAL_CHECK("mluOpExpand",
-                   MLUOP_STATUS_SUCCESS == policyFunc(handle, &k_dim, &k_type));
+    const int64_t *dims_input = tiling + 1;
+    const int64_t *dims_output = tiling + 1 + MLUOP_DIM_MAX;
     VLOG(5) << "Launch Kernel MLUUnion1KernelExpandTensor<<<Union"
             << k_type / CORE_DIM << ", " << k_dim.x << ", " << k_dim.y << ", "
             << k_dim.z << ">>>";
@@ -216,3 +275,31 @@ mluOpExpand(mluOpHandle_t handle, const mluOpTensorDescriptor_t input_desc,
   GEN_CASE_END();
   return MLUOP_STATUS_SUCCESS;
 }
+
+// One op per element of the output, expands without broadcast dims are
+// copies.
+static mluOpStatus_t costExpand(mluOpHandle_t handle,
+                                const mluOpTensorDescriptor_t *descs,
+                                int desc_num, mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[1] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0]->dim <= MLUOP_DIM_MAX);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[1]->dim <= MLUOP_DIM_MAX);
+  if (descs[0]->total_element_num == 0) {
+    cost->kernel_num = 0;
+    return MLUOP_STATUS_SUCCESS;
+  }
+  mluop::runtime::LaunchPlan plan;
+  CHECK_RETURN("[mluOpGetOpCostModel]",
+               expandPlan(handle, descs[0], descs[1], &plan));
+  if (plan.tiling[0] == EXPAND_COPY) {
+    return mluop::runtime::getOpCost(handle, "copy", descs, desc_num, cost);
+  }
+  cost->theory_ops = descs[1]->total_element_num;
+  cost->theory_io_bytes = mluop::runtime::getTensorsBytes(descs, desc_num);
+  cost->k_dim = plan.k_dim;
+  cost->k_type = plan.k_type;
+  cost->compute_dtype = descs[0]->dtype;
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("expand", 2, costExpand);
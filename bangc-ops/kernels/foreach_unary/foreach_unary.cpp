@@ -0,0 +1,159 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "core/context.h"
+#include "core/logging.h"
+#include "core/runtime/chunked_launch.h"
+#include "core/runtime/device.h"
+#include "core/runtime/foreach_launch.h"
+#include "core/tensor.h"
+#include "core/type.h"
+#include "kernels/unary_op/unary_op_host.h"
+#include "mlu_op.h"
+#include "mlu_op_kernel.h"
+
+typedef void (*KernelForeachUnary)(cnrtDim3_t k_dim, cnrtFunctionType_t k_type,
+                                   cnrtQueue_t queue,
+                                   const mluOpForeachUnaryTable_t *table,
+                                   float coef);
+
+static mluOpStatus_t chooseKernel(const mluOpForeachUnaryOp_t op,
+                                  const mluOpComputationPreference_t prefer,
+                                  const mluOpDataType_t dtype,
+                                  KernelForeachUnary *kernel, float *coef) {
+  const bool is_half = dtype == MLUOP_DTYPE_HALF;
+  const bool high_acc = prefer != MLUOP_COMPUTATION_FAST;
+  *coef = 1.0;
+  switch (op) {
+    case MLUOP_FOREACH_ABS:
+      *kernel = is_half ? mluOpBlockKernel3StagePipelineForeachAbsHalfFast
+                        : mluOpBlockKernel3StagePipelineForeachAbsFloatFast;
+      *coef = 0.0;
+      break;
+    case MLUOP_FOREACH_SQRT:
+      if (!is_half) {
+        *kernel = mluOpBlockKernel3StagePipelineForeachSqrtFloatFast;
+      } else if (high_acc) {
+        *kernel = mluOpBlockKernel3StagePipelineForeachSqrtHalfHighAcc;
+      } else {
+        *kernel = mluOpBlockKernel3StagePipelineForeachSqrtHalfFast;
+      }
+      break;
+    case MLUOP_FOREACH_LOG:
+    case MLUOP_FOREACH_LOG2:
+    case MLUOP_FOREACH_LOG10:
+      if (!is_half) {
+        *kernel = mluOpBlockKernel3StagePipelineForeachLogFloatFast;
+      } else if (high_acc) {
+        *kernel = mluOpBlockKernel3StagePipelineForeachLogHalfHighAcc;
+      } else {
+        *kernel = mluOpBlockKernel3StagePipelineForeachLogHalfFast;
+      }
+      // logb(x) = loge(x) * logb(e), the same coef as mluOpLog.
+      if (op == MLUOP_FOREACH_LOG2) {
+        *coef = log2(exp(1));
+      } else if (op == MLUOP_FOREACH_LOG10) {
+        *coef = log10(exp(1));
+      }
+      break;
+    default:
+      LOG(ERROR) << "[mluOpForeachUnary] op " << op << " is not supported.";
+      return MLUOP_STATUS_BAD_PARAM;
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t MLUOP_WIN_API
+mluOpForeachUnary(mluOpHandle_t handle, const mluOpForeachUnaryOp_t op,
+                  const mluOpComputationPreference_t prefer,
+                  const int tensor_num,
+                  const mluOpTensorDescriptor_t x_descs[],
+                  const void *const x[],
+                  const mluOpTensorDescriptor_t y_descs[], void *const y[]) {
+  MLUOP_PROFILE_OP("mluOpForeachUnary");
+  const std::string api = "[mluOpForeachUnary]";
+  PARAM_CHECK(api, handle != NULL);
+  PARAM_CHECK(api, tensor_num >= 0);
+  if (tensor_num == 0) {
+    VLOG(5) << api << " skip empty tensor list.";
+    return MLUOP_STATUS_SUCCESS;
+  }
+  PARAM_CHECK(api, x_descs != NULL);
+  PARAM_CHECK(api, x != NULL);
+  PARAM_CHECK(api, y_descs != NULL);
+  PARAM_CHECK(api, y != NULL);
+
+  mluOpDataType_t support_type[2] = {MLUOP_DTYPE_HALF, MLUOP_DTYPE_FLOAT};
+  std::vector<int64_t> element_nums(tensor_num, 0);
+  for (int i = 0; i < tensor_num; ++i) {
+    bool zero_element = false;
+    CHECK_RETURN(api, unaryOpParamCheck(api, handle, x_descs[i], x[i],
+                                        y_descs[i], y[i], support_type, 2,
+                                        zero_element));
+    PARAM_CHECK_EQ(api, x_descs[i]->dtype, x_descs[0]->dtype);
+    if (!zero_element) {
+      element_nums[i] = x_descs[i]->total_element_num;
+      MLUOP_PROFILE_TENSOR(x_descs[i]);
+    }
+  }
+
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
+  const mluOpDataType_t dtype = x_descs[0]->dtype;
+  KernelForeachUnary kernel = nullptr;
+  float coef = 1.0;
+  CHECK_RETURN(api, chooseKernel(op, prefer, dtype, &kernel, &coef));
+  const std::vector<mluop::runtime::ForeachLaunch> launches =
+      mluop::runtime::planForeachLaunches(element_nums, LAUNCH_CHUNK_MAX_NUM,
+                                          MLUOP_FOREACH_MAX_SEGMENT_NUM);
+  VLOG(5) << api << " " << tensor_num << " tensors in " << launches.size()
+          << " launches.";
+
+  const size_t dtype_size = getSizeOfDataType(dtype);
+  for (const auto &launch : launches) {
+    mluOpForeachUnaryTable_t table;
+    table.segment_num = launch.segments.size();
+    int32_t begin = 0;
+    for (int s = 0; s < table.segment_num; ++s) {
+      const mluop::runtime::ForeachSegment &segment = launch.segments[s];
+      table.x[s] = mluop::runtime::elementOffset(x[segment.tensor_index],
+                                                 segment.offset, dtype_size);
+      table.y[s] = mluop::runtime::elementOffset(y[segment.tensor_index],
+                                                 segment.offset, dtype_size);
+      table.begin[s] = begin;
+      begin += segment.num;
+    }
+    table.begin[table.segment_num] = begin;
+
+    cnrtDim3_t k_dim;
+    cnrtFunctionType_t k_type;
+    unaryOpPolicyFunc(handle, launch.num, dtype, &k_dim, &k_type);
+    VLOG(5) << "[mluOp] Launch [" << k_type << ", " << k_dim.x << ", "
+            << k_dim.y << ", " << k_dim.z << "] with " << table.segment_num
+            << " segments of " << launch.num << " elements.";
+    KERNEL_CHECK((kernel(k_dim, k_type, handle->queue, &table, coef)));
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
@@ -0,0 +1,104 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <string>
+
+#include "core/context.h"
+#include "core/logging.h"
+#include "core/runtime/chunked_launch.h"
+#include "core/runtime/device.h"
+#include "core/tensor.h"
+#include "core/type.h"
+#include "kernels/fused_unary/fused_unary_host.h"
+#include "kernels/unary_op/unary_op_host.h"
+#include "mlu_op.h"
+#include "mlu_op_kernel.h"
+
+mluOpStatus_t MLUOP_WIN_API
+mluOpFusedUnary(mluOpHandle_t handle, const int step_num,
+                const mluOpFusedUnaryStep_t steps[],
+                const mluOpTensorDescriptor_t x_desc, const void *x,
+                const mluOpTensorDescriptor_t y_desc, void *y) {
+  MLUOP_PROFILE_OP("mluOpFusedUnary");
+  mluOpDataType_t support_type[2] = {MLUOP_DTYPE_HALF, MLUOP_DTYPE_FLOAT};
+  bool zero_element = false;
+  mluOpStatus_t param_check =
+      unaryOpParamCheck("[mluOpFusedUnary]", handle, x_desc, x, y_desc, y,
+                        support_type, 2, zero_element);
+  if (param_check != MLUOP_STATUS_SUCCESS) {
+    return param_check;
+  }
+  CHECK_RETURN("[mluOpFusedUnary]",
+               fusedUnaryProgramCheck("[mluOpFusedUnary]", step_num, steps));
+  if (zero_element == true) {
+    return MLUOP_STATUS_SUCCESS;
+  }
+
+  MLUOP_PROFILE_TENSOR(x_desc);
+  MLUOP_PROFILE_TENSOR(y_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
+  mluOpFusedUnaryProgram_t program;
+  fusedUnaryLowerProgram(step_num, steps, &program);
+
+  typedef void (*KernelFusedUnary)(
+      cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+      const void *x, void *y, int num, const mluOpFusedUnaryProgram_t *program);
+  cnrtDim3_t k_dim;
+  cnrtFunctionType_t k_type;
+  unaryOpPolicyFunc(handle, x_desc, &k_dim, &k_type);
+  KernelFusedUnary mluOpBlockKernelFusedUnary = nullptr;
+  if (handle->arch == MLUOP_MLU270) {
+    if (x_desc->dtype == MLUOP_DTYPE_FLOAT) {
+      VLOG(5) << "kernel mluOpBlockKernel5StagePipelineFusedUnaryFloat";
+      mluOpBlockKernelFusedUnary =
+          mluOpBlockKernel5StagePipelineFusedUnaryFloat;
+    } else {
+      VLOG(5) << "kernel mluOpBlockKernel5StagePipelineFusedUnaryHalf";
+      mluOpBlockKernelFusedUnary = mluOpBlockKernel5StagePipelineFusedUnaryHalf;
+    }
+  } else {
+    if (x_desc->dtype == MLUOP_DTYPE_FLOAT) {
+      VLOG(5) << "kernel mluOpBlockKernel3StagePipelineFusedUnaryFloat";
+      mluOpBlockKernelFusedUnary =
+          mluOpBlockKernel3StagePipelineFusedUnaryFloat;
+    } else {
+      VLOG(5) << "kernel mluOpBlockKernel3StagePipelineFusedUnaryHalf";
+      mluOpBlockKernelFusedUnary = mluOpBlockKernel3StagePipelineFusedUnaryHalf;
+    }
+  }
+  VLOG(5) << "[mluOp] Launch [" << k_type << ", " << k_dim.x << ", "
+          << k_dim.y << ", " << k_dim.z << "] with " << step_num << " steps";
+
+  int64_t element_num = x_desc->total_element_num;
+  size_t dtype_size = getSizeOfDataType(x_desc->dtype);
+  auto launch = [&](int64_t offset, int64_t num) {
+    KERNEL_CHECK((mluOpBlockKernelFusedUnary(
+        k_dim, k_type, handle->queue,
+        mluop::runtime::elementOffset(x, offset, dtype_size),
+        mluop::runtime::elementOffset(y, offset, dtype_size), num, &program)));
+    return MLUOP_STATUS_SUCCESS;
+  };
+  CHECK_RETURN("[mluOpFusedUnary]",
+               mluop::runtime::launchInChunks(element_num,
+                                              LAUNCH_CHUNK_MAX_NUM, launch));
+  return MLUOP_STATUS_SUCCESS;
+}
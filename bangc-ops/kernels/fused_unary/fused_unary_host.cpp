@@ -0,0 +1,77 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "kernels/fused_unary/fused_unary_host.h"
+
+#include <string>
+
+#include "core/logging.h"
+#include "mlu_op.h"
+#include "mlu_op_kernel.h"
+
+static_assert(MLUOP_FUSED_UNARY_MAX_STEP_NUM ==
+                  MLUOP_FUSED_UNARY_KERNEL_MAX_STEP_NUM,
+              "the kernel program must hold the steps of every program.");
+
+mluOpStatus_t fusedUnaryProgramCheck(const std::string &op_name,
+                                     const int step_num,
+                                     const mluOpFusedUnaryStep_t steps[]) {
+  PARAM_CHECK(op_name, step_num >= 1);
+  PARAM_CHECK(op_name, step_num <= MLUOP_FUSED_UNARY_MAX_STEP_NUM);
+  PARAM_CHECK(op_name, steps != NULL);
+  for (int i = 0; i < step_num; ++i) {
+    switch (steps[i].type) {
+      case MLUOP_FUSED_UNARY_ABS:
+      case MLUOP_FUSED_UNARY_LOG:
+      case MLUOP_FUSED_UNARY_SQRT:
+      case MLUOP_FUSED_UNARY_MUL_SCALAR:
+      case MLUOP_FUSED_UNARY_ADD_SCALAR:
+        break;
+      case MLUOP_FUSED_UNARY_DIV_SCALAR:
+        if (steps[i].scalar == 0) {
+          LOG(ERROR) << op_name << ":step " << i << " divides by 0.";
+          return MLUOP_STATUS_BAD_PARAM;
+        }
+        break;
+      default:
+        LOG(ERROR) << op_name << ":step " << i << " is of unknown type "
+                   << steps[i].type << ".";
+        return MLUOP_STATUS_BAD_PARAM;
+    }
+  }
+  return MLUOP_STATUS_SUCCESS;
+}
+
+void fusedUnaryLowerProgram(const int step_num,
+                            const mluOpFusedUnaryStep_t steps[],
+                            mluOpFusedUnaryProgram_t *program) {
+  program->step_num = step_num;
+  for (int i = 0; i < step_num; ++i) {
+    if (steps[i].type == MLUOP_FUSED_UNARY_DIV_SCALAR) {
+      program->type[i] = MLUOP_FUSED_UNARY_MUL_SCALAR;
+      program->scalar[i] = 1.0f / steps[i].scalar;
+    } else {
+      program->type[i] = steps[i].type;
+      program->scalar[i] = steps[i].scalar;
+    }
+  }
+}
@@ -0,0 +1,44 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_FUSED_UNARY_FUSED_UNARY_HOST_H_
+#define KERNELS_FUSED_UNARY_FUSED_UNARY_HOST_H_
+#include <string>
+
+#include "mlu_op.h"
+#include "mlu_op_kernel.h"
+
+/* program check
+ * step_num is in [1, MLUOP_FUSED_UNARY_MAX_STEP_NUM], every step is of a known
+ * type and no DIV_SCALAR step divides by 0.
+ * */
+mluOpStatus_t fusedUnaryProgramCheck(const std::string &op_name,
+                                     const int step_num,
+                                     const mluOpFusedUnaryStep_t steps[]);
+
+/* lowers a checked program to the kernel program,
+ * DIV_SCALAR becomes MUL_SCALAR by the reciprocal of its scalar.
+ * */
+void fusedUnaryLowerProgram(const int step_num,
+                            const mluOpFusedUnaryStep_t steps[],
+                            mluOpFusedUnaryProgram_t *program);
+#endif  // KERNELS_FUSED_UNARY_FUSED_UNARY_HOST_H_
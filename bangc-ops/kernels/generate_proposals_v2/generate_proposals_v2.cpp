@@ -20,11 +20,14 @@
  * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  *************************************************************************/
+#include "kernels/generate_proposals_v2/generate_proposals_v2.h"
+
 #include <algorithm>
 
 #include "core/context.h"
 #include "core/gen_case.h"
 #include "core/logging.h"
+#include "core/runtime/cost_model.h"
 #include "core/runtime/device.h"
 #include "core/tensor.h"
 #include "core/type.h"
@@ -60,6 +63,67 @@ static void policyFunc(mluOpHandle_t handle, cnrtDim3_t *k_dim,
   return;
 }
 
+// The smallest union launch with a core for each of the N images, within
+// the job and cluster limits.
+static void policyFuncBatch(mluOpHandle_t handle, cnrtDim3_t *k_dim,
+                            cnrtFunctionType_t *k_type, const int N) {
+  const KernelClass union_class[] = {
+      CN_KERNEL_CLASS_UNION, CN_KERNEL_CLASS_UNION2, CN_KERNEL_CLASS_UNION4,
+      CN_KERNEL_CLASS_UNION8, CN_KERNEL_CLASS_UNION16};
+  const int cluster_limit = std::min(
+      mluop::runtime::getClusterNumberOfJobLimitCapability(handle),
+      mluop::runtime::getClusterLimitCapability(handle));
+  int union_id = 0;
+  while ((1 << union_id) * handle->core_num_per_cluster < N &&
+         (2 << union_id) <= cluster_limit && union_id < 4) {
+    ++union_id;
+  }
+  k_dim->x = (1 << union_id) * handle->core_num_per_cluster;
+  k_dim->y = 1;
+  k_dim->z = 1;
+  *k_type =
+      mluop::runtime::castCnKernelClassToCnrtFuncType(union_class[union_id]);
+}
+
+void getGenerateProposalsV2Plan(mluOpHandle_t handle, const int N,
+                                const int HWA, GenerateProposalsV2Plan *plan) {
+  *plan = GenerateProposalsV2Plan();
+  policyFunc(handle, &plan->k_dim, &plan->k_type, HWA);
+  plan->workspace_size =
+      (size_t)12 * HWA * sizeof(float) +
+      handle->cluster_num * handle->core_num_per_cluster * sizeof(float) * 3;
+  if (N < 2 ||
+      mluop::runtime::getJobLimitCapability(handle) < CN_KERNEL_CLASS_UNION) {
+    return;
+  }
+
+  cnrtDim3_t batch_dim;
+  cnrtFunctionType_t batch_type;
+  policyFuncBatch(handle, &batch_dim, &batch_type, N);
+
+  // the anchors scanned by the busiest core in each schedule
+  const int whole_core_num = plan->k_dim.x;
+  const int batch_core_num = batch_dim.x;
+  const int64_t whole_span =
+      (int64_t)N * ((HWA + whole_core_num - 1) / whole_core_num);
+  const int64_t batch_span =
+      (int64_t)((N + batch_core_num - 1) / batch_core_num) * HWA;
+
+  // | proposals | createAndRemoveBox | collect_num | stop_flag | reduce |
+  // |  6 * HWA  |      5 * HWA       |      1      |     1     |   2    |
+  const int64_t core_workspace_num = (int64_t)12 * HWA + 3;
+  const size_t batch_workspace_size =
+      batch_core_num * core_workspace_num * sizeof(float);
+  if (batch_span > whole_span || batch_workspace_size >= LARGE_TENSOR_SIZE) {
+    return;
+  }
+  plan->k_dim = batch_dim;
+  plan->k_type = batch_type;
+  plan->batch_parallel = true;
+  plan->core_workspace_num = core_workspace_num;
+  plan->workspace_size = std::max(plan->workspace_size, batch_workspace_size);
+}
+
 mluOpStatus_t MLUOP_WIN_API mluOpGetGenerateProposalsV2WorkspaceSize(
     mluOpHandle_t handle, const mluOpTensorDescriptor_t scores_desc,
     size_t *size) {
@@ -87,8 +151,9 @@ mluOpStatus_t MLUOP_WIN_API mluOpGetGenerateProposalsV2WorkspaceSize(
                << " Currently, MLU-OPS supports tensor size smaller than 2^31.";
     return MLUOP_STATUS_NOT_SUPPORTED;
   }
-  *size = 12 * A * H * W * 4 +
-          handle->cluster_num * handle->core_num_per_cluster * 4 * 3;
+  GenerateProposalsV2Plan plan;
+  getGenerateProposalsV2Plan(handle, N, A * H * W, &plan);
+  *size = plan.workspace_size;
   return MLUOP_STATUS_SUCCESS;
 }
 
@@ -105,6 +170,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpGenerateProposalsV2(
     const mluOpTensorDescriptor_t rpn_roi_probs_desc, void *rpn_roi_probs,
     const mluOpTensorDescriptor_t rpn_rois_num_desc, void *rpn_rois_num,
     void *rpn_rois_batch_size) {
+  MLUOP_PROFILE_OP("mluOpGenerateProposalsV2");
   const std::string API = "[mluOpGenerateProposalsV2]";
   // check inputs/outputs
   PARAM_CHECK(API, handle != NULL);
@@ -206,6 +272,14 @@ mluOpStatus_t MLUOP_WIN_API mluOpGenerateProposalsV2(
   PARAM_CHECK(API, rpn_rois_num != NULL);
   PARAM_CHECK(API, rpn_rois_batch_size != NULL);
 
+  if (workspace == NULL) {
+    size_t required_size = 0;
+    CHECK_RETURN(API, mluOpGetGenerateProposalsV2WorkspaceSize(
+                          handle, scores_desc, &required_size));
+    CHECK_RETURN(API, mluop::runtime::getWorkspaceFromArena(
+                          handle, API, required_size, &workspace,
+                          &workspace_size));
+  }
   if (workspace_size > 0) {
     PARAM_CHECK(API, workspace != NULL);
   }
@@ -241,6 +315,15 @@ mluOpStatus_t MLUOP_WIN_API mluOpGenerateProposalsV2(
   }
 
   // generate prototxt
+  MLUOP_PROFILE_TENSOR(scores_desc);
+  MLUOP_PROFILE_TENSOR(bbox_deltas_desc);
+  MLUOP_PROFILE_TENSOR(im_shape_desc);
+  MLUOP_PROFILE_TENSOR(anchors_desc);
+  MLUOP_PROFILE_TENSOR(variances_desc);
+  MLUOP_PROFILE_TENSOR(rpn_rois_desc);
+  MLUOP_PROFILE_TENSOR(rpn_roi_probs_desc);
+  MLUOP_PROFILE_TENSOR(rpn_rois_num_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("generate_proposals_v2");
     GEN_CASE_HANDLE(handle);
@@ -268,22 +351,52 @@ mluOpStatus_t MLUOP_WIN_API mluOpGenerateProposalsV2(
                              pixel_offset);
     GEN_CASE_TEST_PARAM_NEW(true, true, false, 3e-3, 3e-3, 0);
   }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
 
   int HWA = H * W * A;
-  cnrtDim3_t k_dim;
-  cnrtJobType_t k_type;
-  policyFunc(handle, &k_dim, &k_type, HWA);
+  GenerateProposalsV2Plan plan;
+  getGenerateProposalsV2Plan(handle, N, HWA, &plan);
+  // every image keeps its rois in its own post_nms_top_n rows until the
+  // compaction, so the batch schedule needs at least one row per image.
+  const bool batch_parallel = plan.batch_parallel && post_nms_top_n > 0;
+  if (plan.batch_parallel && !batch_parallel) {
+    policyFunc(handle, &plan.k_dim, &plan.k_type, HWA);
+  }
+  cnrtDim3_t k_dim = plan.k_dim;
+  cnrtFunctionType_t k_type = plan.k_type;
 
   VLOG(5) << "Launch Kernel mluOpUBestKernelGenerateProposalsV2Float <<<k_dim: "
           << k_type << ", " << k_dim.x << ", " << k_dim.y << ", " << k_dim.z
-          << ">>>";
+          << ">>>, batch_parallel: " << batch_parallel;
 
   KERNEL_CHECK(mluOpUBestKernelGenerateProposalsV2Float(
       k_dim, k_type, handle->queue, (float *)scores, (float *)bbox_deltas,
       (float *)im_shape, (float *)anchors, (float *)variances,
       (float *)workspace, (float *)rpn_rois, (float *)rpn_roi_probs,
       (int *)rpn_rois_num, (int *)rpn_rois_batch_size, pre_nms_top_n,
-      post_nms_top_n, nms_thresh, min_size, eta, pixel_offset, N, A, H, W));
+      post_nms_top_n, nms_thresh, min_size, eta, pixel_offset, N, A, H, W,
+      batch_parallel, plan.core_workspace_num));
   GEN_CASE_END();
   return MLUOP_STATUS_SUCCESS;
 }
+
+// About 39 ops per anchor for decoding, filtering and NMS.
+static mluOpStatus_t costGenerateProposalsV2(
+    mluOpHandle_t handle, const mluOpTensorDescriptor_t *descs, int desc_num,
+    mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0]->dim == 4);
+  const int64_t N = descs[0]->dims[0];
+  const int64_t H = descs[0]->dims[1];
+  const int64_t W = descs[0]->dims[2];
+  const int64_t A = descs[0]->dims[3];
+  GenerateProposalsV2Plan plan;
+  getGenerateProposalsV2Plan(handle, N, H * W * A, &plan);
+  cost->k_dim = plan.k_dim;
+  cost->k_type = plan.k_type;
+  cost->theory_ops = 39 * N * A * H * W;
+  cost->theory_io_bytes = mluop::runtime::getTensorsBytes(descs, desc_num);
+  cost->compute_dtype = descs[0]->dtype;
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("generate_proposals_v2", 8, costGenerateProposalsV2);
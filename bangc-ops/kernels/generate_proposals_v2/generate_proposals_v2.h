@@ -0,0 +1,51 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_GENERATE_PROPOSALS_V2_GENERATE_PROPOSALS_V2_H_
+#define KERNELS_GENERATE_PROPOSALS_V2_GENERATE_PROPOSALS_V2_H_
+#include <cstddef>
+
+#include "core/context.h"
+#include "mlu_op.h"
+
+/* How mluOpGenerateProposalsV2 runs a batch of N images of HWA anchors.
+ * By default all cores of the launch work on one image at a time and sync
+ * through the workspace. With batch_parallel every core takes whole images
+ * alone, image i on core i % k_dim.x, in a workspace slice of
+ * core_workspace_num floats, and no core waits for another until the rois
+ * of all images are compacted.
+ * */
+struct GenerateProposalsV2Plan {
+  cnrtDim3_t k_dim = {1, 1, 1};
+  cnrtFunctionType_t k_type = CNRT_FUNC_TYPE_BLOCK;
+  bool batch_parallel = false;
+  int core_workspace_num = 0;
+  size_t workspace_size = 0;
+};
+
+/* picks batch_parallel when the images in flight cover the cores at least
+ * as well as splitting every image over the cores, and the workspace
+ * slices stay below 2^31 bytes. Needs a union launch for the final sync.
+ * */
+void getGenerateProposalsV2Plan(mluOpHandle_t handle, const int N,
+                                const int HWA, GenerateProposalsV2Plan *plan);
+#endif  // KERNELS_GENERATE_PROPOSALS_V2_GENERATE_PROPOSALS_V2_H_
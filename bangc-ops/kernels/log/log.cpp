@@ -25,6 +25,8 @@
 #include "core/context.h"
 #include "core/gen_case.h"
 #include "core/logging.h"
+#include "core/runtime/chunked_launch.h"
+#include "core/runtime/cost_model.h"
 #include "core/runtime/device.h"
 #include "core/tensor.h"
 #include "core/type.h"
@@ -36,6 +38,7 @@ mluOpStatus_t MLUOP_WIN_API
 mluOpLog(mluOpHandle_t handle, const mluOpComputationPreference_t prefer,
          const mluOpLogBase_t base, const mluOpTensorDescriptor_t x_desc,
          const void *x, const mluOpTensorDescriptor_t y_desc, void *y) {
+  MLUOP_PROFILE_OP("mluOpLog");
   mluOpDataType_t support_type[2] = {MLUOP_DTYPE_HALF, MLUOP_DTYPE_FLOAT};
   bool zero_element = false;
   mluOpStatus_t param_check =
@@ -48,6 +51,9 @@ mluOpLog(mluOpHandle_t handle, const mluOpComputationPreference_t prefer,
     return MLUOP_STATUS_SUCCESS;
   }
 
+  MLUOP_PROFILE_TENSOR(x_desc);
+  MLUOP_PROFILE_TENSOR(y_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("log");
     GEN_CASE_HANDLE(handle);
@@ -55,6 +61,7 @@ mluOpLog(mluOpHandle_t handle, const mluOpComputationPreference_t prefer,
     GEN_CASE_DATA(false, "y", y, y_desc, 0, 0);
     GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
   }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
 
   cnrtFunctionType_t k_type;
   cnrtDim3_t k_dim;
@@ -73,7 +80,8 @@ mluOpLog(mluOpHandle_t handle, const mluOpComputationPreference_t prefer,
     coef = log10(exp(1));
   }
 
-  int element_num = mluOpGetTensorElementNum(x_desc);
+  int64_t element_num = mluOpGetTensorElementNum(x_desc);
+  size_t dtype_size = getSizeOfDataType(x_desc->dtype);
 
   void (*mluOpBlockKernelUnary)(cnrtDim3_t k_dim, cnrtFunctionType_t k_type,
                                 cnrtQueue_t queue, const void *x, void *y,
@@ -106,8 +114,27 @@ mluOpLog(mluOpHandle_t handle, const mluOpComputationPreference_t prefer,
       }
     }
   }
-  KERNEL_CHECK((mluOpBlockKernelUnary(k_dim, k_type, handle->queue, x, y,
-                                      element_num, coef)));
+  auto launch = [&](int64_t offset, int64_t num) {
+    KERNEL_CHECK((mluOpBlockKernelUnary(
+        k_dim, k_type, handle->queue,
+        mluop::runtime::elementOffset(x, offset, dtype_size),
+        mluop::runtime::elementOffset(y, offset, dtype_size), num, coef)));
+    return MLUOP_STATUS_SUCCESS;
+  };
+  CHECK_RETURN("[mluOpLog]", mluop::runtime::launchInChunks(
+                                 element_num, LAUNCH_CHUNK_MAX_NUM, launch));
   GEN_CASE_END();
   return MLUOP_STATUS_SUCCESS;
 }
+
+// One op per element of x.
+static mluOpStatus_t costLog(mluOpHandle_t handle,
+                             const mluOpTensorDescriptor_t *descs,
+                             int desc_num, mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  mluop::runtime::setElementwiseCost(descs, desc_num,
+                                     descs[0]->total_element_num, 1, cost);
+  unaryOpPolicyFunc(handle, descs[0], &cost->k_dim, &cost->k_type);
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("log", 2, costLog);
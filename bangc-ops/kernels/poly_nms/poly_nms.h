@@ -31,6 +31,12 @@
 #include "mlu_op.h"
 
 #define MASK_T_BITWIDTH 32  // mask will be stored in an uint32_t value
+// box number of a tile of the tiled kernels, a multiple of
+// 32 * MASK_T_BITWIDTH so the mask block rows stay NFU aligned
+#define POLY_NMS_TILE_BOX_NUM 1024
+// the [N, N] bit mask in the workspace takes N * N / 8 bytes, the box number
+// is limited so that it stays within 2 GB
+#define POLY_NMS_MAX_BOX_NUM 131072
 
 template <int MIN_BOX_NUM_PER_CORE>
 struct BlockConfig {
@@ -122,6 +128,17 @@ __mlu_global__ void mluGenNmsMask(const float *__restrict__ input_boxes,
                                   const float *__restrict__ boxes_area,
                                   uint32_t *mask, int *sort_info);
 
+/**
+ * The same as mluGenNmsMask for box sets too large for NRAM. Boxes are loaded
+ * by tiles of POLY_NMS_TILE_BOX_NUM, and the mask is written block by block,
+ * a block being the mask of a tile of rows over a tile of columns.
+ */
+__mlu_global__ void mluGenNmsMaskTiled(const float *__restrict__ input_boxes,
+                                       int input_boxes_num, int real_width,
+                                       float threshold,
+                                       const float *__restrict__ boxes_area,
+                                       uint32_t *mask, int *sort_info);
+
 /**
  * Gen result by reduce the masks generated by mluGenNmsMask
  *
@@ -150,4 +167,71 @@ mluGenNmsResult<OutputOrder::LOW_BOX_ID_FIRST>(
     int input_boxes_num, const uint32_t *__restrict__ p_mask,
     const int *__restrict__ p_sort_info, int *o_index, int *o_num);
 
+/**
+ * The same as mluGenNmsResult for box sets too large for NRAM, sort_info is
+ * scanned and o_index is written by tiles of POLY_NMS_TILE_BOX_NUM, only the
+ * reduced mask of mask_col_num values stays in NRAM.
+ */
+template <OutputOrder OUTPUT_ORDER>
+__mlu_global__ void mluGenNmsResultTiled(int input_boxes_num,
+                                         const uint32_t *__restrict__ p_mask,
+                                         const int *__restrict__ p_sort_info,
+                                         int *o_index, int *o_num);
+
+extern template __mlu_global__ void
+mluGenNmsResultTiled<OutputOrder::HIGH_SCORE_FIRST>(
+    int input_boxes_num, const uint32_t *__restrict__ p_mask,
+    const int *__restrict__ p_sort_info, int *o_index, int *o_num);
+
+extern template __mlu_global__ void
+mluGenNmsResultTiled<OutputOrder::LOW_BOX_ID_FIRST>(
+    int input_boxes_num, const uint32_t *__restrict__ p_mask,
+    const int *__restrict__ p_sort_info, int *o_index, int *o_num);
+
+/**
+ * Generate launch config for mluPolyNmsBatched and mluPolyNmsBatchedPack, a
+ * BLOCK task runs at least one (image, class) group or one image.
+ */
+struct MLUPolyNmsBatchedLaunchConfig : public BlockConfig<1> {
+  using BlockConfig::BlockConfig;
+};
+
+/**
+ * A block kernel running the poly nms of every (image, class) group of a
+ * [B,N,9] array of input_boxes, the groups are split among the cores.
+ *
+ * The kept box ids of a group are written in ascending order to the row of
+ * its image in group_index, starting at the number of boxes of the lower
+ * classes of the image, mluPolyNmsBatchedPack packs them afterwards.
+ *
+ * @param input_boxes device pointer to boxes
+ * @param batch_num the value of B
+ * @param input_boxes_num the value of N
+ * @param real_width the stride between boxes (if no padding, it should be 9)
+ * @param class_ids device pointer to the [B,N] class ids, NULL to put every
+ * box of an image in class 0
+ * @param class_num the number of classes, boxes of other class ids are dropped
+ * @param threshold the IOU threshold
+ * @param boxes_area device pointer to the [B,N] boxes' area
+ * @param group_index[out] device pointer to [B,N] kept box ids
+ * @param group_member_num[out] device pointer to [B,class_num] box numbers
+ * @param o_num[out] device pointer to [B,class_num] kept box numbers
+ */
+__mlu_global__ void mluPolyNmsBatched(
+    const float *__restrict__ input_boxes, int batch_num, int input_boxes_num,
+    int real_width, const int *__restrict__ class_ids, int class_num,
+    float threshold, const float *__restrict__ boxes_area, int *group_index,
+    int *group_member_num, int *o_num);
+
+/**
+ * Packs the kept box ids of the groups of every image written by
+ * mluPolyNmsBatched, the groups of an image follow each other in class order
+ * in its row of the [B,N] o_index.
+ */
+__mlu_global__ void mluPolyNmsBatchedPack(
+    int batch_num, int input_boxes_num, int class_num,
+    const int *__restrict__ group_index,
+    const int *__restrict__ group_member_num, const int *__restrict__ o_num,
+    int *o_index);
+
 #endif  // BANGC_OPS_KERNELS_POLY_NMS_POLY_NMS_H
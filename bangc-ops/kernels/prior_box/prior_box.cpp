@@ -23,6 +23,7 @@
 #include <string>
 
 #include "core/gen_case.h"
+#include "core/runtime/cost_model.h"
 #include "core/runtime/device.h"
 #include "mlu_op_kernel.h"
 
@@ -149,6 +150,7 @@ mluOpStatus_t mluOpPriorBox(
     const bool min_max_aspect_ratios_order,
     const mluOpTensorDescriptor_t output_desc, void *output,
     const mluOpTensorDescriptor_t var_desc, void *var) {
+  MLUOP_PROFILE_OP("mluOpPriorBox");
   // param check
   mluOpStatus_t pb_status = mluOpPriorBoxParamCheck(
       handle, min_sizes_desc, min_sizes, aspect_ratios_desc, aspect_ratios,
@@ -190,6 +192,13 @@ mluOpStatus_t mluOpPriorBox(
                              ? min_sizes_num * aspect_ratios_num + max_sizes_num
                              : min_sizes_num * aspect_ratios_num;
 
+  MLUOP_PROFILE_TENSOR(min_sizes_desc);
+  MLUOP_PROFILE_TENSOR(aspect_ratios_desc);
+  MLUOP_PROFILE_TENSOR(variances_desc);
+  MLUOP_PROFILE_TENSOR(max_sizes_desc);
+  MLUOP_PROFILE_TENSOR(output_desc);
+  MLUOP_PROFILE_TENSOR(var_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("prior_box");
     GEN_CASE_HANDLE(handle);
@@ -213,6 +222,7 @@ mluOpStatus_t mluOpPriorBox(
     GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
   }
   GEN_CASE_END();
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
   cnrtDim3_t k_dim_box;
   cnrtFunctionType_t k_type;
   policyFuncPriorBox(handle, &k_dim_box, &k_type, height);
@@ -227,3 +237,20 @@ mluOpStatus_t mluOpPriorBox(
   VLOG(5) << "End mluOpBlockKernelPriorBoxFloat kernel";
   return MLUOP_STATUS_SUCCESS;
 }
+
+// About 10 ops per prior box, output is [height, width, num_priors, 4].
+static mluOpStatus_t costPriorBox(mluOpHandle_t handle,
+                                  const mluOpTensorDescriptor_t *descs,
+                                  int desc_num,
+                                  mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[4] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[4]->dim == 4);
+  const mluOpTensorDescriptor_t output_desc = descs[4];
+  const int height = output_desc->dims[0];
+  policyFuncPriorBox(handle, &cost->k_dim, &cost->k_type, height);
+  cost->theory_ops = output_desc->total_element_num / 4 * 10;
+  cost->theory_io_bytes = mluop::runtime::getTensorsBytes(descs, desc_num);
+  cost->compute_dtype = output_desc->dtype;
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("prior_box", 6, costPriorBox);
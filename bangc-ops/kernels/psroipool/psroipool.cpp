@@ -24,6 +24,7 @@
 
 #include "core/gen_case.h"
 #include "core/logging.h"
+#include "core/runtime/cost_model.h"
 #include "core/runtime/device.h"
 #include "core/tensor.h"
 #include "core/type.h"
@@ -208,6 +209,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpPsRoiPoolForward(
     const mluOpTensorDescriptor_t rois_desc, const void *rois,
     const mluOpTensorDescriptor_t output_desc, void *output,
     const mluOpTensorDescriptor_t mapping_channel_desc, void *mapping_channel) {
+  MLUOP_PROFILE_OP("mluOpPsRoiPoolForward");
   const std::string api = "[mluOpPsRoiPoolForward]";
   mluOpStatus_t ret = psRoiPoolForwardParamCheck(
       api, handle, pooled_height, pooled_width, spatial_scale, group_size,
@@ -226,6 +228,11 @@ mluOpStatus_t MLUOP_WIN_API mluOpPsRoiPoolForward(
   const int rois_sum = output_desc->dims[0];
   const int rois_offset = rois_desc->dims[1];
 
+  MLUOP_PROFILE_TENSOR(input_desc);
+  MLUOP_PROFILE_TENSOR(rois_desc);
+  MLUOP_PROFILE_TENSOR(output_desc);
+  MLUOP_PROFILE_TENSOR(mapping_channel_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("psroipool_forward");
     GEN_CASE_HANDLE(handle);
@@ -244,6 +251,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpPsRoiPoolForward(
     GEN_CASE_OP_PARAM_SINGLE(2, "psroipool_forward", "group_size", group_size);
     GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
   }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
 
   cnrtDim3_t k_dim;
   cnrtFunctionType_t k_type;
@@ -266,6 +274,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpPsRoiPoolBackward(
     const mluOpTensorDescriptor_t mapping_channel_desc,
     const void *mapping_channel, const mluOpTensorDescriptor_t bottom_grad_desc,
     void *bottom_grad) {
+  MLUOP_PROFILE_OP("mluOpPsRoiPoolBackward");
   const std::string api = "[mluOpPsRoiPoolBackward]";
   mluOpStatus_t ret = psRoiPoolBackwardParamCheck(
       api, handle, pooled_height, pooled_width, spatial_scale, output_dim,
@@ -300,6 +309,11 @@ mluOpStatus_t MLUOP_WIN_API mluOpPsRoiPoolBackward(
   const int rois_sum = rois_desc->dims[0];
   const int rois_offset = rois_desc->dims[1];
 
+  MLUOP_PROFILE_TENSOR(top_grad_desc);
+  MLUOP_PROFILE_TENSOR(rois_desc);
+  MLUOP_PROFILE_TENSOR(mapping_channel_desc);
+  MLUOP_PROFILE_TENSOR(bottom_grad_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("psroipool_backward");
     GEN_CASE_HANDLE(handle);
@@ -318,6 +332,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpPsRoiPoolBackward(
                              spatial_scale);
     GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
   }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
 
   cnrtDim3_t k_dim;
   cnrtFunctionType_t k_type;
@@ -339,3 +354,59 @@ mluOpStatus_t MLUOP_WIN_API mluOpPsRoiPoolBackward(
   GEN_CASE_END();
   return MLUOP_STATUS_SUCCESS;
 }
+
+// The ops of pooling a bin depend on the size of the rois, the estimates
+// assume rois covering the whole input: 7 ops per input element of a bin.
+static int64_t binArea(const mluOpTensorDescriptor_t input_desc,
+                       const mluOpTensorDescriptor_t pooled_desc) {
+  const int64_t bin_h =
+      (input_desc->dims[1] + pooled_desc->dims[1] - 1) / pooled_desc->dims[1];
+  const int64_t bin_w =
+      (input_desc->dims[2] + pooled_desc->dims[2] - 1) / pooled_desc->dims[2];
+  return bin_h * bin_w;
+}
+
+static mluOpStatus_t costPsRoiPoolForward(
+    mluOpHandle_t handle, const mluOpTensorDescriptor_t *descs, int desc_num,
+    mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[2] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0]->dim == 4);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[2]->dim == 4);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[2]->dims[1] > 0);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[2]->dims[2] > 0);
+  const mluOpTensorDescriptor_t input_desc = descs[0];
+  const mluOpTensorDescriptor_t output_desc = descs[2];
+  policyFuncPsRoiPool(handle, &cost->k_dim, &cost->k_type,
+                      output_desc->dims[0]);
+  cost->theory_ops = output_desc->total_element_num *
+                     (7 * binArea(input_desc, output_desc) + 1);
+  cost->theory_io_bytes = mluop::runtime::getTensorsBytes(descs, desc_num);
+  cost->compute_dtype = input_desc->dtype;
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("psroipool_forward", 4, costPsRoiPoolForward);
+
+// bottom_grad is zeroed before the main kernel.
+static mluOpStatus_t costPsRoiPoolBackward(
+    mluOpHandle_t handle, const mluOpTensorDescriptor_t *descs, int desc_num,
+    mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[3] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0]->dim == 4);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[3]->dim == 4);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0]->dims[1] > 0);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0]->dims[2] > 0);
+  const mluOpTensorDescriptor_t top_grad_desc = descs[0];
+  const mluOpTensorDescriptor_t bottom_grad_desc = descs[3];
+  const int nums =
+      top_grad_desc->dims[0] * top_grad_desc->dims[1] * top_grad_desc->dims[2];
+  policyFuncPsRoiPool(handle, &cost->k_dim, &cost->k_type, nums);
+  cost->theory_ops = top_grad_desc->total_element_num * 7 *
+                     binArea(bottom_grad_desc, top_grad_desc);
+  cost->theory_io_bytes = mluop::runtime::getTensorsBytes(descs, desc_num);
+  cost->kernel_num = 2;
+  cost->compute_dtype = top_grad_desc->dtype;
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("psroipool_backward", 4, costPsRoiPoolBackward);
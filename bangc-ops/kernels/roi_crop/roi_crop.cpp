@@ -25,6 +25,7 @@
 #include "core/context.h"
 #include "core/gen_case.h"
 #include "core/logging.h"
+#include "core/runtime/cost_model.h"
 #include "core/runtime/device.h"
 #include "core/tensor.h"
 #include "core/type.h"
@@ -170,6 +171,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpRoiCropForward(
     mluOpHandle_t handle, const mluOpTensorDescriptor_t input_desc,
     const void *input, const mluOpTensorDescriptor_t grid_desc,
     const void *grid, const mluOpTensorDescriptor_t output_desc, void *output) {
+  MLUOP_PROFILE_OP("mluOpRoiCropForward");
   // check params
   mluOpStatus_t param_check =
       RoiCropForwardParamCheck("[mluOpRoiCropForward]", handle, input_desc,
@@ -187,6 +189,10 @@ mluOpStatus_t MLUOP_WIN_API mluOpRoiCropForward(
   uint32_t output_w = output_desc->dims[2];
   uint32_t bin_num = grid_n * output_h * output_w;
 
+  MLUOP_PROFILE_TENSOR(input_desc);
+  MLUOP_PROFILE_TENSOR(grid_desc);
+  MLUOP_PROFILE_TENSOR(output_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("roi_crop_forward");
     GEN_CASE_HANDLE(handle);
@@ -195,6 +201,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpRoiCropForward(
     GEN_CASE_DATA(false, "output", output, output_desc, 0, 0);
     GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
   }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
 
   cnrtDim3_t k_dim;
   cnrtFunctionType_t k_type;
@@ -216,6 +223,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpRoiCropBackward(
     const void *grad_output, const mluOpTensorDescriptor_t grid_desc,
     const void *grid, const mluOpTensorDescriptor_t grad_input_desc,
     void *grad_input) {
+  MLUOP_PROFILE_OP("mluOpRoiCropBackward");
   // check params
   mluOpStatus_t param_check = RoiCropBackwardParamCheck(
       "[mluOpRoiCropBackward]", handle, grad_output_desc, grad_output,
@@ -233,6 +241,10 @@ mluOpStatus_t MLUOP_WIN_API mluOpRoiCropBackward(
   uint32_t output_w = grad_output_desc->dims[2];
   uint32_t bin_num = grid_n * output_h * output_w;
 
+  MLUOP_PROFILE_TENSOR(grad_output_desc);
+  MLUOP_PROFILE_TENSOR(grid_desc);
+  MLUOP_PROFILE_TENSOR(grad_input_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("roi_crop_backward");
     GEN_CASE_HANDLE(handle);
@@ -241,6 +253,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpRoiCropBackward(
     GEN_CASE_DATA(false, "grad_input", grad_input, grad_input_desc, 0, 0);
     GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
   }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
 
   cnrtDim3_t k_dim;
   cnrtFunctionType_t k_type;
@@ -261,3 +274,42 @@ mluOpStatus_t MLUOP_WIN_API mluOpRoiCropBackward(
   GEN_CASE_END();
   return MLUOP_STATUS_SUCCESS;
 }
+
+// Bilinear sampling, about 7 ops per element of the input.
+static mluOpStatus_t costRoiCropForward(mluOpHandle_t handle,
+                                        const mluOpTensorDescriptor_t *descs,
+                                        int desc_num,
+                                        mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[2] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[2]->dim == 4);
+  const mluOpTensorDescriptor_t output_desc = descs[2];
+  const int bin_num =
+      output_desc->dims[0] * output_desc->dims[1] * output_desc->dims[2];
+  policyFunc(handle, bin_num, &cost->k_dim, &cost->k_type);
+  cost->theory_ops = descs[0]->total_element_num * 7;
+  cost->theory_io_bytes = mluop::runtime::getTensorsBytes(descs, desc_num);
+  cost->compute_dtype = descs[0]->dtype;
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("roi_crop_forward", 3, costRoiCropForward);
+
+// About 8 ops per element of grad_output, grad_input is zeroed before the
+// main kernel.
+static mluOpStatus_t costRoiCropBackward(mluOpHandle_t handle,
+                                         const mluOpTensorDescriptor_t *descs,
+                                         int desc_num,
+                                         mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0]->dim == 4);
+  const mluOpTensorDescriptor_t grad_output_desc = descs[0];
+  const int bin_num = grad_output_desc->dims[0] * grad_output_desc->dims[1] *
+                      grad_output_desc->dims[2];
+  policyFunc(handle, bin_num, &cost->k_dim, &cost->k_type);
+  cost->theory_ops = grad_output_desc->total_element_num * 8;
+  cost->theory_io_bytes = mluop::runtime::getTensorsBytes(descs, desc_num);
+  cost->kernel_num = 2;
+  cost->compute_dtype = grad_output_desc->dtype;
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("roi_crop_backward", 3, costRoiCropBackward);
@@ -23,6 +23,8 @@
 #include "core/context.h"
 #include "core/gen_case.h"
 #include "core/logging.h"
+#include "core/runtime/chunked_launch.h"
+#include "core/runtime/cost_model.h"
 #include "core/runtime/device.h"
 #include "core/tensor.h"
 #include "core/type.h"
@@ -37,6 +39,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpSqrt(mluOpHandle_t handle,
                                       const void *x,
                                       const mluOpTensorDescriptor_t y_desc,
                                       void *y) {
+  MLUOP_PROFILE_OP("mluOpSqrt");
   mluOpDataType_t support_type[2] = {MLUOP_DTYPE_HALF, MLUOP_DTYPE_FLOAT};
   bool zero_element = false;
   mluOpStatus_t param_check =
@@ -49,6 +52,9 @@ mluOpStatus_t MLUOP_WIN_API mluOpSqrt(mluOpHandle_t handle,
     return MLUOP_STATUS_SUCCESS;
   }
 
+  MLUOP_PROFILE_TENSOR(x_desc);
+  MLUOP_PROFILE_TENSOR(y_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("sqrt");
     GEN_CASE_HANDLE(handle);
@@ -56,6 +62,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpSqrt(mluOpHandle_t handle,
     GEN_CASE_DATA(true, "y", y, y_desc, 0, 0);
     GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
   }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
 
   // Choose the best task dimension.
   cnrtDim3_t k_dim;
@@ -64,7 +71,8 @@ mluOpStatus_t MLUOP_WIN_API mluOpSqrt(mluOpHandle_t handle,
   VLOG(5) << "[mluOpSqrt] launch kernel policyFUnc[" << k_dim.x << ", "
           << k_dim.y << ", " << k_dim.z << "]";
 
-  int element_num = mluOpGetTensorElementNum(x_desc);
+  int64_t element_num = mluOpGetTensorElementNum(x_desc);
+  size_t dtype_size = getSizeOfDataType(x_desc->dtype);
   void (*mluOpBlockKernelUnary)(cnrtDim3_t k_dim, cnrtFunctionType_t k_type,
                                 cnrtQueue_t queue, const void *x, void *y,
                                 int element_num);
@@ -96,8 +104,15 @@ mluOpStatus_t MLUOP_WIN_API mluOpSqrt(mluOpHandle_t handle,
       }
     }
   }
-  KERNEL_CHECK(
-      (mluOpBlockKernelUnary(k_dim, k_type, handle->queue, x, y, element_num)));
+  auto launch = [&](int64_t offset, int64_t num) {
+    KERNEL_CHECK((mluOpBlockKernelUnary(
+        k_dim, k_type, handle->queue,
+        mluop::runtime::elementOffset(x, offset, dtype_size),
+        mluop::runtime::elementOffset(y, offset, dtype_size), num)));
+    return MLUOP_STATUS_SUCCESS;
+  };
+  CHECK_RETURN("[mluOpSqrt]", mluop::runtime::launchInChunks(
+                                  element_num, LAUNCH_CHUNK_MAX_NUM, launch));
   GEN_CASE_END();
   return MLUOP_STATUS_SUCCESS;
 }
@@ -106,6 +121,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpSqrtBackward(
     mluOpHandle_t handle, const mluOpTensorDescriptor_t y_desc, const void *y,
     const mluOpTensorDescriptor_t dy_desc, const void *diff_y,
     const mluOpTensorDescriptor_t dx_desc, void *diff_x) {
+  MLUOP_PROFILE_OP("mluOpSqrtBackward");
   mluOpDataType_t support_type[2] = {MLUOP_DTYPE_HALF, MLUOP_DTYPE_FLOAT};
   int number_of_supported_types = 2;
   bool zero_element = false;
@@ -119,6 +135,10 @@ mluOpStatus_t MLUOP_WIN_API mluOpSqrtBackward(
     return MLUOP_STATUS_SUCCESS;
   }
 
+  MLUOP_PROFILE_TENSOR(y_desc);
+  MLUOP_PROFILE_TENSOR(dy_desc);
+  MLUOP_PROFILE_TENSOR(dx_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("sqrt_backward");
     GEN_CASE_HANDLE(handle);
@@ -127,12 +147,14 @@ mluOpStatus_t MLUOP_WIN_API mluOpSqrtBackward(
     GEN_CASE_DATA(false, "diff_x", diff_x, dx_desc, 0, 0);
     GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
   }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
 
   cnrtDim3_t k_dim;
   cnrtFunctionType_t k_type;
   binaryOpPolicyFunc(handle, y_desc, handle->nram_size, &k_dim, &k_type);
 
-  int num_elem = mluOpGetTensorElementNum(y_desc);
+  int64_t num_elem = mluOpGetTensorElementNum(y_desc);
+  size_t dtype_size = getSizeOfDataType(y_desc->dtype);
   void (*mluOpBlockKernelBinary)(
       cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
       const void *y, const void *diff_y, void *diff_x, int num_elem);
@@ -146,8 +168,43 @@ mluOpStatus_t MLUOP_WIN_API mluOpSqrtBackward(
     mluOpBlockKernelBinary =
         mluOpBlockKernel3StagePipelineSqrtBackwardFloatFast;
   }
-  KERNEL_CHECK((mluOpBlockKernelBinary(k_dim, k_type, handle->queue, y, diff_y,
-                                       diff_x, num_elem)));
+  auto launch = [&](int64_t offset, int64_t num) {
+    KERNEL_CHECK((mluOpBlockKernelBinary(
+        k_dim, k_type, handle->queue,
+        mluop::runtime::elementOffset(y, offset, dtype_size),
+        mluop::runtime::elementOffset(diff_y, offset, dtype_size),
+        mluop::runtime::elementOffset(diff_x, offset, dtype_size), num)));
+    return MLUOP_STATUS_SUCCESS;
+  };
+  CHECK_RETURN("[mluOpSqrtBackward]",
+               mluop::runtime::launchInChunks(num_elem, LAUNCH_CHUNK_MAX_NUM,
+                                              launch));
   GEN_CASE_END();
   return MLUOP_STATUS_SUCCESS;
 }
+
+// One op per element of x.
+static mluOpStatus_t costSqrt(mluOpHandle_t handle,
+                              const mluOpTensorDescriptor_t *descs,
+                              int desc_num, mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  mluop::runtime::setElementwiseCost(descs, desc_num,
+                                     descs[0]->total_element_num, 1, cost);
+  unaryOpPolicyFunc(handle, descs[0], &cost->k_dim, &cost->k_type);
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("sqrt", 2, costSqrt);
+
+// One op per element of y.
+static mluOpStatus_t costSqrtBackward(mluOpHandle_t handle,
+                                      const mluOpTensorDescriptor_t *descs,
+                                      int desc_num,
+                                      mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  mluop::runtime::setElementwiseCost(descs, desc_num,
+                                     descs[0]->total_element_num, 1, cost);
+  binaryOpPolicyFunc(handle, descs[0], handle->nram_size, &cost->k_dim,
+                     &cost->k_type);
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("sqrt_backward", 3, costSqrtBackward);
@@ -28,6 +28,7 @@
 #include "core/gen_case.h"
 #include "core/logging.h"
 #include "core/runtime/device.h"
+#include "core/stride_coalesce.h"
 #include "core/tensor.h"
 #include "core/type.h"
 #include "tensor_stride_process_mlu.h"
@@ -36,58 +37,10 @@
 using std::vector;
 
 // Check if tensor need stride process.
-bool ifNeedTensorStrideProcess(const mluOpTensorDescriptor_t tensor_desc) {
-  bool needStrideProcess = false;
-  int tensor_dim = tensor_desc->dim;
-  int stride_base = 1;
-  for (int i = tensor_dim - 1; i >= 0; i--) {
-    if (tensor_desc->dims[i] != 1) {
-      if (tensor_desc->strides[i] == stride_base) {
-        stride_base *= tensor_desc->dims[i];
-      } else {
-        needStrideProcess = true;
-        break;
-      }
-    }
-  }
-  return needStrideProcess;
-}
-
-bool isDenseStrideTensor(const mluOpTensorDescriptor_t tensor_desc) {
-  int tensor_dim = tensor_desc->dim;
-  std::vector<int> dims;
-  std::vector<int> strides;
-  std::vector<int> perm;
-  for (int i = 0; i < tensor_dim; i++) {
-    dims.emplace_back(tensor_desc->dims[i]);
-    strides.emplace_back(tensor_desc->strides[i]);
-    perm.emplace_back(i);
-  }
-
-  if (tensor_dim == 1) {
-    return dims[0] < 2 || strides[0] == 1;
-  }
-  std::sort(perm.begin(), perm.end(), [&](int a, int b) {
-    if (dims[a] < 2) {
-      return false;
-    } else if (dims[b] < 2) {
-      return true;
-    }
-    return strides[a] < strides[b];
-  });
-
-  auto require_stride = 1;
-  for (auto i = 0; i < tensor_dim; i++) {
-    const auto size_perm_i = dims[perm[i]];
-    if (size_perm_i < 2) {
-      return true;
-    }
-    if (strides[perm[i]] != require_stride) {
-      return false;
-    }
-    require_stride *= size_perm_i;
-  }
-  return true;
+// The stride facts are cached in the descriptor by the setters.
+static inline bool ifNeedTensorStrideProcess(
+    const mluOpTensorDescriptor_t tensor_desc) {
+  return !tensor_desc->is_contiguous;
 }
 
 // Tensor may be a stride case, but if the stride of a tensor is dense,
@@ -110,20 +63,16 @@ bool strideCaseWithNotConsistentDense(int tensor_num, ...) {
     va_end(ap);
     return false;
   } else {
+    va_end(ap);
     va_start(ap, tensor_num);
     mluOpTensorDescriptor_t first_tensor = va_arg(ap, mluOpTensorDescriptor_t);
-    if (!isDenseStrideTensor(first_tensor)) {
+    if (!first_tensor->is_dense) {
       va_end(ap);
       return true;
     }
-    int first_dims[MLUOP_DIM_MAX] = {0};
-    int first_stride[MLUOP_DIM_MAX] = {0};
+    const int64_t *first_dims = first_tensor->dims_int64;
+    const int64_t *first_stride = first_tensor->strides_int64;
     auto first_dim = first_tensor->dim;
-    // get first tensor's shape and stride info
-    for (auto i = 0; i < first_dim; i++) {
-      first_dims[i] = first_tensor->dims[i];
-      first_stride[i] = first_tensor->strides[i];
-    }
     // judge whether shapes and strides of tensors are same,
     // if not, need stride process
     // note: we should ignore the dim if the shape at this dim is 1.
@@ -134,9 +83,9 @@ bool strideCaseWithNotConsistentDense(int tensor_num, ...) {
         return true;
       }
       for (auto j = 0; j < first_dim; j++) {
-        if (first_dims[j] != this_tensor->dims[j] ||
+        if (first_dims[j] != this_tensor->dims_int64[j] ||
             ((first_dims[j] != 1) &&
-             (first_stride[j] != this_tensor->strides[j]))) {
+             (first_stride[j] != this_tensor->strides_int64[j]))) {
           va_end(ap);
           return true;
         }
@@ -147,68 +96,87 @@ bool strideCaseWithNotConsistentDense(int tensor_num, ...) {
   return false;
 }
 
-// From tensor_desc get tensor's dims and strides.
-void getTensorShape(const mluOpTensorDescriptor_t tensor_desc,
-                    TensorShape *tensor_shape) {
-  if (!ifNeedTensorStrideProcess(tensor_desc)) {
-    tensor_shape->is_contiguous = true;
-  } else {
-    tensor_shape->is_contiguous = false;
-  }
-  int tensor_dim = tensor_desc->dim;
-  int tensor_dims[MLUOP_DIM_MAX];
-  int tensor_strides[MLUOP_DIM_MAX];
-  int tensor_temp_dims[MLUOP_DIM_MAX];
-  int tensor_temp_strides[MLUOP_DIM_MAX];
-  int total_num = 1;
-  // dims:    (2, 3) -> (1, 1, 1, 1, 1, 1, 2, 3)
-  // strides: (2, 3) -> (0, 0, 0, 0, 0, 0, 2, 3)
+// Fills tensor_shape with `dim` coalesced dims and strides, aligned to the
+// lowest dims.
+// dims:    (2, 60) -> (1, 1, 1, 1, 1, 1,   2, 60)
+// strides: (500, 1) -> (0, 0, 0, 0, 0, 0, 500,  1)
+static void fillTensorShape(int dim, const int64_t *dims,
+                            const int64_t *strides, TensorShape *tensor_shape) {
+  int64_t total_num = 1;
   for (int i = 0; i < MLUOP_DIM_MAX; i++) {
-    if (i < MLUOP_DIM_MAX - tensor_dim) {
-      tensor_dims[i] = 1;
-      tensor_strides[i] = 1;
+    if (i < MLUOP_DIM_MAX - dim) {
+      tensor_shape->tensor_dims[i] = 1;
+      tensor_shape->tensor_strides[i] = 0;
     } else {
-      total_num *= tensor_desc->dims[i + tensor_dim - MLUOP_DIM_MAX];
-      tensor_dims[i] = tensor_desc->dims[i + tensor_dim - MLUOP_DIM_MAX];
-      tensor_strides[i] = tensor_desc->strides[i + tensor_dim - MLUOP_DIM_MAX];
+      tensor_shape->tensor_dims[i] = dims[i + dim - MLUOP_DIM_MAX];
+      tensor_shape->tensor_strides[i] = strides[i + dim - MLUOP_DIM_MAX];
+      total_num *= dims[i + dim - MLUOP_DIM_MAX];
     }
   }
   tensor_shape->total_num = total_num;
-  // dims:    (1, 1, 1, 1, 2, 1, 1, 3) -> (1, 1, 1, 1, 1, 1, 2, 3)
-  // strides: (0, 0, 0, 0, 2, 4, 5, 3) -> (0, 0, 0, 0, 0, 0, 2, 3)
-  for (int i = MLUOP_DIM_MAX - 1, j = MLUOP_DIM_MAX - 1; j >= 0; --i) {
-    if (i < 0) {
-      tensor_temp_dims[j] = 1;
-      tensor_temp_strides[j] = 0;
-      --j;
-    } else if (tensor_dims[i] != 1) {
-      tensor_temp_dims[j] = tensor_dims[i];
-      tensor_temp_strides[j] = tensor_strides[i];
-      --j;
-    }
+}
+
+// From tensor_desc get tensor's dims and strides.
+// dims:    (1, 2, 1, 3, 4, 5) -> (1, 1, 1, 1, 1, 1,   2, 60)
+// strides: (9, 500, 7, 20, 5, 1) -> (0, 0, 0, 0, 0, 0, 500,  1)
+mluOpStatus_t getTensorShape(const mluOpTensorDescriptor_t tensor_desc,
+                             TensorShape *tensor_shape) {
+  tensor_shape->is_contiguous = !ifNeedTensorStrideProcess(tensor_desc);
+  const int tensor_dim = tensor_desc->dim;
+  std::vector<int64_t> dims(tensor_desc->dims_int64,
+                            tensor_desc->dims_int64 + tensor_dim);
+  std::vector<int64_t> strides(tensor_desc->strides_int64,
+                               tensor_desc->strides_int64 + tensor_dim);
+  const int dim = mluop::coalesceDims(tensor_dim, dims.data(), strides.data());
+  if (dim > MLUOP_DIM_MAX) {
+    LOG(ERROR) << "[getTensorShape] the tensor has " << dim
+               << " dims after coalescing, more than " << MLUOP_DIM_MAX
+               << ".";
+    return MLUOP_STATUS_NOT_SUPPORTED;
   }
-  // dims:    (1, 1, 1, 1,   2,  3, 4, 5) -> (1, 1, 1, 1, 1, 1,   2, 60)
-  // strides: (0, 0, 0, 0, 500, 20, 5, 1) -> (0, 0, 0, 0, 0, 0, 500,  1)
-  int offset = 0;
-  for (int i = MLUOP_DIM_MAX - 1; i > 0; i--) {
-    if (tensor_temp_strides[i] == 1 &&
-        tensor_temp_strides[i - 1] == tensor_temp_dims[i]) {
-      tensor_temp_dims[i - 1] *= tensor_temp_dims[i];
-      tensor_temp_strides[i - 1] = 1;
-      offset++;
-    } else {
-      break;
-    }
+  fillTensorShape(dim, dims.data(), strides.data(), tensor_shape);
+  return MLUOP_STATUS_SUCCESS;
+}
+
+// Tensors of the same shape are permuted together from the largest output
+// stride to the smallest before coalescing, so a transposed copy walks the
+// output in order and merges what the permutation made contiguous. Tensors of
+// different shapes only share the element order and are coalesced one by one.
+mluOpStatus_t getCopyTensorShape(const mluOpTensorDescriptor_t input_desc,
+                                 const mluOpTensorDescriptor_t output_desc,
+                                 TensorShape *input_shape,
+                                 TensorShape *output_shape) {
+  bool same_shape = input_desc->dim == output_desc->dim;
+  for (int i = 0; same_shape && i < input_desc->dim; i++) {
+    same_shape = input_desc->dims_int64[i] == output_desc->dims_int64[i];
   }
-  for (int i = 0; i < MLUOP_DIM_MAX; i++) {
-    if (i < offset) {
-      tensor_shape->tensor_dims[i] = 1;
-      tensor_shape->tensor_strides[i] = 0;
-    } else {
-      tensor_shape->tensor_dims[i] = tensor_temp_dims[i - offset];
-      tensor_shape->tensor_strides[i] = tensor_temp_strides[i - offset];
-    }
+  if (!same_shape) {
+    CHECK_RETURN("[getCopyTensorShape]",
+                 getTensorShape(input_desc, input_shape));
+    CHECK_RETURN("[getCopyTensorShape]",
+                 getTensorShape(output_desc, output_shape));
+    return MLUOP_STATUS_SUCCESS;
   }
+  input_shape->is_contiguous = !ifNeedTensorStrideProcess(input_desc);
+  output_shape->is_contiguous = !ifNeedTensorStrideProcess(output_desc);
+  const int tensor_dim = input_desc->dim;
+  std::vector<int64_t> dims(input_desc->dims_int64,
+                            input_desc->dims_int64 + tensor_dim);
+  std::vector<int64_t> input_strides(input_desc->strides_int64,
+                                     input_desc->strides_int64 + tensor_dim);
+  std::vector<int64_t> output_strides(
+      output_desc->strides_int64, output_desc->strides_int64 + tensor_dim);
+  int64_t *strides[2] = {output_strides.data(), input_strides.data()};
+  const int dim = mluop::canonicalizeDims(tensor_dim, dims.data(), strides, 2);
+  if (dim > MLUOP_DIM_MAX) {
+    LOG(ERROR) << "[getCopyTensorShape] the tensors have " << dim
+               << " dims after coalescing, more than " << MLUOP_DIM_MAX
+               << ".";
+    return MLUOP_STATUS_NOT_SUPPORTED;
+  }
+  fillTensorShape(dim, dims.data(), input_strides.data(), input_shape);
+  fillTensorShape(dim, dims.data(), output_strides.data(), output_shape);
+  return MLUOP_STATUS_SUCCESS;
 }
 
 // From tensor_desc and target_shape get the soft expand tensor's dims and
@@ -221,71 +189,23 @@ void getExpandTensorShape(const mluOpTensorDescriptor_t tensor_desc,
                           int *target_shape, int target_dim,
                           TensorShape *tensor_shape) {
   tensor_shape->is_contiguous = false;
-  int tensor_dim = target_dim;
-  int tensor_dims[MLUOP_DIM_MAX];
-  int tensor_strides[MLUOP_DIM_MAX];
-  int tensor_temp_dims[MLUOP_DIM_MAX];
-  int tensor_temp_strides[MLUOP_DIM_MAX];
-  int total_num = 1;
+  int64_t dims[MLUOP_DIM_MAX];
+  int64_t strides[MLUOP_DIM_MAX];
   // target_shape:      (7, 3, 4, 5)
   // tensor_desc_shape:    (3, 1, 5)
   // tensor_desc_stride:   (s1, s2, s3)
-  // dims:    (1, 1, 1, 1, 7, 3, 4, 5)
-  // strides: (0, 0, 0, 0, 0, s1, 0, s3)
-  for (int i = 0; i < MLUOP_DIM_MAX; i++) {
-    tensor_strides[i] = 0;
-    if (i < MLUOP_DIM_MAX - tensor_dim) {  // add 1 at high dim.
-      tensor_dims[i] = 1;
-    } else {
-      total_num *= target_shape[i + tensor_dim - MLUOP_DIM_MAX];
-      tensor_dims[i] =
-          target_shape[i + tensor_dim - MLUOP_DIM_MAX];  // set shape
-      if (i >=
-          MLUOP_DIM_MAX -
-              tensor_desc->dim) {  // set stride if tensor_desc has this stride
-        if (tensor_desc->dims[i + tensor_desc->dim - MLUOP_DIM_MAX] != 1) {
-          tensor_strides[i] =
-              tensor_desc->strides[i + tensor_desc->dim - MLUOP_DIM_MAX];
-        }
-      }
-    }
-  }
-  tensor_shape->total_num = total_num;
-  // dims:    (1, 1, 1, 1, 2, 1, 1, 3) -> (1, 1, 1, 1, 1, 1, 2, 3)
-  // strides: (0, 0, 0, 0, 2, 4, 5, 3) -> (0, 0, 0, 0, 0, 0, 2, 3)
-  for (int i = MLUOP_DIM_MAX - 1, j = MLUOP_DIM_MAX - 1; j >= 0; --i) {
-    if (i < 0) {
-      tensor_temp_dims[j] = 1;
-      tensor_temp_strides[j] = 0;
-      --j;
-    } else if (tensor_dims[i] != 1) {
-      tensor_temp_dims[j] = tensor_dims[i];
-      tensor_temp_strides[j] = tensor_strides[i];
-      --j;
-    }
-  }
-  // dims:    (1, 1, 1, 1,   2,  3, 4, 5) -> (1, 1, 1, 1, 1, 1,   2, 60)
-  // strides: (0, 0, 0, 0, 500, 20, 5, 1) -> (0, 0, 0, 0, 0, 0, 500,  1)
-  int offset = 0;
-  for (int i = MLUOP_DIM_MAX - 1; i > 0; i--) {
-    if (tensor_temp_strides[i] == 1 &&
-        tensor_temp_strides[i - 1] == tensor_temp_dims[i]) {
-      tensor_temp_dims[i - 1] *= tensor_temp_dims[i];
-      tensor_temp_strides[i - 1] = 1;
-      offset++;
-    } else {
-      break;
-    }
-  }
-  for (int i = 0; i < MLUOP_DIM_MAX; i++) {
-    if (i < offset) {
-      tensor_shape->tensor_dims[i] = 1;
-      tensor_shape->tensor_strides[i] = 0;
-    } else {
-      tensor_shape->tensor_dims[i] = tensor_temp_dims[i - offset];
-      tensor_shape->tensor_strides[i] = tensor_temp_strides[i - offset];
+  // dims:    (7, 3, 4, 5)
+  // strides: (0, s1, 0, s3)
+  for (int i = 0; i < target_dim; i++) {
+    dims[i] = target_shape[i];
+    strides[i] = 0;
+    const int desc_i = i + tensor_desc->dim - target_dim;
+    if (desc_i >= 0 && tensor_desc->dims_int64[desc_i] != 1) {
+      strides[i] = tensor_desc->strides_int64[desc_i];
     }
   }
+  const int dim = mluop::coalesceDims(target_dim, dims, strides);
+  fillTensorShape(dim, dims, strides, tensor_shape);
 }
 
 // Policy function
@@ -307,12 +227,17 @@ static mluOpStatus_t policyFunc(mluOpHandle_t handle, cnrtDim3_t *k_dim,
 mluOpStatus_t MLUOP_WIN_API mluOpTensorStrideIn(
     mluOpHandle_t handle, const mluOpTensorDescriptor_t input_desc,
     const void *input, void *output) {
+  MLUOP_PROFILE_OP("mluOpTensorStrideIn");
   TensorShape input_shape;
-  getTensorShape(input_desc, &input_shape);
+  CHECK_RETURN("[mluOpTensorStrideIn]",
+               getTensorShape(input_desc, &input_shape));
   mluOpDataType_t data_type = input_desc->dtype;
   cnrtDim3_t k_dim;
   cnrtFunctionType_t k_type;
 
+  MLUOP_PROFILE_TENSOR(input_desc);
+  MLUOP_PROFILE_TENSOR(input_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
   policyFunc(handle, &k_dim, &k_type, input_shape.total_num);
 
   VLOG(5) << "Launch Kernel mluOpUnion1KernelTensorStrideIn<<<Union"
@@ -326,13 +251,18 @@ mluOpStatus_t MLUOP_WIN_API mluOpTensorStrideIn(
 mluOpStatus_t MLUOP_WIN_API mluOpTensorStrideOut(
     mluOpHandle_t handle, const mluOpTensorDescriptor_t input_desc,
     const void *input, void *output) {
+  MLUOP_PROFILE_OP("mluOpTensorStrideOut");
   TensorShape output_shape;
-  getTensorShape(input_desc, &output_shape);
+  CHECK_RETURN("[mluOpTensorStrideOut]",
+               getTensorShape(input_desc, &output_shape));
 
   mluOpDataType_t data_type = input_desc->dtype;
   cnrtDim3_t k_dim;
   cnrtFunctionType_t k_type;
 
+  MLUOP_PROFILE_TENSOR(input_desc);
+  MLUOP_PROFILE_TENSOR(input_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
   policyFunc(handle, &k_dim, &k_type, output_shape.total_num);
 
   VLOG(5) << "Launch Kernel mluOpUnion1KernelTensorStrideOut<<<Union"
@@ -343,9 +273,9 @@ mluOpStatus_t MLUOP_WIN_API mluOpTensorStrideOut(
   return MLUOP_STATUS_SUCCESS;
 }
 
-static vector<int> getDefaultStride(int *dims, int dim) {
-  vector<int> default_stride(dim, 1);
-  int temp = 1;
+static vector<int64_t> getDefaultStride(const int64_t *dims, int dim) {
+  vector<int64_t> default_stride(dim, 1);
+  int64_t temp = 1;
   for (int i = 0; i < dim; i++) {
     int offset = dim - 1 - i;
     default_stride[offset] = temp;
@@ -357,12 +287,14 @@ static vector<int> getDefaultStride(int *dims, int dim) {
 mluOpStatus_t MLUOP_WIN_API
 mluOpContiguous(mluOpHandle_t handle, const mluOpTensorDescriptor_t input_desc,
                 const void *input, void *output) {
-  auto default_stride = getDefaultStride(input_desc->dims, input_desc->dim);
+  MLUOP_PROFILE_OP("mluOpContiguous");
+  auto default_stride =
+      getDefaultStride(input_desc->dims_int64, input_desc->dim);
   mluOpTensorDescriptor_t temp_desc = nullptr;
   mluOpCreateTensorDescriptor(&temp_desc);
-  mluOpSetTensorDescriptorEx(temp_desc, input_desc->layout, input_desc->dtype,
-                             input_desc->dim, input_desc->dims,
-                             default_stride.data());
+  mluOpSetTensorDescriptorEx_v2(temp_desc, input_desc->layout,
+                                input_desc->dtype, input_desc->dim,
+                                input_desc->dims_int64, default_stride.data());
   auto status_copy = mluOpCopy(handle, input_desc, input, temp_desc, output);
   if (status_copy != MLUOP_STATUS_SUCCESS) {
     KERNEL_CALL_CHECK("mluOpContiguous", "mluOpCopy", status_copy, "");
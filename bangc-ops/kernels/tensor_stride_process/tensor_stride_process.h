@@ -39,8 +39,18 @@ struct TensorShape {
 
 bool strideCaseWithNotConsistentDense(int tensor_num, ...);
 
-void getTensorShape(const mluOpTensorDescriptor_t tensor_desc,
-                    TensorShape *tensor_shape);
+// Fills tensor_shape with the dims and strides of tensor_desc, dims of size
+// 1 are dropped and contiguous adjacent dims merged. Returns
+// MLUOP_STATUS_NOT_SUPPORTED when more than MLUOP_DIM_MAX dims are left.
+mluOpStatus_t getTensorShape(const mluOpTensorDescriptor_t tensor_desc,
+                             TensorShape *tensor_shape);
+
+// The shapes of the input and the output of a strided copy, coalesced
+// together when both have the same dims.
+mluOpStatus_t getCopyTensorShape(const mluOpTensorDescriptor_t input_desc,
+                                 const mluOpTensorDescriptor_t output_desc,
+                                 TensorShape *input_shape,
+                                 TensorShape *output_shape);
 
 mluOpStatus_t MLUOP_WIN_API mluOpTensorStrideIn(
     mluOpHandle_t handle, const mluOpTensorDescriptor_t input_desc,
@@ -25,6 +25,7 @@
 #include "core/context.h"
 #include "core/gen_case.h"
 #include "core/logging.h"
+#include "core/runtime/cost_model.h"
 #include "core/runtime/device.h"
 #include "core/tensor.h"
 #include "core/type.h"
@@ -256,17 +257,54 @@ mluOpStatus_t MLUOP_WIN_API mluOpThreeInterpolateForward(
     const void *indices, const mluOpTensorDescriptor_t weights_desc,
     const void *weights, const mluOpTensorDescriptor_t output_desc,
     void *output) {
-  mluOpStatus_t param_check = ThreeInterpolateForwardParamCheck(
-      "[mluOpThreeInterpolateForward]", handle, features_desc, features,
-      indices_desc, indices, weights_desc, weights, output_desc, output);
-  if (param_check != MLUOP_STATUS_SUCCESS) {
-    return param_check;
+  MLUOP_PROFILE_OP("mluOpThreeInterpolateForward");
+  const std::string API = "[mluOpThreeInterpolateForward]";
+  mluop::runtime::LaunchPlanKey key(API.c_str());
+  key.add(handle).add(features_desc).add(indices_desc).add(weights_desc);
+  key.add(output_desc);
+  mluop::runtime::LaunchPlan plan;
+  if (mluop::runtime::lookupLaunchPlan(handle, key, &plan)) {
+    PARAM_CHECK(API, features != NULL);
+    PARAM_CHECK(API, indices != NULL);
+    PARAM_CHECK(API, weights != NULL);
+    PARAM_CHECK(API, output != NULL);
+  } else {
+    mluOpStatus_t param_check = ThreeInterpolateForwardParamCheck(
+        API, handle, features_desc, features, indices_desc, indices,
+        weights_desc, weights, output_desc, output);
+    if (param_check != MLUOP_STATUS_SUCCESS) {
+      return param_check;
+    }
+    MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
+    int input_size = sizeof(float);
+    if (features_desc->dtype == MLUOP_DTYPE_HALF) {
+      input_size /= 2;
+    }
+    int c_limit_size = NFU_ALIGN_SIZE / input_size;
+    int m_limit_size = c_limit_size;
+    int n_limit_size = c_limit_size;
+    PolicyFuncThreeInterpolateForward(
+        handle, features_desc, features_desc->dims[0], features_desc->dims[1],
+        features_desc->dims[2], output_desc->dims[2], &plan.k_dim,
+        &plan.k_type, c_limit_size, m_limit_size, n_limit_size);
+    plan.tiling[0] = c_limit_size;
+    plan.tiling[1] = m_limit_size;
+    plan.tiling[2] = n_limit_size;
+    mluop::runtime::insertLaunchPlan(handle, key, plan);
   }
   int b = features_desc->dims[0];
   int c = features_desc->dims[1];
   int m = features_desc->dims[2];
   int n = output_desc->dims[2];
+  int c_limit_size = plan.tiling[0];
+  int m_limit_size = plan.tiling[1];
+  int n_limit_size = plan.tiling[2];
 
+  MLUOP_PROFILE_TENSOR(features_desc);
+  MLUOP_PROFILE_TENSOR(indices_desc);
+  MLUOP_PROFILE_TENSOR(weights_desc);
+  MLUOP_PROFILE_TENSOR(output_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("three_interpolate_forward");
     GEN_CASE_HANDLE(handle);
@@ -276,20 +314,10 @@ mluOpStatus_t MLUOP_WIN_API mluOpThreeInterpolateForward(
     GEN_CASE_DATA(false, "output", output, output_desc, 0, 0);
     GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
   }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
 
-  cnrtDim3_t k_dim;
-  cnrtFunctionType_t k_type;
-  int input_size = sizeof(float);
-  if (features_desc->dtype == MLUOP_DTYPE_HALF) {
-    input_size /= 2;
-  }
-  int c_limit_size = NFU_ALIGN_SIZE / input_size;
-  int m_limit_size = c_limit_size;
-  int n_limit_size = c_limit_size;
-  PolicyFuncThreeInterpolateForward(handle, features_desc, b, c, m, n, &k_dim,
-                                    &k_type, c_limit_size, m_limit_size,
-                                    n_limit_size);
-
+  cnrtDim3_t k_dim = plan.k_dim;
+  cnrtFunctionType_t k_type = plan.k_type;
   VLOG(5) << "[mluOpThreeInterpolateForward] launch kernel policyFunc["
           << k_dim.x << ", " << k_dim.y << ", " << k_dim.z << "]";
   if (features_desc->dtype == MLUOP_DTYPE_HALF) {
@@ -306,3 +334,29 @@ mluOpStatus_t MLUOP_WIN_API mluOpThreeInterpolateForward(
   GEN_CASE_END();
   return MLUOP_STATUS_SUCCESS;
 }
+
+// Every output element weights 3 features.
+static mluOpStatus_t costThreeInterpolateForward(
+    mluOpHandle_t handle, const mluOpTensorDescriptor_t *descs, int desc_num,
+    mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[3] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0]->dim == 3);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[3]->dim == 3);
+  const mluOpTensorDescriptor_t features_desc = descs[0];
+  const mluOpTensorDescriptor_t output_desc = descs[3];
+  int input_size = getSizeOfDataType(features_desc->dtype);
+  int c_limit_size = NFU_ALIGN_SIZE / input_size;
+  int m_limit_size = c_limit_size;
+  int n_limit_size = c_limit_size;
+  PolicyFuncThreeInterpolateForward(
+      handle, features_desc, features_desc->dims[0], features_desc->dims[1],
+      features_desc->dims[2], output_desc->dims[2], &cost->k_dim,
+      &cost->k_type, c_limit_size, m_limit_size, n_limit_size);
+  cost->theory_ops = output_desc->total_element_num * 5;
+  cost->theory_io_bytes = mluop::runtime::getTensorsBytes(descs, desc_num);
+  cost->compute_dtype = features_desc->dtype;
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("three_interpolate_forward", 4,
+                       costThreeInterpolateForward);
@@ -24,6 +24,7 @@
 #define KERNELS_UNARY_OP_UNARY_OP_3PIPELINE_H_
 
 #include "kernels/kernel.h"
+#include "mlu_op_kernel.h"
 #define UNARY_ALIGN_NUM 64
 
 #define UNARY_OP_KERNEL_3PIPELINE_DECLARE(Op, DType, Prefer)           \
@@ -42,6 +43,18 @@
         offset_aux_a, offset_aux_b, num_deal, num_pong, coef);             \
   }
 
+#define UNARY_OP_KERNEL_3PIPELINE_FOREACH_IMPLE(Op, DType, Prefer)            \
+  __mlu_global__ void MLUBlockKernel3StagePipelineForeach##Op##DType##Prefer( \
+      mluOpForeachUnaryTable_t table, float coef) {                           \
+    int32_t num_deal = 0, num_pong = 0;                                       \
+    int32_t offset_half = 0, offset_aux_a = 0, offset_aux_b = 0;              \
+    get3Offset##Op##Prefer<DType>(offset_half, offset_aux_a, offset_aux_b,    \
+                                  num_deal, num_pong);                        \
+    block3ForeachUnary<DType, compute##Op##Prefer>(                           \
+        table, nram_buffer, offset_half, offset_aux_a, offset_aux_b,          \
+        num_deal, num_pong, coef);                                            \
+  }
+
 template <typename T, void (*OpFunc)(T *, T *, T *, T *, int, int, float)>
 __mlu_func__ void block3Unary(T *x, T *y, char *nram_buffer, int32_t num_total,
                               int32_t offset_x_half, int32_t offset_aux_a,
@@ -135,4 +148,141 @@ __mlu_func__ void block3Unary(T *x, T *y, char *nram_buffer, int32_t num_total,
     pvUnlock();
   }
 }
+
+// Loads `num` elements of the launch from element `begin` on into `nram`, one
+// copy per segment of `table` the span crosses.
+template <typename T>
+__mlu_func__ void foreachLoad(T *nram, const mluOpForeachUnaryTable_t &table,
+                              int32_t begin, int32_t num) {
+  int32_t seg = 0;
+  while (table.begin[seg + 1] <= begin) {
+    seg++;
+  }
+  while (num > 0) {
+    int32_t seg_rem = table.begin[seg + 1] - begin;
+    int32_t cur_num = num < seg_rem ? num : seg_rem;
+    __memcpy_async(nram, (T *)table.x[seg] + (begin - table.begin[seg]),
+                   cur_num * sizeof(T), GDRAM2NRAM);
+    nram += cur_num;
+    begin += cur_num;
+    num -= cur_num;
+    seg++;
+  }
+}
+
+// Stores `num` elements of `nram` to the launch from element `begin` on.
+template <typename T>
+__mlu_func__ void foreachStore(const mluOpForeachUnaryTable_t &table,
+                               int32_t begin, T *nram, int32_t num) {
+  int32_t seg = 0;
+  while (table.begin[seg + 1] <= begin) {
+    seg++;
+  }
+  while (num > 0) {
+    int32_t seg_rem = table.begin[seg + 1] - begin;
+    int32_t cur_num = num < seg_rem ? num : seg_rem;
+    __memcpy_async((T *)table.y[seg] + (begin - table.begin[seg]), nram,
+                   cur_num * sizeof(T), NRAM2GDRAM);
+    nram += cur_num;
+    begin += cur_num;
+    num -= cur_num;
+    seg++;
+  }
+}
+
+// block3Unary over the segments of a foreach launch. The elements of all
+// segments are split by cores as one run, a tile of num_deal elements may
+// span several tensors and is gathered and scattered piece by piece, so small
+// tensors still fill whole tiles.
+template <typename T, void (*OpFunc)(T *, T *, T *, T *, int, int, float)>
+__mlu_func__ void block3ForeachUnary(const mluOpForeachUnaryTable_t &table,
+                                     char *nram_buffer, int32_t offset_x_half,
+                                     int32_t offset_aux_a,
+                                     int32_t offset_aux_b, int32_t num_deal,
+                                     int32_t num_pong, float coef) {
+  if (coreId == 0x80) {
+    return;
+  }
+  int32_t num_total = table.begin[table.segment_num];
+  int32_t num_per_core = num_total / taskDim;
+  int32_t num_rem = num_total % taskDim;
+  int32_t core_begin = taskId * num_per_core;
+  if (num_rem > 0 && taskId == taskDim - 1) {
+    num_per_core = num_per_core + num_rem;
+  }
+  int32_t repeat = num_per_core / num_deal;
+  int32_t rem = num_per_core % num_deal;
+  int32_t align_rem = CEIL_ALIGN(rem, UNARY_ALIGN_NUM);
+
+  T *nram_x = (T *)nram_buffer;
+  T *nram_x_half = (T *)nram_buffer + offset_x_half;
+  T *nram_aux_a = (T *)nram_buffer + offset_aux_a;
+  T *nram_aux_b = (T *)nram_buffer + offset_aux_b;
+
+  // 3 level pipeline.
+  if (repeat > 0) {
+    foreachLoad(nram_x_half, table, core_begin, num_deal);
+    __asm__ volatile("sync;");
+  }
+
+  if (repeat > 1) {
+    foreachLoad(nram_x_half + num_pong, table, core_begin + num_deal,
+                num_deal);
+    OpFunc(nram_x, nram_x_half, nram_aux_a, nram_aux_b, num_deal, num_deal,
+           coef);
+    __asm__ volatile("sync;");
+  }
+
+  for (int i = 0; i < repeat - 2; i++) {
+    pvLock();
+    foreachStore(table, core_begin + i * num_deal,
+                 nram_x + (i % 2) * num_pong, num_deal);
+    pvUnlock();
+
+    foreachLoad(nram_x_half + (i % 2) * num_pong, table,
+                core_begin + (i + 2) * num_deal, num_deal);
+    OpFunc(nram_x + ((i + 1) % 2) * num_pong,
+           nram_x_half + ((i + 1) % 2) * num_pong, nram_aux_a, nram_aux_b,
+           num_deal, num_deal, coef);
+    __asm__ volatile("sync;");
+  }
+
+  if (repeat > 1) {
+    pvLock();
+    foreachStore(table, core_begin + (repeat - 2) * num_deal,
+                 nram_x + ((repeat - 2) % 2) * num_pong, num_deal);
+    pvUnlock();
+  }
+
+  if (rem > 0) {
+    foreachLoad(nram_x_half + (repeat % 2) * num_pong, table,
+                core_begin + repeat * num_deal, rem);
+  }
+
+  if (repeat > 0) {
+    OpFunc(nram_x + ((repeat - 1) % 2) * num_pong,
+           nram_x_half + ((repeat - 1) % 2) * num_pong, nram_aux_a, nram_aux_b,
+           num_deal, num_deal, coef);
+  }
+  __asm__ volatile("sync;");
+
+  if (repeat > 0) {
+    pvLock();
+    foreachStore(table, core_begin + (repeat - 1) * num_deal,
+                 nram_x + ((repeat - 1) % 2) * num_pong, num_deal);
+    pvUnlock();
+  }
+
+  if (rem > 0) {
+    OpFunc(nram_x + (repeat % 2) * num_pong,
+           nram_x_half + (repeat % 2) * num_pong, nram_aux_a, nram_aux_b,
+           align_rem, rem, coef);
+    __asm__ volatile("sync;");
+
+    pvLock();
+    foreachStore(table, core_begin + repeat * num_deal,
+                 nram_x + (repeat % 2) * num_pong, rem);
+    pvUnlock();
+  }
+}
 #endif  // KERNELS_UNARY_OP_UNARY_OP_3PIPELINE_H_
@@ -34,11 +34,17 @@
 void unaryOpPolicyFunc(const mluOpHandle_t &handle,
                        const mluOpTensorDescriptor_t &desc, cnrtDim3_t *k_dim,
                        cnrtFunctionType_t *k_type) {
+  unaryOpPolicyFunc(handle, mluOpGetTensorElementNum(desc), desc->dtype, k_dim,
+                    k_type);
+}
+
+void unaryOpPolicyFunc(const mluOpHandle_t &handle, const size_t element_num,
+                       const mluOpDataType_t dtype, cnrtDim3_t *k_dim,
+                       cnrtFunctionType_t *k_type) {
   size_t union_number = mluop::runtime::getClusterLimitCapability(handle);
   size_t core_in_cluster = handle->core_num_per_cluster;
   size_t core_number = union_number * core_in_cluster;
-  size_t element_num = mluOpGetTensorElementNum(desc);
-  size_t tensor_size = element_num * getSizeOfDataType(desc->dtype);
+  size_t tensor_size = element_num * getSizeOfDataType(dtype);
   tensor_size = CEIL_ALIGN(tensor_size, NFU_ALIGN_SIZE);
   size_t need_core = CEIL_ALIGN(tensor_size / NFU_ALIGN_SIZE, core_in_cluster);
   *k_type = CNRT_FUNC_TYPE_UNION1;  // default func type
@@ -82,11 +88,11 @@ mluOpStatus_t unaryOpParamCheck(
   }
 
   for (int i = 0; i < x_desc->dim; i++) {
-    if (x_desc->dims[i] != y_desc->dims[i]) {
+    if (x_desc->dims_int64[i] != y_desc->dims_int64[i]) {
       LOG(ERROR) << op_name << ":The shape of x should be equal to y"
                  << ". But now x_desc's shape[" << i << "] is "
-                 << x_desc->dims[i] << ", y_desc's shape[" << i << "] is "
-                 << y_desc->dims[i] << ".";
+                 << x_desc->dims_int64[i] << ", y_desc's shape[" << i
+                 << "] is " << y_desc->dims_int64[i] << ".";
       return MLUOP_STATUS_BAD_PARAM;
     }
   }
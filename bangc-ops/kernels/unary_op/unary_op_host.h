@@ -30,6 +30,12 @@ void unaryOpPolicyFunc(const mluOpHandle_t &handle,
                        const mluOpTensorDescriptor_t &desc, cnrtDim3_t *k_dim,
                        cnrtFunctionType_t *k_type);
 
+// same as above for `element_num` elements of `dtype`, e.g. a foreach launch
+// over parts of several tensors.
+void unaryOpPolicyFunc(const mluOpHandle_t &handle, const size_t element_num,
+                       const mluOpDataType_t dtype, cnrtDim3_t *k_dim,
+                       cnrtFunctionType_t *k_type);
+
 /* user param check
  * step1:check desc and data ptr is not nullptr_t
  * step2:check shape and data type
@@ -25,6 +25,7 @@
 #include "core/context.h"
 #include "core/gen_case.h"
 #include "core/logging.h"
+#include "core/runtime/cost_model.h"
 #include "core/runtime/device.h"
 #include "core/tensor.h"
 #include "core/type.h"
@@ -33,6 +34,8 @@
 
 #define MAX_CLASS_NUM_ARCH_200 1534
 #define MAX_CLASS_NUM_ARCH_300 2558
+// the fused kernel keeps box ids as float.
+#define YOLO_BOX_NMS_MAX_BOX_NUM (1 << 24)
 
 static void policyFunc(const mluOpHandle_t handle, const int kw_num,
                        cnrtDim3_t *k_dim, cnrtFunctionType_t *k_type) {
@@ -47,58 +50,40 @@ static void policyFunc(const mluOpHandle_t handle, const int kw_num,
   k_dim->z = 1;
 }
 
-mluOpStatus_t YoloBoxParamCheck(
+// The checks of x, img_size, anchors and class_num shared by mluOpYoloBox and
+// mluOpYoloBoxNms.
+static mluOpStatus_t YoloBoxInputCheck(
     const std::string &op_name, const mluOpHandle_t handle,
-    const mluOpTensorDescriptor_t x_desc, const void *x,
-    const mluOpTensorDescriptor_t img_size_desc, const void *img_size,
-    const mluOpTensorDescriptor_t anchors_desc, const void *anchors,
-    const mluOpTensorDescriptor_t boxes_desc, const void *boxes,
-    const mluOpTensorDescriptor_t scores_desc, const void *scores,
-    const int class_num, const bool iou_aware, bool *zero_element) {
-  // check descriptor and data
+    const mluOpTensorDescriptor_t x_desc,
+    const mluOpTensorDescriptor_t img_size_desc,
+    const mluOpTensorDescriptor_t anchors_desc, const int class_num,
+    const bool iou_aware) {
+  // check descriptor
   PARAM_CHECK(op_name, handle != NULL);
   PARAM_CHECK(op_name, x_desc != NULL);
   PARAM_CHECK(op_name, img_size_desc != NULL);
   PARAM_CHECK(op_name, anchors_desc != NULL);
-  PARAM_CHECK(op_name, boxes_desc != NULL);
-  PARAM_CHECK(op_name, scores_desc != NULL);
 
   // check shape
   PARAM_CHECK(op_name, x_desc->dim == 4);
   PARAM_CHECK(op_name, img_size_desc->dim == 2);
   PARAM_CHECK(op_name, anchors_desc->dim == 1);
-  PARAM_CHECK(op_name, boxes_desc->dim == 4);
-  PARAM_CHECK(op_name, scores_desc->dim == 4);
 
   // check data type
   PARAM_CHECK(op_name, x_desc->dtype == MLUOP_DTYPE_FLOAT);
   PARAM_CHECK(op_name, img_size_desc->dtype == MLUOP_DTYPE_INT32);
   PARAM_CHECK(op_name, anchors_desc->dtype == MLUOP_DTYPE_INT32);
-  PARAM_CHECK(op_name, boxes_desc->dtype == MLUOP_DTYPE_FLOAT);
-  PARAM_CHECK(op_name, scores_desc->dtype == MLUOP_DTYPE_FLOAT);
 
   // check dim
   const int x_dimN = x_desc->dims[0];
   const int x_dimC = x_desc->dims[1];
-  const int x_dimH = x_desc->dims[2];
-  const int x_dimW = x_desc->dims[3];
   const int img_size_dimN = img_size_desc->dims[0];
   const int img_size_dim2 = img_size_desc->dims[1];
   const int anchors_dim0 = anchors_desc->dims[0];
-  const int boxes_dimN = boxes_desc->dims[0];
-  const int boxes_dim1 = boxes_desc->dims[1];
-  const int boxes_dim2 = boxes_desc->dims[2];
-  const int boxes_dim3 = boxes_desc->dims[3];
-  const int scores_dimN = scores_desc->dims[0];
-  const int scores_dim1 = scores_desc->dims[1];
-  const int scores_dim2 = scores_desc->dims[2];
-  const int scores_dim3 = scores_desc->dims[3];
   const int anchors_num = anchors_dim0 / 2;
 
   PARAM_CHECK(op_name, (anchors_dim0 % 2 == 0));
   PARAM_CHECK(op_name, (x_dimN == img_size_dimN));
-  PARAM_CHECK(op_name, (x_dimN == boxes_dimN));
-  PARAM_CHECK(op_name, (x_dimN == scores_dimN));
   PARAM_CHECK(op_name, anchors_num > 0);
   PARAM_CHECK(op_name, class_num > 0);
   if (handle->arch >= MLUOP_MLU370) {
@@ -113,6 +98,48 @@ mluOpStatus_t YoloBoxParamCheck(
 
   PARAM_CHECK(op_name, (x_dimC == dimc_size));
   PARAM_CHECK(op_name, (img_size_dim2 == 2));
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t YoloBoxParamCheck(
+    const std::string &op_name, const mluOpHandle_t handle,
+    const mluOpTensorDescriptor_t x_desc, const void *x,
+    const mluOpTensorDescriptor_t img_size_desc, const void *img_size,
+    const mluOpTensorDescriptor_t anchors_desc, const void *anchors,
+    const mluOpTensorDescriptor_t boxes_desc, const void *boxes,
+    const mluOpTensorDescriptor_t scores_desc, const void *scores,
+    const int class_num, const bool iou_aware, bool *zero_element) {
+  CHECK_RETURN(op_name,
+               YoloBoxInputCheck(op_name, handle, x_desc, img_size_desc,
+                                 anchors_desc, class_num, iou_aware));
+  // check descriptor and data
+  PARAM_CHECK(op_name, boxes_desc != NULL);
+  PARAM_CHECK(op_name, scores_desc != NULL);
+
+  // check shape
+  PARAM_CHECK(op_name, boxes_desc->dim == 4);
+  PARAM_CHECK(op_name, scores_desc->dim == 4);
+
+  // check data type
+  PARAM_CHECK(op_name, boxes_desc->dtype == MLUOP_DTYPE_FLOAT);
+  PARAM_CHECK(op_name, scores_desc->dtype == MLUOP_DTYPE_FLOAT);
+
+  // check dim
+  const int x_dimN = x_desc->dims[0];
+  const int x_dimH = x_desc->dims[2];
+  const int x_dimW = x_desc->dims[3];
+  const int boxes_dimN = boxes_desc->dims[0];
+  const int boxes_dim1 = boxes_desc->dims[1];
+  const int boxes_dim2 = boxes_desc->dims[2];
+  const int boxes_dim3 = boxes_desc->dims[3];
+  const int scores_dimN = scores_desc->dims[0];
+  const int scores_dim1 = scores_desc->dims[1];
+  const int scores_dim2 = scores_desc->dims[2];
+  const int scores_dim3 = scores_desc->dims[3];
+  const int anchors_num = anchors_desc->dims[0] / 2;
+
+  PARAM_CHECK(op_name, (x_dimN == boxes_dimN));
+  PARAM_CHECK(op_name, (x_dimN == scores_dimN));
   PARAM_CHECK(op_name, (boxes_dim1 == anchors_num));
   PARAM_CHECK(op_name, (boxes_dim2 == 4));
   PARAM_CHECK(op_name, (boxes_dim3 == (x_dimH * x_dimW)));
@@ -153,6 +180,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpYoloBox(
     const bool clip_bbox, const float scale, const bool iou_aware,
     const float iou_aware_factor, const mluOpTensorDescriptor_t boxes_desc,
     void *boxes, const mluOpTensorDescriptor_t scores_desc, void *scores) {
+  MLUOP_PROFILE_OP("mluOpYoloBox");
   // check params
   bool zero_element = false;
   mluOpStatus_t param_check = YoloBoxParamCheck(
@@ -169,6 +197,12 @@ mluOpStatus_t MLUOP_WIN_API mluOpYoloBox(
     return MLUOP_STATUS_SUCCESS;
   }
 
+  MLUOP_PROFILE_TENSOR(x_desc);
+  MLUOP_PROFILE_TENSOR(img_size_desc);
+  MLUOP_PROFILE_TENSOR(anchors_desc);
+  MLUOP_PROFILE_TENSOR(boxes_desc);
+  MLUOP_PROFILE_TENSOR(scores_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
   if (MLUOP_GEN_CASE_ON_NEW) {
     GEN_CASE_START("yolo_box");
     GEN_CASE_HANDLE(handle);
@@ -188,6 +222,7 @@ mluOpStatus_t MLUOP_WIN_API mluOpYoloBox(
                              iou_aware_factor);
     GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
   }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
 
   const int n_in = x_desc->dims[0];
   const int c_in = x_desc->dims[1];
@@ -217,3 +252,202 @@ mluOpStatus_t MLUOP_WIN_API mluOpYoloBox(
   GEN_CASE_END();
   return MLUOP_STATUS_SUCCESS;
 }
+
+// About 30 ops per element of x, boxes and scores are zeroed before the main
+// kernel.
+static mluOpStatus_t costYoloBox(mluOpHandle_t handle,
+                                 const mluOpTensorDescriptor_t *descs,
+                                 int desc_num, mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0]->dim == 4);
+  const int kw_num = descs[0]->dims[2] * descs[0]->dims[3];
+  policyFunc(handle, kw_num, &cost->k_dim, &cost->k_type);
+  cost->theory_ops = descs[0]->total_element_num * 30;
+  cost->theory_io_bytes = mluop::runtime::getTensorsBytes(descs, desc_num);
+  cost->kernel_num = 3;
+  cost->compute_dtype = descs[0]->dtype;
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("yolo_box", 5, costYoloBox);
+
+// The fused kernel decodes one image at a time on a core, the workspace of a
+// core is
+// | x1 | y1 | x2 | y2 | area | conf | score | id | x1 | y1 | x2 | y2 | area |
+// |      decoded cells, 6 * box_num     |  candidates of a class, 7 * box_num |
+// | score | id | label |
+// | kept boxes, 3 * class_num * keep_top_k |
+static inline size_t getYoloBoxNmsCoreWorkspaceNum(const int box_num,
+                                                   const int class_num,
+                                                   const int keep_top_k) {
+  return 13 * (size_t)box_num + 3 * (size_t)class_num * keep_top_k;
+}
+
+mluOpStatus_t MLUOP_WIN_API mluOpGetYoloBoxNmsWorkspaceSize(
+    mluOpHandle_t handle, const mluOpTensorDescriptor_t x_desc,
+    const mluOpTensorDescriptor_t anchors_desc, const int class_num,
+    const int keep_top_k, size_t *size) {
+  const std::string API = "[mluOpGetYoloBoxNmsWorkspaceSize]";
+  PARAM_CHECK(API, handle != NULL);
+  PARAM_CHECK(API, x_desc != NULL);
+  PARAM_CHECK(API, anchors_desc != NULL);
+  PARAM_CHECK(API, size != NULL);
+  PARAM_CHECK(API, x_desc->dim == 4);
+  PARAM_CHECK(API, anchors_desc->dim == 1);
+  PARAM_CHECK(API, class_num > 0);
+  PARAM_CHECK(API, keep_top_k > 0);
+
+  cnrtDim3_t k_dim;
+  cnrtFunctionType_t k_type;
+  policyFunc(handle, x_desc->dims[0], &k_dim, &k_type);
+  const int box_num =
+      anchors_desc->dims[0] / 2 * x_desc->dims[2] * x_desc->dims[3];
+  *size = k_dim.x *
+          getYoloBoxNmsCoreWorkspaceNum(box_num, class_num, keep_top_k) *
+          sizeof(float);
+  return MLUOP_STATUS_SUCCESS;
+}
+
+mluOpStatus_t MLUOP_WIN_API mluOpYoloBoxNms(
+    mluOpHandle_t handle, const mluOpTensorDescriptor_t x_desc, const void *x,
+    const mluOpTensorDescriptor_t img_size_desc, const void *img_size,
+    const mluOpTensorDescriptor_t anchors_desc, const void *anchors,
+    const int class_num, const float conf_thresh, const int downsample_ratio,
+    const bool clip_bbox, const float scale, const bool iou_aware,
+    const float iou_aware_factor, const float score_thresh,
+    const float nms_thresh, const int keep_top_k, void *workspace,
+    size_t workspace_size, const mluOpTensorDescriptor_t output_desc,
+    void *output, const mluOpTensorDescriptor_t output_num_desc,
+    void *output_num) {
+  MLUOP_PROFILE_OP("mluOpYoloBoxNms");
+  const std::string API = "[mluOpYoloBoxNms]";
+  // check inputs/outputs
+  CHECK_RETURN(API, YoloBoxInputCheck(API, handle, x_desc, img_size_desc,
+                                      anchors_desc, class_num, iou_aware));
+  PARAM_CHECK(API, output_desc != NULL);
+  PARAM_CHECK(API, output_num_desc != NULL);
+  PARAM_CHECK(API, output_desc->dtype == MLUOP_DTYPE_FLOAT);
+  PARAM_CHECK(API, output_num_desc->dtype == MLUOP_DTYPE_INT32);
+  PARAM_CHECK(API, downsample_ratio > 0);
+  // a cell below conf_thresh gets score 0, so it must never pass.
+  PARAM_CHECK(API, score_thresh >= 0);
+  PARAM_CHECK(API, keep_top_k > 0);
+
+  const int n_in = x_desc->dims[0];
+  const int c_in = x_desc->dims[1];
+  const int h_in = x_desc->dims[2];
+  const int w_in = x_desc->dims[3];
+  const int anchor_s = anchors_desc->dims[0] / 2;
+  // check outputs shape
+  PARAM_CHECK_EQ(API, output_desc->dim, 3);
+  PARAM_CHECK_EQ(API, output_desc->dims[0], n_in);
+  PARAM_CHECK_EQ(API, output_desc->dims[1], keep_top_k);
+  PARAM_CHECK_EQ(API, output_desc->dims[2], 6);
+  PARAM_CHECK_EQ(API, output_num_desc->dim, 1);
+  PARAM_CHECK_EQ(API, output_num_desc->dims[0], n_in);
+
+  if (handle->arch < MLUOP_MLU370) {
+    LOG(ERROR) << API << " only supports MLU300 series and above.";
+    return MLUOP_STATUS_ARCH_MISMATCH;
+  }
+  if ((mluOpGetTensorElementNum(x_desc) >= LARGE_TENSOR_NUM) ||
+      (mluOpGetTensorElementNum(output_desc) >= LARGE_TENSOR_NUM)) {
+    LOG(ERROR) << API << " Overflow max tensor num."
+               << " Currently, MLU-OPS supports tensor num smaller than 2^31.";
+    return MLUOP_STATUS_NOT_SUPPORTED;
+  }
+  if ((int64_t)anchor_s * h_in * w_in > YOLO_BOX_NMS_MAX_BOX_NUM) {
+    LOG(ERROR) << API << " The number of boxes per image should not exceed "
+               << YOLO_BOX_NMS_MAX_BOX_NUM << ".";
+    return MLUOP_STATUS_NOT_SUPPORTED;
+  }
+
+  if (n_in == 0) {
+    VLOG(5) << API << " skip zero element tensor.";
+    return MLUOP_STATUS_SUCCESS;
+  }
+  PARAM_CHECK(API, output_num != NULL);
+  if (h_in * w_in == 0) {
+    VLOG(5) << API << " skip zero element tensor.";
+    CNRT_CHECK(cnrtMemset(output_num, 0, n_in * sizeof(int)));
+    return MLUOP_STATUS_SUCCESS;
+  }
+  PARAM_CHECK(API, x != NULL);
+  PARAM_CHECK(API, img_size != NULL);
+  PARAM_CHECK(API, anchors != NULL);
+  PARAM_CHECK(API, output != NULL);
+
+  size_t required_size = 0;
+  CHECK_RETURN(API, mluOpGetYoloBoxNmsWorkspaceSize(
+                        handle, x_desc, anchors_desc, class_num, keep_top_k,
+                        &required_size));
+  if (workspace == NULL) {
+    CHECK_RETURN(API, mluop::runtime::getWorkspaceFromArena(
+                          handle, API, required_size, &workspace,
+                          &workspace_size));
+  }
+  PARAM_CHECK(API, workspace != NULL);
+  PARAM_CHECK(API, workspace_size >= required_size);
+
+  MLUOP_PROFILE_TENSOR(x_desc);
+  MLUOP_PROFILE_TENSOR(img_size_desc);
+  MLUOP_PROFILE_TENSOR(anchors_desc);
+  MLUOP_PROFILE_TENSOR(output_desc);
+  MLUOP_PROFILE_TENSOR(output_num_desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
+  if (MLUOP_GEN_CASE_ON_NEW) {
+    GEN_CASE_START("yolo_box_nms");
+    GEN_CASE_HANDLE(handle);
+    GEN_CASE_DATA(true, "x", x, x_desc, 10, 0);
+    GEN_CASE_DATA(true, "img_size", img_size, img_size_desc, 1000, 100);
+    GEN_CASE_DATA(true, "anchors", anchors, anchors_desc, 10, 1);
+    GEN_CASE_DATA(false, "output", output, output_desc, 0, 0);
+    GEN_CASE_DATA(false, "output_num", output_num, output_num_desc, 0, 0);
+    GEN_CASE_OP_PARAM_SINGLE(0, "yolo_box_nms", "class_num", class_num);
+    GEN_CASE_OP_PARAM_SINGLE(1, "yolo_box_nms", "conf_thresh", conf_thresh);
+    GEN_CASE_OP_PARAM_SINGLE(2, "yolo_box_nms", "downsample_ratio",
+                             downsample_ratio);
+    GEN_CASE_OP_PARAM_SINGLE(3, "yolo_box_nms", "clip_bbox", clip_bbox);
+    GEN_CASE_OP_PARAM_SINGLE(4, "yolo_box_nms", "scale_x_y", scale);
+    GEN_CASE_OP_PARAM_SINGLE(5, "yolo_box_nms", "iou_aware", iou_aware);
+    GEN_CASE_OP_PARAM_SINGLE(6, "yolo_box_nms", "iou_aware_factor",
+                             iou_aware_factor);
+    GEN_CASE_OP_PARAM_SINGLE(7, "yolo_box_nms", "score_thresh", score_thresh);
+    GEN_CASE_OP_PARAM_SINGLE(8, "yolo_box_nms", "nms_thresh", nms_thresh);
+    GEN_CASE_OP_PARAM_SINGLE(9, "yolo_box_nms", "keep_top_k", keep_top_k);
+    GEN_CASE_TEST_PARAM_NEW(true, true, false, 0.003, 0.003, 0);
+  }
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
+
+  cnrtDim3_t k_dim;
+  cnrtFunctionType_t k_type;
+  policyFunc(handle, n_in, &k_dim, &k_type);
+  VLOG(5) << API << " launch kernel policyFunc[" << k_dim.x << ", " << k_dim.y
+          << ", " << k_dim.z << "].";
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_KERNEL_ENQUEUE);
+  KERNEL_CHECK((mluOpBlockKernelYoloBoxNmsFloat(
+      k_dim, k_type, handle->queue, x, img_size, anchors, class_num,
+      conf_thresh, downsample_ratio, clip_bbox, scale, iou_aware,
+      iou_aware_factor, score_thresh, nms_thresh, keep_top_k, n_in, anchor_s,
+      c_in, h_in, w_in, workspace, output, output_num)));
+  VLOG(5) << "Kernel mluOpBlockKernelYoloBoxNmsFloat.";
+  GEN_CASE_END();
+  return MLUOP_STATUS_SUCCESS;
+}
+
+// About 10 ops per element of x, a sigmoid, a multiply and a compare for every
+// class logit. The suppression depends on the number of candidates and is not
+// counted.
+static mluOpStatus_t costYoloBoxNms(mluOpHandle_t handle,
+                                    const mluOpTensorDescriptor_t *descs,
+                                    int desc_num,
+                                    mluop::runtime::OpCost *cost) {
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0] != NULL);
+  PARAM_CHECK("[mluOpGetOpCostModel]", descs[0]->dim == 4);
+  policyFunc(handle, descs[0]->dims[0], &cost->k_dim, &cost->k_type);
+  cost->theory_ops = descs[0]->total_element_num * 10;
+  cost->theory_io_bytes = mluop::runtime::getTensorsBytes(descs, desc_num);
+  cost->kernel_num = 1;
+  cost->compute_dtype = descs[0]->dtype;
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("yolo_box_nms", 5, costYoloBoxNms);
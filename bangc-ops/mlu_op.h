@@ -196,6 +196,50 @@ typedef enum {
   MLUOP_LOG_10 = 2, /*!< The base 10 is used.*/
 } mluOpLogBase_t;
 
+/*!
+ * @brief Describes the element-wise operations applied by ::mluOpForeachUnary
+ * to every tensor of a tensor list.
+ */
+typedef enum {
+  MLUOP_FOREACH_ABS = 0,   /*!< The absolute value, see ::mluOpAbs.*/
+  MLUOP_FOREACH_SQRT = 1,  /*!< The square root, see ::mluOpSqrt.*/
+  MLUOP_FOREACH_LOG = 2,   /*!< The logarithm of base e, see ::mluOpLog.*/
+  MLUOP_FOREACH_LOG2 = 3,  /*!< The logarithm of base 2, see ::mluOpLog.*/
+  MLUOP_FOREACH_LOG10 = 4, /*!< The logarithm of base 10, see ::mluOpLog.*/
+} mluOpForeachUnaryOp_t;
+
+/*!
+ * @brief Describes the steps of a program run by ::mluOpFusedUnary.
+ */
+typedef enum {
+  MLUOP_FUSED_UNARY_ABS = 0,
+  /*!< The absolute value, see ::mluOpAbs.*/
+  MLUOP_FUSED_UNARY_LOG = 1,
+  /*!< The logarithm of base e multiplied by the scalar of the step. The
+   *   scalar is 1 for base e, log2(e) for base 2 and log10(e) for base 10.*/
+  MLUOP_FUSED_UNARY_SQRT = 2,
+  /*!< The square root, see ::mluOpSqrt.*/
+  MLUOP_FUSED_UNARY_MUL_SCALAR = 3,
+  /*!< The multiplication by the scalar of the step.*/
+  MLUOP_FUSED_UNARY_ADD_SCALAR = 4,
+  /*!< The addition of the scalar of the step.*/
+  MLUOP_FUSED_UNARY_DIV_SCALAR = 5,
+  /*!< The division by the scalar of the step, which must not be 0.*/
+} mluOpFusedUnaryStepType_t;
+
+/*!
+ * @brief The maximum number of steps of a program run by ::mluOpFusedUnary.
+ */
+#define MLUOP_FUSED_UNARY_MAX_STEP_NUM 8
+
+/*!
+ * @brief Describes one step of a program run by ::mluOpFusedUnary.
+ */
+typedef struct {
+  mluOpFusedUnaryStepType_t type; /*!< The element-wise operation.*/
+  float scalar; /*!< The operand of the operation, unused by abs and sqrt.*/
+} mluOpFusedUnaryStep_t;
+
 
 /******************************************************************************
  * MLUOP Runtime Management
@@ -260,6 +304,40 @@ typedef struct mluOpTensorSetStruct *mluOpTensorSetDescriptor_t;
  */
 mluOpStatus_t MLUOP_WIN_API mluOpCreate(mluOpHandle_t *handle);
 
+// Group:Runtime Management
+/*!
+ *  @brief Sets the virtual device used by the handles created by ::mluOpCreate afterwards.
+ *  A handle created on a virtual device takes the number of clusters and cores, the size
+ *  of on-chip memories, the cluster and job limits and the parallel job numbers from a
+ *  device profile instead of the current MLU device, so the host side work of the
+ *  operations, such as parameter checking, task dimension policy and workspace size
+ *  computing, can run on a host without MLU devices.
+ *
+ *  @param[in] profile
+ *  The name of a preset device profile, which is one of "MLU220", "MLU270", "MLU290" and
+ *  "MLU370", or the path of a device profile file. NULL or an empty string means the
+ *  handles are created on the current MLU device again.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ *
+ *  @note
+ *  - A device profile file has one "key = value" pair per line. The keys are \b preset,
+ *    \b name, \b cluster_num, \b core_num_per_cluster, \b nram_size, \b wram_size,
+ *    \b sram_size, \b capability_cluster_num, \b capability_job_limit and
+ *    \b job_num_block, \b job_num_union1, ..., \b job_num_union16.
+ *  - The virtual device can also be set with the environment variable
+ *    MLUOP_VIRTUAL_DEVICE, which is read when ::mluOpCreate is called for the first time.
+ *  - Kernels must not be launched with a handle created on a virtual device, and
+ *    ::mluOpUpdateContextInformation does nothing on such a handle.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpSetVirtualDevice(const char *profile);
+
 // Group:Runtime Management
 /*!
  *  @brief Updates the MLUOP context information that is held by the \b handle. This function
@@ -294,10 +372,13 @@ mluOpStatus_t MLUOP_WIN_API mluOpUpdateContextInformation(mluOpHandle_t handle);
  *  @param[in] handle
  *  Pointer to the MLU devices that holds information to be destroyed.
  *  @par Return
- *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM,
+ *    ::MLUOP_STATUS_EXECUTION_FAILED
  *
  *  @note
- *  - None.
+ *  - The handle is freed even if releasing its workspace arena fails, in which
+ *    case ::MLUOP_STATUS_EXECUTION_FAILED is returned and \b handle must not
+ *    be destroyed again.
  *
  *  @par Requirements
  *  - None.
@@ -357,6 +438,316 @@ mluOpStatus_t MLUOP_WIN_API mluOpSetQueue(mluOpHandle_t handle, cnrtQueue_t queu
  */
 mluOpStatus_t MLUOP_WIN_API mluOpGetQueue(mluOpHandle_t handle, cnrtQueue_t *queue);
 
+// Group:Runtime Management
+/*!
+ *  @brief Enables the workspace arena of the handle \b handle. The arena is a growable
+ *  region of MLU memory owned by the handle. When the workspace arena is enabled, the
+ *  operations that need extra workspace, such as ::mluOpPolyNms and
+ *  ::mluOpGenerateProposalsV2, accept NULL as \b workspace and draw the workspace from the
+ *  arena, so you do not need to allocate and free MLU memory around each call.
+ *
+ *  @param[in] handle
+ *  Handle to an MLUOP context that is used to manage MLU devices and
+ *  queues. For detailed information, see ::mluOpHandle_t.
+ *  @param[in] reserved_size
+ *  The size in bytes of MLU memory reserved for the arena in advance. It can be 0, and
+ *  the arena grows on demand.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM, ::MLUOP_STATUS_ALLOC_FAILED
+ *
+ *  @note
+ *  - The total MLU memory held by the arena does not exceed the value of the environment
+ *    variable MLUOP_MEM_POOL_SIZE, which is 2081MB by default.
+ *  - The workspace drawn from the arena is only valid until the next operation called
+ *    with the same handle. All operations of a handle are launched on the same queue,
+ *    so the workspace can be reused without synchronization.
+ *  - When the queue of the handle is changed with ::mluOpSetQueue, the old queue is
+ *    synchronized.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpEnableWorkspaceArena(mluOpHandle_t handle, size_t reserved_size);
+
+// Group:Runtime Management
+/*!
+ *  @brief Disables the workspace arena of the handle \b handle and releases the MLU memory
+ *  held by the arena. The queue of the handle is synchronized before the memory is released.
+ *
+ *  @param[in] handle
+ *  Handle to an MLUOP context that is used to manage MLU devices and
+ *  queues. For detailed information, see ::mluOpHandle_t.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ *
+ *  @note
+ *  - None.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpDisableWorkspaceArena(mluOpHandle_t handle);
+
+// Group:Runtime Management
+/*!
+ *  @brief Retrieves the current capacity and the high-water mark of the workspace arena of
+ *  the handle \b handle.
+ *
+ *  @param[in] handle
+ *  Handle to an MLUOP context that is used to manage MLU devices and
+ *  queues. For detailed information, see ::mluOpHandle_t.
+ *  @param[out] capacity
+ *  Pointer to the size in bytes of the MLU memory block currently used by the arena.
+ *  @param[out] high_water_mark
+ *  Pointer to the largest workspace size in bytes ever drawn from the arena.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ *
+ *  @note
+ *  - Both \b capacity and \b high_water_mark are 0 if the arena is not enabled.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpGetWorkspaceArenaInfo(mluOpHandle_t handle,
+                                                       size_t *capacity,
+                                                       size_t *high_water_mark);
+
+// Group:Runtime Management
+/*!
+ *  @brief Sets the capacity of the launch plan cache of the handle \b handle. The launch
+ *  plan cache remembers the result of parameter checking, task dimension policy and
+ *  kernel selection of recent operation calls. When an operation is called again with
+ *  tensor descriptors and parameters identical to a cached call, only the data pointers
+ *  are checked and the cached plan is launched directly.
+ *
+ *  @param[in] handle
+ *  Handle to an MLUOP context that is used to manage MLU devices and
+ *  queues. For detailed information, see ::mluOpHandle_t.
+ *  @param[in] capacity
+ *  The maximum number of launch plans kept in the cache. The least recently used plan
+ *  is dropped when the cache is full. 0 means the launch plan cache is disabled.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM, ::MLUOP_STATUS_ALLOC_FAILED
+ *
+ *  @note
+ *  - The default capacity is 128, and can be changed with the environment variable
+ *    MLUOP_LAUNCH_PLAN_CACHE_CAPACITY before ::mluOpCreate is called.
+ *  - The launch plan cache is used by ::mluOpBallQuery, ::mluOpThreeInterpolateForward
+ *    and ::mluOpExpand. Element-wise operations check their parameters directly, which
+ *    is cheaper than a cache lookup.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpSetLaunchPlanCacheCapacity(mluOpHandle_t handle,
+                                                            size_t capacity);
+
+// Group:Runtime Management
+/*!
+ *  @brief Retrieves the number of launch plans in the launch plan cache of the handle
+ *  \b handle, and the number of cache hits and misses since the handle is created.
+ *
+ *  @param[in] handle
+ *  Handle to an MLUOP context that is used to manage MLU devices and
+ *  queues. For detailed information, see ::mluOpHandle_t.
+ *  @param[out] size
+ *  Pointer to the number of launch plans in the cache.
+ *  @param[out] hits
+ *  Pointer to the number of operation calls which hit the cache.
+ *  @param[out] misses
+ *  Pointer to the number of operation calls which missed the cache.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ *
+ *  @note
+ *  - None.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpGetLaunchPlanCacheInfo(mluOpHandle_t handle,
+                                                        size_t *size,
+                                                        uint64_t *hits,
+                                                        uint64_t *misses);
+
+/*!
+ * @brief Describes the host side phases of an operation call measured by the
+ * profiling of ::mluOpSetProfilingEnabled.
+ */
+typedef enum {
+  MLUOP_PROFILING_PHASE_TOTAL = 0,
+  /*!< The whole host time of the operation call.*/
+  MLUOP_PROFILING_PHASE_PARAM_CHECK = 1,
+  /*!< Parameter checking, from the entry of the operation call.*/
+  MLUOP_PROFILING_PHASE_POLICY = 2,
+  /*!< Task dimension policy and the other host work preparing the launch.*/
+  MLUOP_PROFILING_PHASE_GEN_CASE = 3,
+  /*!< Test case generation hooks, see MLUOP_GEN_CASE.*/
+  MLUOP_PROFILING_PHASE_KERNEL_ENQUEUE = 4,
+  /*!< Enqueueing the kernels of the operation.*/
+} mluOpProfilingPhase_t;
+
+#define MLUOP_PROFILING_PHASE_NUM 5
+
+/*!
+ * @brief The profile of one operation call, passed to the callback set by
+ * ::mluOpSetProfilingCallback.
+ */
+typedef struct {
+  const char *op_name;
+  /*!< The name of the operation API, such as "mluOpCopy".*/
+  uint64_t bytes;
+  /*!< The bytes of the tensors read and written by the call.*/
+  uint64_t phase_ns[MLUOP_PROFILING_PHASE_NUM];
+  /*!< The host time of each ::mluOpProfilingPhase_t in nanoseconds.*/
+} mluOpProfilingRecord_t;
+
+/*!
+ * @brief The profile of all calls of one operation since profiling was reset,
+ * returned by ::mluOpGetProfilingSnapshot. Percentiles come from log-linear
+ * histograms and are accurate to 1/16 of their value.
+ */
+typedef struct {
+  const char *op_name;
+  /*!< The name of the operation API, such as "mluOpCopy".*/
+  uint64_t call_count;
+  /*!< The number of calls.*/
+  uint64_t bytes;
+  /*!< The bytes of the tensors read and written by all calls.*/
+  uint64_t sum_ns[MLUOP_PROFILING_PHASE_NUM];
+  /*!< The host time of each ::mluOpProfilingPhase_t summed over all calls.*/
+  uint64_t max_ns[MLUOP_PROFILING_PHASE_NUM];
+  /*!< The longest host time of each phase.*/
+  uint64_t p50_ns[MLUOP_PROFILING_PHASE_NUM];
+  /*!< The median host time of each phase.*/
+  uint64_t p90_ns[MLUOP_PROFILING_PHASE_NUM];
+  /*!< The 90th percentile host time of each phase.*/
+  uint64_t p99_ns[MLUOP_PROFILING_PHASE_NUM];
+  /*!< The 99th percentile host time of each phase.*/
+} mluOpProfilingOpStats_t;
+
+/*!
+ * @brief The callback called at the end of every profiled operation call, on
+ * the thread of the call. \b record is only valid during the callback.
+ */
+typedef void (*mluOpProfilingCallback_t)(const mluOpProfilingRecord_t *record,
+                                         void *user_data);
+
+// Group:Runtime Management
+/*!
+ *  @brief Enables or disables the host side profiling of operation calls. When enabled,
+ *  the host time each operation call spends in parameter checking, task dimension policy,
+ *  test case generation and kernel enqueueing is recorded per operation, together with
+ *  the number of calls and the bytes of the tensors they touch.
+ *
+ *  @param[in] enabled
+ *  Whether the profiling is enabled.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS
+ *
+ *  @note
+ *  - The profiling is disabled by default, and can be enabled with the environment
+ *    variable MLUOP_PROFILING_ENABLE=ON.
+ *  - When the profiling is disabled, the cost on an operation call is one branch per
+ *    profiling hook.
+ *  - An operation called by another one, such as ::mluOpCopy called by ::mluOpExpand,
+ *    is recorded on its own, and its time is also part of the calling operation.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpSetProfilingEnabled(bool enabled);
+
+// Group:Runtime Management
+/*!
+ *  @brief Sets the callback called with the profile of every operation call while the
+ *  profiling is enabled, for example to export the profiles to a metrics system.
+ *
+ *  @param[in] callback
+ *  The callback, see ::mluOpProfilingCallback_t. NULL removes the callback.
+ *  @param[in] user_data
+ *  The pointer passed to every call of \b callback.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS
+ *
+ *  @note
+ *  - The callback runs on the thread of the operation call, before the operation
+ *    returns, so it should be short and must not call operations itself.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpSetProfilingCallback(mluOpProfilingCallback_t callback,
+                                                      void *user_data);
+
+// Group:Runtime Management
+/*!
+ *  @brief Retrieves the profiles of the operations called since the profiling was last
+ *  reset, one ::mluOpProfilingOpStats_t per operation.
+ *
+ *  @param[out] stats
+ *  Pointer to an array of \b stats_num profiles, filled in order of operation names.
+ *  @param[in] stats_num
+ *  The number of elements of \b stats. It can be 0 to only query \b op_num.
+ *  @param[out] op_num
+ *  Pointer to the number of operations which have a profile. When it is larger than
+ *  \b stats_num, only the first \b stats_num profiles are returned.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ *
+ *  @note
+ *  - The op_name strings stay valid until the library is unloaded.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpGetProfilingSnapshot(mluOpProfilingOpStats_t *stats,
+                                                      int stats_num,
+                                                      int *op_num);
+
+// Group:Runtime Management
+/*!
+ *  @brief Clears the profiles of all operations.
+ *
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS
+ *
+ *  @note
+ *  - None.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpResetProfiling();
+
 // Group:Runtime Management
 /*!
  *  @brief Converts the MLUOP enumerated status code to ASCIIZ static string and returns
@@ -608,6 +999,50 @@ mluOpStatus_t MLUOP_WIN_API mluOpSetTensorDescriptor(mluOpTensorDescriptor_t des
                                                      int dimNb,
                                                      const int dimSize[]);
 
+// Group:Tensor
+/*!
+ *  @brief Initializes the tensor descriptor pointed by \b desc that is
+ *  previously created with the ::mluOpCreateTensorDescriptor function, and sets
+ *  the information about the dimensions, data type, and layout of the input
+ *  tensor. Compared with ::mluOpSetTensorDescriptor, the size of each dimension
+ *  is a 64-bit integer, so tensors with dimensions or element numbers larger
+ *  than 2^31 can be described.
+ *
+ *  @param[in] desc
+ *  The descriptor of the input tensor. For detailed information,
+ *  see ::mluOpTensorDescriptor_t.
+ *  @param[in] layout
+ *  The layout of the input tensor. For detailed information, see ::mluOpTensorLayout_t.
+ *  @param[in] dtype
+ *  The data type of the input tensor. For detailed information, see ::mluOpDataType_t.
+ *  @param[in] dimNb
+ *  The number of dimensions in the input tensor of the initialized operation.
+ *  @param[in] dimSize
+ *  An array that contains the size of the tensor for each dimension.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ *
+ *  @note
+ *  - dimSize[0] represents the highest dimension, dimSize[DIM_MAX - 1] represents
+ *    the lowest dimension, and DIM_MAX represents the number of dimensions in the input tensor.
+ *  - If the size or the stride of any dimension is larger than 2^31 - 1, the tensor
+ *    descriptor can only be retrieved with ::mluOpGetTensorDescriptor_v2 and
+ *    ::mluOpGetTensorDescriptorEx_v2.
+ *  - Operations that do not support large tensors return ::MLUOP_STATUS_NOT_SUPPORTED
+ *    when the number of elements is not smaller than 2^31.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpSetTensorDescriptor_v2(mluOpTensorDescriptor_t desc,
+                                                        mluOpTensorLayout_t layout,
+                                                        mluOpDataType_t dtype,
+                                                        int dimNb,
+                                                        const int64_t dimSize[]);
+
 // Group:Tensor
 /*!
  *  @brief Initializes the group of tensor descriptors stored by \b group_desc
@@ -737,6 +1172,49 @@ mluOpStatus_t MLUOP_WIN_API mluOpSetTensorDescriptorEx(mluOpTensorDescriptor_t d
                                                        const int dimSize[],
                                                        const int dimStride[]);
 
+// Group:Tensor
+/*!
+ *  @brief Initializes the tensor descriptor pointed by \b desc that is previously created
+ *  with the ::mluOpCreateTensorDescriptor function, and sets the information about
+ *  the dimensions, strides, data type, and layout of the input tensor. Compared with
+ *  ::mluOpSetTensorDescriptorEx, the sizes and strides are 64-bit integers.
+ *
+ *  @param[in] desc
+ *  The descriptor of the input tensor. For detailed information,
+ *  see ::mluOpTensorDescriptor_t.
+ *  @param[in] layout
+ *  The layout of the input tensor. For detailed information, see ::mluOpTensorLayout_t.
+ *  @param[in] dtype
+ *  The data type of the input tensor. For detailed information, see ::mluOpDataType_t.
+ *  @param[in] dimNb
+ *  The number of dimensions in the input tensor of the initialized operation.
+ *  @param[in] dimSize
+ *  An array that contains the size of the tensor for each dimension.
+ *  @param[in] dimStride
+ *  An array that contains the stride of the tensor for each dimension.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ *
+ *  @note
+ *  - dimSize[0] represents the highest dimension, and dimSize[DIM_MAX - 1] represents
+ *    the lowest dimension.
+ *  - If the size or the stride of any dimension is larger than 2^31 - 1, the tensor
+ *    descriptor can only be retrieved with ::mluOpGetTensorDescriptor_v2 and
+ *    ::mluOpGetTensorDescriptorEx_v2.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpSetTensorDescriptorEx_v2(mluOpTensorDescriptor_t desc,
+                                                          mluOpTensorLayout_t layout,
+                                                          mluOpDataType_t dtype,
+                                                          int dimNb,
+                                                          const int64_t dimSize[],
+                                                          const int64_t dimStride[]);
+
 // Group:Tensor
 /*!
  *  @brief Sets the \b dimNb and \b dimSize factors to the input tensor descriptor.
@@ -771,6 +1249,36 @@ mluOpStatus_t mluOpSetTensorDescriptorDim(mluOpTensorDescriptor_t desc,
                                         int dimNb,
                                         const int *dimSize);
 
+// Group:Tensor
+/*!
+ *  @brief Sets the \b dimNb and \b dimSize factors to the input tensor descriptor.
+ *  Compared with ::mluOpSetTensorDescriptorDim, the size of each dimension is a
+ *  64-bit integer.
+ *
+ *  @param[in] desc
+ *  The descriptor of the input tensor. For detailed information,
+ *  see ::mluOpTensorDescriptor_t.
+ *  @param[in] dimNb
+ *  The number of dimensions in the input tensor of the initialized operation.
+ *  @param[in] dimSize
+ *  An array that contains the size of the tensor for each dimension.
+ *  @par Return
+ *   - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM.
+ *
+ *  @note
+ *   - dimSize[0] represents the highest dimension, dimSize[DIM_MAX - 1] represents
+ *    the lowest dimension, and DIM_MAX represents the number of dimensions in the input tensor.
+ *
+ *  @par Requirements
+ *   - None.
+ *
+ *  @par Example
+ *   - None.
+ */
+mluOpStatus_t mluOpSetTensorDescriptorDim_v2(mluOpTensorDescriptor_t desc,
+                                           int dimNb,
+                                           const int64_t *dimSize);
+
 // Group:Tensor
 /*!
  *  @brief Sets the on-chip data type to the descriptor of a tensor \b desc.
@@ -913,11 +1421,13 @@ mluOpSetTensorDescriptorPositionScaleAndOffset(mluOpTensorDescriptor_t desc,
  *  @param[out] dimSize
  *  An array that contains the size of the tensor for each dimension.
  *  @par Return
- *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM, ::MLUOP_STATUS_NOT_SUPPORTED
  *
  *  @note
  *  - dimSize[0] represents the highest dimension, and dimSize[DIM_MAX - 1] represents the lowest
  *    dimension.
+ *  - If the size of any dimension is larger than 2^31 - 1, ::MLUOP_STATUS_NOT_SUPPORTED
+ *    is returned. Please call ::mluOpGetTensorDescriptor_v2 instead.
  *
  *  @par Requirements
  *  - None.
@@ -931,6 +1441,47 @@ mluOpStatus_t MLUOP_WIN_API mluOpGetTensorDescriptor(const mluOpTensorDescriptor
                                                      int *dimNb,
                                                      int dimSize[]);
 
+// Group:Tensor
+/*!
+ *  @brief Retrieves a tensor descriptor \b desc that is previously created with the
+ *  ::mluOpCreateTensorDescriptor function, and sets the information about the dimensions,
+ *  data type, and layout of input tensor. Compared with ::mluOpGetTensorDescriptor, the
+ *  size of each dimension is returned as a 64-bit integer.
+ *
+ *  @param[in] desc
+ *  The descriptor of the input tensor. For detailed information,
+ *  see ::mluOpTensorDescriptor_t.
+ *  @param[out] layout
+ *  Pointer to the host memory that holds information about the layout of the input
+ *  tensor.
+ *  For detailed information, see ::mluOpTensorLayout_t.
+ *  @param[out] dtype
+ *  Pointer to the host memory that holds information about the data type of the input
+ *  tensor.
+ *  For detailed information, see ::mluOpDataType_t.
+ *  @param[out] dimNb
+ *  Pointer to the host memory that holds information about the dimension of input tensor.
+ *  @param[out] dimSize
+ *  An array that contains the size of the tensor for each dimension.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ *
+ *  @note
+ *  - dimSize[0] represents the highest dimension, and dimSize[DIM_MAX - 1] represents the lowest
+ *    dimension.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpGetTensorDescriptor_v2(const mluOpTensorDescriptor_t desc,
+                                                        mluOpTensorLayout_t *layout,
+                                                        mluOpDataType_t *dtype,
+                                                        int *dimNb,
+                                                        int64_t dimSize[]);
+
 // Group:Tensor
 /*!
  *  @brief Retrieves a tensor descriptor \b desc that is previously created with the
@@ -955,11 +1506,13 @@ mluOpStatus_t MLUOP_WIN_API mluOpGetTensorDescriptor(const mluOpTensorDescriptor
  *  @param[out] dimStride
  *  An array that contains the stride of the tensor for each dimension.
  *  @par Return
- *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM, ::MLUOP_STATUS_NOT_SUPPORTED
  *
  *  @note
  *  - dimSize[0] represents the highest dimension, and dimSize[DIM_MAX - 1] represents the lowest
  *    dimension.
+ *  - If the size or the stride of any dimension is larger than 2^31 - 1, ::MLUOP_STATUS_NOT_SUPPORTED
+ *    is returned. Please call ::mluOpGetTensorDescriptorEx_v2 instead.
  *
  *  @par Requirements
  *  - None.
@@ -974,6 +1527,50 @@ mluOpStatus_t MLUOP_WIN_API mluOpGetTensorDescriptorEx(const mluOpTensorDescript
                                                        int dimSize[],
                                                        int dimStride[]);
 
+// Group:Tensor
+/*!
+ *  @brief Retrieves a tensor descriptor \b desc that is previously created with the
+ *  ::mluOpCreateTensorDescriptor and sets the information about the dimensions, data type,
+ *  stride and layout of input tensor. Compared with ::mluOpGetTensorDescriptorEx, the sizes
+ *  and strides are returned as 64-bit integers.
+ *
+ *  @param[in] desc
+ *  The descriptor of the input tensor. For detailed information,
+ *  see ::mluOpTensorDescriptor_t.
+ *  @param[out] layout
+ *  Pointer to the host memory that holds information about the layout of the input
+ *  tensor.
+ *  For detailed information, see ::mluOpTensorLayout_t.
+ *  @param[out] dtype
+ *  Pointer to the host memory that holds information about the data type of the input
+ *  tensor.
+ *  For detailed information, see ::mluOpDataType_t.
+ *  @param[out] dimNb
+ *  Pointer to the host memory that holds information about the dimension of input tensor.
+ *  @param[out] dimSize
+ *  An array that contains the size of the tensor for each dimension.
+ *  @param[out] dimStride
+ *  An array that contains the stride of the tensor for each dimension.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ *
+ *  @note
+ *  - dimSize[0] represents the highest dimension, and dimSize[DIM_MAX - 1] represents the lowest
+ *    dimension.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpGetTensorDescriptorEx_v2(const mluOpTensorDescriptor_t desc,
+                                                          mluOpTensorLayout_t *layout,
+                                                          mluOpDataType_t *dtype,
+                                                          int *dimNb,
+                                                          int64_t dimSize[],
+                                                          int64_t dimStride[]);
+
 // Group:Tensor
 /*!
  *  @brief Retrieves the number of elements according to the input descriptor \b desc. You
@@ -1435,6 +2032,68 @@ mluOpGetTensorAndDataFromTensorSet(mluOpTensorSetDescriptor_t tensorSetDesc,
                                    mluOpTensorDescriptor_t *tensorDesc,
                                    void **dataAddrInDevice);
 
+/*!
+ * @brief The estimated cost of an operation call, returned by ::mluOpGetOpCostModel.
+ */
+typedef struct {
+  int64_t theory_ops;
+  /*!< The number of operations of the computation.*/
+  int64_t theory_io_bytes;
+  /*!< The bytes of the tensors read and written by the call.*/
+  cnrtDim3_t k_dim;
+  /*!< The task dimension of the kernel doing most of the work.*/
+  cnrtFunctionType_t k_type;
+  /*!< The task type of the kernel doing most of the work.*/
+  int kernel_num;
+  /*!< The number of kernels launched by the call.*/
+  double latency_us;
+  /*!< The estimated latency of the call in microseconds, negative when the device
+   *   has no known peak bandwidth.*/
+} mluOpOpCost_t;
+
+// Group:Runtime Management
+/*!
+ *  @brief Estimates the cost of an operation call from its tensor descriptors, without
+ *  running the operation: the number of operations, the bytes moved, the task dimension
+ *  of its main kernel and the latency on the device of \b handle.
+ *
+ *  @param[in] handle
+ *  Handle to an MLUOP context that is used to manage MLU devices and
+ *  queues. For detailed information, see ::mluOpHandle_t.
+ *  @param[in] op_name
+ *  The name of the operation, as used by the test cases of MLUOP_GEN_CASE, such as
+ *  "abs", "ball_query" or "psroipool_forward".
+ *  @param[in] desc_num
+ *  The number of tensor descriptors in \b descs.
+ *  @param[in] descs
+ *  The tensor descriptors of the operation, in the order of the tensor descriptor
+ *  parameters of the operation API. Optional tensors can be NULL.
+ *  @param[out] cost
+ *  Pointer to the estimated cost, see ::mluOpOpCost_t.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM, ::MLUOP_STATUS_NOT_SUPPORTED
+ *
+ *  @note
+ *  - The latency is a roofline estimate: the slower of the compute bound and the IO
+ *    bound on the cores the main kernel occupies, plus a fixed launch overhead for each
+ *    kernel.
+ *  - The descriptors are checked as far as the estimate needs, a successful estimate
+ *    does not mean that the operation accepts them.
+ *  - For operations whose work depends on the data, such as ::mluOpPsRoiPoolForward or
+ *    ::mluOpPolyNms, the estimate assumes the largest work.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpGetOpCostModel(mluOpHandle_t handle,
+                                                const char *op_name,
+                                                int desc_num,
+                                                const mluOpTensorDescriptor_t descs[],
+                                                mluOpOpCost_t *cost);
+
 // Group:Abs
 /*!
  * @brief Computes the absolute value for every element of the input tensor \b x
@@ -1581,11 +2240,16 @@ mluOpLog(mluOpHandle_t handle, const mluOpComputationPreference_t prefer,
  *   - output tensor: half, float.
  *
  * @par Scale Limitation
- * - The input tensors and output tensor must have the same shape.
+ * - The shapes of \b x and \b y must be broadcastable in the NumPy way: aligned
+ *   from the last dimension on, each dimension is either the same in both
+ *   tensors, or 1 or missing in one of them.
+ * - The output tensor must have the broadcast shape of \b x and \b y.
  *
  * @note
- * - The input tensors and output tensor have the same shape, and the input
- *   tensor \b y must meet the following input data range:
+ * - Broadcast inputs are read in place, they need not be expanded by
+ *   ::mluOpExpand first. When \b x and \b y have the same shape the plain
+ *   element-wise path is used.
+ * - The input tensor \b y must meet the following input data range:
  *   - float: [-1e10,-1e-20] & [1e-20,1e10].
  *   - half: [-65504,-1e-4] & [1e-4,65504].
  *
@@ -1606,7 +2270,11 @@ mluOpDiv(mluOpHandle_t handle, const mluOpComputationPreference_t prefer,
 
 // Group:GenerateProposalsV2
 /*!
- *  @brief Gets extra space size that is needed in poly_nms operation.
+ *  @brief Gets extra space size that is needed in generate_proposals_v2
+ *  operation. The workspace holds the decoded proposals of an image. When the
+ *  images of a batch are processed on separate cores at the same time, every
+ *  core gets a workspace slice of its own, so the size also depends on the
+ *  batch size.
  *
  *  @param[in] handle
  *  Handle to an MLUOP context that is used to manage MLU devices
@@ -1681,7 +2349,8 @@ mluOpStatus_t MLUOP_WIN_API mluOpGetGenerateProposalsV2WorkspaceSize(
  *  Pointer to the MLU memory that stores the input tensor.
  *  Bounding box variances with same shape as `anchors`.
  *  @param[in] workspace
- *  Pointer to the MLU memory that stores the extra workspace.
+ *  Pointer to the MLU memory that stores the extra workspace. It can be NULL if the
+ *  workspace arena of \b handle is enabled, see ::mluOpEnableWorkspaceArena.
  *  @param[in] workspace_size
  *  The size of extra space.
  *  @param[in] rpn_rois_desc
@@ -1758,6 +2427,8 @@ mluOpStatus_t MLUOP_WIN_API mluOpGetGenerateProposalsV2WorkspaceSize(
  *  - Not support adaptive NMS. The attribute 'eta' should not less
  *    than 1.
  *  - 'nms_thresh' should be more than 0.
+ *  - Small images of a batch are processed one per core at the same time,
+ *    larger images one after another on all cores.
  *
  * @par Reference
  * - https://github.com/PaddlePaddle/Paddle/blob/develop/paddle/phi/kernels/gpu/generate_proposals_v2_kernel.cu
@@ -1778,7 +2449,10 @@ mluOpStatus_t MLUOP_WIN_API mluOpGenerateProposalsV2(
 
 // Group:PolyNms
 /*!
- *  @brief Gets extra space size that is needed in poly_nms operation.
+ *  @brief Gets extra space size that is needed in poly_nms operation. The
+ *  workspace holds the area and the score order of the boxes, and the
+ *  [N, ceil(N / 32)] bitwise suppression mask of the N boxes, which grows
+ *  quadratically, about 312 MB for 50000 boxes and 2 GB for 131072 boxes.
  *
  *  @param[in] handle
  *  Handle to an MLUOP context that is used to manage MLU devices
@@ -1810,7 +2484,8 @@ mluOpStatus_t MLUOP_WIN_API mluOpGetPolyNmsWorkspaceSize(
  *  @param[in] iou_threshold
  *  The iou_threshold data.
  *  @param[in] workspace
- *  Pointer to the MLU memory that stores the extra workspace.
+ *  Pointer to the MLU memory that stores the extra workspace. It can be NULL if the
+ *  workspace arena of \b handle is enabled, see ::mluOpEnableWorkspaceArena.
  *  @param[in] workspace_size
  *  The size of extra space.
  *  @param[in] output_desc
@@ -1854,25 +2529,138 @@ mluOpStatus_t MLUOP_WIN_API mluOpGetPolyNmsWorkspaceSize(
  *  @par Example
  *  - None.
  *
- *  @par Note
- *  - This commit does not support nan/inf.
- *  - The coordinates of the input boxes must all be sorted clockwise or
- *    counterclockwise. If the coordinates of the boxes are out of order,
- *    the calculation result is not guaranteed and is consistent with the
- *    calculation result of the competitor operator.
- *  - If there are cases with the same score in the input boxes, the output
- *    results may be inconsistent with the results of competing products.
- *  - The number of input boxes on MLU270, MLU290 and MLU370 does not exceed
- *    9770.
- *
+ *  @par Note
+ *  - This commit does not support nan/inf.
+ *  - The coordinates of the input boxes must all be sorted clockwise or
+ *    counterclockwise. If the coordinates of the boxes are out of order,
+ *    the calculation result is not guaranteed and is consistent with the
+ *    calculation result of the competitor operator.
+ *  - If there are cases with the same score in the input boxes, the output
+ *    results may be inconsistent with the results of competing products.
+ *  - On MLU270, MLU290 and MLU370, more than 9770 input boxes do not fit in
+ *    on-chip memory at once, they are processed by tiles of 1024 boxes with
+ *    the suppression mask built block by block in \b workspace.
+ *  - The number of input boxes does not exceed 131072, so that the
+ *    suppression mask in \b workspace stays within 2 GB, see
+ *    ::mluOpGetPolyNmsWorkspaceSize.
+ *
+ * @par Reference
+ * - https://github.com/dingjiansw101/AerialDetection/tree/master/mmdet/ops/poly_nms
+ */
+mluOpStatus_t MLUOP_WIN_API
+mluOpPolyNms(mluOpHandle_t handle, const mluOpTensorDescriptor_t boxes_desc,
+             const void *boxes, const float iou_threshold, void *workspace,
+             size_t workspace_size, const mluOpTensorDescriptor_t output_desc,
+             void *output, void *output_size);
+
+// Group:PolyNms
+/*!
+ *  @brief Gets extra space size that is needed in the batched poly_nms operation
+ *  ::mluOpPolyNmsBatched.
+ *
+ *  @param[in] handle
+ *  Handle to an MLUOP context that is used to manage MLU devices
+ *  and queues in the poly_nms operation.
+ *  @param[in] boxes_desc
+ *  The descriptor of the [B, N, 9] boxes tensor. For detailed information,
+ *  see ::mluOpTensorDescriptor_t.
+ *  @param[in] class_num
+ *  The number of classes, 1 when the boxes have no class ids.
+ *  @param[out] size
+ *  A host pointer to the returned size of extra space in bytes.
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpGetPolyNmsBatchedWorkspaceSize(
+    mluOpHandle_t handle, const mluOpTensorDescriptor_t boxes_desc,
+    const int class_num, size_t *size);
+
+// Group:PolyNms
+/*!
+ *  @brief Polygon Non Maximum Suppression of a batch of images, run independently
+ *  on every (image, class) group of boxes in one call.
+ *
+ *  @param[in] handle
+ *  Handle to an MLUOP context that is used to manage MLU devices
+ *  and queues in the poly_nms operation.
+ *  @param[in] boxes_desc
+ *  The descriptor of the [B, N, 9] boxes tensor. For detailed information,
+ *  see ::mluOpTensorDescriptor_t.
+ *  @param[in] boxes
+ *  Pointer to the MLU memory that stores the boxes tensor, each box is four
+ *  points followed by its score as in ::mluOpPolyNms.
+ *  @param[in] class_ids_desc
+ *  The descriptor of the [B, N] class ids tensor. It can be NULL, then every box
+ *  of an image is in the same group and \b class_num must be 1.
+ *  @param[in] class_ids
+ *  Pointer to the MLU memory that stores the class ids tensor.
+ *  @param[in] class_num
+ *  The number of classes. Boxes whose class ids are out of [0, class_num) are
+ *  dropped.
+ *  @param[in] iou_threshold
+ *  The iou_threshold data.
+ *  @param[in] workspace
+ *  Pointer to the MLU memory that stores the extra workspace. It can be NULL if the
+ *  workspace arena of \b handle is enabled, see ::mluOpEnableWorkspaceArena.
+ *  @param[in] workspace_size
+ *  The size of extra space, see ::mluOpGetPolyNmsBatchedWorkspaceSize.
+ *  @param[in] output_desc
+ *  The descriptor of the [B, N] output tensor. For detailed information,
+ *  see ::mluOpTensorDescriptor_t.
+ *  @param[out] output
+ *  Pointer to the MLU memory that stores the output tensor. The row of an image
+ *  packs the kept box ids of its groups one after another in class order, and
+ *  in ascending order inside a group. The rest of the row is not written.
+ *  @param[in] output_size_desc
+ *  The descriptor of the [B, class_num] output_size tensor. For detailed
+ *  information, see ::mluOpTensorDescriptor_t.
+ *  @param[out] output_size
+ *  Pointer to the MLU memory that stores the number of kept boxes of every group.
+ *
+ *  @par Return
+ *  - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM,
+ *    ::MLUOP_STATUS_NOT_SUPPORTED
+ *
+ *  @par Data Type
+ *  - The supported data types of input and output tensors are as follows:
+ *     - boxes tensor: float.
+ *     - class_ids tensor: int32.
+ *     - output tensor: int32.
+ *     - output_size tensor: int32.
+ *
+ *  @par Data Layout
+ *  - The data layout of \b boxes should be \p MLUOP_LAYOUT_ARRAY.
+ *
+ *  @par Scale Limitation
+ *  - The shape[2] of \b boxes should be equal to 9, the boxes of an image may
+ *    be padded, the images should not.
+ *  - \b class_ids should be contiguous.
+ *  - On MLU270, MLU290 and MLU370, the number of boxes per image does not
+ *    exceed 7021.
+ *
+ *  @note
+ *  - A group is suppressed as ::mluOpPolyNms suppresses its boxes, the groups
+ *    are split among the cores and the whole batch is processed by one call
+ *    without a host loop.
+ *  - The offset of a group in the row of its image is the sum of the
+ *    \b output_size of the lower classes of the image.
+ *
+ *  @par Requirements
+ *  - None.
+ *
+ *  @par Example
+ *  - None.
+ *
  * @par Reference
  * - https://github.com/dingjiansw101/AerialDetection/tree/master/mmdet/ops/poly_nms
  */
-mluOpStatus_t MLUOP_WIN_API
-mluOpPolyNms(mluOpHandle_t handle, const mluOpTensorDescriptor_t boxes_desc,
-             const void *boxes, const float iou_threshold, void *workspace,
-             size_t workspace_size, const mluOpTensorDescriptor_t output_desc,
-             void *output, void *output_size);
+mluOpStatus_t MLUOP_WIN_API mluOpPolyNmsBatched(
+    mluOpHandle_t handle, const mluOpTensorDescriptor_t boxes_desc,
+    const void *boxes, const mluOpTensorDescriptor_t class_ids_desc,
+    const void *class_ids, const int class_num, const float iou_threshold,
+    void *workspace, size_t workspace_size,
+    const mluOpTensorDescriptor_t output_desc, void *output,
+    const mluOpTensorDescriptor_t output_size_desc, void *output_size);
 
 // Group:PriorBox
 /*!
@@ -2558,6 +3346,147 @@ mluOpStatus_t MLUOP_WIN_API mluOpYoloBox(
     const float iou_aware_factor, const mluOpTensorDescriptor_t boxes_desc,
     void *boxes, const mluOpTensorDescriptor_t scores_desc, void *scores);
 
+// Group:YoloBox
+/*!
+ * @brief Gets extra space size that is needed in the fused yolo_box and
+ * multiclass nms operation ::mluOpYoloBoxNms.
+ *
+ * @param[in] handle
+ * Handle to an MLUOP context that is used to manage MLU devices and
+ * queues in the yolo_box_nms operation. For detailed information, see
+ * ::mluOpHandle_t.
+ * @param[in] x_desc
+ * The descriptor of the input x tensor. For detailed information, see
+ * ::mluOpTensorDescriptor_t.
+ * @param[in] anchors_desc
+ * The descriptor of the anchors tensor. For detailed information, see
+ * ::mluOpTensorDescriptor_t.
+ * @param[in] class_num
+ * The number of classes.
+ * @param[in] keep_top_k
+ * The number of boxes kept per image.
+ * @param[out] size
+ * A host pointer to the returned size of extra space in bytes.
+ *
+ * @par Return
+ * - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpGetYoloBoxNmsWorkspaceSize(
+    mluOpHandle_t handle, const mluOpTensorDescriptor_t x_desc,
+    const mluOpTensorDescriptor_t anchors_desc, const int class_num,
+    const int keep_top_k, size_t *size);
+
+// Group:YoloBox
+/*!
+ * @brief Decodes the backbone output of the detected network as ::mluOpYoloBox
+ * and runs a multiclass non maximum suppression on the boxes in one call,
+ * only the best boxes of every image are written.
+ *
+ * @param[in] handle
+ * Handle to an MLUOP context that is used to manage MLU devices and
+ * queues in the yolo_box_nms operation. For detailed information, see
+ * ::mluOpHandle_t.
+ * @param[in] x_desc
+ * The descriptor of the input x tensor, the same as in ::mluOpYoloBox.
+ * @param[in] x
+ * Pointer to the MLU memory that stores the input tensor.
+ * @param[in] img_size_desc
+ * The descriptor of the [N, 2] img_size tensor, the height and the width of
+ * every image.
+ * @param[in] img_size
+ * Pointer to the MLU memory that stores the img_size tensor.
+ * @param[in] anchors_desc
+ * The descriptor of the anchors tensor, the width and the height of every
+ * anchor.
+ * @param[in] anchors
+ * Pointer to the MLU memory that stores the anchors tensor.
+ * @param[in] class_num
+ * The number of classes.
+ * @param[in] conf_thresh
+ * The detection boxes with the confidence score below the threshold should be ignored.
+ * @param[in] downsample_ratio
+ * The downsample ratio from network input to yolo_box operator input.
+ * @param[in] clip_bbox
+ * Whether clip output bounding box in img_size boundary.
+ * @param[in] scale
+ * Scale the center point of decoded bounding box.
+ * @param[in] iou_aware
+ * Whether use iou aware.
+ * @param[in] iou_aware_factor
+ * iou aware factor.
+ * @param[in] score_thresh
+ * A box is a candidate of a class when its score of the class is above
+ * \b score_thresh.
+ * @param[in] nms_thresh
+ * A candidate is dropped when its intersection with a kept box of its class
+ * is above \b nms_thresh times their union.
+ * @param[in] keep_top_k
+ * The number of boxes kept per image.
+ * @param[in] workspace
+ * Pointer to the MLU memory that stores the extra workspace. It can be NULL if the
+ * workspace arena of \b handle is enabled, see ::mluOpEnableWorkspaceArena.
+ * @param[in] workspace_size
+ * The size of extra space, see ::mluOpGetYoloBoxNmsWorkspaceSize.
+ * @param[in] output_desc
+ * The descriptor of the [N, keep_top_k, 6] output tensor. For detailed
+ * information, see ::mluOpTensorDescriptor_t.
+ * @param[out] output
+ * Pointer to the MLU memory that stores the output tensor. Every row is
+ * (label, score, x1, y1, x2, y2), the kept boxes of an image are sorted by
+ * score and then by label. The rows after \b output_num are not written.
+ * @param[in] output_num_desc
+ * The descriptor of the [N] output_num tensor. For detailed information,
+ * see ::mluOpTensorDescriptor_t.
+ * @param[out] output_num
+ * Pointer to the MLU memory that stores the number of rows written per image.
+ *
+ * @par Return
+ * - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM,
+ *   ::MLUOP_STATUS_ARCH_MISMATCH, ::MLUOP_STATUS_NOT_SUPPORTED
+ *
+ * @par Data Type
+ * - The supported data types of input and output tensors are as follows:
+ *   - input x tensor: float.
+ *   - input img_size and anchors tensors: int.
+ *   - output tensor: float.
+ *   - output_num tensor: int.
+ *
+ * @par Scale Limitation
+ * - \b x, \b img_size, \b anchors and \b class_num are limited as in
+ *   ::mluOpYoloBox.
+ * - \b score_thresh should not be less than 0 and \b keep_top_k should be
+ *   larger than 0.
+ * - The number of boxes per image, the anchor number multiplied by H and W,
+ *   should not exceed 2^24.
+ * - Only MLU300 series and above are supported.
+ *
+ * @note
+ * - The scores of ::mluOpYoloBox stay on chip, each class keeps at most
+ *   \b keep_top_k of its candidates, the highest score first and the first
+ *   box among equal scores.
+ * - Every image is processed by one core.
+ *
+ * @par Requirements
+ * - None.
+ *
+ * @par Example
+ * - None.
+ *
+ * @par Reference
+ * - https://github.com/PaddlePaddle/Paddle/blob/release/2.3/python/paddle/vision/ops.py
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpYoloBoxNms(
+    mluOpHandle_t handle, const mluOpTensorDescriptor_t x_desc, const void *x,
+    const mluOpTensorDescriptor_t img_size_desc, const void *img_size,
+    const mluOpTensorDescriptor_t anchors_desc, const void *anchors,
+    const int class_num, const float conf_thresh, const int downsample_ratio,
+    const bool clip_bbox, const float scale, const bool iou_aware,
+    const float iou_aware_factor, const float score_thresh,
+    const float nms_thresh, const int keep_top_k, void *workspace,
+    size_t workspace_size, const mluOpTensorDescriptor_t output_desc,
+    void *output, const mluOpTensorDescriptor_t output_num_desc,
+    void *output_num);
+
 // Group: ThreeInterpolate
 /*!
  * @brief Computes weighted linear interpolation on 3 points by using
@@ -2744,6 +3673,111 @@ mluOpStatus_t MLUOP_WIN_API mluOpBallQuery(mluOpHandle_t handle,
                                            const mluOpTensorDescriptor_t idx_desc,
                                            void *idx);
 
+// Group:Ballquery
+/*!
+ * @brief Returns in \b size the size of the MLU memory that is used as an extra workspace
+ * to optimize ::mluOpBallQueryGrid.
+ *
+ * @param[in] handle
+ * Handle to an MLUOP context that is used to manage MLU devices and
+ * queues in the ball query operation. For detailed information, see
+ * ::mluOpHandle_t.
+ * @param[in] new_xyz_desc
+ * The descriptor of the new_xyz tensor. For detailed information, see
+ * ::mluOpTensorDescriptor_t.
+ * @param[in] xyz_desc
+ * The descriptor of the xyz tensor. For detailed information, see
+ * ::mluOpTensorDescriptor_t.
+ * @param[out] size
+ * A host pointer to the returned size of extra space in bytes.
+ *
+ * @par Return
+ * - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM
+ */
+mluOpStatus_t MLUOP_WIN_API
+mluOpGetBallQueryGridWorkspaceSize(mluOpHandle_t handle,
+                                   const mluOpTensorDescriptor_t new_xyz_desc,
+                                   const mluOpTensorDescriptor_t xyz_desc,
+                                   size_t *size);
+
+// Group:Ballquery
+/*!
+ * @brief Computes the same \b idx as ::mluOpBallQuery, but only compares each point of
+ * \b new_xyz with the points of \b xyz around it.
+ *
+ * The points of each batch are binned into cubic cells a little larger than \b max_radius,
+ * and the cells are folded into a fixed number of buckets. A point of \b new_xyz is only
+ * compared with the points of the 27 buckets around its own. The in-ball indices are
+ * merged back into ascending order, so the first \b nsample indices, the repeated first
+ * index in the unused slots, and the untouched rows without any point in their ball are
+ * the same as ::mluOpBallQuery. The query costs about the number of points in the buckets
+ * around each point of \b new_xyz instead of N, which pays off for large point clouds.
+ *
+ * @param[in] handle
+ * Handle to an MLUOP context that is used to manage MLU devices and
+ * queues in the ball query operation. For detailed information, see
+ * ::mluOpHandle_t.
+ * @param[in] new_xyz_desc
+ * The descriptor of the new_xyz tensor. For detailed information, see
+ * ::mluOpTensorDescriptor_t.
+ * @param[in] new_xyz
+ * Pointer to the MLU memory that stores the new_xyz tensor of shape [B, M, 3].
+ * @param[in] xyz_desc
+ * The descriptor of the xyz tensor. For detailed information, see
+ * ::mluOpTensorDescriptor_t.
+ * @param[in] xyz
+ * Pointer to the MLU memory that stores the xyz tensor of shape [B, N, 3].
+ * @param[in] min_radius
+ * A float value which is the minimum radius.
+ * @param[in] max_radius
+ * A float value which is the maximum radius.
+ * @param[in] nsample
+ * The number of point indices kept for each point of \b new_xyz.
+ * @param[in] workspace
+ * Pointer to the MLU memory that stores the grid. It can be NULL if the
+ * workspace arena of \b handle is enabled, see ::mluOpEnableWorkspaceArena.
+ * @param[in] workspace_size
+ * The size of the extra workspace in bytes, see ::mluOpGetBallQueryGridWorkspaceSize.
+ * @param[in] idx_desc
+ * The descriptor of the idx tensor. For detailed information, see
+ * ::mluOpTensorDescriptor_t.
+ * @param[out] idx
+ * Pointer to the MLU memory that stores the idx tensor of shape [B, M, nsample].
+ *
+ * @par Return
+ * - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM, ::MLUOP_STATUS_ARCH_MISMATCH,
+ *   ::MLUOP_STATUS_NOT_SUPPORTED
+ *
+ * @par Data Type
+ * - The same as ::mluOpBallQuery.
+ *
+ * @par Scale Limitation
+ * - The same as ::mluOpBallQuery.
+ * - The \b nsample should not be greater than 4096.
+ *
+ * @par Requirements
+ * - The operation is supported on MLU300 series and above.
+ *
+ * @note
+ * - As in ::mluOpBallQuery, the rows of \b idx without any point in their ball keep the
+ *   values passed in.
+ *
+ * @par Example
+ * - None.
+ */
+mluOpStatus_t MLUOP_WIN_API mluOpBallQueryGrid(mluOpHandle_t handle,
+                                               const mluOpTensorDescriptor_t new_xyz_desc,
+                                               const void *new_xyz,
+                                               const mluOpTensorDescriptor_t xyz_desc,
+                                               const void *xyz,
+                                               const float min_radius,
+                                               const float max_radius,
+                                               const int nsample,
+                                               void *workspace,
+                                               size_t workspace_size,
+                                               const mluOpTensorDescriptor_t idx_desc,
+                                               void *idx);
+
 // Group:Copy
 /*!
  * @brief Returns a copy of input tensor \b input in the output tensor \b output
@@ -2808,6 +3842,66 @@ mluOpStatus_t MLUOP_WIN_API mluOpCopy(mluOpHandle_t handle,
                                       const mluOpTensorDescriptor_t output_desc,
                                       void *output);
 
+// Group:Copy
+/*!
+ * @brief Copies the input tensor \b input to the output tensor \b output of
+ * another data type, converting every element while copying.
+ *
+ * @param[in] handle
+ * Handle to an MLUOP context that is used to manage MLU devices
+ * and queues in the copy operation. For detailed information, see ::mluOpHandle_t.
+ * The rounding mode of the handle, see ::mluOpSetQuantizeRoundMode, is used for
+ * lossy conversions.
+ * @param[in] input_desc
+ * The descriptor of the input tensor. For detailed information,
+ * see ::mluOpTensorDescriptor_t.
+ * @param[in] input
+ * Pointer to the MLU memory that stores the input tensor.
+ * @param[in] output_desc
+ * The descriptor of the output tensor. For detailed information,
+ * see ::mluOpTensorDescriptor_t.
+ * @param[out] output
+ * Pointer to the MLU memory that stores the output tensor.
+ *
+ * @par Return
+ * - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM, ::MLUOP_STATUS_ARCH_MISMATCH
+ *
+ * @par Data Type
+ * - Any pair of the following data types is supported:
+ *   - input tensor: int8, int16, int32, half, float.
+ *   - output tensor: int8, int16, int32, half, float.
+ * - When the data types are the same, ::mluOpCopy is called and all of its
+ *   data types are supported.
+ *
+ * @note
+ * - Elements are converted through float. Conversions to half and to integers
+ *   are rounded by the rounding mode of \b handle. Integers saturate, while
+ *   values beyond the range of half become inf as in IEEE 754.
+ * - int32 values beyond \f$2^{24}\f$ are rounded to float first.
+ * - You can specify the stride of all dimensions for input_desc and output_desc
+ *   with ::mluOpSetTensorDescriptorEx, strided tensors are converted in the same
+ *   pass as the copy.
+ *
+ * @par Requirements
+ * - The element number of input tensor and output tensor must be the same.
+ *
+ * @par Scale Limitation
+ * - When the input or output tensor is non-contiguous, the total number of bytes
+ *   spanned by either of the input or output tensor should be less than
+ *   \f$2^{31}\f$.
+ * - Only MLU300 series and above are supported.
+ *
+ * @par Example
+ * - None.
+ *
+ * @par Reference
+ * - https://www.tensorflow.org/api_docs/python/tf/cast
+ */
+mluOpStatus_t MLUOP_WIN_API
+mluOpCopyWithCast(mluOpHandle_t handle, const mluOpTensorDescriptor_t input_desc,
+                  const void *input, const mluOpTensorDescriptor_t output_desc,
+                  void *output);
+
 // Group:Expand
 /*!
  * @brief Copies and expands the input tensor \b input to the shape of output
@@ -2870,6 +3964,142 @@ mluOpStatus_t MLUOP_WIN_API mluOpExpand(
     mluOpHandle_t handle, const mluOpTensorDescriptor_t input_desc,
     const void *input, const mluOpTensorDescriptor_t output_desc, void *output);
 
+// Group:ForeachUnary
+/*!
+ * @brief Applies the element-wise operation \b op to every tensor of the
+ * tensor list \b x, and returns the results in the tensor list \b y. The
+ * tensors are packed into as few kernel launches as possible instead of one
+ * launch per tensor, which saves the launch overhead for lists of many small
+ * tensors.
+ *
+ * @param[in] handle
+ * Handle to an MLUOP context that is used to manage MLU devices and
+ * queues in the foreach unary operation. For detailed information, see
+ * ::mluOpHandle_t.
+ * @param[in] op
+ * The element-wise operation defined in ::mluOpForeachUnaryOp_t enum.
+ * @param[in] prefer
+ * The \b prefer modes defined in ::mluOpComputationPreference_t enum.
+ * @param[in] tensor_num
+ * The number of tensors in \b x and \b y.
+ * @param[in] x_descs
+ * The descriptors of the input tensors. For detailed information, see
+ * ::mluOpTensorDescriptor_t.
+ * @param[in] x
+ * Pointers to the MLU memory that stores the input tensors.
+ * @param[in] y_descs
+ * The descriptors of the output tensors. For detailed information, see
+ * ::mluOpTensorDescriptor_t.
+ * @param[out] y
+ * Pointers to the MLU memory that stores the output tensors.
+ *
+ * @par Return
+ * - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM,
+ *   ::MLUOP_STATUS_EXECUTION_FAILED
+ *
+ * @par Data Type
+ * - All input and output tensors should be of the same data type.
+ * - The supported data types of input and output tensors are as follows:
+ *   - input tensors: half, float.
+ *   - output tensors: half, float.
+ *
+ * @par Scale Limitation
+ * - Every output tensor has the shape of its input tensor, and the input
+ *   tensors must meet the data ranges of the single tensor operation, see
+ *   ::mluOpAbs, ::mluOpSqrt and ::mluOpLog.
+ *
+ * @note
+ * - Tensors of zero elements are skipped.
+ * - The results are the same as calling the single tensor operation on every
+ *   tensor.
+ *
+ * @par Requirements
+ * - None.
+ *
+ * @par Example
+ * - None.
+ *
+ * @par Reference
+ * - https://pytorch.org/docs/stable/generated/torch._foreach_abs.html
+ */
+mluOpStatus_t MLUOP_WIN_API
+mluOpForeachUnary(mluOpHandle_t handle, const mluOpForeachUnaryOp_t op,
+                  const mluOpComputationPreference_t prefer,
+                  const int tensor_num,
+                  const mluOpTensorDescriptor_t x_descs[],
+                  const void *const x[],
+                  const mluOpTensorDescriptor_t y_descs[], void *const y[]);
+
+// Group:FusedUnary
+/*!
+ * @brief Runs the program \b steps of element-wise operations on the input
+ * tensor \b x, and returns the results in the output tensor \b y. Step i
+ * takes the result of step i - 1, step 0 takes \b x. All steps are computed
+ * on chip, \b x is read and \b y is written once, instead of once per step
+ * as with a sequence of single operation calls.
+ *
+ * @param[in] handle
+ * Handle to an MLUOP context that is used to manage MLU devices and
+ * queues in the fused unary operation. For detailed information, see
+ * ::mluOpHandle_t.
+ * @param[in] step_num
+ * The number of steps of the program, from 1 to
+ * \p MLUOP_FUSED_UNARY_MAX_STEP_NUM.
+ * @param[in] steps
+ * The steps of the program. For detailed information, see
+ * ::mluOpFusedUnaryStep_t.
+ * @param[in] x_desc
+ * The descriptor of the input tensor. For detailed information, see
+ * ::mluOpTensorDescriptor_t.
+ * @param[in] x
+ * Pointer to the MLU memory that stores the input tensor \b x.
+ * @param[in] y_desc
+ * The descriptor of the output tensor. For detailed information, see
+ * ::mluOpTensorDescriptor_t.
+ * @param[out] y
+ * Pointer to the MLU memory that stores the output tensor \b y.
+ *
+ * @par Return
+ * - ::MLUOP_STATUS_SUCCESS, ::MLUOP_STATUS_BAD_PARAM,
+ *   ::MLUOP_STATUS_EXECUTION_FAILED
+ *
+ * @par Data Type
+ * - Data type of input tensor and output tensor should be the same.
+ * - The supported data types of input and output tensors are as follows:
+ *   - input tensor: half, float.
+ *   - output tensor: half, float.
+ *
+ * @par Scale Limitation
+ * - The input tensor and output tensor have the same shape. The input of
+ *   every log and sqrt step must meet the float data range of ::mluOpLog and
+ *   ::mluOpSqrt.
+ *
+ * @note
+ * - Half data is computed in float, the intermediate results are not rounded
+ *   to half between steps.
+ * - A division by a scalar is computed as a multiplication by its reciprocal.
+ *
+ * @par Requirements
+ * - None.
+ *
+ * @par Example
+ * - log(|x|) * 0.5 + 1:
+     @verbatim
+     mluOpFusedUnaryStep_t steps[3] = {{MLUOP_FUSED_UNARY_ABS, 0},
+                                       {MLUOP_FUSED_UNARY_LOG, 0.5},
+                                       {MLUOP_FUSED_UNARY_ADD_SCALAR, 1}};
+     mluOpFusedUnary(handle, 3, steps, x_desc, x, y_desc, y);
+     @endverbatim
+ *
+ * @par Reference
+ * - None.
+ */
+mluOpStatus_t MLUOP_WIN_API
+mluOpFusedUnary(mluOpHandle_t handle, const int step_num,
+                const mluOpFusedUnaryStep_t steps[],
+                const mluOpTensorDescriptor_t x_desc, const void *x,
+                const mluOpTensorDescriptor_t y_desc, void *y);
+
 #if defined(__cplusplus)
 }
 #endif
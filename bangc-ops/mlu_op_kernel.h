@@ -53,6 +53,18 @@ void MLUOP_WIN_API mluOpBlockKernel5StagePipelineAbsFloatFast(
     cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
     const void *x, void *y, int num);
 
+/* BinaryBroadcast */
+// a broadcast binary op launch z = x op y, passed to the kernel by value.
+// z is contiguous of the shape `dims`, strides are in elements, 0 on the dims
+// an input is broadcast along. The innermost stride of x and y is 0 or 1.
+#define MLUOP_BINARY_BROADCAST_MAX_DIM 8
+typedef struct {
+  int32_t dim;
+  int32_t dims[MLUOP_BINARY_BROADCAST_MAX_DIM];
+  int32_t x_strides[MLUOP_BINARY_BROADCAST_MAX_DIM];
+  int32_t y_strides[MLUOP_BINARY_BROADCAST_MAX_DIM];
+} mluOpBinaryBroadcastPlan_t;
+
 /* Div */
 void MLUOP_WIN_API mluOpBlockKernel3StagePipelineDivHalfFast(
     cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
@@ -64,12 +76,88 @@ void MLUOP_WIN_API mluOpBlockKernel3StagePipelineDivFloatFast(
     cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
     const void *x, const void *y, void *z, int num);
 
+void MLUOP_WIN_API mluOpBlockKernel3StagePipelineBroadcastDivHalfFast(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const void *x, const void *y, void *z,
+    const mluOpBinaryBroadcastPlan_t *plan);
+void MLUOP_WIN_API mluOpBlockKernel3StagePipelineBroadcastDivHalfHighAcc(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const void *x, const void *y, void *z,
+    const mluOpBinaryBroadcastPlan_t *plan);
+void MLUOP_WIN_API mluOpBlockKernel3StagePipelineBroadcastDivFloatFast(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const void *x, const void *y, void *z,
+    const mluOpBinaryBroadcastPlan_t *plan);
+
 /* FillZero */
 void MLUOP_WIN_API mluOpBlockKernelFillZeroByte(cnrtDim3_t k_dim,
                                                 cnrtFunctionType_t k_type,
                                                 cnrtQueue_t queue,
                                                 const int num_byte, void *x);
 
+/* ForeachUnary */
+// the segments of one foreach launch, passed to the kernel by value.
+#define MLUOP_FOREACH_MAX_SEGMENT_NUM 32
+typedef struct {
+  int32_t segment_num;
+  // x[i] and y[i] point to the first element of segment i.
+  const void *x[MLUOP_FOREACH_MAX_SEGMENT_NUM];
+  void *y[MLUOP_FOREACH_MAX_SEGMENT_NUM];
+  // begin[i] is the index of the first element of segment i in the launch,
+  // begin[segment_num] is the element number of the launch.
+  int32_t begin[MLUOP_FOREACH_MAX_SEGMENT_NUM + 1];
+} mluOpForeachUnaryTable_t;
+
+void MLUOP_WIN_API mluOpBlockKernel3StagePipelineForeachAbsHalfFast(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const mluOpForeachUnaryTable_t *table, float coef);
+void MLUOP_WIN_API mluOpBlockKernel3StagePipelineForeachAbsFloatFast(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const mluOpForeachUnaryTable_t *table, float coef);
+void MLUOP_WIN_API mluOpBlockKernel3StagePipelineForeachLogHalfFast(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const mluOpForeachUnaryTable_t *table, float coef);
+void MLUOP_WIN_API mluOpBlockKernel3StagePipelineForeachLogHalfHighAcc(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const mluOpForeachUnaryTable_t *table, float coef);
+void MLUOP_WIN_API mluOpBlockKernel3StagePipelineForeachLogFloatFast(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const mluOpForeachUnaryTable_t *table, float coef);
+void MLUOP_WIN_API mluOpBlockKernel3StagePipelineForeachSqrtHalfFast(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const mluOpForeachUnaryTable_t *table, float coef);
+void MLUOP_WIN_API mluOpBlockKernel3StagePipelineForeachSqrtHalfHighAcc(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const mluOpForeachUnaryTable_t *table, float coef);
+void MLUOP_WIN_API mluOpBlockKernel3StagePipelineForeachSqrtFloatFast(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const mluOpForeachUnaryTable_t *table, float coef);
+
+/* FusedUnary */
+// the program of mluOpFusedUnary after lowering, passed to the kernel by value.
+#define MLUOP_FUSED_UNARY_KERNEL_MAX_STEP_NUM 8
+typedef struct {
+  int32_t step_num;
+  // mluOpFusedUnaryStepType_t of every step, DIV_SCALAR is lowered to
+  // MUL_SCALAR by the reciprocal.
+  int32_t type[MLUOP_FUSED_UNARY_KERNEL_MAX_STEP_NUM];
+  float scalar[MLUOP_FUSED_UNARY_KERNEL_MAX_STEP_NUM];
+} mluOpFusedUnaryProgram_t;
+
+void MLUOP_WIN_API mluOpBlockKernel3StagePipelineFusedUnaryHalf(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const void *x, void *y, int num, const mluOpFusedUnaryProgram_t *program);
+void MLUOP_WIN_API mluOpBlockKernel3StagePipelineFusedUnaryFloat(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const void *x, void *y, int num, const mluOpFusedUnaryProgram_t *program);
+
+void MLUOP_WIN_API mluOpBlockKernel5StagePipelineFusedUnaryHalf(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const void *x, void *y, int num, const mluOpFusedUnaryProgram_t *program);
+void MLUOP_WIN_API mluOpBlockKernel5StagePipelineFusedUnaryFloat(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const void *x, void *y, int num, const mluOpFusedUnaryProgram_t *program);
+
 /* Log */
 void MLUOP_WIN_API mluOpBlockKernel3StagePipelineLogHalfFast(
     cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
@@ -100,7 +188,7 @@ void MLUOP_WIN_API mluOpUBestKernelGenerateProposalsV2Float(
     int *rpn_rois_batch_size, const int pre_nms_top_n, const int post_nms_top_n,
     const float nms_thresh, const float min_size, const float eta,
     bool pixel_offset, const int batch_size, const int Anchors_num, const int H,
-    const int W);
+    const int W, const bool batch_parallel, const int core_workspace_num);
 
 /* poly_nms */
 void MLUOP_WIN_API mluOpBlockKernelPolyNmsCalcAreaFloat(
@@ -119,6 +207,30 @@ void MLUOP_WIN_API mluOpBlockKernelPolyNmsGenResultFloat(
     const int box_num, uint32_t *dev_mask, int *dev_sort_info, int *output,
     int *output_size);
 
+void MLUOP_WIN_API mluOpBlockKernelPolyNmsGenMaskTiledFloat(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const float *boxes, const int box_num, const int real_width,
+    const float iou_threshold, float *dev_area, uint32_t *dev_mask,
+    int *dev_sort_info);
+
+void MLUOP_WIN_API mluOpBlockKernelPolyNmsGenResultTiledFloat(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const int box_num, uint32_t *dev_mask, int *dev_sort_info, int *output,
+    int *output_size);
+
+void MLUOP_WIN_API mluOpBlockKernelPolyNmsBatchedFloat(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const float *boxes, const int batch_num, const int box_num,
+    const int real_width, const int *class_ids, const int class_num,
+    const float iou_threshold, float *dev_area, int *dev_group_index,
+    int *dev_group_member_num, int *output_size);
+
+void MLUOP_WIN_API mluOpBlockKernelPolyNmsBatchedPack(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const int batch_num, const int box_num, const int class_num,
+    int *dev_group_index, int *dev_group_member_num, int *output_size,
+    int *output);
+
 /* PSRoIPool */
 void MLUOP_WIN_API mluOpBlockKernelPsRoiPoolForwardFloat(
     cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
@@ -198,6 +310,15 @@ void MLUOP_WIN_API mluOpBlockKernelYoloBoxFloat(
     const bool clip_bbox, const float scale, const bool iou_aware,
     const float iou_aware_factor, const int n_in, const int anchor_s,
     const int c_in, const int h_in, const int w_in, void *boxes, void *scores);
+void MLUOP_WIN_API mluOpBlockKernelYoloBoxNmsFloat(
+    cnrtDim3_t k_dim, cnrtFunctionType_t k_type, cnrtQueue_t queue,
+    const void *x, const void *img_size, const void *anchors,
+    const int class_num, const float conf_thresh, const int downsample_ratio,
+    const bool clip_bbox, const float scale, const bool iou_aware,
+    const float iou_aware_factor, const float score_thresh,
+    const float nms_thresh, const int keep_top_k, const int n_in,
+    const int anchor_s, const int c_in, const int h_in, const int w_in,
+    void *workspace, void *output, void *output_num);
 
 /* ThreeInterpolateForward*/
 void MLUOP_WIN_API mluOpUnionKernelThreeInterpolateForwardFloat(
@@ -0,0 +1,180 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "api_test_tools.h"
+#include "gtest/gtest.h"
+#include "ball_query_grid_reference.h"
+
+namespace mluopapitest {
+class ball_query_grid : public testing::Test {
+ protected:
+  // b batches of n points uniform in [-range, range)^3.
+  static std::vector<float> randomPoints(int b, int n, float range,
+                                         std::mt19937 *gen) {
+    std::uniform_real_distribution<float> dist(-range, range);
+    std::vector<float> points(b * n * 3);
+    for (float &value : points) {
+      value = dist(*gen);
+    }
+    return points;
+  }
+
+  // the cells of mluOpBallQueryGrid for float points.
+  static float cellSize(float max_radius) {
+    return std::max(max_radius * (17.0f / 16.0f), 1.0f / 64);
+  }
+
+  static void expectSameIdx(const std::vector<float> &new_xyz,
+                            const std::vector<float> &xyz, int b, int m, int n,
+                            float min_radius, float max_radius, int nsample,
+                            int grid_bits) {
+    std::vector<int32_t> expected(b * m * nsample, -1);
+    std::vector<int32_t> result(b * m * nsample, -1);
+    ballQueryBruteForce(new_xyz.data(), xyz.data(), b, m, n, min_radius,
+                        max_radius, nsample, expected.data());
+    ballQueryGridReference(new_xyz.data(), xyz.data(), b, m, n, min_radius,
+                           max_radius, nsample, cellSize(max_radius),
+                           grid_bits, result.data());
+    EXPECT_EQ(expected, result);
+  }
+};
+
+TEST_F(ball_query_grid, build) {
+  try {
+    // 4 buckets per axis, cells 4 apart share a bucket.
+    std::vector<float> xyz = {0.1, 0.1, 0.1,  5.0, 5.0, 5.0, 0.2, 0.3, 0.4,
+                              0.8, 0.8, 0.8, -0.5, 0.0, 0.0, 4.5, 0.0, 0.0};
+    BallQueryGrid grid;
+    buildBallQueryGrid(xyz.data(), 2, 3, 1.0, 2, &grid);
+    const int32_t *start = grid.bucket_start.data();
+    EXPECT_EQ(0, start[0]);
+    EXPECT_EQ(2, start[1]);
+    EXPECT_EQ(2, start[21]);
+    EXPECT_EQ(3, start[22]);
+    EXPECT_EQ(3, start[64]);
+    start += 65;
+    EXPECT_EQ(2, start[3]);
+    EXPECT_EQ(3, start[4]);
+    EXPECT_EQ(std::vector<int32_t>({0, 2, 1, 0, 2, 1}), grid.point_index);
+
+    // far or not finite coordinates are clamped to the outermost cells.
+    const float far[][3] = {{65536.5, 0, 0}, {1e6, 0, 0}, {INFINITY, 0, 0}};
+    const float low[][3] = {{-1e6, 0, 0}, {-INFINITY, 0, 0}, {NAN, 0, 0}};
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(getBallQueryGridBucket(far[0], 1.0, 5),
+                getBallQueryGridBucket(far[i], 1.0, 5));
+      EXPECT_EQ(getBallQueryGridBucket(low[0], 1.0, 5),
+                getBallQueryGridBucket(low[i], 1.0, 5));
+    }
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in ball_query_grid";
+  }
+}
+
+TEST_F(ball_query_grid, first_nsample) {
+  try {
+    // the in-ball points lie in different buckets, out of index order.
+    std::vector<float> new_xyz = {0, 0, 0, 100, 100, 100};
+    std::vector<float> xyz = {0.9, 0,   0, 0,    -0.9, 0,   0.5, 0.5, 0,
+                              3,   3,   3, -0.5, -0.5, 0.5, 0,   0,   0};
+    std::vector<int32_t> idx(2 * 3);
+    ballQueryGridReference(new_xyz.data(), xyz.data(), 1, 2, 6, 0.2, 1.0, 3,
+                           cellSize(1.0), 2, idx.data());
+    EXPECT_EQ(std::vector<int32_t>({0, 1, 2, 0, 0, 0}), idx);
+    // a point coinciding with the query is in the ball within min_radius,
+    // the unused slots repeat the first index.
+    ballQueryGridReference(new_xyz.data(), xyz.data(), 1, 1, 6, 0.95, 1.0, 3,
+                           cellSize(1.0), 2, idx.data());
+    idx.resize(3);
+    EXPECT_EQ(std::vector<int32_t>({5, 5, 5}), idx);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in ball_query_grid";
+  }
+}
+
+TEST_F(ball_query_grid, random) {
+  try {
+    std::mt19937 gen(2022);
+    const int b = 2, m = 64, n = 512;
+    const float radius[][2] = {{0, 0.2}, {0.1, 0.5}, {0, 3}, {0, 0}};
+    for (const auto &r : radius) {
+      std::vector<float> xyz = randomPoints(b, n, 2.0, &gen);
+      std::vector<float> new_xyz = randomPoints(b, m, 2.0, &gen);
+      // queries on top of points of their batch.
+      for (int i = 0; i < b * m; i += 4) {
+        const int batch = i / m;
+        for (int j = 0; j < 3; ++j) {
+          new_xyz[i * 3 + j] = xyz[(batch * n + i % n) * 3 + j];
+        }
+      }
+      for (int nsample : {1, 16, 600}) {
+        for (int grid_bits : {2, 4}) {
+          expectSameIdx(new_xyz, xyz, b, m, n, r[0], r[1], nsample,
+                        grid_bits);
+        }
+      }
+    }
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in ball_query_grid";
+  }
+}
+
+TEST_F(ball_query_grid, cell_boundaries) {
+  try {
+    // points and queries within a few ulp of the cell boundaries.
+    std::mt19937 gen(7);
+    const int m = 256, n = 1024;
+    const float max_radius = 1.0;
+    const float cell_size = cellSize(max_radius);
+    std::vector<float> xyz(n * 3), new_xyz(m * 3);
+    for (auto *points : {&xyz, &new_xyz}) {
+      for (float &value : *points) {
+        const int cell = (int)(gen() % 7) - 3;
+        const int ulp = (int)(gen() % 5) - 2;
+        value = cell * cell_size;
+        for (int i = 0; i < std::abs(ulp); ++i) {
+          value = std::nextafter(value, ulp > 0 ? INFINITY : -INFINITY);
+        }
+      }
+    }
+    expectSameIdx(new_xyz, xyz, 1, m, n, 0, max_radius, 64, 2);
+    expectSameIdx(new_xyz, xyz, 1, m, n, 0.5, max_radius, 64, 3);
+
+    // points far from the origin in cells share the outermost cells.
+    std::vector<float> far = randomPoints(1, n, 2.0, &gen);
+    for (float &value : far) {
+      value += 1e6;
+    }
+    std::vector<float> far_new_xyz = {1e6, 1e6, 1e6, 0, 0, 0, NAN, 0, 0};
+    expectSameIdx(far_new_xyz, far, 1, 3, n, 0, 0.5, 8, 2);
+    expectSameIdx(far_new_xyz, far, 1, 3, n, 0, 1e7, 8, 2);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in ball_query_grid";
+  }
+}
+}  // namespace mluopapitest
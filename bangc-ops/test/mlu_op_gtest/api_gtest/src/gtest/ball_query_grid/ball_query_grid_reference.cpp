@@ -0,0 +1,185 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "ball_query_grid_reference.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Cells are clamped to [-2^16, 2^16], where the rounding of x / cell_size is
+// below 2^-8 of a cell. With cells 1/16 larger than max_radius two points
+// closer than max_radius are then never two cells apart.
+#define BALL_QUERY_GRID_MAX_CELL 65536.0f
+
+namespace mluopapitest {
+static int32_t getCell(const float coord, const float cell_size) {
+  float q = coord / cell_size;
+  // NaN points are never in a ball, any cell will do.
+  if (!(q > -BALL_QUERY_GRID_MAX_CELL)) {
+    q = -BALL_QUERY_GRID_MAX_CELL;
+  } else if (q > BALL_QUERY_GRID_MAX_CELL) {
+    q = BALL_QUERY_GRID_MAX_CELL;
+  }
+  return (int32_t)std::floor(q);
+}
+
+static int32_t getBucket(const int32_t x, const int32_t y, const int32_t z,
+                         const int grid_bits) {
+  const int32_t mask = (1 << grid_bits) - 1;
+  return ((z & mask) << (2 * grid_bits)) | ((y & mask) << grid_bits) |
+         (x & mask);
+}
+
+// the test of MLUUnion1KernelBallQuery, a point coinciding with the query is
+// always in the ball.
+static bool inBall(const float *query, const float *point,
+                   const float min_radius2, const float max_radius2) {
+  const float sub_x = query[0] - point[0];
+  const float sub_y = query[1] - point[1];
+  const float sub_z = query[2] - point[2];
+  const float distance2 = sub_x * sub_x + sub_y * sub_y + sub_z * sub_z;
+  return distance2 == 0 ||
+         (distance2 >= min_radius2 && distance2 < max_radius2);
+}
+
+// writes the ascending in-ball indices of one query to its nsample slots.
+static void fillIdx(const std::vector<int32_t> &in_ball, const int nsample,
+                    int32_t *idx) {
+  if (in_ball.empty()) {
+    std::fill(idx, idx + nsample, 0);
+    return;
+  }
+  const int num = std::min((int)in_ball.size(), nsample);
+  std::copy(in_ball.begin(), in_ball.begin() + num, idx);
+  std::fill(idx + num, idx + nsample, in_ball[0]);
+}
+
+int32_t getBallQueryGridBucket(const float *point, const float cell_size,
+                               const int grid_bits) {
+  return getBucket(getCell(point[0], cell_size), getCell(point[1], cell_size),
+                   getCell(point[2], cell_size), grid_bits);
+}
+
+void buildBallQueryGrid(const float *xyz, const int b, const int n,
+                        const float cell_size, const int grid_bits,
+                        BallQueryGrid *grid) {
+  const int bucket_num = 1 << (3 * grid_bits);
+  grid->b = b;
+  grid->n = n;
+  grid->grid_bits = grid_bits;
+  grid->cell_size = cell_size;
+  grid->bucket_start.assign((size_t)b * (bucket_num + 1), 0);
+  grid->point_index.resize((size_t)b * n);
+  std::vector<int32_t> bucket(n);
+  for (int batch = 0; batch < b; ++batch) {
+    const float *batch_xyz = xyz + (size_t)batch * n * 3;
+    int32_t *start = grid->bucket_start.data() + batch * (bucket_num + 1);
+    for (int i = 0; i < n; ++i) {
+      bucket[i] = getBallQueryGridBucket(batch_xyz + i * 3, cell_size,
+                                         grid_bits);
+      ++start[bucket[i] + 1];
+    }
+    for (int j = 0; j < bucket_num; ++j) {
+      start[j + 1] += start[j];
+    }
+    std::vector<int32_t> cursor(start, start + bucket_num);
+    int32_t *point_index = grid->point_index.data() + (size_t)batch * n;
+    for (int i = 0; i < n; ++i) {
+      point_index[cursor[bucket[i]]++] = i;
+    }
+  }
+}
+
+void ballQueryBruteForce(const float *new_xyz, const float *xyz, const int b,
+                         const int m, const int n, const float min_radius,
+                         const float max_radius, const int nsample,
+                         int32_t *idx) {
+  const float min_radius2 = min_radius * min_radius;
+  const float max_radius2 = max_radius * max_radius;
+  std::vector<int32_t> in_ball;
+  for (int batch = 0; batch < b; ++batch) {
+    for (int row = 0; row < m; ++row) {
+      const size_t offset = (size_t)batch * m + row;
+      const float *query = new_xyz + offset * 3;
+      in_ball.clear();
+      for (int i = 0; i < n && (int)in_ball.size() < nsample; ++i) {
+        if (inBall(query, xyz + ((size_t)batch * n + i) * 3, min_radius2,
+                   max_radius2)) {
+          in_ball.push_back(i);
+        }
+      }
+      fillIdx(in_ball, nsample, idx + offset * nsample);
+    }
+  }
+}
+
+void ballQueryGridReference(const float *new_xyz, const float *xyz,
+                            const int b, const int m, const int n,
+                            const float min_radius, const float max_radius,
+                            const int nsample, const float cell_size,
+                            const int grid_bits, int32_t *idx) {
+  BallQueryGrid grid;
+  buildBallQueryGrid(xyz, b, n, cell_size, grid_bits, &grid);
+  const int bucket_num = 1 << (3 * grid_bits);
+  const float min_radius2 = min_radius * min_radius;
+  const float max_radius2 = max_radius * max_radius;
+  std::vector<int32_t> in_ball;
+  for (int batch = 0; batch < b; ++batch) {
+    const float *batch_xyz = xyz + (size_t)batch * n * 3;
+    const int32_t *start = grid.bucket_start.data() + batch * (bucket_num + 1);
+    const int32_t *point_index = grid.point_index.data() + (size_t)batch * n;
+    for (int row = 0; row < m; ++row) {
+      const size_t offset = (size_t)batch * m + row;
+      const float *query = new_xyz + offset * 3;
+      const int32_t x = getCell(query[0], cell_size);
+      const int32_t y = getCell(query[1], cell_size);
+      const int32_t z = getCell(query[2], cell_size);
+      in_ball.clear();
+      for (int dz = -1; dz <= 1; ++dz) {
+        for (int dy = -1; dy <= 1; ++dy) {
+          for (int dx = -1; dx <= 1; ++dx) {
+            const int32_t bucket =
+                getBucket(x + dx, y + dy, z + dz, grid_bits);
+            for (int32_t i = start[bucket]; i < start[bucket + 1]; ++i) {
+              if (inBall(query, batch_xyz + point_index[i] * 3, min_radius2,
+                         max_radius2)) {
+                in_ball.push_back(point_index[i]);
+              }
+            }
+          }
+        }
+      }
+      // the buckets are visited out of index order, keep the first nsample
+      // indices as the brute force query does.
+      if ((int)in_ball.size() > nsample) {
+        std::nth_element(in_ball.begin(), in_ball.begin() + nsample,
+                         in_ball.end());
+        in_ball.resize(nsample);
+      }
+      std::sort(in_ball.begin(), in_ball.end());
+      fillIdx(in_ball, nsample, idx + offset * nsample);
+    }
+  }
+}
+}  // namespace mluopapitest
@@ -0,0 +1,75 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef TEST_MLU_OP_GTEST_API_GTEST_SRC_GTEST_BALL_QUERY_GRID_REFERENCE_H_
+#define TEST_MLU_OP_GTEST_API_GTEST_SRC_GTEST_BALL_QUERY_GRID_REFERENCE_H_
+#include <cstdint>
+#include <vector>
+
+namespace mluopapitest {
+/* A host model of the grid built by mluOpBallQueryGrid. The cubic cells of
+ * cell_size are folded into 2^grid_bits buckets per axis, and the points of
+ * each batch are counting sorted by bucket, in ascending index order inside
+ * a bucket. The points of bucket j of batch i are
+ * point_index[i * n + bucket_start[i * (bucket_num + 1) + j], ...) up to
+ * bucket_start[i * (bucket_num + 1) + j + 1].
+ * */
+struct BallQueryGrid {
+  int b = 0;
+  int n = 0;
+  int grid_bits = 0;
+  float cell_size = 0;
+  std::vector<int32_t> bucket_start;
+  std::vector<int32_t> point_index;
+};
+
+// the bucket of a point, cells are clamped to [-2^16, 2^16] per axis.
+int32_t getBallQueryGridBucket(const float *point, const float cell_size,
+                               const int grid_bits);
+
+// bins xyz of shape [b, n, 3] into grid.
+void buildBallQueryGrid(const float *xyz, const int b, const int n,
+                        const float cell_size, const int grid_bits,
+                        BallQueryGrid *grid);
+
+/* the reference of mluOpBallQuery comparing every new_xyz point with every
+ * xyz point of its batch. idx of shape [b, m, nsample] holds the first
+ * nsample indices of the points with distance2 == 0 or
+ * min_radius2 <= distance2 < max_radius2, the unused slots repeat the first
+ * index, and a new_xyz point without any point in its ball gets 0.
+ * */
+void ballQueryBruteForce(const float *new_xyz, const float *xyz, const int b,
+                         const int m, const int n, const float min_radius,
+                         const float max_radius, const int nsample,
+                         int32_t *idx);
+
+/* the same result as ballQueryBruteForce as long as cell_size is larger than
+ * max_radius, only the xyz points in the 27 buckets around the bucket of
+ * each new_xyz point are compared.
+ * */
+void ballQueryGridReference(const float *new_xyz, const float *xyz,
+                            const int b, const int m, const int n,
+                            const float min_radius, const float max_radius,
+                            const int nsample, const float cell_size,
+                            const int grid_bits, int32_t *idx);
+}  // namespace mluopapitest
+#endif  // TEST_MLU_OP_GTEST_API_GTEST_SRC_GTEST_BALL_QUERY_GRID_REFERENCE_H_
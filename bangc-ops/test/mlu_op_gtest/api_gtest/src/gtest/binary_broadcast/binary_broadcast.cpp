@@ -0,0 +1,255 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <iostream>
+#include <random>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/broadcast_plan.h"
+#include "core/logging.h"
+#include "gtest/gtest.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+// CPU reference of z = op(x, y) with NumPy broadcasting, computed from the
+// shapes element by element without any planning. z has the broadcast shape.
+template <typename T, typename OpFunc>
+static void broadcastReference(int x_dim, const int64_t *x_dims, const T *x,
+                               int y_dim, const int64_t *y_dims, const T *y,
+                               T *z, OpFunc op) {
+  int z_dim = 0;
+  int64_t z_dims[MLUOP_DIM_MAX];
+  if (!mluop::getBroadcastShape(x_dim, x_dims, y_dim, y_dims, &z_dim,
+                                z_dims)) {
+    return;
+  }
+  int64_t z_num = 1;
+  for (int i = 0; i < z_dim; ++i) {
+    z_num *= z_dims[i];
+  }
+  for (int64_t n = 0; n < z_num; ++n) {
+    // unravel n in z, then ravel the index in x and y from the last dim on.
+    int64_t rest = n, x_index = 0, y_index = 0, x_size = 1, y_size = 1;
+    for (int i = z_dim - 1, k = 0; i >= 0; --i, ++k) {
+      const int64_t index = rest % z_dims[i];
+      rest /= z_dims[i];
+      if (k < x_dim) {
+        const int64_t d = x_dims[x_dim - 1 - k];
+        x_index += (d == 1 ? 0 : index) * x_size;
+        x_size *= d;
+      }
+      if (k < y_dim) {
+        const int64_t d = y_dims[y_dim - 1 - k];
+        y_index += (d == 1 ? 0 : index) * y_size;
+        y_size *= d;
+      }
+    }
+    z[n] = op(x[x_index], y[y_index]);
+  }
+}
+
+// z of `plan` computed element by element from the plan strides, the way the
+// broadcast kernels gather x and y.
+static std::vector<float> planCompute(const mluop::BroadcastPlan &plan,
+                                      const float *x, const float *y) {
+  std::vector<float> z(plan.getElementNum());
+  for (int64_t n = 0; n < (int64_t)z.size(); ++n) {
+    int64_t rest = n, x_offset = 0, y_offset = 0;
+    for (int i = plan.dim - 1; i >= 0; --i) {
+      x_offset += rest % plan.dims[i] * plan.x_strides[i];
+      y_offset += rest % plan.dims[i] * plan.y_strides[i];
+      rest /= plan.dims[i];
+    }
+    z[n] = x[x_offset] - 2 * y[y_offset];
+  }
+  return z;
+}
+
+static std::vector<float> iota(int dim, const int64_t *dims, float start) {
+  int64_t num = 1;
+  for (int i = 0; i < dim; ++i) {
+    num *= dims[i];
+  }
+  std::vector<float> data(num);
+  for (int64_t i = 0; i < num; ++i) {
+    data[i] = start + i;
+  }
+  return data;
+}
+
+static float op(float a, float b) { return a - 2 * b; }
+
+TEST(binary_broadcast, shape) {
+  try {
+    int dim = 0;
+    int64_t dims[MLUOP_DIM_MAX];
+    int64_t a[4] = {2, 1, 4, 1};
+    int64_t b[3] = {3, 1, 5};
+    EXPECT_TRUE(mluop::getBroadcastShape(4, a, 3, b, &dim, dims));
+    EXPECT_EQ(4, dim);
+    EXPECT_EQ((std::vector<int64_t>{2, 3, 4, 5}),
+              std::vector<int64_t>(dims, dims + dim));
+    int64_t c[2] = {0, 1};
+    int64_t d[1] = {7};
+    EXPECT_TRUE(mluop::getBroadcastShape(2, c, 1, d, &dim, dims));
+    EXPECT_EQ((std::vector<int64_t>{0, 7}),
+              std::vector<int64_t>(dims, dims + dim));
+    int64_t e[2] = {3, 4};
+    int64_t f[2] = {3, 5};
+    EXPECT_FALSE(mluop::getBroadcastShape(2, e, 2, f, &dim, dims));
+    EXPECT_TRUE(mluop::getBroadcastShape(2, e, 0, f, &dim, dims));
+    EXPECT_EQ(2, dim);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in binary_broadcast";
+  }
+}
+
+TEST(binary_broadcast, plan) {
+  try {
+    // per channel: [N, C, H, W] / [1, C, 1, 1] is [N, C, H * W].
+    mluop::BroadcastPlan plan;
+    int64_t x_dims[4] = {2, 3, 4, 5};
+    int64_t y_dims[4] = {1, 3, 1, 1};
+    EXPECT_TRUE(mluop::planBroadcast(4, x_dims, 4, y_dims, &plan));
+    EXPECT_FALSE(plan.isElementwise());
+    EXPECT_EQ(3, plan.dim);
+    EXPECT_EQ((std::vector<int64_t>{2, 3, 20}),
+              std::vector<int64_t>(plan.dims, plan.dims + plan.dim));
+    EXPECT_EQ((std::vector<int64_t>{60, 20, 1}),
+              std::vector<int64_t>(plan.x_strides, plan.x_strides + plan.dim));
+    EXPECT_EQ((std::vector<int64_t>{0, 1, 0}),
+              std::vector<int64_t>(plan.y_strides, plan.y_strides + plan.dim));
+
+    // outer product: [4, 1] / [5] is [4, 5].
+    int64_t col[2] = {4, 1};
+    int64_t row[1] = {5};
+    EXPECT_TRUE(mluop::planBroadcast(2, col, 1, row, &plan));
+    EXPECT_EQ(2, plan.dim);
+    EXPECT_EQ((std::vector<int64_t>{1, 0}),
+              std::vector<int64_t>(plan.x_strides, plan.x_strides + 2));
+    EXPECT_EQ((std::vector<int64_t>{0, 1}),
+              std::vector<int64_t>(plan.y_strides, plan.y_strides + 2));
+
+    // same shapes and single elements are element-wise.
+    EXPECT_TRUE(mluop::planBroadcast(4, x_dims, 4, x_dims, &plan));
+    EXPECT_TRUE(plan.isElementwise());
+    EXPECT_EQ(120, plan.dims[0]);
+    int64_t ones[3] = {1, 1, 1};
+    EXPECT_TRUE(mluop::planBroadcast(3, ones, 1, ones, &plan));
+    EXPECT_TRUE(plan.isElementwise());
+    EXPECT_EQ(1, plan.getElementNum());
+
+    // a scalar divisor is one broadcast dim.
+    EXPECT_TRUE(mluop::planBroadcast(4, x_dims, 1, ones, &plan));
+    EXPECT_EQ(1, plan.dim);
+    EXPECT_EQ(1, plan.x_strides[0]);
+    EXPECT_EQ(0, plan.y_strides[0]);
+
+    int64_t bad[1] = {4};
+    EXPECT_FALSE(mluop::planBroadcast(4, x_dims, 1, bad, &plan));
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in binary_broadcast";
+  }
+}
+
+TEST(binary_broadcast, random) {
+  try {
+    std::mt19937 gen(2022);
+    for (int iter = 0; iter < 200; ++iter) {
+      const int dim = gen() % 5 + 1;
+      int64_t dims[MLUOP_DIM_MAX], x_dims[MLUOP_DIM_MAX],
+          y_dims[MLUOP_DIM_MAX];
+      for (int i = 0; i < dim; ++i) {
+        dims[i] = gen() % 4 + 1;
+        x_dims[i] = gen() % 3 == 0 ? 1 : dims[i];
+        y_dims[i] = gen() % 3 == 0 ? 1 : dims[i];
+      }
+      // drop some leading dims of y.
+      const int y_dim = dim - gen() % dim;
+      const int64_t *y_begin = y_dims + (dim - y_dim);
+      std::vector<float> x = iota(dim, x_dims, 0);
+      std::vector<float> y = iota(y_dim, y_begin, 1000);
+      mluop::BroadcastPlan plan;
+      ASSERT_TRUE(mluop::planBroadcast(dim, x_dims, y_dim, y_begin, &plan));
+      std::vector<float> z = planCompute(plan, x.data(), y.data());
+      std::vector<float> ref(z.size());
+      broadcastReference(dim, x_dims, x.data(), y_dim, y_begin, y.data(),
+                         ref.data(), op);
+      ASSERT_EQ(ref, z) << "iteration " << iter;
+      for (int i = 1; i < plan.dim; ++i) {
+        // coalesced: no two neighbour dims could be merged further.
+        EXPECT_FALSE(plan.x_strides[i - 1] ==
+                         plan.x_strides[i] * plan.dims[i] &&
+                     plan.y_strides[i - 1] == plan.y_strides[i] * plan.dims[i]);
+      }
+    }
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in binary_broadcast";
+  }
+}
+
+TEST(binary_broadcast, chunks) {
+  try {
+    int64_t x_dims[3] = {6, 1, 10};
+    int64_t y_dims[2] = {7, 1};
+    std::vector<float> x = iota(3, x_dims, 0);
+    std::vector<float> y = iota(2, y_dims, 1000);
+    mluop::BroadcastPlan plan;
+    ASSERT_TRUE(mluop::planBroadcast(3, x_dims, 2, y_dims, &plan));
+    std::vector<float> ref(plan.getElementNum());
+    broadcastReference(3, x_dims, x.data(), 2, y_dims, y.data(), ref.data(),
+                       op);
+    // 70 elements per index of dim 0: whole rows, then pieces of one row.
+    for (int64_t max_num : {1000, 150, 70, 69, 10, 3, 1}) {
+      std::vector<float> z;
+      int64_t chunk_count = 0;
+      auto launch = [&](const mluop::BroadcastPlan &chunk, int64_t x_offset,
+                        int64_t y_offset, int64_t z_offset) {
+        EXPECT_LE(chunk.getElementNum(), max_num);
+        EXPECT_EQ((int64_t)z.size(), z_offset);
+        std::vector<float> part =
+            planCompute(chunk, x.data() + x_offset, y.data() + y_offset);
+        z.insert(z.end(), part.begin(), part.end());
+        ++chunk_count;
+        return MLUOP_STATUS_SUCCESS;
+      };
+      EXPECT_EQ(MLUOP_STATUS_SUCCESS,
+                mluop::launchBroadcastInChunks(plan, max_num, launch));
+      EXPECT_EQ(ref, z) << "max_num " << max_num;
+      if (max_num >= 420) {
+        EXPECT_EQ(1, chunk_count);
+      }
+    }
+    // a failed launch stops the remaining chunks.
+    int64_t launch_num = 0;
+    auto fail = [&](const mluop::BroadcastPlan &, int64_t, int64_t, int64_t) {
+      ++launch_num;
+      return MLUOP_STATUS_EXECUTION_FAILED;
+    };
+    EXPECT_EQ(MLUOP_STATUS_EXECUTION_FAILED,
+              mluop::launchBroadcastInChunks(plan, 10, fail));
+    EXPECT_EQ(1, launch_num);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in binary_broadcast";
+  }
+}
+}  // namespace mluopapitest
@@ -0,0 +1,182 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "api_test_tools.h"
+#include "core/logging.h"
+#include "gtest/gtest.h"
+
+namespace mluopapitest {
+class cnlog_async : public testing::Test {
+ protected:
+  void TearDown() override { cnlog::setAsync(false); }
+
+  // returns the ns per LOG(ERROR) call with thread_num threads.
+  static double logCost(int thread_num, int message_num) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_num; ++t) {
+      threads.emplace_back([=]() {
+        for (int i = 0; i < message_num; ++i) {
+          LOG(ERROR) << "[cnlog_async] bench thread " << t << " message " << i;
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    cnlog::flushLog();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           (thread_num * message_num);
+  }
+};
+
+static std::atomic<int> evaluated(0);
+static int countEvaluated() { return ++evaluated; }
+
+TEST_F(cnlog_async, filtered_message_not_formatted) {
+  try {
+    evaluated = 0;
+    cnlog::CLOG(NOT_A_MODULE, ERROR) << countEvaluated();
+    EXPECT_EQ(evaluated, 0);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in cnlog_async";
+  }
+}
+
+TEST_F(cnlog_async, flush_keeps_every_message_in_order) {
+  try {
+    const int thread_num = 8;
+    const int message_num = 3 * LOG_ASYNC_RING_SIZE;
+    testing::internal::CaptureStdout();
+    cnlog::setAsync(true);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_num; ++t) {
+      threads.emplace_back([=]() {
+        for (int i = 0; i < message_num; ++i) {
+          LOG(ERROR) << "[cnlog_async] t" << t << " m" << i << ";";
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    cnlog::flushLog();
+    std::string output = testing::internal::GetCapturedStdout();
+    // error messages are never dropped, and each thread keeps its order.
+    for (int t = 0; t < thread_num; ++t) {
+      size_t pos = 0;
+      for (int i = 0; i < message_num; ++i) {
+        std::string message = "[cnlog_async] t" + std::to_string(t) + " m" +
+                              std::to_string(i) + ";";
+        pos = output.find(message, pos);
+        ASSERT_NE(pos, std::string::npos) << message;
+        pos += message.size();
+      }
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in cnlog_async";
+  }
+}
+
+TEST_F(cnlog_async, exited_thread_messages_kept) {
+  try {
+    // the rings of exited threads are released by the writer while other
+    // threads keep logging, their last messages must still be written.
+    const int round_num = 50;
+    const int thread_num = 8;
+    const int message_num = 16;
+    testing::internal::CaptureStdout();
+    cnlog::setAsync(true);
+    for (int r = 0; r < round_num; ++r) {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < thread_num; ++t) {
+        threads.emplace_back([=]() {
+          for (int i = 0; i < message_num; ++i) {
+            LOG(ERROR) << "[cnlog_async] r" << r << " t" << t << " m" << i
+                       << ";";
+          }
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+    }
+    cnlog::flushLog();
+    std::string output = testing::internal::GetCapturedStdout();
+    for (int r = 0; r < round_num; ++r) {
+      for (int t = 0; t < thread_num; ++t) {
+        for (int i = 0; i < message_num; ++i) {
+          std::string message = "[cnlog_async] r" + std::to_string(r) + " t" +
+                                std::to_string(t) + " m" + std::to_string(i) +
+                                ";";
+          ASSERT_NE(output.find(message), std::string::npos) << message;
+        }
+      }
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in cnlog_async";
+  }
+}
+
+// Per call cost of sync and async logging with 1, 8 and 32 threads, and of a
+// filtered message. It prints numbers only, so it is disabled unless
+// --gtest_also_run_disabled_tests is given.
+TEST_F(cnlog_async, DISABLED_benchmark) {
+  try {
+    const int message_num = 2000;
+    std::vector<int> thread_nums = {1, 8, 32};
+    std::vector<double> sync_cost, async_cost;
+    testing::internal::CaptureStdout();
+    for (int thread_num : thread_nums) {
+      cnlog::setAsync(false);
+      sync_cost.push_back(logCost(thread_num, message_num));
+      cnlog::setAsync(true);
+      async_cost.push_back(logCost(thread_num, message_num));
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < message_num; ++i) {
+      cnlog::CLOG(NOT_A_MODULE, ERROR) << "[cnlog_async] message " << i;
+    }
+    auto end = std::chrono::steady_clock::now();
+    testing::internal::GetCapturedStdout();
+    for (size_t i = 0; i < thread_nums.size(); ++i) {
+      std::cout << "[cnlog_async] " << thread_nums[i]
+                << " threads, sync: " << sync_cost[i]
+                << " ns/call, async: " << async_cost[i] << " ns/call"
+                << std::endl;
+    }
+    std::cout << "[cnlog_async] filtered: "
+              << std::chrono::duration<double, std::nano>(end - start).count() /
+                     message_num
+              << " ns/call" << std::endl;
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in cnlog_async";
+  }
+}
+}  // namespace mluopapitest
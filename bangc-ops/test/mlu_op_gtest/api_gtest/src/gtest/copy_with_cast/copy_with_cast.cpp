@@ -0,0 +1,365 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/context.h"
+#include "core/logging.h"
+#include "core/tensor.h"
+#include "core/tool.h"
+#include "gtest/gtest.h"
+#include "kernels/copy/copy_with_cast_host.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+// castHalfToFloat32 of core/tool saturates inf to 65504, __bang_half2float
+// keeps inf and nan.
+static float halfToFloat(const int16_t value) {
+  if ((value & 0x7c00) != 0x7c00) {
+    return castHalfToFloat32(value);
+  }
+  if ((value & 0x3ff) != 0) {
+    return NAN;
+  }
+  return (value & 0x8000) ? -INFINITY : INFINITY;
+}
+
+static float loadAsFloat(const void *src, const mluOpDataType_t dtype,
+                         const size_t i) {
+  switch (dtype) {
+    case MLUOP_DTYPE_INT8:
+      return ((const int8_t *)src)[i];
+    case MLUOP_DTYPE_INT16:
+      return ((const int16_t *)src)[i];
+    case MLUOP_DTYPE_INT32:
+      return (float)((const int32_t *)src)[i];
+    case MLUOP_DTYPE_HALF:
+      return halfToFloat(((const int16_t *)src)[i]);
+    default:
+      return ((const float *)src)[i];
+  }
+}
+
+// Rounds to the nearest half as __bang_float2half_{rn,up,oz} do, ties go to
+// even, towards +inf or away from zero for MLUOP_ROUND_HALF_TO_EVEN,
+// MLUOP_ROUND_HALF_UP and MLUOP_ROUND_HALF_OFF_ZERO. Unlike castFloat32ToHalf
+// of core/tool, which saturates, results beyond 65504 round to inf, and
+// magnitudes below 2^-25 round to zero; 2^-25 itself is a tie between zero
+// and the smallest subnormal 2^-24.
+static int16_t castFloat32ToHalfRound(const float value,
+                                      const mluOpQuantizeRoundMode_t mode) {
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  const int sign = (bits >> 16) & 0x8000;
+  const float magnitude = std::fabs(value);
+  if (std::isnan(value)) {
+    return (int16_t)(sign | 0x7e00);
+  }
+  if (magnitude == 0.0f) {
+    return (int16_t)sign;
+  }
+  // the ulp of the half holding magnitude is 2^ulp_exp, 2^-24 for subnormals.
+  int exp = 0;
+  std::frexp(magnitude, &exp);
+  const int ulp_exp = std::max(exp - 11, -24);
+  // number of ulps, exact in double.
+  const double ulps = std::ldexp((double)magnitude, -ulp_exp);
+  double result = std::floor(ulps);
+  const double rest = ulps - result;
+  if (rest > 0.5) {
+    result += 1;
+  } else if (rest == 0.5) {
+    if ((mode == MLUOP_ROUND_HALF_TO_EVEN && std::fmod(result, 2) != 0) ||
+        (mode == MLUOP_ROUND_HALF_UP && sign == 0) ||
+        mode == MLUOP_ROUND_HALF_OFF_ZERO) {
+      result += 1;
+    }
+  }
+  if (result == 0) {
+    return (int16_t)sign;
+  }
+  // half bits grow linearly with the ulps over subnormals and normals, a
+  // carry out of the mantissa goes to the exponent. Beyond the largest
+  // exponent it is inf.
+  const double half_bits =
+      std::ldexp(1.0, 10) * (ulp_exp + 25) + result - std::ldexp(1.0, 10);
+  if (half_bits >= 0x7c00) {
+    return (int16_t)(sign | 0x7c00);
+  }
+  return (int16_t)(sign | (int)half_bits);
+}
+
+static double roundInteger(const float value,
+                           const mluOpQuantizeRoundMode_t mode) {
+  if (std::isnan(value)) {
+    return 0;
+  }
+  switch (mode) {
+    case MLUOP_ROUND_HALF_UP:
+      return std::floor((double)value + 0.5);
+    case MLUOP_ROUND_HALF_OFF_ZERO:
+      return std::round((double)value);
+    default:
+      return std::nearbyint((double)value);
+  }
+}
+
+template <typename T>
+static T saturate(const double value, const double low, const double high) {
+  return (T)(value < low ? low : (value > high ? high : value));
+}
+
+static void storeFromFloat(void *dst, const mluOpDataType_t dtype,
+                           const size_t i, const float value,
+                           const mluOpQuantizeRoundMode_t mode) {
+  switch (dtype) {
+    case MLUOP_DTYPE_INT8:
+      ((int8_t *)dst)[i] =
+          saturate<int8_t>(roundInteger(value, mode), INT8_MIN, INT8_MAX);
+      break;
+    case MLUOP_DTYPE_INT16:
+      ((int16_t *)dst)[i] =
+          saturate<int16_t>(roundInteger(value, mode), INT16_MIN, INT16_MAX);
+      break;
+    case MLUOP_DTYPE_INT32:
+      ((int32_t *)dst)[i] =
+          saturate<int32_t>(roundInteger(value, mode), INT32_MIN, INT32_MAX);
+      break;
+    case MLUOP_DTYPE_HALF:
+      ((int16_t *)dst)[i] = castFloat32ToHalfRound(value, mode);
+      break;
+    default:
+      ((float *)dst)[i] = value;
+      break;
+  }
+}
+
+// reference conversion of num contiguous host elements of a supported pair,
+// values go through float32 as on MLU. half and integer outputs are rounded
+// by round_mode, half overflows to inf and integers saturate.
+static void copyWithCastReference(const void *src,
+                                  const mluOpDataType_t src_dtype, void *dst,
+                                  const mluOpDataType_t dst_dtype,
+                                  const size_t num,
+                                  const mluOpQuantizeRoundMode_t round_mode) {
+  for (size_t i = 0; i < num; ++i) {
+    storeFromFloat(dst, dst_dtype, i, loadAsFloat(src, src_dtype, i),
+                   round_mode);
+  }
+}
+
+class copy_with_cast : public testing::Test {
+ public:
+  void SetUp() {
+    MLUOP_CHECK(mluOpSetVirtualDevice("MLU370"));
+    MLUOP_CHECK(mluOpCreate(&handle_));
+    MLUOP_CHECK(mluOpSetQuantizeRoundMode(handle_, MLUOP_ROUND_HALF_TO_EVEN));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&input_desc_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&output_desc_));
+  }
+
+  void TearDown() {
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(input_desc_));
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(output_desc_));
+    MLUOP_CHECK(mluOpDestroy(handle_));
+    MLUOP_CHECK(mluOpSetVirtualDevice(NULL));
+  }
+
+ protected:
+  void setDesc(mluOpTensorDescriptor_t desc, mluOpDataType_t dtype,
+               std::vector<int> dims) {
+    MLUOP_CHECK(mluOpSetTensorDescriptor(desc, MLUOP_LAYOUT_ARRAY, dtype,
+                                         dims.size(), dims.data()));
+  }
+
+  // the half result of casting the float `value` with `mode`.
+  static int16_t toHalf(float value, mluOpQuantizeRoundMode_t mode) {
+    int16_t result = 0;
+    copyWithCastReference(&value, MLUOP_DTYPE_FLOAT, &result,
+                          MLUOP_DTYPE_HALF, 1, mode);
+    return result;
+  }
+
+  template <typename T>
+  static T toInteger(float value, mluOpDataType_t dtype,
+                     mluOpQuantizeRoundMode_t mode) {
+    T result = 0;
+    copyWithCastReference(&value, MLUOP_DTYPE_FLOAT, &result, dtype, 1, mode);
+    return result;
+  }
+
+  mluOpHandle_t handle_ = NULL;
+  mluOpTensorDescriptor_t input_desc_ = NULL;
+  mluOpTensorDescriptor_t output_desc_ = NULL;
+};
+
+TEST_F(copy_with_cast, table) {
+  try {
+    EXPECT_TRUE(copyWithCastIsSupported(MLUOP_DTYPE_FLOAT, MLUOP_DTYPE_HALF));
+    EXPECT_TRUE(copyWithCastIsSupported(MLUOP_DTYPE_INT32, MLUOP_DTYPE_FLOAT));
+    EXPECT_TRUE(copyWithCastIsSupported(MLUOP_DTYPE_INT8, MLUOP_DTYPE_INT16));
+    EXPECT_FALSE(copyWithCastIsSupported(MLUOP_DTYPE_DOUBLE, MLUOP_DTYPE_HALF));
+    EXPECT_FALSE(copyWithCastIsSupported(MLUOP_DTYPE_FLOAT, MLUOP_DTYPE_BOOL));
+
+    EXPECT_TRUE(copyWithCastIsExact(MLUOP_DTYPE_HALF, MLUOP_DTYPE_FLOAT));
+    EXPECT_TRUE(copyWithCastIsExact(MLUOP_DTYPE_INT8, MLUOP_DTYPE_HALF));
+    EXPECT_TRUE(copyWithCastIsExact(MLUOP_DTYPE_INT16, MLUOP_DTYPE_FLOAT));
+    EXPECT_FALSE(copyWithCastIsExact(MLUOP_DTYPE_INT16, MLUOP_DTYPE_HALF));
+    EXPECT_FALSE(copyWithCastIsExact(MLUOP_DTYPE_INT32, MLUOP_DTYPE_FLOAT));
+    EXPECT_FALSE(copyWithCastIsExact(MLUOP_DTYPE_FLOAT, MLUOP_DTYPE_HALF));
+    EXPECT_FALSE(copyWithCastIsExact(MLUOP_DTYPE_HALF, MLUOP_DTYPE_INT32));
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in copy_with_cast";
+  }
+}
+
+TEST_F(copy_with_cast, reference_half) {
+  try {
+    // 1 + 2^-11 is a tie between 1.0 (0x3c00) and 1 + 2^-10 (0x3c01).
+    const float tie = 1.0f + 1.0f / 2048;
+    EXPECT_EQ(0x3c00, toHalf(tie, MLUOP_ROUND_HALF_TO_EVEN));
+    EXPECT_EQ(0x3c01, toHalf(tie, MLUOP_ROUND_HALF_UP));
+    EXPECT_EQ(0x3c01, toHalf(tie, MLUOP_ROUND_HALF_OFF_ZERO));
+    EXPECT_EQ((int16_t)0xbc00, toHalf(-tie, MLUOP_ROUND_HALF_TO_EVEN));
+    EXPECT_EQ((int16_t)0xbc00, toHalf(-tie, MLUOP_ROUND_HALF_UP));
+    EXPECT_EQ((int16_t)0xbc01, toHalf(-tie, MLUOP_ROUND_HALF_OFF_ZERO));
+    // odd ties round up to even for every mode.
+    const float odd_tie = 1.0f + 3.0f / 2048;
+    EXPECT_EQ(0x3c02, toHalf(odd_tie, MLUOP_ROUND_HALF_TO_EVEN));
+    EXPECT_EQ(0x3c02, toHalf(odd_tie, MLUOP_ROUND_HALF_UP));
+    // not a tie.
+    EXPECT_EQ(0x3c01, toHalf(1.0f + 1.0f / 1500, MLUOP_ROUND_HALF_TO_EVEN));
+
+    // 65520 is a tie between 65504 and inf, anything beyond is inf.
+    EXPECT_EQ(0x7c00, toHalf(65520.0f, MLUOP_ROUND_HALF_TO_EVEN));
+    EXPECT_EQ((int16_t)0xfbff, toHalf(-65520.0f, MLUOP_ROUND_HALF_UP));
+    EXPECT_EQ((int16_t)0xfc00, toHalf(-65520.0f, MLUOP_ROUND_HALF_OFF_ZERO));
+    EXPECT_EQ(0x7bff, toHalf(65519.0f, MLUOP_ROUND_HALF_OFF_ZERO));
+    EXPECT_EQ(0x7c00, toHalf(INFINITY, MLUOP_ROUND_HALF_TO_EVEN));
+    EXPECT_EQ(0x7e00, toHalf(NAN, MLUOP_ROUND_HALF_TO_EVEN) & 0x7e00);
+    // 2^-25 is a tie between 0 and the smallest subnormal, below it is 0.
+    const float min_tie = std::ldexp(1.0f, -25);
+    EXPECT_EQ(0x0000, toHalf(min_tie, MLUOP_ROUND_HALF_TO_EVEN));
+    EXPECT_EQ(0x0001, toHalf(min_tie, MLUOP_ROUND_HALF_UP));
+    EXPECT_EQ((int16_t)0x8000, toHalf(-min_tie, MLUOP_ROUND_HALF_UP));
+    EXPECT_EQ((int16_t)0x8001, toHalf(-min_tie, MLUOP_ROUND_HALF_OFF_ZERO));
+    EXPECT_EQ(0x0000, toHalf(min_tie * 0.75f, MLUOP_ROUND_HALF_OFF_ZERO));
+    EXPECT_EQ(0x0001, toHalf(min_tie * 1.5f, MLUOP_ROUND_HALF_TO_EVEN));
+
+    // half to float and back is exact.
+    const std::vector<int16_t> halves = {0x0000, 0x0001, 0x3c00,
+                                         0x3555, (int16_t)0xc900, 0x7bff,
+                                         0x7c00, (int16_t)0xfc00};
+    std::vector<float> floats(halves.size());
+    std::vector<int16_t> back(halves.size());
+    copyWithCastReference(halves.data(), MLUOP_DTYPE_HALF, floats.data(),
+                          MLUOP_DTYPE_FLOAT, halves.size(),
+                          MLUOP_ROUND_HALF_TO_EVEN);
+    EXPECT_FLOAT_EQ(1.0f, floats[2]);
+    EXPECT_FLOAT_EQ(-10.0f, floats[4]);
+    EXPECT_FLOAT_EQ(65504.0f, floats[5]);
+    EXPECT_EQ(INFINITY, floats[6]);
+    EXPECT_EQ(-INFINITY, floats[7]);
+    copyWithCastReference(floats.data(), MLUOP_DTYPE_FLOAT, back.data(),
+                          MLUOP_DTYPE_HALF, floats.size(),
+                          MLUOP_ROUND_HALF_TO_EVEN);
+    EXPECT_EQ(halves, back);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in copy_with_cast";
+  }
+}
+
+TEST_F(copy_with_cast, reference_integer) {
+  try {
+    const mluOpQuantizeRoundMode_t even = MLUOP_ROUND_HALF_TO_EVEN;
+    const mluOpQuantizeRoundMode_t up = MLUOP_ROUND_HALF_UP;
+    const mluOpQuantizeRoundMode_t off = MLUOP_ROUND_HALF_OFF_ZERO;
+    EXPECT_EQ(2, toInteger<int32_t>(2.5f, MLUOP_DTYPE_INT32, even));
+    EXPECT_EQ(3, toInteger<int32_t>(2.5f, MLUOP_DTYPE_INT32, up));
+    EXPECT_EQ(3, toInteger<int32_t>(2.5f, MLUOP_DTYPE_INT32, off));
+    EXPECT_EQ(-2, toInteger<int32_t>(-2.5f, MLUOP_DTYPE_INT32, even));
+    EXPECT_EQ(-2, toInteger<int32_t>(-2.5f, MLUOP_DTYPE_INT32, up));
+    EXPECT_EQ(-3, toInteger<int32_t>(-2.5f, MLUOP_DTYPE_INT32, off));
+    EXPECT_EQ(-1, toInteger<int16_t>(-1.4f, MLUOP_DTYPE_INT16, off));
+    // saturation.
+    EXPECT_EQ(127, toInteger<int8_t>(300.0f, MLUOP_DTYPE_INT8, even));
+    EXPECT_EQ(-128, toInteger<int8_t>(-300.0f, MLUOP_DTYPE_INT8, even));
+    EXPECT_EQ(INT16_MAX, toInteger<int16_t>(1e6f, MLUOP_DTYPE_INT16, up));
+    EXPECT_EQ(INT32_MIN, toInteger<int32_t>(-1e10f, MLUOP_DTYPE_INT32, off));
+
+    // integers go through float.
+    const std::vector<int32_t> ints = {-7, 0, 16777217, 100000};
+    std::vector<float> floats(ints.size());
+    copyWithCastReference(ints.data(), MLUOP_DTYPE_INT32, floats.data(),
+                          MLUOP_DTYPE_FLOAT, ints.size(), even);
+    EXPECT_EQ(-7.0f, floats[0]);
+    EXPECT_EQ(16777216.0f, floats[2]);
+    std::vector<int16_t> halves(ints.size());
+    copyWithCastReference(ints.data(), MLUOP_DTYPE_INT32, halves.data(),
+                          MLUOP_DTYPE_HALF, ints.size(), even);
+    EXPECT_EQ((int16_t)0xc700, halves[0]);
+    EXPECT_EQ(0x7c00, halves[3]);  // beyond 65504 rounds to inf.
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in copy_with_cast";
+  }
+}
+
+TEST_F(copy_with_cast, param_check) {
+  try {
+    setDesc(input_desc_, MLUOP_DTYPE_DOUBLE, {2, 3});
+    setDesc(output_desc_, MLUOP_DTYPE_HALF, {2, 3});
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM,
+              mluOpCopyWithCast(handle_, input_desc_, NULL, output_desc_,
+                                NULL));
+    setDesc(input_desc_, MLUOP_DTYPE_FLOAT, {2, 3});
+    setDesc(output_desc_, MLUOP_DTYPE_HALF, {3, 3});
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM,
+              mluOpCopyWithCast(handle_, input_desc_, NULL, output_desc_,
+                                NULL));
+    // reshaping copies only need the same element number, then the NULL
+    // pointers are caught.
+    setDesc(output_desc_, MLUOP_DTYPE_HALF, {6});
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM,
+              mluOpCopyWithCast(handle_, input_desc_, NULL, output_desc_,
+                                NULL));
+    setDesc(input_desc_, MLUOP_DTYPE_FLOAT, {2, 0});
+    setDesc(output_desc_, MLUOP_DTYPE_HALF, {0});
+    EXPECT_EQ(MLUOP_STATUS_SUCCESS,
+              mluOpCopyWithCast(handle_, input_desc_, NULL, output_desc_,
+                                NULL));
+    mluOpHandle_t mlu270_handle = NULL;
+    MLUOP_CHECK(mluOpSetVirtualDevice("MLU270"));
+    MLUOP_CHECK(mluOpCreate(&mlu270_handle));
+    EXPECT_EQ(MLUOP_STATUS_ARCH_MISMATCH,
+              mluOpCopyWithCast(mlu270_handle, input_desc_, NULL, output_desc_,
+                                NULL));
+    MLUOP_CHECK(mluOpDestroy(mlu270_handle));
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in copy_with_cast";
+  }
+}
+}  // namespace mluopapitest
@@ -0,0 +1,178 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <iostream>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/context.h"
+#include "core/logging.h"
+#include "core/runtime/chunked_launch.h"
+#include "core/runtime/cost_model.h"
+#include "core/tensor.h"
+#include "gtest/gtest.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+namespace {
+// ops and bytes of a fake op, set by the test before the query.
+mluop::runtime::OpCost fake_cost;
+
+mluOpStatus_t costFake(mluOpHandle_t handle,
+                       const mluOpTensorDescriptor_t *descs, int desc_num,
+                       mluop::runtime::OpCost *cost) {
+  *cost = fake_cost;
+  return MLUOP_STATUS_SUCCESS;
+}
+MLUOP_REGISTER_OP_COST("cost_model_fake", 2, costFake);
+}  // namespace
+
+class cost_model : public testing::Test {
+ public:
+  void SetUp() {
+    MLUOP_CHECK(mluOpSetVirtualDevice("MLU370"));
+    MLUOP_CHECK(mluOpCreate(&handle_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&x_desc_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&y_desc_));
+    std::vector<int> dims = {2, 3, 4, 5};
+    MLUOP_CHECK(mluOpSetTensorDescriptor(x_desc_, MLUOP_LAYOUT_ARRAY,
+                                         MLUOP_DTYPE_FLOAT, 4, dims.data()));
+    MLUOP_CHECK(mluOpSetTensorDescriptor(y_desc_, MLUOP_LAYOUT_ARRAY,
+                                         MLUOP_DTYPE_FLOAT, 4, dims.data()));
+    fake_cost = mluop::runtime::OpCost();
+  }
+
+  void TearDown() {
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(x_desc_));
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(y_desc_));
+    MLUOP_CHECK(mluOpDestroy(handle_));
+    MLUOP_CHECK(mluOpSetVirtualDevice(NULL));
+  }
+
+ protected:
+  mluOpHandle_t handle_ = NULL;
+  mluOpTensorDescriptor_t x_desc_ = NULL;
+  mluOpTensorDescriptor_t y_desc_ = NULL;
+};
+
+TEST_F(cost_model, unknown_op) {
+  try {
+    mluOpTensorDescriptor_t descs[2] = {x_desc_, y_desc_};
+    mluOpOpCost_t cost;
+    EXPECT_EQ(MLUOP_STATUS_NOT_SUPPORTED,
+              mluOpGetOpCostModel(handle_, "no_such_op", 2, descs, &cost));
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in cost_model";
+  }
+}
+
+TEST_F(cost_model, desc_num_mismatch) {
+  try {
+    mluOpTensorDescriptor_t descs[3] = {x_desc_, y_desc_, y_desc_};
+    mluOpOpCost_t cost;
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM,
+              mluOpGetOpCostModel(handle_, "cost_model_fake", 3, descs, &cost));
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM,
+              mluOpGetOpCostModel(handle_, "cost_model_fake", 2, descs, NULL));
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in cost_model";
+  }
+}
+
+TEST_F(cost_model, roofline) {
+  try {
+    mluOpTensorDescriptor_t descs[2] = {x_desc_, y_desc_};
+    mluOpOpCost_t cost;
+    // all 32 cores, 1ms of IO at 307.2 GB/s and little compute.
+    fake_cost.k_dim = {4, 8, 1};
+    fake_cost.k_type = CNRT_FUNC_TYPE_UNION1;
+    fake_cost.theory_ops = 1024;
+    fake_cost.theory_io_bytes = 307200000;
+    MLUOP_CHECK(
+        mluOpGetOpCostModel(handle_, "cost_model_fake", 2, descs, &cost));
+    EXPECT_EQ(307200000, cost.theory_io_bytes);
+    EXPECT_EQ(CNRT_FUNC_TYPE_UNION1, cost.k_type);
+    EXPECT_NEAR(1000 + 5, cost.latency_us, 1e-6);
+
+    // 1ms of float compute at 32 ops per cycle on 32 cores, IO is cheap.
+    fake_cost.theory_ops = 1024000000;
+    fake_cost.theory_io_bytes = 1024;
+    MLUOP_CHECK(
+        mluOpGetOpCostModel(handle_, "cost_model_fake", 2, descs, &cost));
+    EXPECT_NEAR(1000 + 5, cost.latency_us, 1e-6);
+
+    // half as much for half, twice as much on half of the cores.
+    fake_cost.compute_dtype = MLUOP_DTYPE_HALF;
+    MLUOP_CHECK(
+        mluOpGetOpCostModel(handle_, "cost_model_fake", 2, descs, &cost));
+    EXPECT_NEAR(500 + 5, cost.latency_us, 1e-6);
+    fake_cost.compute_dtype = MLUOP_DTYPE_FLOAT;
+    fake_cost.k_dim = {4, 4, 1};
+    fake_cost.kernel_num = 2;
+    MLUOP_CHECK(
+        mluOpGetOpCostModel(handle_, "cost_model_fake", 2, descs, &cost));
+    EXPECT_NEAR(2000 + 2 * 5, cost.latency_us, 1e-6);
+    EXPECT_EQ(2, cost.kernel_num);
+
+    // an arch without a device profile has no latency.
+    handle_->arch = MLUOP_UNKNOWN_DEVICE;
+    MLUOP_CHECK(
+        mluOpGetOpCostModel(handle_, "cost_model_fake", 2, descs, &cost));
+    EXPECT_EQ(-1, cost.latency_us);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in cost_model";
+  }
+}
+
+TEST_F(cost_model, elementwise) {
+  try {
+    mluOpTensorDescriptor_t descs[2] = {x_desc_, y_desc_};
+    mluop::runtime::OpCost cost;
+    mluop::runtime::setElementwiseCost(descs, 2, 120, 3, &cost);
+    EXPECT_EQ(360, cost.theory_ops);
+    EXPECT_EQ(2 * 120 * 4, cost.theory_io_bytes);
+    EXPECT_EQ(1, cost.kernel_num);
+    EXPECT_EQ(MLUOP_DTYPE_FLOAT, cost.compute_dtype);
+
+    const int64_t max_num = LAUNCH_CHUNK_MAX_NUM;
+    EXPECT_EQ(0, mluop::runtime::getChunkCount(0, max_num));
+    EXPECT_EQ(1, mluop::runtime::getChunkCount(max_num, max_num));
+    EXPECT_EQ(2, mluop::runtime::getChunkCount(max_num + 1, max_num));
+    EXPECT_EQ(3, mluop::runtime::getChunkCount(3 * max_num, max_num));
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in cost_model";
+  }
+}
+
+TEST_F(cost_model, abs) {
+  try {
+    mluOpTensorDescriptor_t descs[2] = {x_desc_, y_desc_};
+    mluOpOpCost_t cost;
+    MLUOP_CHECK(mluOpGetOpCostModel(handle_, "abs", 2, descs, &cost));
+    EXPECT_EQ(120, cost.theory_ops);
+    EXPECT_EQ(2 * 120 * 4, cost.theory_io_bytes);
+    EXPECT_EQ(1, cost.kernel_num);
+    EXPECT_GT(cost.latency_us, 0);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in cost_model";
+  }
+}
+}  // namespace mluopapitest
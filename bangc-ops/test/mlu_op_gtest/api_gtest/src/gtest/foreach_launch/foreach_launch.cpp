@@ -0,0 +1,130 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <iostream>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/runtime/foreach_launch.h"
+#include "gtest/gtest.h"
+#include "mlu_op.h"
+#include "mlu_op_kernel.h"
+
+namespace mluopapitest {
+namespace {
+// checks that `launches` cover every element of `element_nums` once, in
+// order, within the launch limits.
+void checkCoverage(const std::vector<int64_t> &element_nums,
+                   const std::vector<mluop::runtime::ForeachLaunch> &launches,
+                   int64_t max_launch_num, int max_segment_num) {
+  int tensor_index = 0;
+  int64_t offset = 0;
+  for (const auto &launch : launches) {
+    EXPECT_GT(launch.num, 0);
+    EXPECT_LE(launch.num, max_launch_num);
+    EXPECT_LE((int)launch.segments.size(), max_segment_num);
+    int64_t num = 0;
+    for (const auto &segment : launch.segments) {
+      while (element_nums[tensor_index] == offset) {
+        tensor_index++;
+        offset = 0;
+      }
+      EXPECT_EQ(tensor_index, segment.tensor_index);
+      EXPECT_EQ(offset, segment.offset);
+      EXPECT_GT(segment.num, 0);
+      offset += segment.num;
+      num += segment.num;
+    }
+    EXPECT_EQ(num, launch.num);
+  }
+  while (tensor_index < (int)element_nums.size() &&
+         element_nums[tensor_index] == offset) {
+    tensor_index++;
+    offset = 0;
+  }
+  EXPECT_EQ((int)element_nums.size(), tensor_index);
+}
+}  // namespace
+
+TEST(foreach_launch, small_tensors_share_a_launch) {
+  try {
+    std::vector<int64_t> element_nums(20, 100);
+    auto launches = mluop::runtime::planForeachLaunches(
+        element_nums, 1 << 20, MLUOP_FOREACH_MAX_SEGMENT_NUM);
+    ASSERT_EQ(1, launches.size());
+    EXPECT_EQ(2000, launches[0].num);
+    EXPECT_EQ(20, launches[0].segments.size());
+    checkCoverage(element_nums, launches, 1 << 20,
+                  MLUOP_FOREACH_MAX_SEGMENT_NUM);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in foreach_launch";
+  }
+}
+
+TEST(foreach_launch, segment_limit) {
+  try {
+    std::vector<int64_t> element_nums(70, 8);
+    auto launches =
+        mluop::runtime::planForeachLaunches(element_nums, 1 << 20, 32);
+    ASSERT_EQ(3, launches.size());
+    EXPECT_EQ(32, launches[0].segments.size());
+    EXPECT_EQ(32, launches[1].segments.size());
+    EXPECT_EQ(6, launches[2].segments.size());
+    checkCoverage(element_nums, launches, 1 << 20, 32);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in foreach_launch";
+  }
+}
+
+TEST(foreach_launch, tensors_span_launches) {
+  try {
+    // the second tensor fills the rest of the first launch, all of the second
+    // and starts the third one.
+    std::vector<int64_t> element_nums = {600, 2000, 0, 300};
+    auto launches = mluop::runtime::planForeachLaunches(element_nums, 1000, 32);
+    ASSERT_EQ(3, launches.size());
+    ASSERT_EQ(2, launches[0].segments.size());
+    EXPECT_EQ(1, launches[0].segments[1].tensor_index);
+    EXPECT_EQ(0, launches[0].segments[1].offset);
+    EXPECT_EQ(400, launches[0].segments[1].num);
+    ASSERT_EQ(1, launches[1].segments.size());
+    EXPECT_EQ(400, launches[1].segments[0].offset);
+    EXPECT_EQ(1000, launches[1].num);
+    ASSERT_EQ(2, launches[2].segments.size());
+    EXPECT_EQ(3, launches[2].segments[1].tensor_index);
+    EXPECT_EQ(900, launches[2].num);
+    checkCoverage(element_nums, launches, 1000, 32);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in foreach_launch";
+  }
+}
+
+TEST(foreach_launch, empty_list) {
+  try {
+    std::vector<int64_t> element_nums = {0, 0};
+    EXPECT_TRUE(
+        mluop::runtime::planForeachLaunches(element_nums, 1000, 32).empty());
+    EXPECT_TRUE(mluop::runtime::planForeachLaunches({}, 1000, 32).empty());
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in foreach_launch";
+  }
+}
+}  // namespace mluopapitest
@@ -0,0 +1,143 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/logging.h"
+#include "gtest/gtest.h"
+#include "kernels/fused_unary/fused_unary_host.h"
+#include "mlu_op.h"
+#include "mlu_op_kernel.h"
+
+namespace mluopapitest {
+// reference interpreter of a checked program on host float data, y[i] is the
+// result of the steps on x[i], x and y may be the same array.
+static void fusedUnaryReference(const int step_num,
+                                const mluOpFusedUnaryStep_t steps[],
+                                const float *x, float *y, const size_t num) {
+  for (size_t n = 0; n < num; ++n) {
+    float value = x[n];
+    for (int i = 0; i < step_num; ++i) {
+      const float scalar = steps[i].scalar;
+      switch (steps[i].type) {
+        case MLUOP_FUSED_UNARY_ABS:
+          value = std::fabs(value);
+          break;
+        case MLUOP_FUSED_UNARY_LOG:
+          value = std::log(value) * scalar;
+          break;
+        case MLUOP_FUSED_UNARY_SQRT:
+          value = std::sqrt(value);
+          break;
+        case MLUOP_FUSED_UNARY_MUL_SCALAR:
+          value = value * scalar;
+          break;
+        case MLUOP_FUSED_UNARY_ADD_SCALAR:
+          value = value + scalar;
+          break;
+        case MLUOP_FUSED_UNARY_DIV_SCALAR:
+          value = value / scalar;
+          break;
+        default:
+          break;
+      }
+    }
+    y[n] = value;
+  }
+}
+
+TEST(fused_unary, program_check) {
+  try {
+    mluOpFusedUnaryStep_t steps[MLUOP_FUSED_UNARY_MAX_STEP_NUM + 1];
+    for (auto &step : steps) {
+      step = {MLUOP_FUSED_UNARY_ABS, 0};
+    }
+    EXPECT_EQ(MLUOP_STATUS_SUCCESS, fusedUnaryProgramCheck("[test]", 1, steps));
+    EXPECT_EQ(MLUOP_STATUS_SUCCESS,
+              fusedUnaryProgramCheck("[test]", MLUOP_FUSED_UNARY_MAX_STEP_NUM,
+                                     steps));
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM,
+              fusedUnaryProgramCheck("[test]", 0, steps));
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM,
+              fusedUnaryProgramCheck(
+                  "[test]", MLUOP_FUSED_UNARY_MAX_STEP_NUM + 1, steps));
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM,
+              fusedUnaryProgramCheck("[test]", 1, NULL));
+    steps[1] = {MLUOP_FUSED_UNARY_DIV_SCALAR, 0};
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM,
+              fusedUnaryProgramCheck("[test]", 2, steps));
+    steps[1] = {(mluOpFusedUnaryStepType_t)100, 1};
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM,
+              fusedUnaryProgramCheck("[test]", 2, steps));
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in fused_unary";
+  }
+}
+
+TEST(fused_unary, lower_program) {
+  try {
+    mluOpFusedUnaryStep_t steps[3] = {{MLUOP_FUSED_UNARY_SQRT, 0},
+                                      {MLUOP_FUSED_UNARY_DIV_SCALAR, 4},
+                                      {MLUOP_FUSED_UNARY_LOG, 0.5}};
+    mluOpFusedUnaryProgram_t program;
+    fusedUnaryLowerProgram(3, steps, &program);
+    EXPECT_EQ(3, program.step_num);
+    EXPECT_EQ(MLUOP_FUSED_UNARY_SQRT, program.type[0]);
+    EXPECT_EQ(MLUOP_FUSED_UNARY_MUL_SCALAR, program.type[1]);
+    EXPECT_FLOAT_EQ(0.25, program.scalar[1]);
+    EXPECT_EQ(MLUOP_FUSED_UNARY_LOG, program.type[2]);
+    EXPECT_FLOAT_EQ(0.5, program.scalar[2]);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in fused_unary";
+  }
+}
+
+TEST(fused_unary, reference) {
+  try {
+    std::vector<float> x = {-4, -1, 0.5, 2, 100};
+    std::vector<float> y(x.size());
+    // log2(|x|) * 2
+    mluOpFusedUnaryStep_t abs_log[3] = {
+        {MLUOP_FUSED_UNARY_ABS, 0},
+        {MLUOP_FUSED_UNARY_LOG, (float)log2(exp(1))},
+        {MLUOP_FUSED_UNARY_MUL_SCALAR, 2}};
+    fusedUnaryReference(3, abs_log, x.data(), y.data(), x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+      EXPECT_NEAR(std::log2(std::fabs(x[i])) * 2, y[i], 1e-5);
+    }
+    // sqrt(|x|) / 4 - 1, in place.
+    mluOpFusedUnaryStep_t sqrt_div[4] = {{MLUOP_FUSED_UNARY_ABS, 0},
+                                         {MLUOP_FUSED_UNARY_SQRT, 0},
+                                         {MLUOP_FUSED_UNARY_DIV_SCALAR, 4},
+                                         {MLUOP_FUSED_UNARY_ADD_SCALAR, -1}};
+    std::vector<float> z = x;
+    fusedUnaryReference(4, sqrt_div, z.data(), z.data(), z.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+      EXPECT_NEAR(std::sqrt(std::fabs(x[i])) / 4 - 1, z[i], 1e-6);
+    }
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in fused_unary";
+  }
+}
+}  // namespace mluopapitest
@@ -0,0 +1,213 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "api_test_tools.h"
+#include "core/gen_case.h"
+#include "gtest/gtest.h"
+
+namespace mluopapitest {
+// an api which records itself like the ops do, and calls itself as an
+// internal api if call_internal is set.
+static void genCaseApi(const float *input, float *output,
+                       mluOpTensorDescriptor_t desc, bool dump_input,
+                       bool call_internal) {
+  if (MLUOP_GEN_CASE_ON_NEW) {
+    GEN_CASE_START("gen_case_api");
+    if (dump_input) {
+      GEN_CASE_DATA_REAL(true, "input1", input, desc);
+    } else {
+      GEN_CASE_DATA(true, "input1", input, desc, 10, 0);
+    }
+    GEN_CASE_DATA(false, "output1", output, desc, 0, 0);
+    GEN_CASE_OP_PARAM_SINGLE(0, "gen_case_api", "alpha", 1.5);
+    GEN_CASE_TEST_PARAM_NEW(true, true, false, 3e-3, 3e-3, 0);
+  }
+  if (call_internal) {
+    genCaseApi(input, output, desc, dump_input, false);
+  }
+  GEN_CASE_END();
+}
+
+class gen_case : public testing::Test {
+ public:
+  void SetUp() {
+    char dir_template[] = "/tmp/mluop_gen_case_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    dir_ = dir_template;
+    char cwd[PATH_MAX];
+    ASSERT_NE(getcwd(cwd, sizeof(cwd)), nullptr);
+    cwd_ = cwd;
+    ASSERT_EQ(chdir(dir_.c_str()), 0);
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&desc_));
+    std::vector<int> dims = {4, 256};
+    MLUOP_CHECK(mluOpSetTensorDescriptor(desc_, MLUOP_LAYOUT_ARRAY,
+                                         MLUOP_DTYPE_FLOAT, 2, dims.data()));
+    input_.assign(1024, 0.25f);
+    output_.assign(1024, 0.0f);
+  }
+
+  void TearDown() {
+    mluop::gen_case::genCaseAsyncSet(true);
+    mluop::gen_case::genCaseModeSet(0);
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(desc_));
+    EXPECT_EQ(chdir(cwd_.c_str()), 0);
+    EXPECT_EQ(system(("rm -rf " + dir_).c_str()), 0);
+  }
+
+ protected:
+  // all prototxt written into the case folder of genCaseApi.
+  std::string readCases() {
+    std::string folder = dir_ + "/gen_case/gen_case_api";
+    std::string content;
+    DIR *dir = opendir(folder.c_str());
+    if (dir == nullptr) {
+      return content;
+    }
+    while (struct dirent *entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      if (name.find(".prototxt") == std::string::npos) {
+        continue;
+      }
+      std::ifstream file(folder + "/" + name);
+      std::stringstream ss;
+      ss << file.rdbuf();
+      content += ss.str() + "\n";
+    }
+    closedir(dir);
+    return content;
+  }
+
+  static size_t countOf(const std::string &text, const std::string &pattern) {
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos;
+         pos = text.find(pattern, pos + pattern.size())) {
+      ++count;
+    }
+    return count;
+  }
+
+  // the ns spent by the caller per api call, calls are made in bursts and
+  // the cases are flushed between bursts.
+  double callCost(int mode, bool async, bool dump_input, int burst_num,
+                  int burst_size) {
+    mluop::gen_case::genCaseAsyncSet(async);
+    mluop::gen_case::genCaseModeSet(mode);
+    double total = 0;
+    for (int b = 0; b < burst_num; ++b) {
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < burst_size; ++i) {
+        genCaseApi(input_.data(), output_.data(), desc_, dump_input, false);
+      }
+      auto end = std::chrono::steady_clock::now();
+      total += std::chrono::duration<double, std::nano>(end - start).count();
+      mluop::gen_case::genCaseFlush();
+    }
+    mluop::gen_case::genCaseModeSet(0);
+    return total / (burst_num * burst_size);
+  }
+
+  std::string dir_;
+  std::string cwd_;
+  mluOpTensorDescriptor_t desc_ = nullptr;
+  std::vector<float> input_;
+  std::vector<float> output_;
+};
+
+TEST_F(gen_case, internal_api_not_dumped) {
+  try {
+    for (bool async : {false, true}) {
+      mluop::gen_case::genCaseAsyncSet(async);
+      mluop::gen_case::genCaseModeSet(1);
+      genCaseApi(input_.data(), output_.data(), desc_, false, true);
+      mluop::gen_case::genCaseFlush();
+      mluop::gen_case::genCaseModeSet(0);
+    }
+    std::string cases = readCases();
+    EXPECT_EQ(countOf(cases, "op_name: \"gen_case_api\""), 2);
+    EXPECT_EQ(countOf(cases, "alpha: 1.500000"), 2);
+    EXPECT_EQ(countOf(cases, "baseline_device: CPU"), 2);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in gen_case";
+  }
+}
+
+TEST_F(gen_case, async_dump_from_threads) {
+  try {
+    const int thread_num = 4;
+    const int call_num = 50;
+    mluop::gen_case::genCaseAsyncSet(true);
+    mluop::gen_case::genCaseModeSet(2);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_num; ++t) {
+      threads.emplace_back([&]() {
+        for (int i = 0; i < call_num; ++i) {
+          genCaseApi(input_.data(), output_.data(), desc_, true, true);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    mluop::gen_case::genCaseFlush();
+    std::string cases = readCases();
+    EXPECT_EQ(countOf(cases, "op_name: \"gen_case_api\""),
+              thread_num * call_num);
+    EXPECT_EQ(countOf(cases, "value_f: 0.250000"),
+              thread_num * call_num * input_.size());
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in gen_case";
+  }
+}
+
+// Times the host cost of gen_case per api call, off, sync and async, with and
+// without data. Being a benchmark it is disabled, pass
+// --gtest_also_run_disabled_tests to print the numbers.
+TEST_F(gen_case, DISABLED_overhead) {
+  try {
+    // bursts shorter than the writer queue, as api calls come in production.
+    const int burst_size = 16;
+    double off = callCost(0, true, false, 100, burst_size);
+    double sync = callCost(1, false, false, 20, burst_size);
+    double async = callCost(1, true, false, 20, burst_size);
+    double sync_data = callCost(2, false, true, 5, burst_size);
+    double async_data = callCost(2, true, true, 5, burst_size);
+    std::cout << "[gen_case] off: " << off << " ns/call" << std::endl;
+    std::cout << "[gen_case] prototxt, sync: " << sync
+              << " ns/call, async: " << async << " ns/call" << std::endl;
+    std::cout << "[gen_case] prototxt with " << input_.size()
+              << " values, sync: " << sync_data
+              << " ns/call, async: " << async_data << " ns/call" << std::endl;
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in gen_case";
+  }
+}
+}  // namespace mluopapitest
@@ -0,0 +1,202 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/context.h"
+#include "core/logging.h"
+#include "core/tensor.h"
+#include "gtest/gtest.h"
+#include "kernels/generate_proposals_v2/generate_proposals_v2.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+class generate_proposals_v2_plan : public testing::Test {
+ public:
+  void SetUp() {
+    // a virtual MLU370 with 8 clusters of 4 cores.
+    setDevice("MLU370");
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&scores_desc_));
+  }
+
+  void TearDown() {
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(scores_desc_));
+    MLUOP_CHECK(mluOpDestroy(handle_));
+    MLUOP_CHECK(mluOpSetVirtualDevice(NULL));
+    std::remove(profile_path_.c_str());
+  }
+
+ protected:
+  // replaces handle_ by a handle of a virtual device preset or profile file.
+  void setDevice(const char *profile) {
+    if (handle_ != NULL) {
+      MLUOP_CHECK(mluOpDestroy(handle_));
+      handle_ = NULL;
+    }
+    MLUOP_CHECK(mluOpSetVirtualDevice(profile));
+    MLUOP_CHECK(mluOpCreate(&handle_));
+  }
+
+  // a virtual MLU370 with the given lines of a profile file on top.
+  void setMLU370Profile(const std::string &lines) {
+    std::ofstream profile(profile_path_);
+    profile << "preset = MLU370\n" << lines;
+    profile.close();
+    setDevice(profile_path_.c_str());
+  }
+
+  // the plan of N images of HWA anchors, also checks the workspace size.
+  GenerateProposalsV2Plan getPlan(int N, int HWA) {
+    GenerateProposalsV2Plan plan;
+    getGenerateProposalsV2Plan(handle_, N, HWA, &plan);
+    std::vector<int> dims = {N, 1, 1, HWA};
+    MLUOP_CHECK(mluOpSetTensorDescriptor(scores_desc_, MLUOP_LAYOUT_ARRAY,
+                                         MLUOP_DTYPE_FLOAT, 4, dims.data()));
+    size_t size = 0;
+    EXPECT_EQ(MLUOP_STATUS_SUCCESS, mluOpGetGenerateProposalsV2WorkspaceSize(
+                                        handle_, scores_desc_, &size));
+    EXPECT_EQ(plan.workspace_size, size);
+    return plan;
+  }
+
+  static size_t wholeWorkspaceSize(int HWA, int core_num = 32) {
+    return 12 * HWA * 4 + core_num * 12;
+  }
+
+  mluOpHandle_t handle_ = NULL;
+  mluOpTensorDescriptor_t scores_desc_ = NULL;
+  const std::string profile_path_ =
+      "./mluop_generate_proposals_v2_plan_profile.txt";
+};
+
+TEST_F(generate_proposals_v2_plan, whole_image) {
+  try {
+    // a single image, or large images, are split over all cores.
+    GenerateProposalsV2Plan plan = getPlan(1, 100000);
+    EXPECT_FALSE(plan.batch_parallel);
+    EXPECT_EQ(32, plan.k_dim.x);
+    EXPECT_EQ(CNRT_FUNC_TYPE_UNION8, plan.k_type);
+    EXPECT_EQ(wholeWorkspaceSize(100000), plan.workspace_size);
+
+    // 16 images of 313 anchors per core beat 10000 anchors on 16 cores.
+    plan = getPlan(16, 10000);
+    EXPECT_FALSE(plan.batch_parallel);
+    EXPECT_EQ(32, plan.k_dim.x);
+    EXPECT_EQ(wholeWorkspaceSize(10000), plan.workspace_size);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in generate_proposals_v2_plan";
+  }
+}
+
+TEST_F(generate_proposals_v2_plan, batch_parallel) {
+  try {
+    // small images run on a single core each, a core per image.
+    GenerateProposalsV2Plan plan = getPlan(16, 300);
+    EXPECT_TRUE(plan.batch_parallel);
+    EXPECT_EQ(16, plan.k_dim.x);
+    EXPECT_EQ(CNRT_FUNC_TYPE_UNION4, plan.k_type);
+    EXPECT_EQ(12 * 300 + 3, plan.core_workspace_num);
+    EXPECT_EQ(16 * (12 * 300 + 3) * 4, plan.workspace_size);
+
+    // two images per core match the whole image schedule.
+    plan = getPlan(64, 10000);
+    EXPECT_TRUE(plan.batch_parallel);
+    EXPECT_EQ(32, plan.k_dim.x);
+    EXPECT_EQ(CNRT_FUNC_TYPE_UNION8, plan.k_type);
+    EXPECT_EQ(32 * (12 * 10000 + 3) * 4, plan.workspace_size);
+
+    // 3 images still take a whole cluster.
+    plan = getPlan(3, 16);
+    EXPECT_TRUE(plan.batch_parallel);
+    EXPECT_EQ(4, plan.k_dim.x);
+    EXPECT_EQ(CNRT_FUNC_TYPE_UNION1, plan.k_type);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in generate_proposals_v2_plan";
+  }
+}
+
+TEST_F(generate_proposals_v2_plan, presets) {
+  try {
+    // 4 clusters of 4 cores, up to UNION4.
+    setDevice("MLU270");
+    GenerateProposalsV2Plan plan = getPlan(1, 100000);
+    EXPECT_FALSE(plan.batch_parallel);
+    EXPECT_EQ(16, plan.k_dim.x);
+    EXPECT_EQ(CNRT_FUNC_TYPE_UNION4, plan.k_type);
+    EXPECT_EQ(wholeWorkspaceSize(100000, 16), plan.workspace_size);
+    plan = getPlan(16, 300);
+    EXPECT_TRUE(plan.batch_parallel);
+    EXPECT_EQ(16, plan.k_dim.x);
+    EXPECT_EQ(CNRT_FUNC_TYPE_UNION4, plan.k_type);
+    EXPECT_EQ(16 * (12 * 300 + 3) * 4, plan.workspace_size);
+
+    // 16 clusters of 4 cores, up to UNION16.
+    setDevice("MLU290");
+    plan = getPlan(1, 100000);
+    EXPECT_FALSE(plan.batch_parallel);
+    EXPECT_EQ(64, plan.k_dim.x);
+    EXPECT_EQ(CNRT_FUNC_TYPE_UNION16, plan.k_type);
+    EXPECT_EQ(wholeWorkspaceSize(100000, 64), plan.workspace_size);
+    plan = getPlan(64, 300);
+    EXPECT_TRUE(plan.batch_parallel);
+    EXPECT_EQ(64, plan.k_dim.x);
+    EXPECT_EQ(CNRT_FUNC_TYPE_UNION16, plan.k_type);
+    EXPECT_EQ(64 * (12 * 300 + 3) * 4, plan.workspace_size);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in generate_proposals_v2_plan";
+  }
+}
+
+TEST_F(generate_proposals_v2_plan, job_limit) {
+  try {
+    // the final sync needs a union launch.
+    setMLU370Profile("capability_job_limit = BLOCK\n");
+    GenerateProposalsV2Plan plan = getPlan(16, 300);
+    EXPECT_FALSE(plan.batch_parallel);
+    EXPECT_EQ(1, plan.k_dim.x);
+    EXPECT_EQ(CNRT_FUNC_TYPE_BLOCK, plan.k_type);
+
+    setMLU370Profile("capability_job_limit = UNION1\n");
+    plan = getPlan(16, 300);
+    EXPECT_TRUE(plan.batch_parallel);
+    EXPECT_EQ(4, plan.k_dim.x);
+    EXPECT_EQ(CNRT_FUNC_TYPE_UNION1, plan.k_type);
+
+    // the clusters are limited by the visible clusters too.
+    setMLU370Profile("capability_cluster_num = 2\n");
+    plan = getPlan(16, 300);
+    EXPECT_TRUE(plan.batch_parallel);
+    EXPECT_EQ(8, plan.k_dim.x);
+    EXPECT_EQ(CNRT_FUNC_TYPE_UNION2, plan.k_type);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in generate_proposals_v2_plan";
+  }
+}
+}  // namespace mluopapitest
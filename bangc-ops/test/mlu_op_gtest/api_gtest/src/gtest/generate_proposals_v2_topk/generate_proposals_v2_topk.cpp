@@ -0,0 +1,109 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <float.h>
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "api_test_tools.h"
+#include "gtest/gtest.h"
+#include "generate_proposals_v2_topk.h"
+
+namespace mluopapitest {
+class generate_proposals_v2_topk : public testing::Test {
+ protected:
+  static void expectSameIndex(const std::vector<float> &scores, int k) {
+    const int n = scores.size();
+    std::vector<int32_t> expected(k, -1);
+    std::vector<int32_t> result(k, -1);
+    generateProposalsV2TopKByMaxScan(scores.data(), n, k, expected.data());
+    generateProposalsV2TopK(scores.data(), n, k, result.data());
+    EXPECT_EQ(expected, result) << "n: " << n << ", k: " << k;
+  }
+};
+
+TEST_F(generate_proposals_v2_topk, score_key) {
+  try {
+    const float values[] = {-INFINITY, -FLT_MAX, -1.5f, -FLT_MIN, 0.0f,
+                            FLT_MIN,   1.0f,     1.5f,  FLT_MAX,  INFINITY};
+    for (int i = 1; i < sizeof(values) / sizeof(float); ++i) {
+      EXPECT_LT(generateProposalsV2ScoreKey(values[i - 1]),
+                generateProposalsV2ScoreKey(values[i]));
+    }
+    EXPECT_EQ(generateProposalsV2ScoreKey(0.0f),
+              generateProposalsV2ScoreKey(-0.0f));
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in generate_proposals_v2_topk";
+  }
+}
+
+TEST_F(generate_proposals_v2_topk, ties) {
+  try {
+    // equal scores are picked by ascending index, -0.0 equals 0.0.
+    std::vector<float> scores = {0.5, 0.7, 0.5, -0.0, 0.7, 0.0, 0.5, -1};
+    std::vector<int32_t> index(6);
+    generateProposalsV2TopK(scores.data(), scores.size(), 6, index.data());
+    EXPECT_EQ(std::vector<int32_t>({1, 4, 0, 2, 6, 3}), index);
+    for (int k = 1; k <= scores.size(); ++k) {
+      expectSameIndex(scores, k);
+    }
+    expectSameIndex(std::vector<float>(100, 0.25), 37);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in generate_proposals_v2_topk";
+  }
+}
+
+TEST_F(generate_proposals_v2_topk, random) {
+  try {
+    std::mt19937 gen(2022);
+    std::uniform_real_distribution<float> dist(-4.0, 4.0);
+    for (int n : {1, 7, 256, 3000}) {
+      std::vector<float> scores(n);
+      // a few distinct values give many ties across the k-th score.
+      for (int levels : {0, 16}) {
+        for (float &score : scores) {
+          score = dist(gen);
+          if (levels != 0) {
+            score = std::floor(score * levels) / levels;
+          }
+        }
+        for (int k : {1, n / 3 + 1, n - 1, n}) {
+          if (k > 0) {
+            expectSameIndex(scores, k);
+          }
+        }
+      }
+    }
+    // NaN or -FLT_MAX scores fall back to the max scan.
+    std::vector<float> scores = {1, NAN, -FLT_MAX, 2, -INFINITY, 1};
+    expectSameIndex(scores, 5);
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in generate_proposals_v2_topk";
+  }
+}
+}  // namespace mluopapitest
@@ -0,0 +1,162 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/tool.h"
+#include "gtest/gtest.h"
+
+namespace mluopapitest {
+class half_cast : public testing::Test {
+ protected:
+  template <typename T>
+  static uint32_t bits(T value) {
+    uint32_t result = 0;
+    memcpy(&result, &value, sizeof(T));
+    return result;
+  }
+};
+
+TEST_F(half_cast, half_to_float32_all_values) {
+  try {
+    std::vector<int16_t> src(1 << 16);
+    std::vector<float> dst(src.size());
+    for (size_t i = 0; i < src.size(); ++i) {
+      src[i] = (int16_t)i;
+    }
+    arrayCastHalfToFloat32(src.data(), dst.data(), src.size());
+    for (size_t i = 0; i < src.size(); ++i) {
+      ASSERT_EQ(bits(dst[i]), bits(castHalfToFloat32(src[i]))) << "half " << i;
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in half_cast";
+  }
+}
+
+TEST_F(half_cast, float32_to_half_sweep) {
+  try {
+    // every 251st bit pattern, which hits every exponent and round bit.
+    const uint64_t step = 251;
+    std::vector<float> src;
+    for (uint64_t i = 0; i < (1ULL << 32); i += step) {
+      uint32_t in = (uint32_t)i;
+      float value;
+      memcpy(&value, &in, sizeof(float));
+      src.push_back(value);
+    }
+    const float special[] = {0.0f, -0.0f, 65504.0f, 65519.0f, 65520.0f,
+                             -65520.0f, 1e10f, -1e-10f, 5.96e-8f, 2.98e-8f,
+                             6.1e-5f, INFINITY, -INFINITY, NAN};
+    src.insert(src.end(), special, special + sizeof(special) / sizeof(float));
+    std::vector<int16_t> dst(src.size());
+    arrayCastFloat32ToHalf(src.data(), dst.data(), src.size());
+    for (size_t i = 0; i < src.size(); ++i) {
+      ASSERT_EQ(dst[i], castFloat32ToHalf(src[i])) << "float " << src[i];
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in half_cast";
+  }
+}
+
+TEST_F(half_cast, tail) {
+  try {
+    std::vector<float> src(40);
+    for (size_t i = 0; i < src.size(); ++i) {
+      src[i] = 0.3f * i - 5.0f;
+    }
+    for (size_t num = 0; num <= src.size(); ++num) {
+      std::vector<int16_t> half(src.size() + 1, 0x55);
+      std::vector<float> back(src.size() + 1, -1.0f);
+      arrayCastFloat32ToHalf(src.data(), half.data(), num);
+      arrayCastHalfToFloat32(half.data(), back.data(), num);
+      for (size_t i = 0; i < num; ++i) {
+        ASSERT_EQ(half[i], castFloat32ToHalf(src[i]));
+        ASSERT_EQ(bits(back[i]), bits(castHalfToFloat32(half[i])));
+      }
+      // nothing beyond num is written.
+      ASSERT_EQ(half[num], 0x55);
+      ASSERT_EQ(back[num], -1.0f);
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in half_cast";
+  }
+}
+
+// Array casts against element-wise casts over 16M elements. This is a
+// benchmark rather than a check and stays disabled unless
+// --gtest_also_run_disabled_tests is given.
+TEST_F(half_cast, DISABLED_throughput) {
+  try {
+    const size_t num = 1 << 24;
+    const int loop = 5;
+    std::vector<float> src(num);
+    std::vector<int16_t> half(num);
+    std::vector<float> back(num);
+    for (size_t i = 0; i < num; ++i) {
+      src[i] = (float)((int)(i % 20011) - 10000) * 0.37f;
+    }
+    // bytes read and written by one pass.
+    const double bytes = num * (sizeof(float) + sizeof(int16_t)) * loop;
+    auto gbps = [&](std::chrono::steady_clock::time_point start) {
+      std::chrono::duration<double> seconds =
+          std::chrono::steady_clock::now() - start;
+      return bytes / seconds.count() / 1e9;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (int l = 0; l < loop; ++l) {
+      for (size_t i = 0; i < num; ++i) {
+        half[i] = castFloat32ToHalf(src[i]);
+      }
+    }
+    double scalar_to_half = gbps(start);
+    start = std::chrono::steady_clock::now();
+    for (int l = 0; l < loop; ++l) {
+      arrayCastFloat32ToHalf(src.data(), half.data(), num);
+    }
+    double array_to_half = gbps(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int l = 0; l < loop; ++l) {
+      for (size_t i = 0; i < num; ++i) {
+        back[i] = castHalfToFloat32(half[i]);
+      }
+    }
+    double scalar_to_float = gbps(start);
+    start = std::chrono::steady_clock::now();
+    for (int l = 0; l < loop; ++l) {
+      arrayCastHalfToFloat32(half.data(), back.data(), num);
+    }
+    double array_to_float = gbps(start);
+
+    std::cout << "[half_cast] float32 to half: scalar " << scalar_to_half
+              << " GB/s, array " << array_to_half << " GB/s" << std::endl;
+    std::cout << "[half_cast] half to float32: scalar " << scalar_to_float
+              << " GB/s, array " << array_to_float << " GB/s" << std::endl;
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in half_cast";
+  }
+}
+}  // namespace mluopapitest
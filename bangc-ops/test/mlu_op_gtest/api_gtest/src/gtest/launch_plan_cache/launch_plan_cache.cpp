@@ -0,0 +1,251 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/context.h"
+#include "core/logging.h"
+#include "core/runtime/launch_plan_cache.h"
+#include "core/tensor.h"
+#include "gtest/gtest.h"
+#include "kernels/unary_op/unary_op_host.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+class launch_plan_cache : public testing::Test {
+ public:
+  void SetUp() {
+    // a host only context, enough for keys and policy functions.
+    ctx_.arch = MLUOP_MLU370;
+    ctx_.cluster_num = 8;
+    ctx_.core_num_per_cluster = 4;
+    ctx_.nram_size = 512 * 1024;
+    ctx_.capability_cluster_num = 8;
+    ctx_.capability_job_limit = CN_KERNEL_CLASS_UNION;
+    ctx_.round_mode = MLUOP_ROUND_HALF_TO_EVEN;
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&x_desc_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&y_desc_));
+    std::vector<int> dims = {2, 3, 4, 5};
+    MLUOP_CHECK(mluOpSetTensorDescriptor(x_desc_, MLUOP_LAYOUT_ARRAY,
+                                         MLUOP_DTYPE_FLOAT, 4, dims.data()));
+    MLUOP_CHECK(mluOpSetTensorDescriptor(y_desc_, MLUOP_LAYOUT_ARRAY,
+                                         MLUOP_DTYPE_FLOAT, 4, dims.data()));
+  }
+
+  void TearDown() {
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(x_desc_));
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(y_desc_));
+  }
+
+ protected:
+  mluOpContext ctx_;
+  mluOpTensorDescriptor_t x_desc_ = NULL;
+  mluOpTensorDescriptor_t y_desc_ = NULL;
+};
+
+TEST_F(launch_plan_cache, hit_and_miss) {
+  try {
+    mluop::runtime::LaunchPlanCache cache(4);
+    mluop::runtime::LaunchPlanKey key("[test]");
+    key.add(&ctx_).add(x_desc_).add(y_desc_);
+    mluop::runtime::LaunchPlan plan;
+    EXPECT_FALSE(cache.lookup(key, &plan));
+
+    plan.k_dim = {4, 2, 1};
+    plan.tiling[0] = 120;
+    cache.insert(key, plan);
+
+    mluop::runtime::LaunchPlan cached;
+    EXPECT_TRUE(cache.lookup(key, &cached));
+    EXPECT_EQ(cached.k_dim.y, 2u);
+    EXPECT_EQ(cached.tiling[0], 120);
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_EQ(cache.misses(), 1u);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in launch_plan_cache";
+  }
+}
+
+TEST_F(launch_plan_cache, key_covers_params) {
+  try {
+    mluop::runtime::LaunchPlanCache cache(16);
+    mluop::runtime::LaunchPlan plan;
+    mluop::runtime::LaunchPlanKey key("[test]");
+    key.add(&ctx_).add(x_desc_).add(MLUOP_COMPUTATION_FAST);
+    cache.insert(key, plan);
+
+    // another scalar param.
+    mluop::runtime::LaunchPlanKey prefer_key("[test]");
+    prefer_key.add(&ctx_).add(x_desc_).add(MLUOP_COMPUTATION_HIGH_PRECISION);
+    EXPECT_FALSE(cache.lookup(prefer_key, &plan));
+
+    // another op.
+    mluop::runtime::LaunchPlanKey op_key("[test2]");
+    op_key.add(&ctx_).add(x_desc_).add(MLUOP_COMPUTATION_FAST);
+    EXPECT_FALSE(cache.lookup(op_key, &plan));
+
+    // another job limit of the handle.
+    ctx_.capability_cluster_num = 4;
+    mluop::runtime::LaunchPlanKey ctx_key("[test]");
+    ctx_key.add(&ctx_).add(x_desc_).add(MLUOP_COMPUTATION_FAST);
+    EXPECT_FALSE(cache.lookup(ctx_key, &plan));
+    ctx_.capability_cluster_num = 8;
+
+    // another round mode of the handle.
+    ctx_.round_mode = MLUOP_ROUND_HALF_UP;
+    mluop::runtime::LaunchPlanKey round_key("[test]");
+    round_key.add(&ctx_).add(x_desc_).add(MLUOP_COMPUTATION_FAST);
+    EXPECT_FALSE(cache.lookup(round_key, &plan));
+    ctx_.round_mode = MLUOP_ROUND_HALF_TO_EVEN;
+
+    // other quantization params.
+    MLUOP_CHECK(mluOpSetTensorDescriptorPositionScaleAndOffset(x_desc_, 2,
+                                                               0.5, 1));
+    mluop::runtime::LaunchPlanKey quant_key("[test]");
+    quant_key.add(&ctx_).add(x_desc_).add(MLUOP_COMPUTATION_FAST);
+    EXPECT_FALSE(cache.lookup(quant_key, &plan));
+
+    // another shape.
+    std::vector<int> dims = {2, 3, 4, 6};
+    MLUOP_CHECK(mluOpSetTensorDescriptor(x_desc_, MLUOP_LAYOUT_ARRAY,
+                                         MLUOP_DTYPE_FLOAT, 4, dims.data()));
+    mluop::runtime::LaunchPlanKey shape_key("[test]");
+    shape_key.add(&ctx_).add(x_desc_).add(MLUOP_COMPUTATION_FAST);
+    EXPECT_FALSE(cache.lookup(shape_key, &plan));
+
+    // NULL descriptors are never cached.
+    mluop::runtime::LaunchPlanKey null_key("[test]");
+    null_key.add(&ctx_).add((mluOpTensorDescriptor_t)NULL);
+    EXPECT_FALSE(null_key.valid());
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in launch_plan_cache";
+  }
+}
+
+TEST_F(launch_plan_cache, lru_eviction) {
+  try {
+    mluop::runtime::LaunchPlanCache cache(2);
+    mluop::runtime::LaunchPlan plan;
+    mluop::runtime::LaunchPlanKey key0("[test]");
+    mluop::runtime::LaunchPlanKey key1("[test]");
+    mluop::runtime::LaunchPlanKey key2("[test]");
+    key0.add(0);
+    key1.add(1);
+    key2.add(2);
+    cache.insert(key0, plan);
+    cache.insert(key1, plan);
+    // key0 becomes the most recently used one, so key1 is evicted.
+    EXPECT_TRUE(cache.lookup(key0, &plan));
+    cache.insert(key2, plan);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_TRUE(cache.lookup(key0, &plan));
+    EXPECT_FALSE(cache.lookup(key1, &plan));
+    EXPECT_TRUE(cache.lookup(key2, &plan));
+
+    cache.setCapacity(0);
+    EXPECT_EQ(cache.size(), 0u);
+    cache.insert(key0, plan);
+    EXPECT_FALSE(cache.lookup(key0, &plan));
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in launch_plan_cache";
+  }
+}
+
+TEST_F(launch_plan_cache, handle_info) {
+  try {
+    mluOpHandle_t handle = NULL;
+    size_t size = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    MLUOP_CHECK(mluOpCreate(&handle));
+    MLUOP_CHECK(mluOpSetLaunchPlanCacheCapacity(handle, 8));
+    MLUOP_CHECK(mluOpGetLaunchPlanCacheInfo(handle, &size, &hits, &misses));
+    EXPECT_EQ(size, 0u);
+    EXPECT_EQ(hits, 0u);
+    EXPECT_EQ(misses, 0u);
+    EXPECT_TRUE(MLUOP_STATUS_BAD_PARAM ==
+                mluOpGetLaunchPlanCacheInfo(handle, NULL, &hits, &misses));
+    MLUOP_CHECK(mluOpDestroy(handle));
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in launch_plan_cache";
+  }
+}
+
+// Times the host work of a unary op call before its kernel launch, with and
+// without the launch plan cache. Being a benchmark it is disabled, pass
+// --gtest_also_run_disabled_tests to print the numbers.
+TEST_F(launch_plan_cache, DISABLED_host_overhead) {
+  try {
+    const int loop = 200000;
+    mluOpHandle_t handle = &ctx_;
+    mluOpDataType_t support_type[2] = {MLUOP_DTYPE_HALF, MLUOP_DTYPE_FLOAT};
+    const void *x = (const void *)0x100;
+    const void *y = (const void *)0x200;
+    uint64_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop; ++i) {
+      bool zero_element = false;
+      MLUOP_CHECK(unaryOpParamCheck("[test]", handle, x_desc_, x, y_desc_, y,
+                                    support_type, 2, zero_element));
+      mluop::runtime::LaunchPlan plan;
+      unaryOpPolicyFunc(handle, x_desc_, &plan.k_dim, &plan.k_type);
+      plan.tiling[0] = mluOpGetTensorElementNum(x_desc_);
+      checksum += plan.k_dim.y + plan.tiling[0];
+    }
+    std::chrono::duration<double, std::nano> uncached =
+        std::chrono::steady_clock::now() - start;
+
+    mluop::runtime::LaunchPlanCache cache(LAUNCH_PLAN_CACHE_DEFAULT_CAPACITY);
+    ctx_.launch_plan_cache = &cache;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop; ++i) {
+      bool zero_element = false;
+      mluop::runtime::LaunchPlanKey key("[test]");
+      key.add(handle).add(x_desc_).add(y_desc_);
+      mluop::runtime::LaunchPlan plan;
+      if (!mluop::runtime::lookupLaunchPlan(handle, key, &plan)) {
+        MLUOP_CHECK(unaryOpParamCheck("[test]", handle, x_desc_, x, y_desc_,
+                                      y, support_type, 2, zero_element));
+        unaryOpPolicyFunc(handle, x_desc_, &plan.k_dim, &plan.k_type);
+        plan.tiling[0] = mluOpGetTensorElementNum(x_desc_);
+        mluop::runtime::insertLaunchPlan(handle, key, plan);
+      }
+      checksum -= plan.k_dim.y + plan.tiling[0];
+    }
+    std::chrono::duration<double, std::nano> cached =
+        std::chrono::steady_clock::now() - start;
+    ctx_.launch_plan_cache = NULL;
+
+    EXPECT_EQ(checksum, 0u);
+    EXPECT_EQ(cache.hits(), (uint64_t)loop - 1);
+    std::cout << "[launch_plan_cache] host overhead per call, uncached: "
+              << uncached.count() / loop
+              << " ns, cached: " << cached.count() / loop << " ns"
+              << std::endl;
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in launch_plan_cache";
+  }
+}
+}  // namespace mluopapitest
@@ -0,0 +1,199 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "api_test_tools.h"
+#include "core/logging.h"
+#include "core/runtime/op_profiler.h"
+#include "core/tensor.h"
+#include "gtest/gtest.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+namespace {
+// a host only stand-in for an op API, walks through the phases the way the
+// op APIs do and sleeps `phase_us` in each of them.
+void fakeOp(const char *name, mluOpTensorDescriptor_t desc, int phase_us) {
+  MLUOP_PROFILE_OP(name);
+  auto work = [phase_us]() {
+    std::this_thread::sleep_for(std::chrono::microseconds(phase_us));
+  };
+  work();
+  MLUOP_PROFILE_TENSOR(desc);
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_GEN_CASE);
+  work();
+  MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_POLICY);
+  work();
+  int previous = MLUOP_PROFILE_PHASE(MLUOP_PROFILING_PHASE_KERNEL_ENQUEUE);
+  work();
+  MLUOP_PROFILE_PHASE(previous);
+}
+
+void collect(const mluOpProfilingRecord_t *record, void *user_data) {
+  auto records = (std::vector<mluOpProfilingRecord_t> *)user_data;
+  records->push_back(*record);
+}
+}  // namespace
+
+class op_profiler : public testing::Test {
+ public:
+  void SetUp() {
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&desc_));
+    int dims[2] = {4, 8};
+    MLUOP_CHECK(mluOpSetTensorDescriptor(desc_, MLUOP_LAYOUT_ARRAY,
+                                         MLUOP_DTYPE_FLOAT, 2, dims));
+    MLUOP_CHECK(mluOpResetProfiling());
+  }
+  void TearDown() {
+    MLUOP_CHECK(mluOpSetProfilingEnabled(false));
+    MLUOP_CHECK(mluOpSetProfilingCallback(NULL, NULL));
+    MLUOP_CHECK(mluOpResetProfiling());
+    if (desc_ != NULL) {
+      MLUOP_CHECK(mluOpDestroyTensorDescriptor(desc_));
+      desc_ = NULL;
+    }
+  }
+
+ protected:
+  // the snapshot of `name`, call_count stays 0 if the op has no calls.
+  mluOpProfilingOpStats_t findOp(const char *name) {
+    mluOpProfilingOpStats_t found;
+    memset(&found, 0, sizeof(found));
+    int op_num = 0;
+    MLUOP_CHECK(mluOpGetProfilingSnapshot(NULL, 0, &op_num));
+    std::vector<mluOpProfilingOpStats_t> stats(op_num);
+    MLUOP_CHECK(mluOpGetProfilingSnapshot(stats.data(), op_num, &op_num));
+    for (const auto &op : stats) {
+      if (std::string(op.op_name) == name) {
+        found = op;
+      }
+    }
+    return found;
+  }
+
+  mluOpTensorDescriptor_t desc_ = NULL;
+};
+
+TEST_F(op_profiler, disabled_records_nothing) {
+  try {
+    fakeOp("fakeOpDisabled", desc_, 0);
+    EXPECT_EQ(findOp("fakeOpDisabled").call_count, (uint64_t)0);
+    EXPECT_EQ(mluop::runtime::OpProfileScope::current(), nullptr);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in op_profiler";
+  }
+}
+
+TEST_F(op_profiler, phases_and_snapshot) {
+  try {
+    MLUOP_CHECK(mluOpSetProfilingEnabled(true));
+    for (int i = 0; i < 10; ++i) {
+      fakeOp("fakeOpPhases", desc_, 200);
+    }
+    EXPECT_EQ(mluop::runtime::OpProfileScope::current(), nullptr);
+    mluOpProfilingOpStats_t op = findOp("fakeOpPhases");
+    EXPECT_EQ(op.call_count, (uint64_t)10);
+    EXPECT_EQ(op.bytes, (uint64_t)(10 * 4 * 8 * sizeof(float)));
+    uint64_t phase_sum = 0;
+    for (int p = MLUOP_PROFILING_PHASE_PARAM_CHECK;
+         p < MLUOP_PROFILING_PHASE_NUM; ++p) {
+      // every phase slept 200 us per call.
+      EXPECT_GE(op.sum_ns[p], (uint64_t)10 * 200000);
+      EXPECT_GE(op.p50_ns[p], (uint64_t)200000 * 15 / 16);
+      EXPECT_LE(op.p50_ns[p], op.p90_ns[p]);
+      EXPECT_LE(op.p90_ns[p], op.p99_ns[p]);
+      EXPECT_LE(op.p99_ns[p], op.max_ns[p]);
+      phase_sum += op.sum_ns[p];
+    }
+    EXPECT_EQ(op.sum_ns[MLUOP_PROFILING_PHASE_TOTAL], phase_sum);
+
+    MLUOP_CHECK(mluOpResetProfiling());
+    EXPECT_EQ(findOp("fakeOpPhases").call_count, (uint64_t)0);
+
+    int op_num = -1;
+    EXPECT_EQ(mluOpGetProfilingSnapshot(NULL, 1, &op_num),
+              MLUOP_STATUS_BAD_PARAM);
+    EXPECT_EQ(mluOpGetProfilingSnapshot(NULL, 0, NULL),
+              MLUOP_STATUS_BAD_PARAM);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in op_profiler";
+  }
+}
+
+TEST_F(op_profiler, nested_and_callback) {
+  try {
+    std::vector<mluOpProfilingRecord_t> records;
+    MLUOP_CHECK(mluOpSetProfilingCallback(collect, &records));
+    MLUOP_CHECK(mluOpSetProfilingEnabled(true));
+    {
+      MLUOP_PROFILE_OP("fakeOpOuter");
+      MLUOP_PROFILE_TENSOR(desc_);
+      fakeOp("fakeOpInner", desc_, 0);
+      EXPECT_NE(mluop::runtime::OpProfileScope::current(), nullptr);
+    }
+    ASSERT_EQ(records.size(), (size_t)2);
+    EXPECT_STREQ(records[0].op_name, "fakeOpInner");
+    EXPECT_STREQ(records[1].op_name, "fakeOpOuter");
+    // the inner call adds its bytes to its own record only.
+    EXPECT_EQ(records[0].bytes, (uint64_t)(4 * 8 * sizeof(float)));
+    EXPECT_EQ(records[1].bytes, (uint64_t)(4 * 8 * sizeof(float)));
+    EXPECT_GE(records[1].phase_ns[MLUOP_PROFILING_PHASE_TOTAL],
+              records[0].phase_ns[MLUOP_PROFILING_PHASE_TOTAL]);
+    EXPECT_EQ(findOp("fakeOpOuter").call_count, (uint64_t)1);
+    EXPECT_EQ(findOp("fakeOpInner").call_count, (uint64_t)1);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in op_profiler";
+  }
+}
+
+// Host cost of the hooks of one op call with profiling disabled and enabled,
+// over 1M calls each. Only meaningful as a benchmark, so it is disabled and
+// runs with --gtest_also_run_disabled_tests.
+TEST_F(op_profiler, DISABLED_hook_overhead) {
+  try {
+    const int call_num = 1000000;
+    auto perCall = [call_num](mluOpTensorDescriptor_t desc) {
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < call_num; ++i) {
+        fakeOp("fakeOpOverhead", desc, 0);
+      }
+      return std::chrono::duration<double, std::nano>(
+                 std::chrono::steady_clock::now() - start)
+                 .count() /
+             call_num;
+    };
+    double disabled = perCall(desc_);
+    MLUOP_CHECK(mluOpSetProfilingEnabled(true));
+    double enabled = perCall(desc_);
+    EXPECT_EQ(findOp("fakeOpOverhead").call_count, (uint64_t)call_num);
+    std::cout << "[op_profiler] hooks per call, disabled: " << disabled
+              << " ns, enabled: " << enabled << " ns" << std::endl;
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in op_profiler";
+  }
+}
+}  // namespace mluopapitest
@@ -41,13 +41,13 @@ class poly_nms : public testing::Test {
     }
     if (boxes_desc) {
       MLUOP_CHECK(mluOpCreateTensorDescriptor(&boxes_desc_));
-      std::vector<int> dim_size = {2, 9};
+      std::vector<int> dim_size = {box_num_, 9};
       MLUOP_CHECK(mluOpSetTensorDescriptor(boxes_desc_, MLUOP_LAYOUT_NHWC,
                                            MLUOP_DTYPE_FLOAT, 2,
                                            dim_size.data()));
     }
     if (boxes) {
-      size_t i_ele_num = 2 * 9;
+      size_t i_ele_num = (size_t)box_num_ * 9;
       size_t i_dtype_bytes = mluOpDataTypeBytes(MLUOP_DTYPE_FLOAT);
       size_t i_bytes = i_ele_num * i_dtype_bytes;
       GTEST_CHECK(CNRT_RET_SUCCESS == cnrtMalloc(&boxes_, i_bytes));
@@ -57,13 +57,13 @@ class poly_nms : public testing::Test {
     }
     if (output_desc) {
       MLUOP_CHECK(mluOpCreateTensorDescriptor(&output_desc_));
-      std::vector<int> dim_size = {2};
+      std::vector<int> dim_size = {box_num_};
       MLUOP_CHECK(mluOpSetTensorDescriptor(output_desc_, MLUOP_LAYOUT_NHWC,
                                            MLUOP_DTYPE_INT32, 1,
                                            dim_size.data()));
     }
     if (output) {
-      size_t o_ele_num = 2;
+      size_t o_ele_num = box_num_;
       size_t o_dtype_bytes = mluOpDataTypeBytes(MLUOP_DTYPE_INT32);
       size_t o_bytes = o_ele_num * o_dtype_bytes;
       GTEST_CHECK(CNRT_RET_SUCCESS == cnrtMalloc(&output_, o_bytes));
@@ -115,6 +115,8 @@ class poly_nms : public testing::Test {
     }
   }
 
+  int box_num_ = 2;
+
  private:
   mluOpHandle_t handle_ = NULL;
   mluOpTensorDescriptor_t boxes_desc_ = NULL;
@@ -189,4 +191,15 @@ TEST_F(poly_nms, BAD_PARAM_result_num_null) {
     FAIL() << "MLUOPAPITEST: catched " << e.what() << " in poly_nms";
   }
 }
+
+TEST_F(poly_nms, NOT_SUPPORTED_box_num) {
+  try {
+    // the workspace mask of more than 131072 boxes would exceed 2 GB
+    box_num_ = 131073;
+    setParam(true, true, true, true, true, true, true);
+    EXPECT_TRUE(MLUOP_STATUS_NOT_SUPPORTED == compute());
+  } catch (const std::exception& e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in poly_nms";
+  }
+}
 }  // namespace mluopapitest
@@ -0,0 +1,185 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/context.h"
+#include "core/logging.h"
+#include "core/tensor.h"
+#include "gtest/gtest.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+class poly_nms_batched : public testing::Test {
+ public:
+  void SetUp() {
+    MLUOP_CHECK(mluOpSetVirtualDevice("MLU370"));
+    MLUOP_CHECK(mluOpCreate(&handle_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&boxes_desc_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&class_ids_desc_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&output_desc_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&output_size_desc_));
+    setValid();
+  }
+
+  void TearDown() {
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(boxes_desc_));
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(class_ids_desc_));
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(output_desc_));
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(output_size_desc_));
+    MLUOP_CHECK(mluOpDestroy(handle_));
+    MLUOP_CHECK(mluOpSetVirtualDevice(NULL));
+  }
+
+ protected:
+  void setDesc(mluOpTensorDescriptor_t desc, mluOpDataType_t dtype,
+               std::vector<int> dims) {
+    MLUOP_CHECK(mluOpSetTensorDescriptor(desc, MLUOP_LAYOUT_ARRAY, dtype,
+                                         dims.size(), dims.data()));
+  }
+
+  // valid parameters of 2 images of 16 boxes in 3 classes, every case below
+  // breaks exactly one of them.
+  void setValid() {
+    setDesc(boxes_desc_, MLUOP_DTYPE_FLOAT, {2, 16, 9});
+    setDesc(class_ids_desc_, MLUOP_DTYPE_INT32, {2, 16});
+    setDesc(output_desc_, MLUOP_DTYPE_INT32, {2, 16});
+    setDesc(output_size_desc_, MLUOP_DTYPE_INT32, {2, 3});
+    class_num_ = 3;
+    boxes_ = dummy_;
+    class_ids_ = dummy_;
+    workspace_ = dummy_;
+    output_ = dummy_;
+    output_size_ = dummy_;
+    MLUOP_CHECK(mluOpGetPolyNmsBatchedWorkspaceSize(handle_, boxes_desc_,
+                                                    class_num_,
+                                                    &workspace_size_));
+  }
+
+  // the pointers are never dereferenced, every case fails its check before
+  // any launch.
+  mluOpStatus_t compute(mluOpHandle_t handle,
+                        mluOpTensorDescriptor_t class_ids_desc) {
+    return mluOpPolyNmsBatched(handle, boxes_desc_, boxes_, class_ids_desc,
+                               class_ids_, class_num_, 0.5, workspace_,
+                               workspace_size_, output_desc_, output_,
+                               output_size_desc_, output_size_);
+  }
+
+  mluOpStatus_t compute() { return compute(handle_, class_ids_desc_); }
+
+  mluOpHandle_t handle_ = NULL;
+  mluOpTensorDescriptor_t boxes_desc_ = NULL;
+  mluOpTensorDescriptor_t class_ids_desc_ = NULL;
+  mluOpTensorDescriptor_t output_desc_ = NULL;
+  mluOpTensorDescriptor_t output_size_desc_ = NULL;
+  int class_num_ = 3;
+  int dummy_[4] = {0};
+  void *boxes_ = NULL;
+  void *class_ids_ = NULL;
+  void *workspace_ = NULL;
+  size_t workspace_size_ = 0;
+  void *output_ = NULL;
+  void *output_size_ = NULL;
+};
+
+TEST_F(poly_nms_batched, workspace_size) {
+  try {
+    size_t size = 0;
+    // the areas and the kept ids of every box, the box number of every group.
+    EXPECT_EQ(MLUOP_STATUS_SUCCESS, mluOpGetPolyNmsBatchedWorkspaceSize(
+                                        handle_, boxes_desc_, 3, &size));
+    EXPECT_EQ(2 * 16 * 8 + 2 * 3 * 4, size);
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, mluOpGetPolyNmsBatchedWorkspaceSize(
+                                          handle_, boxes_desc_, 0, &size));
+    setDesc(boxes_desc_, MLUOP_DTYPE_FLOAT, {16, 9});
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, mluOpGetPolyNmsBatchedWorkspaceSize(
+                                          handle_, boxes_desc_, 1, &size));
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in poly_nms_batched";
+  }
+}
+
+TEST_F(poly_nms_batched, param_check) {
+  try {
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute(NULL, class_ids_desc_));
+    // several classes need class ids.
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute(handle_, NULL));
+    class_num_ = 0;
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute());
+    setValid();
+    // output_size has a column per class.
+    class_num_ = 2;
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute());
+    setValid();
+    setDesc(boxes_desc_, MLUOP_DTYPE_HALF, {2, 16, 9});
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute());
+    setValid();
+    setDesc(boxes_desc_, MLUOP_DTYPE_FLOAT, {2, 16, 8});
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute());
+    setValid();
+    setDesc(class_ids_desc_, MLUOP_DTYPE_FLOAT, {2, 16});
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute());
+    setValid();
+    setDesc(class_ids_desc_, MLUOP_DTYPE_INT32, {2, 15});
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute());
+    setValid();
+    setDesc(output_desc_, MLUOP_DTYPE_INT32, {2, 15});
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute());
+    setValid();
+    setDesc(output_size_desc_, MLUOP_DTYPE_FLOAT, {2, 3});
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute());
+    setValid();
+    output_size_ = NULL;
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute());
+    setValid();
+    boxes_ = NULL;
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute());
+    setValid();
+    class_ids_ = NULL;
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute());
+    setValid();
+    output_ = NULL;
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute());
+    setValid();
+    workspace_size_ -= 1;
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute());
+    // the boxes of an image are kept in NRAM.
+    setValid();
+    setDesc(boxes_desc_, MLUOP_DTYPE_FLOAT, {2, 8192, 9});
+    setDesc(class_ids_desc_, MLUOP_DTYPE_INT32, {2, 8192});
+    setDesc(output_desc_, MLUOP_DTYPE_INT32, {2, 8192});
+    EXPECT_EQ(MLUOP_STATUS_NOT_SUPPORTED, compute());
+    // an empty batch has nothing to write.
+    setValid();
+    setDesc(boxes_desc_, MLUOP_DTYPE_FLOAT, {0, 16, 9});
+    setDesc(class_ids_desc_, MLUOP_DTYPE_INT32, {0, 16});
+    setDesc(output_desc_, MLUOP_DTYPE_INT32, {0, 16});
+    setDesc(output_size_desc_, MLUOP_DTYPE_INT32, {0, 3});
+    EXPECT_EQ(MLUOP_STATUS_SUCCESS, compute());
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in poly_nms_batched";
+  }
+}
+}  // namespace mluopapitest
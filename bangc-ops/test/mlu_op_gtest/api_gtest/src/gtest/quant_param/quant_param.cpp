@@ -0,0 +1,256 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/tool.h"
+#include "gtest/gtest.h"
+
+namespace mluopapitest {
+// the serial scans which getPosition* used to do.
+static float refAbsMax(const float *input, size_t num) {
+  float absmax = std::fabs(input[0]);
+  for (size_t i = 0; i < num; ++i) {
+    if (std::fabs(input[i]) > absmax) absmax = std::fabs(input[i]);
+  }
+  return absmax;
+}
+
+static void refMinMax(const float *input, size_t num, float *min_data,
+                      float *max_data) {
+  *max_data = input[0];
+  *min_data = input[0];
+  for (size_t i = 0; i < num; ++i) {
+    *max_data = *max_data > input[i] ? *max_data : input[i];
+    *min_data = *min_data < input[i] ? *min_data : input[i];
+  }
+}
+
+static void refCastFloat32ToInt31(const float *src, size_t num, void *dst) {
+  int var = 0;
+  float absmax = refAbsMax(src, num);
+  int position = absmax == 0
+                     ? 0
+                     : static_cast<int>(std::floor(std::log2(absmax)) - 29);
+  if (absmax == 0) {
+    memset(dst, 0, 2 * num * sizeof(int16_t));
+    return;
+  }
+  var = std::pow(2, 16 - 1);
+  for (size_t i = 0; i < num; ++i) {
+    float temp = src[i] / (std::pow(2, position));
+    temp = (temp >= 0) ? (temp + 0.5f) : (temp - 0.5f);
+    float temp_high = temp / var;
+    ((int16_t *)dst)[i + num] = static_cast<int16_t>(temp_high);
+    float temp_low = temp - ((int16_t *)dst)[i + num] * var;
+    ((int16_t *)dst)[i] = static_cast<int16_t>(temp_low);
+  }
+}
+
+class quant_param : public testing::Test {
+ protected:
+  std::vector<float> randomData(size_t num, float range) {
+    std::uniform_real_distribution<float> dist(-range, range);
+    std::vector<float> data(num);
+    for (auto &value : data) {
+      value = dist(engine_);
+    }
+    return data;
+  }
+
+  // compares every API with the serial reference.
+  void check(std::vector<float> data) {
+    size_t num = data.size();
+    float *input = data.data();
+    int position = 0;
+    float scale = 0.0f;
+    int offset = 0;
+
+    float absmax = refAbsMax(input, num);
+    int ref_position = absmax == 0 ? 0
+                                   : static_cast<int>(
+                                         std::floor(std::log2(absmax)) - 6);
+    MLUOP_CHECK(getPosition(input, num, MLUOP_DTYPE_INT8, &position));
+    ASSERT_EQ(position, ref_position);
+    MLUOP_CHECK(
+        getPositionAndScale(input, num, MLUOP_DTYPE_INT16, &position, &scale));
+    if (absmax == 0) {
+      ASSERT_EQ(scale, 1.0f);
+    } else {
+      int pos16 = static_cast<int>(std::floor(std::log2(absmax)) - 14);
+      float ref_scale =
+          static_cast<float>(std::pow(2, pos16) * 32767 / absmax);
+      ASSERT_EQ(position, pos16);
+      ASSERT_EQ(memcmp(&scale, &ref_scale, sizeof(float)), 0);
+    }
+
+    float min_data = 0.0f;
+    float max_data = 0.0f;
+    refMinMax(input, num, &min_data, &max_data);
+    max_data = max_data > 0 ? max_data : 0;
+    min_data = min_data < 0 ? min_data : 0;
+    MLUOP_CHECK(getPositionScaleAndOffset(input, num, MLUOP_DTYPE_INT8,
+                                          &position, &scale, &offset));
+    if (max_data == min_data) {
+      ASSERT_EQ(position, 0);
+    } else {
+      int ref_pos =
+          (int)(floorf(log2f(max_data - min_data)) - (8 - 1));
+      float ref_scale =
+          powf(2, ref_pos) * (powf(2, 8) - 1) / (max_data - min_data);
+      int ref_offset =
+          (int)roundf(-powf(2, 8 - 1) -
+                      min_data * (powf(2, 8) - 1) / (max_data - min_data));
+      ASSERT_EQ(position, ref_pos);
+      ASSERT_EQ(memcmp(&scale, &ref_scale, sizeof(float)), 0);
+      ASSERT_EQ(offset, ref_offset);
+    }
+
+    std::vector<int16_t> int31(2 * num);
+    std::vector<int16_t> ref_int31(2 * num);
+    MLUOP_CHECK(castFloat32ToInt31(input, num, int31.data()));
+    refCastFloat32ToInt31(input, num, ref_int31.data());
+    ASSERT_EQ(int31, ref_int31);
+  }
+
+  std::mt19937 engine_{2022};
+};
+
+TEST_F(quant_param, same_as_serial_scan) {
+  try {
+    for (size_t num : {1, 7, 8, 17, 1000, 3 * 1024 * 1024 + 5}) {
+      check(randomData(num, 100.0f));
+      check(randomData(num, 1e-30f));
+      check(std::vector<float>(num, 0.0f));
+      check(std::vector<float>(num, -3.0f));
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in quant_param";
+  }
+}
+
+TEST_F(quant_param, special_values) {
+  try {
+    const size_t num = 3 * 1024 * 1024 + 5;
+    std::vector<float> data = randomData(num, 10.0f);
+    data[num / 2] = -0.0f;
+    data[num / 3] = 1e-42f;
+    check(data);
+    // nan results depend on where the nan is.
+    for (size_t pos : {(size_t)0, num / 2, num - 1}) {
+      std::vector<float> with_nan = data;
+      with_nan[pos] = NAN;
+      check(with_nan);
+    }
+    // the largest element on the edges of the chunks and vector lanes.
+    for (size_t pos : {(size_t)1, (size_t)15, num / 4, num - 2}) {
+      std::vector<float> peak = data;
+      peak[pos] = -1e6f;
+      check(peak);
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in quant_param";
+  }
+}
+
+TEST_F(quant_param, int31_round_trip) {
+  try {
+    std::vector<float> data = randomData(1000, 50.0f);
+    std::vector<int16_t> int31(2 * data.size());
+    std::vector<float> back(data.size());
+    MLUOP_CHECK(castFloat32ToInt31(data.data(), data.size(), int31.data()));
+    float absmax = refAbsMax(data.data(), data.size());
+    int position = static_cast<int>(std::floor(std::log2(absmax)) - 29);
+    MLUOP_CHECK(
+        castInt31ToFloat32(int31.data(), back.data(), data.size(), position));
+    for (size_t i = 0; i < data.size(); ++i) {
+      ASSERT_NEAR(back[i], data[i], std::ldexp(1.0, position));
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in quant_param";
+  }
+}
+
+// Times the serial scans against the current ones on inputs from 1M elements
+// up to MLUOP_QUANT_BENCH_MAX_NUM elements, 64M by default; 1G elements need
+// 12GB host memory. It asserts nothing, so it is disabled and only runs with
+// --gtest_also_run_disabled_tests.
+TEST_F(quant_param, DISABLED_benchmark) {
+  try {
+    const char *env = std::getenv("MLUOP_QUANT_BENCH_MAX_NUM");
+    size_t max_num = env == NULL ? (1 << 26) : strtoull(env, NULL, 10);
+    auto ms = [](std::chrono::steady_clock::time_point start) {
+      std::chrono::duration<double, std::milli> duration =
+          std::chrono::steady_clock::now() - start;
+      return duration.count();
+    };
+    for (size_t num = 1 << 20; num <= max_num; num *= 4) {
+      std::vector<float> data = randomData(num, 100.0f);
+      std::vector<int16_t> int31(2 * num);
+      int position = 0;
+      float scale = 0.0f;
+      int offset = 0;
+      float min_data = 0.0f;
+      float max_data = 0.0f;
+
+      auto start = std::chrono::steady_clock::now();
+      volatile float absmax = refAbsMax(data.data(), num);
+      double ref_absmax = ms(start);
+      start = std::chrono::steady_clock::now();
+      MLUOP_CHECK(getPositionAndScale(data.data(), num, MLUOP_DTYPE_INT8,
+                                      &position, &scale));
+      double absmax_time = ms(start);
+
+      start = std::chrono::steady_clock::now();
+      refMinMax(data.data(), num, &min_data, &max_data);
+      volatile float range = max_data - min_data;
+      double ref_minmax = ms(start);
+      start = std::chrono::steady_clock::now();
+      MLUOP_CHECK(getPositionScaleAndOffset(data.data(), num, MLUOP_DTYPE_INT8,
+                                            &position, &scale, &offset));
+      double minmax_time = ms(start);
+
+      start = std::chrono::steady_clock::now();
+      refCastFloat32ToInt31(data.data(), num, int31.data());
+      double ref_int31 = ms(start);
+      start = std::chrono::steady_clock::now();
+      MLUOP_CHECK(castFloat32ToInt31(data.data(), num, int31.data()));
+      double int31_time = ms(start);
+      (void)absmax;
+      (void)range;
+
+      std::cout << "[quant_param] num " << num << ", absmax " << ref_absmax
+                << " -> " << absmax_time << " ms, minmax " << ref_minmax
+                << " -> " << minmax_time << " ms, int31 " << ref_int31
+                << " -> " << int31_time << " ms" << std::endl;
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in quant_param";
+  }
+}
+}  // namespace mluopapitest
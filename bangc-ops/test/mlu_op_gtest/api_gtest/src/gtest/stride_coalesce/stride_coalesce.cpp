@@ -0,0 +1,354 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/logging.h"
+#include "core/stride_coalesce.h"
+#include "core/tensor.h"
+#include "gtest/gtest.h"
+#include "kernels/tensor_stride_process/tensor_stride_process.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+class stride_coalesce : public testing::Test {
+ public:
+  void SetUp() {
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&input_desc_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&output_desc_));
+  }
+
+  void TearDown() {
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(input_desc_));
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(output_desc_));
+  }
+
+ protected:
+  // the offsets of every operand, element by element in row major order.
+  static std::vector<std::vector<int64_t>> offsets(
+      int dim, const int64_t *dims,
+      const std::vector<std::vector<int64_t>> &strides) {
+    int64_t total = 1;
+    for (int i = 0; i < dim; ++i) {
+      total *= dims[i];
+    }
+    std::vector<std::vector<int64_t>> result(total);
+    std::vector<int64_t> index(dim, 0);
+    for (int64_t n = 0; n < total; ++n) {
+      for (const auto &s : strides) {
+        int64_t offset = 0;
+        for (int i = 0; i < dim; ++i) {
+          offset += index[i] * s[i];
+        }
+        result[n].push_back(offset);
+      }
+      for (int i = dim - 1; i >= 0 && ++index[i] == dims[i]; --i) {
+        index[i] = 0;
+      }
+    }
+    return result;
+  }
+
+  // dims of size 1 to 4, strides of a permuted layout with gaps, broadcast
+  // and duplicated strides now and then.
+  static void randomShape(std::mt19937 &gen, int operand_num,
+                          std::vector<int64_t> *dims,
+                          std::vector<std::vector<int64_t>> *strides) {
+    int dim = 1 + gen() % MLUOP_DIM_MAX;
+    dims->resize(dim);
+    for (auto &d : *dims) {
+      d = gen() % 3 ? 1 + gen() % 4 : 1;
+    }
+    strides->assign(operand_num, std::vector<int64_t>(dim));
+    for (auto &s : *strides) {
+      std::vector<int> order(dim);
+      for (int i = 0; i < dim; ++i) {
+        order[i] = i;
+      }
+      if (gen() % 2) {
+        std::shuffle(order.begin(), order.end(), gen);
+      }
+      int64_t base = 1;
+      for (int i = dim - 1; i >= 0; --i) {
+        s[order[i]] = gen() % 10 == 0 ? 0 : base;
+        base *= (*dims)[order[i]] + (gen() % 6 == 0 ? 1 : 0);
+      }
+    }
+  }
+
+  mluOpTensorDescriptor_t input_desc_ = NULL;
+  mluOpTensorDescriptor_t output_desc_ = NULL;
+};
+
+TEST_F(stride_coalesce, coalesce_dims) {
+  try {
+    // contiguous with unit dims collapses to one dim.
+    std::vector<int64_t> dims = {2, 1, 3, 4, 1};
+    std::vector<int64_t> strides = {12, 7, 4, 1, 9};
+    EXPECT_EQ(mluop::coalesceDims(5, dims.data(), strides.data()), 1);
+    EXPECT_EQ(dims[0], 24);
+    EXPECT_EQ(strides[0], 1);
+
+    // a slice of the last dim keeps the dims on both sides of the gap.
+    dims = {2, 3, 4, 5};
+    strides = {180, 60, 15, 3};
+    EXPECT_EQ(mluop::coalesceDims(4, dims.data(), strides.data()), 1);
+    dims = {2, 3, 4, 5};
+    strides = {144, 48, 12, 1};
+    EXPECT_EQ(mluop::coalesceDims(4, dims.data(), strides.data()), 2);
+    EXPECT_EQ(dims[0], 24);
+    EXPECT_EQ(dims[1], 5);
+    EXPECT_EQ(strides[0], 12);
+    EXPECT_EQ(strides[1], 1);
+
+    // adjacent broadcast dims merge.
+    dims = {4, 5, 6};
+    strides = {0, 0, 1};
+    EXPECT_EQ(mluop::coalesceDims(3, dims.data(), strides.data()), 2);
+    EXPECT_EQ(dims[0], 20);
+    EXPECT_EQ(strides[0], 0);
+
+    // all unit dims, and a zero element tensor.
+    dims = {1, 1};
+    strides = {5, 5};
+    EXPECT_EQ(mluop::coalesceDims(2, dims.data(), strides.data()), 0);
+    dims = {3, 0, 2};
+    strides = {2, 2, 1};
+    EXPECT_EQ(mluop::coalesceDims(3, dims.data(), strides.data()), 1);
+    EXPECT_EQ(dims[0], 0);
+
+    // operands only merge dims which are contiguous in all of them.
+    dims = {2, 3, 4};
+    std::vector<int64_t> a = {12, 4, 1};
+    std::vector<int64_t> b = {1, 8, 3};
+    int64_t *operands[2] = {a.data(), b.data()};
+    EXPECT_EQ(mluop::coalesceDims(3, dims.data(), operands, 2), 3);
+    dims = {2, 3, 4};
+    a = {12, 4, 1};
+    b = {24, 8, 2};
+    EXPECT_EQ(mluop::coalesceDims(3, dims.data(), operands, 2), 1);
+    EXPECT_EQ(dims[0], 24);
+    EXPECT_EQ(b[0], 2);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in stride_coalesce";
+  }
+}
+
+TEST_F(stride_coalesce, canonicalize_transpose) {
+  try {
+    // NCHW -> NHWC copy: out(N, H, W, C) contiguous, in is a permuted view.
+    std::vector<int64_t> dims = {2, 8, 8, 3};
+    std::vector<int64_t> out = {192, 24, 3, 1};
+    std::vector<int64_t> in = {192, 8, 1, 64};
+    int64_t *strides[2] = {out.data(), in.data()};
+    EXPECT_EQ(mluop::canonicalizeDims(4, dims.data(), strides, 2), 3);
+    EXPECT_EQ(dims[0], 2);
+    EXPECT_EQ(dims[1], 64);
+    EXPECT_EQ(dims[2], 3);
+    EXPECT_EQ(in[1], 1);
+    EXPECT_EQ(in[2], 64);
+
+    // ties of the key are ordered by the next operand.
+    dims = {3, 4};
+    out = {0, 0};
+    in = {1, 3};
+    EXPECT_EQ(mluop::canonicalizeDims(2, dims.data(), strides, 2), 1);
+    EXPECT_EQ(dims[0], 12);
+    EXPECT_EQ(in[0], 1);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in stride_coalesce";
+  }
+}
+
+TEST_F(stride_coalesce, match_reference) {
+  try {
+    std::mt19937 gen(2022);
+    for (int iter = 0; iter < 5000; ++iter) {
+      const int operand_num = 1 + iter % 3;
+      std::vector<int64_t> dims;
+      std::vector<std::vector<int64_t>> strides;
+      randomShape(gen, operand_num, &dims, &strides);
+      const int dim = dims.size();
+      auto ref = offsets(dim, dims.data(), strides);
+
+      // coalescing keeps every element at its place in the order.
+      std::vector<int64_t> c_dims = dims;
+      std::vector<std::vector<int64_t>> c_strides = strides;
+      std::vector<int64_t *> ptrs;
+      for (auto &s : c_strides) {
+        ptrs.push_back(s.data());
+      }
+      int c_dim =
+          mluop::coalesceDims(dim, c_dims.data(), ptrs.data(), operand_num);
+      ASSERT_LE(c_dim, dim);
+      ASSERT_EQ(offsets(c_dim, c_dims.data(), c_strides), ref);
+
+      // canonicalizing keeps the element mapping between operands.
+      c_dims = dims;
+      c_strides = strides;
+      c_dim =
+          mluop::canonicalizeDims(dim, c_dims.data(), ptrs.data(), operand_num);
+      auto result = offsets(c_dim, c_dims.data(), c_strides);
+      std::sort(ref.begin(), ref.end());
+      std::sort(result.begin(), result.end());
+      ASSERT_EQ(result, ref);
+      for (int i = 1; i < c_dim; ++i) {
+        ASSERT_GE(c_strides[0][i - 1], c_strides[0][i]);
+      }
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in stride_coalesce";
+  }
+}
+
+TEST_F(stride_coalesce, copy_tensor_shape) {
+  try {
+    // a 9 dims copy fits the stride kernel once coalesced.
+    std::vector<int64_t> dims = {2, 1, 3, 1, 4, 1, 5, 1, 6};
+    std::vector<int64_t> in_strides = {720, 1, 120, 1, 30, 1, 6, 1, 1};
+    in_strides[0] = 1440;  // a gap between the two highest dims
+    MLUOP_CHECK(mluOpSetTensorDescriptorEx_v2(
+        input_desc_, MLUOP_LAYOUT_ARRAY, MLUOP_DTYPE_FLOAT, 9, dims.data(),
+        in_strides.data()));
+    MLUOP_CHECK(mluOpSetTensorDescriptor_v2(
+        output_desc_, MLUOP_LAYOUT_ARRAY, MLUOP_DTYPE_FLOAT, 9, dims.data()));
+    TensorShape in_shape;
+    TensorShape out_shape;
+    MLUOP_CHECK(getCopyTensorShape(input_desc_, output_desc_, &in_shape,
+                                   &out_shape));
+    EXPECT_FALSE(in_shape.is_contiguous);
+    EXPECT_TRUE(out_shape.is_contiguous);
+    EXPECT_EQ(in_shape.total_num, 720);
+    EXPECT_EQ(out_shape.total_num, 720);
+    for (int i = 0; i < MLUOP_DIM_MAX - 2; ++i) {
+      EXPECT_EQ(in_shape.tensor_dims[i], 1);
+    }
+    EXPECT_EQ(in_shape.tensor_dims[MLUOP_DIM_MAX - 2], 2);
+    EXPECT_EQ(in_shape.tensor_dims[MLUOP_DIM_MAX - 1], 360);
+    EXPECT_EQ(in_shape.tensor_strides[MLUOP_DIM_MAX - 2], 1440);
+    EXPECT_EQ(out_shape.tensor_strides[MLUOP_DIM_MAX - 2], 360);
+
+    // a reshaping copy coalesces each side on its own.
+    std::vector<int64_t> out_dims = {6, 120};
+    MLUOP_CHECK(mluOpSetTensorDescriptor_v2(
+        output_desc_, MLUOP_LAYOUT_ARRAY, MLUOP_DTYPE_FLOAT, 2,
+        out_dims.data()));
+    MLUOP_CHECK(getCopyTensorShape(input_desc_, output_desc_, &in_shape,
+                                   &out_shape));
+    EXPECT_EQ(in_shape.tensor_dims[MLUOP_DIM_MAX - 1], 360);
+    EXPECT_EQ(out_shape.tensor_dims[MLUOP_DIM_MAX - 1], 720);
+    EXPECT_EQ(out_shape.tensor_dims[MLUOP_DIM_MAX - 2], 1);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in stride_coalesce";
+  }
+}
+
+// views frameworks commonly hand to a strided copy, with the rank left for
+// the device to walk after coalescing.
+struct FrameworkView {
+  std::string name;
+  std::vector<int64_t> dims;
+  std::vector<int64_t> in_strides;
+  int coalesced_rank;
+};
+
+static const std::vector<FrameworkView> &frameworkViews() {
+  static const std::vector<FrameworkView> views = {
+      {"NCHW to NHWC", {8, 56, 56, 64}, {200704, 56, 1, 3136}, 3},
+      {"NHWC to NCHW", {8, 64, 56, 56}, {200704, 1, 3584, 64}, 3},
+      {"transpose last 2", {16, 12, 128, 64}, {98304, 8192, 1, 128}, 3},
+      {"slice of last dim", {32, 128, 512}, {196608, 1536, 1}, 2},
+      {"unsqueeze expand", {16, 1, 197, 768}, {768, 768, 0, 1}, 3},
+      {"narrow channels", {4, 3, 224, 224}, {301056, 50176, 224, 1}, 2},
+      {"split heads", {8, 197, 12, 64}, {453888, 2304, 64, 1}, 2},
+      {"channels last 3d",
+       {2, 16, 8, 32, 32},
+       {131072, 1, 16384, 512, 16},
+       3},
+  };
+  return views;
+}
+
+TEST_F(stride_coalesce, framework_views) {
+  try {
+    TensorShape in_shape;
+    TensorShape out_shape;
+    for (const auto &view : frameworkViews()) {
+      const int dim = view.dims.size();
+      MLUOP_CHECK(mluOpSetTensorDescriptorEx_v2(
+          input_desc_, MLUOP_LAYOUT_ARRAY, MLUOP_DTYPE_FLOAT, dim,
+          view.dims.data(), view.in_strides.data()));
+      MLUOP_CHECK(mluOpSetTensorDescriptor_v2(output_desc_, MLUOP_LAYOUT_ARRAY,
+                                              MLUOP_DTYPE_FLOAT, dim,
+                                              view.dims.data()));
+      MLUOP_CHECK(getCopyTensorShape(input_desc_, output_desc_, &in_shape,
+                                     &out_shape));
+      int rank = 0;
+      for (int i = 0; i < MLUOP_DIM_MAX; ++i) {
+        rank += in_shape.tensor_dims[i] != 1;
+      }
+      EXPECT_EQ(rank, view.coalesced_rank) << view.name;
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in stride_coalesce";
+  }
+}
+
+// Prints the host time of planning the shapes of the views above. This is a
+// benchmark, disabled unless --gtest_also_run_disabled_tests is given.
+TEST_F(stride_coalesce, DISABLED_framework_views_host_time) {
+  try {
+    const int loop = 100000;
+    TensorShape in_shape;
+    TensorShape out_shape;
+    for (const auto &view : frameworkViews()) {
+      const int dim = view.dims.size();
+      MLUOP_CHECK(mluOpSetTensorDescriptorEx_v2(
+          input_desc_, MLUOP_LAYOUT_ARRAY, MLUOP_DTYPE_FLOAT, dim,
+          view.dims.data(), view.in_strides.data()));
+      MLUOP_CHECK(mluOpSetTensorDescriptor_v2(output_desc_, MLUOP_LAYOUT_ARRAY,
+                                              MLUOP_DTYPE_FLOAT, dim,
+                                              view.dims.data()));
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < loop; ++i) {
+        MLUOP_CHECK(getCopyTensorShape(input_desc_, output_desc_, &in_shape,
+                                       &out_shape));
+      }
+      double ns = std::chrono::duration<double, std::nano>(
+                      std::chrono::steady_clock::now() - start)
+                      .count() /
+                  loop;
+      std::cout << "[stride_coalesce] " << view.name << ": rank " << dim
+                << " -> " << view.coalesced_rank << ", " << ns << " ns"
+                << std::endl;
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in stride_coalesce";
+  }
+}
+}  // namespace mluopapitest
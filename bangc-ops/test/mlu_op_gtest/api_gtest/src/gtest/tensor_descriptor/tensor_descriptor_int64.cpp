@@ -0,0 +1,238 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <cstring>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/logging.h"
+#include "core/runtime/chunked_launch.h"
+#include "core/runtime/launch_plan_cache.h"
+#include "core/tensor.h"
+#include "gtest/gtest.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+class tensor_descriptor_int64 : public testing::Test {
+ public:
+  void SetUp() { MLUOP_CHECK(mluOpCreateTensorDescriptor(&desc_)); }
+
+  void TearDown() { MLUOP_CHECK(mluOpDestroyTensorDescriptor(desc_)); }
+
+ protected:
+  mluOpTensorDescriptor_t desc_ = NULL;
+};
+
+TEST_F(tensor_descriptor_int64, set_get_large_dims) {
+  try {
+    const int64_t large = ((int64_t)1 << 31) + 5;
+    std::vector<int64_t> dims = {3, large};
+    MLUOP_CHECK(mluOpSetTensorDescriptor_v2(desc_, MLUOP_LAYOUT_ARRAY,
+                                            MLUOP_DTYPE_HALF, 2, dims.data()));
+    EXPECT_EQ(mluOpGetTensorElementNum(desc_), (size_t)(3 * large));
+    EXPECT_EQ(desc_->total_tensor_size, (uint64_t)(3 * large * 2));
+    EXPECT_TRUE(desc_->dims_overflow_int32);
+    EXPECT_EQ(desc_->dims[1], INT32_MAX);
+
+    mluOpTensorLayout_t layout;
+    mluOpDataType_t dtype;
+    int dim = 0;
+    int64_t get_dims[2] = {0};
+    int64_t get_strides[2] = {0};
+    MLUOP_CHECK(mluOpGetTensorDescriptorEx_v2(desc_, &layout, &dtype, &dim,
+                                              get_dims, get_strides));
+    EXPECT_EQ(layout, MLUOP_LAYOUT_ARRAY);
+    EXPECT_EQ(dtype, MLUOP_DTYPE_HALF);
+    EXPECT_EQ(dim, 2);
+    EXPECT_EQ(get_dims[0], 3);
+    EXPECT_EQ(get_dims[1], large);
+    EXPECT_EQ(get_strides[0], large);
+    EXPECT_EQ(get_strides[1], 1);
+
+    // the int getters can not describe the tensor.
+    int int_dims[2] = {0};
+    int int_strides[2] = {0};
+    EXPECT_EQ(mluOpGetTensorDescriptor(desc_, &layout, &dtype, &dim, int_dims),
+              MLUOP_STATUS_NOT_SUPPORTED);
+    EXPECT_EQ(mluOpGetTensorDescriptorEx(desc_, &layout, &dtype, &dim,
+                                         int_dims, int_strides),
+              MLUOP_STATUS_NOT_SUPPORTED);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in tensor_descriptor_int64";
+  }
+}
+
+TEST_F(tensor_descriptor_int64, int_dims_large_element_num) {
+  try {
+    // every dim fits in int, but the element number and the highest stride
+    // do not.
+    std::vector<int> dims = {2, 2, 1 << 30};
+    MLUOP_CHECK(mluOpSetTensorDescriptor(desc_, MLUOP_LAYOUT_ARRAY,
+                                         MLUOP_DTYPE_FLOAT, 3, dims.data()));
+    EXPECT_EQ(mluOpGetTensorElementNum(desc_), (size_t)1 << 32);
+    EXPECT_EQ(desc_->strides_int64[0], (int64_t)1 << 31);
+    EXPECT_EQ(desc_->strides_int64[1], (int64_t)1 << 30);
+    EXPECT_TRUE(desc_->dims_overflow_int32);
+
+    int dim = 0;
+    int get_dims[3] = {0};
+    MLUOP_CHECK(mluOpGetTensorDescriptor(desc_, NULL, NULL, &dim, get_dims));
+    EXPECT_EQ(dim, 3);
+    EXPECT_EQ(get_dims[2], 1 << 30);
+
+    int64_t get_dims_int64[3] = {0};
+    MLUOP_CHECK(
+        mluOpGetTensorDescriptor_v2(desc_, NULL, NULL, &dim, get_dims_int64));
+    EXPECT_EQ(get_dims_int64[0], 2);
+    EXPECT_EQ(get_dims_int64[2], 1 << 30);
+
+    // a small shape afterwards clears the overflow state.
+    dims = {2, 3};
+    MLUOP_CHECK(mluOpSetTensorDescriptor(desc_, MLUOP_LAYOUT_ARRAY,
+                                         MLUOP_DTYPE_FLOAT, 2, dims.data()));
+    EXPECT_FALSE(desc_->dims_overflow_int32);
+    EXPECT_EQ(desc_->strides[0], 3);
+    EXPECT_EQ(desc_->strides_int64[0], 3);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in tensor_descriptor_int64";
+  }
+}
+
+TEST_F(tensor_descriptor_int64, ex_v2_more_than_dim_max) {
+  try {
+    const int dim_num = MLUOP_DIM_MAX + 2;
+    std::vector<int64_t> dims(dim_num, 1);
+    std::vector<int64_t> strides(dim_num, 1);
+    dims[0] = 5;
+    strides[0] = (int64_t)3 << 32;
+    MLUOP_CHECK(mluOpSetTensorDescriptorEx_v2(desc_, MLUOP_LAYOUT_ARRAY,
+                                              MLUOP_DTYPE_INT8, dim_num,
+                                              dims.data(), strides.data()));
+    EXPECT_TRUE(desc_->dims_int64 == desc_->larger_dims_int64);
+    EXPECT_TRUE(desc_->dims == desc_->larger_dims);
+    EXPECT_EQ(mluOpGetTensorElementNum(desc_), 5u);
+    EXPECT_EQ(desc_->strides_int64[0], (int64_t)3 << 32);
+    EXPECT_EQ(desc_->strides[0], INT32_MAX);
+
+    // the larger storage is released when fewer dims are set again.
+    std::vector<int> small_dims = {4};
+    std::vector<int> small_strides = {2};
+    MLUOP_CHECK(mluOpSetTensorDescriptorEx(desc_, MLUOP_LAYOUT_ARRAY,
+                                           MLUOP_DTYPE_INT8, 1,
+                                           small_dims.data(),
+                                           small_strides.data()));
+    EXPECT_TRUE(desc_->larger_dims_int64 == NULL);
+    EXPECT_TRUE(desc_->dims_int64 == desc_->normal_dims_int64);
+    EXPECT_EQ(desc_->strides_int64[0], 2);
+    EXPECT_FALSE(desc_->dims_overflow_int32);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in tensor_descriptor_int64";
+  }
+}
+
+TEST_F(tensor_descriptor_int64, launch_plan_key_uses_int64_dims) {
+  try {
+    // both shapes have the same clamped int views.
+    mluOpTensorDescriptor_t other = NULL;
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&other));
+    std::vector<int64_t> dims = {((int64_t)1 << 31) + 1};
+    MLUOP_CHECK(mluOpSetTensorDescriptor_v2(desc_, MLUOP_LAYOUT_ARRAY,
+                                            MLUOP_DTYPE_INT8, 1, dims.data()));
+    dims[0] += 1;
+    MLUOP_CHECK(mluOpSetTensorDescriptor_v2(other, MLUOP_LAYOUT_ARRAY,
+                                            MLUOP_DTYPE_INT8, 1, dims.data()));
+    EXPECT_EQ(desc_->dims[0], other->dims[0]);
+
+    mluop::runtime::LaunchPlanKey key1("op");
+    mluop::runtime::LaunchPlanKey key2("op");
+    key1.add(desc_);
+    key2.add(other);
+    ASSERT_EQ(key1.size(), key2.size());
+    EXPECT_NE(memcmp(key1.data(), key2.data(), key1.size()), 0);
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(other));
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in tensor_descriptor_int64";
+  }
+}
+
+TEST_F(tensor_descriptor_int64, launch_in_chunks) {
+  try {
+    struct Chunk {
+      int64_t offset;
+      int64_t num;
+    };
+    std::vector<Chunk> chunks;
+    auto record = [&chunks](int64_t offset, int64_t num) {
+      chunks.push_back({offset, num});
+      return MLUOP_STATUS_SUCCESS;
+    };
+
+    MLUOP_CHECK(mluop::runtime::launchInChunks(0, LAUNCH_CHUNK_MAX_NUM,
+                                               record));
+    EXPECT_TRUE(chunks.empty());
+
+    MLUOP_CHECK(mluop::runtime::launchInChunks(1000, LAUNCH_CHUNK_MAX_NUM,
+                                               record));
+    ASSERT_EQ(chunks.size(), 1u);
+    EXPECT_EQ(chunks[0].offset, 0);
+    EXPECT_EQ(chunks[0].num, 1000);
+
+    // 2^32 + 7 elements are split into 3 balanced, aligned chunks.
+    const int64_t total = ((int64_t)1 << 32) + 7;
+    chunks.clear();
+    MLUOP_CHECK(mluop::runtime::launchInChunks(total, LAUNCH_CHUNK_MAX_NUM,
+                                               record));
+    ASSERT_EQ(chunks.size(), 3u);
+    int64_t expect_offset = 0;
+    for (const auto &chunk : chunks) {
+      EXPECT_EQ(chunk.offset, expect_offset);
+      EXPECT_EQ(chunk.offset % LAUNCH_CHUNK_ALIGN_NUM, 0);
+      EXPECT_GT(chunk.num, 0);
+      EXPECT_LE(chunk.num, LAUNCH_CHUNK_MAX_NUM);
+      EXPECT_LT(chunk.num, (int64_t)LARGE_TENSOR_NUM);
+      expect_offset += chunk.num;
+    }
+    EXPECT_EQ(expect_offset, total);
+    EXPECT_EQ(chunks[0].num, chunks[1].num);
+
+    // the first failed launch stops the rest.
+    int calls = 0;
+    auto fail = [&calls](int64_t offset, int64_t num) {
+      ++calls;
+      return MLUOP_STATUS_EXECUTION_FAILED;
+    };
+    EXPECT_EQ(mluop::runtime::launchInChunks(total, LAUNCH_CHUNK_MAX_NUM, fail),
+              MLUOP_STATUS_EXECUTION_FAILED);
+    EXPECT_EQ(calls, 1);
+
+    float data[4] = {0};
+    EXPECT_EQ(mluop::runtime::elementOffset(data, 3, sizeof(float)),
+              (void *)(data + 3));
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in tensor_descriptor_int64";
+  }
+}
+}  // namespace mluopapitest
@@ -0,0 +1,205 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+#include "api_test_tools.h"
+#include "core/logging.h"
+#include "core/tensor.h"
+#include "gtest/gtest.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+class tensor_descriptor_pool : public testing::Test {
+ public:
+  // creates, sets and destroys `desc_num` descriptors `loop` times, returns
+  // the number of descriptors handled per second.
+  static double runPool(int thread_num, int loop, int desc_num) {
+    return run(thread_num, [loop, desc_num]() {
+      std::vector<mluOpTensorDescriptor_t> descs(desc_num, NULL);
+      std::vector<int> dims = {2, 3, 4, 5};
+      for (int i = 0; i < loop; ++i) {
+        for (auto &desc : descs) {
+          MLUOP_CHECK(mluOpCreateTensorDescriptor(&desc));
+          MLUOP_CHECK(mluOpSetTensorDescriptor(desc, MLUOP_LAYOUT_ARRAY,
+                                               MLUOP_DTYPE_FLOAT, 4,
+                                               dims.data()));
+        }
+        for (auto &desc : descs) {
+          MLUOP_CHECK(mluOpDestroyTensorDescriptor(desc));
+        }
+      }
+    }) * loop * desc_num;
+  }
+
+  // the same work with descriptors on the heap, as it was before the pool.
+  static double runHeap(int thread_num, int loop, int desc_num) {
+    return run(thread_num, [loop, desc_num]() {
+      std::vector<std::unique_ptr<mluOpTensorStruct>> descs(desc_num);
+      std::vector<int> dims = {2, 3, 4, 5};
+      for (int i = 0; i < loop; ++i) {
+        for (auto &desc : descs) {
+          desc.reset(new (std::nothrow) mluOpTensorStruct());
+          MLUOP_CHECK(mluOpSetTensorDescriptor(desc.get(), MLUOP_LAYOUT_ARRAY,
+                                               MLUOP_DTYPE_FLOAT, 4,
+                                               dims.data()));
+        }
+        for (auto &desc : descs) {
+          desc->reset();
+          desc.reset();
+        }
+      }
+    }) * loop * desc_num;
+  }
+
+ private:
+  template <typename Func>
+  static double run(int thread_num, Func func) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < thread_num; ++i) {
+      threads.emplace_back(func);
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return thread_num / elapsed.count();
+  }
+};
+
+TEST_F(tensor_descriptor_pool, reuse_as_default) {
+  try {
+    mluOpTensorDescriptor_t desc = NULL;
+    std::vector<int> dims = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&desc));
+    MLUOP_CHECK(mluOpSetTensorDescriptor(desc, MLUOP_LAYOUT_NHWC,
+                                         MLUOP_DTYPE_HALF, 10, dims.data()));
+    MLUOP_CHECK(mluOpSetTensorDescriptorPositionAndScale(desc, 3, 0.5));
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(desc));
+
+    // the slot just destroyed is handed out again by the thread cache.
+    mluOpTensorDescriptor_t reused = NULL;
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&reused));
+    EXPECT_EQ(reused, desc);
+    EXPECT_EQ(reused->dim, 0);
+    EXPECT_EQ(reused->dtype, MLUOP_DTYPE_FLOAT);
+    EXPECT_EQ(reused->layout, MLUOP_LAYOUT_ARRAY);
+    EXPECT_EQ(reused->position, 0);
+    EXPECT_EQ(reused->scale, 1.0f);
+    EXPECT_TRUE(reused->dims == reused->normal_dims);
+    EXPECT_TRUE(reused->larger_dims == NULL);
+    EXPECT_EQ(mluOpGetTensorElementNum(reused), 0u);
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(reused));
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in tensor_descriptor_pool";
+  }
+}
+
+TEST_F(tensor_descriptor_pool, group_create_destroy) {
+  try {
+    const int desc_num = 100;
+    std::vector<mluOpTensorDescriptor_t> descs(desc_num, NULL);
+    std::vector<mluOpTensorDescriptor_t *> group(desc_num);
+    for (int i = 0; i < desc_num; ++i) {
+      group[i] = &descs[i];
+    }
+    MLUOP_CHECK(mluOpCreateGroupTensorDescriptors(group.data(), desc_num));
+    for (int i = 0; i < desc_num; ++i) {
+      ASSERT_TRUE(descs[i] != NULL);
+      for (int j = 0; j < i; ++j) {
+        ASSERT_NE(descs[i], descs[j]);
+      }
+    }
+    MLUOP_CHECK(mluOpDestroyGroupTensorDescriptors(group.data(), desc_num));
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in tensor_descriptor_pool";
+  }
+}
+
+TEST_F(tensor_descriptor_pool, multi_thread_no_alias) {
+  try {
+    const int thread_num = 32;
+    const int desc_num = 300;
+    std::atomic<int> created(0);
+    std::atomic<int> errors(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_num; ++t) {
+      threads.emplace_back([t, &created, &errors]() {
+        std::vector<mluOpTensorDescriptor_t> descs(desc_num, NULL);
+        std::vector<int> dims = {t + 1};
+        for (auto &desc : descs) {
+          MLUOP_CHECK(mluOpCreateTensorDescriptor(&desc));
+          MLUOP_CHECK(mluOpSetTensorDescriptor(desc, MLUOP_LAYOUT_ARRAY,
+                                               MLUOP_DTYPE_INT32, 1,
+                                               dims.data()));
+        }
+        // wait until every thread holds its descriptors.
+        created++;
+        while (created.load() < thread_num) {
+          std::this_thread::yield();
+        }
+        for (auto &desc : descs) {
+          if (desc->dims[0] != t + 1) {
+            errors++;
+          }
+          MLUOP_CHECK(mluOpDestroyTensorDescriptor(desc));
+        }
+      });
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+    EXPECT_EQ(errors.load(), 0);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in tensor_descriptor_pool";
+  }
+}
+
+// Compares the create/set/destroy throughput of the pool with the heap path
+// used before. It only prints numbers, so it is disabled and runs with
+// --gtest_also_run_disabled_tests.
+TEST_F(tensor_descriptor_pool, DISABLED_throughput) {
+  try {
+    const int loop = 20000;
+    const int desc_num = 4;
+    for (int thread_num : {1, 8, 32}) {
+      double pool = runPool(thread_num, loop, desc_num);
+      double heap = runHeap(thread_num, loop, desc_num);
+      std::cout << "[tensor_descriptor_pool] threads: " << thread_num
+                << ", pool: " << pool / 1e6 << " M desc/s"
+                << ", heap: " << heap / 1e6 << " M desc/s" << std::endl;
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in tensor_descriptor_pool";
+  }
+}
+}  // namespace mluopapitest
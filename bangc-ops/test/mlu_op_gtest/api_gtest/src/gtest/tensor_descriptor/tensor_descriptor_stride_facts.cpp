@@ -0,0 +1,303 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/logging.h"
+#include "core/tensor.h"
+#include "gtest/gtest.h"
+#include "kernels/tensor_stride_process/tensor_stride_process.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+class tensor_descriptor_stride_facts : public testing::Test {
+ public:
+  void SetUp() {
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&a_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&b_));
+  }
+
+  void TearDown() {
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(a_));
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(b_));
+  }
+
+ protected:
+  // The scans which stride aware ops ran on every call before the facts
+  // were cached, kept as the reference.
+  static bool refNeedStride(const std::vector<int64_t> &dims,
+                            const std::vector<int64_t> &strides) {
+    int64_t stride_base = 1;
+    for (int i = (int)dims.size() - 1; i >= 0; i--) {
+      if (dims[i] != 1) {
+        if (strides[i] == stride_base) {
+          stride_base *= dims[i];
+        } else {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  static bool refIsDense(const std::vector<int64_t> &dims,
+                         const std::vector<int64_t> &strides) {
+    int tensor_dim = dims.size();
+    std::vector<int> perm(tensor_dim);
+    std::iota(perm.begin(), perm.end(), 0);
+    if (tensor_dim == 1) {
+      return dims[0] < 2 || strides[0] == 1;
+    }
+    std::sort(perm.begin(), perm.end(), [&](int a, int b) {
+      if (dims[a] < 2) {
+        return false;
+      } else if (dims[b] < 2) {
+        return true;
+      }
+      return strides[a] < strides[b];
+    });
+    int64_t require_stride = 1;
+    for (int i = 0; i < tensor_dim; i++) {
+      if (dims[perm[i]] < 2) {
+        return true;
+      }
+      if (strides[perm[i]] != require_stride) {
+        return false;
+      }
+      require_stride *= dims[perm[i]];
+    }
+    return true;
+  }
+
+  static int refCoalescedDim(const std::vector<int64_t> &dims,
+                             const std::vector<int64_t> &strides) {
+    std::vector<int64_t> merged_dims;
+    std::vector<int64_t> merged_strides;
+    for (int i = (int)dims.size() - 1; i >= 0; --i) {
+      if (dims[i] == 1) {
+        continue;
+      }
+      if (!merged_dims.empty() &&
+          strides[i] == merged_strides.back() * merged_dims.back()) {
+        merged_dims.back() *= dims[i];
+      } else {
+        merged_dims.push_back(dims[i]);
+        merged_strides.push_back(strides[i]);
+      }
+    }
+    return std::max<int>(merged_dims.size(), 1);
+  }
+
+  static bool refStrideCase(const std::vector<int64_t> &dims,
+                            const std::vector<int64_t> &a_strides,
+                            const std::vector<int64_t> &b_strides) {
+    if (!refNeedStride(dims, a_strides) && !refNeedStride(dims, b_strides)) {
+      return false;
+    }
+    if (!refIsDense(dims, a_strides)) {
+      return true;
+    }
+    for (size_t j = 0; j < dims.size(); j++) {
+      if (dims[j] != 1 && a_strides[j] != b_strides[j]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // strides of a random layout: permuted, sometimes with gaps, broadcast or
+  // overlapping dims.
+  static std::vector<int64_t> randomStrides(const std::vector<int64_t> &dims,
+                                            std::mt19937 &gen) {
+    int dim = dims.size();
+    std::vector<int> order(dim);
+    std::iota(order.begin(), order.end(), 0);
+    if (gen() % 2) {
+      std::shuffle(order.begin(), order.end(), gen);
+    }
+    std::vector<int64_t> strides(dim);
+    int64_t base = 1;
+    for (int i = dim - 1; i >= 0; --i) {
+      strides[order[i]] = base;
+      base *= dims[order[i]] + (gen() % 8 == 0 ? 1 : 0);  // gap
+    }
+    if (gen() % 6 == 0) {
+      strides[gen() % dim] = 0;  // broadcast
+    }
+    if (gen() % 8 == 0 && dim > 1) {
+      strides[0] = strides[dim - 1];  // overlap
+    }
+    return strides;
+  }
+
+  mluOpTensorDescriptor_t a_ = NULL;
+  mluOpTensorDescriptor_t b_ = NULL;
+};
+
+TEST_F(tensor_descriptor_stride_facts, contiguous_setters) {
+  try {
+    std::vector<int> dims = {2, 1, 3, 4};
+    MLUOP_CHECK(mluOpSetTensorDescriptor(a_, MLUOP_LAYOUT_ARRAY,
+                                         MLUOP_DTYPE_FLOAT, 4, dims.data()));
+    EXPECT_TRUE(a_->is_contiguous);
+    EXPECT_TRUE(a_->is_dense);
+    EXPECT_FALSE(a_->has_broadcast_dims);
+    EXPECT_EQ(a_->coalesced_dim, 1);
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_EQ(a_->dense_perm[i], i);
+    }
+
+    // a transposed view, then a broadcast one on the same descriptor.
+    std::vector<int> strides = {12, 12, 1, 3};
+    MLUOP_CHECK(mluOpSetTensorDescriptorEx(a_, MLUOP_LAYOUT_ARRAY,
+                                           MLUOP_DTYPE_FLOAT, 4, dims.data(),
+                                           strides.data()));
+    EXPECT_FALSE(a_->is_contiguous);
+    EXPECT_TRUE(a_->is_dense);
+    EXPECT_EQ(a_->coalesced_dim, 3);
+    EXPECT_EQ(a_->dense_perm[0], 0);
+    EXPECT_EQ(a_->dense_perm[3], 2);
+
+    strides = {0, 0, 4, 1};
+    MLUOP_CHECK(mluOpSetTensorDescriptorEx(a_, MLUOP_LAYOUT_ARRAY,
+                                           MLUOP_DTYPE_FLOAT, 4, dims.data(),
+                                           strides.data()));
+    EXPECT_FALSE(a_->is_contiguous);
+    EXPECT_FALSE(a_->is_dense);
+    EXPECT_TRUE(a_->has_broadcast_dims);
+    EXPECT_EQ(a_->coalesced_dim, 2);
+
+    MLUOP_CHECK(mluOpResetTensorDescriptor(a_));
+    EXPECT_TRUE(a_->is_contiguous);
+    EXPECT_FALSE(a_->has_broadcast_dims);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in tensor_descriptor_stride_facts";
+  }
+}
+
+TEST_F(tensor_descriptor_stride_facts, match_reference) {
+  try {
+    std::mt19937 gen(2022);
+    for (int iter = 0; iter < 20000; ++iter) {
+      int dim = 1 + gen() % MLUOP_DIM_MAX;
+      std::vector<int64_t> dims(dim);
+      for (auto &d : dims) {
+        d = 1 + gen() % 4;
+      }
+      std::vector<int64_t> a_strides = randomStrides(dims, gen);
+      std::vector<int64_t> b_strides =
+          gen() % 2 ? a_strides : randomStrides(dims, gen);
+      MLUOP_CHECK(mluOpSetTensorDescriptorEx_v2(
+          a_, MLUOP_LAYOUT_ARRAY, MLUOP_DTYPE_FLOAT, dim, dims.data(),
+          a_strides.data()));
+      MLUOP_CHECK(mluOpSetTensorDescriptorEx_v2(
+          b_, MLUOP_LAYOUT_ARRAY, MLUOP_DTYPE_FLOAT, dim, dims.data(),
+          b_strides.data()));
+
+      ASSERT_EQ(a_->is_contiguous, !refNeedStride(dims, a_strides));
+      ASSERT_EQ(a_->is_dense, refIsDense(dims, a_strides));
+      ASSERT_EQ(a_->coalesced_dim, refCoalescedDim(dims, a_strides));
+      bool broadcast = false;
+      for (int i = 0; i < dim; ++i) {
+        broadcast |= dims[i] > 1 && a_strides[i] == 0;
+      }
+      ASSERT_EQ(a_->has_broadcast_dims, broadcast);
+      ASSERT_EQ(strideCaseWithNotConsistentDense(2, a_, b_),
+                refStrideCase(dims, a_strides, b_strides));
+
+      // a dense tensor permuted by dense_perm is contiguous.
+      if (a_->is_dense) {
+        std::vector<int64_t> perm_dims(dim);
+        std::vector<int64_t> perm_strides(dim);
+        for (int i = 0; i < dim; ++i) {
+          perm_dims[i] = dims[a_->dense_perm[i]];
+          perm_strides[i] = a_strides[a_->dense_perm[i]];
+        }
+        ASSERT_FALSE(refNeedStride(perm_dims, perm_strides));
+      }
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in tensor_descriptor_stride_facts";
+  }
+}
+
+// Host time of the descriptor heavy path of a stride aware op: set two
+// strided descriptors and classify them, with the cached facts against the
+// scans which ran on every call before. Disabled as it is a benchmark, see
+// --gtest_also_run_disabled_tests.
+TEST_F(tensor_descriptor_stride_facts, DISABLED_host_overhead) {
+  try {
+    const int loop = 200000;
+    std::vector<int64_t> dims = {8, 16, 3, 32, 2};
+    std::vector<int64_t> strides = {3072, 1, 1024, 32, 16};
+    auto elapsed = [](std::chrono::steady_clock::time_point start) {
+      return std::chrono::duration<double, std::nano>(
+                 std::chrono::steady_clock::now() - start)
+          .count();
+    };
+    // the descriptors are set once per call, reading the facts afterwards
+    // costs nothing, so both paths are measured with the set included.
+    int stride_case = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop; ++i) {
+      MLUOP_CHECK(mluOpSetTensorDescriptorEx_v2(
+          a_, MLUOP_LAYOUT_ARRAY, MLUOP_DTYPE_FLOAT, 5, dims.data(),
+          strides.data()));
+      MLUOP_CHECK(mluOpSetTensorDescriptorEx_v2(
+          b_, MLUOP_LAYOUT_ARRAY, MLUOP_DTYPE_FLOAT, 5, dims.data(),
+          strides.data()));
+      for (int repeat = 0; repeat < 4; ++repeat) {
+        stride_case += strideCaseWithNotConsistentDense(2, a_, b_);
+      }
+    }
+    double cached = elapsed(start) / loop;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop; ++i) {
+      MLUOP_CHECK(mluOpSetTensorDescriptorEx_v2(
+          a_, MLUOP_LAYOUT_ARRAY, MLUOP_DTYPE_FLOAT, 5, dims.data(),
+          strides.data()));
+      MLUOP_CHECK(mluOpSetTensorDescriptorEx_v2(
+          b_, MLUOP_LAYOUT_ARRAY, MLUOP_DTYPE_FLOAT, 5, dims.data(),
+          strides.data()));
+      for (int repeat = 0; repeat < 4; ++repeat) {
+        stride_case += refStrideCase(dims, strides, strides);
+      }
+    }
+    double scanned = elapsed(start) / loop;
+    EXPECT_EQ(stride_case, 0);
+    std::cout << "[tensor_descriptor_stride_facts] set 2 descriptors and "
+              << "classify them 4 times, cached: " << cached
+              << " ns, scanned: " << scanned << " ns" << std::endl;
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what()
+           << " in tensor_descriptor_stride_facts";
+  }
+}
+}  // namespace mluopapitest
@@ -0,0 +1,207 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/gen_case.h"
+#include "core/tensor_file.h"
+#include "gtest/gtest.h"
+
+namespace mluopapitest {
+class tensor_file : public testing::Test {
+ public:
+  void SetUp() {
+    char dir_template[] = "/tmp/mluop_tensor_file_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    dir_ = dir_template;
+  }
+
+  void TearDown() { EXPECT_EQ(system(("rm -rf " + dir_).c_str()), 0); }
+
+ protected:
+  // activations after relu, half of them are zero and the rest are rounded
+  // like the output of a half precision kernel.
+  static std::vector<float> activations(size_t num) {
+    std::mt19937 gen(233);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> data(num);
+    for (auto &value : data) {
+      value = castHalfToFloat32(castFloat32ToHalf(std::max(0.0f, dist(gen))));
+    }
+    return data;
+  }
+
+  static size_t fileSize(const std::string &file_name) {
+    struct stat st;
+    return stat(file_name.c_str(), &st) == 0 ? st.st_size : 0;
+  }
+
+  static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+  }
+
+  std::string dir_;
+};
+
+TEST_F(tensor_file, round_trip) {
+  try {
+    // sizes around the chunk boundary
+    std::vector<size_t> nums = {0, 1, 1000, TENSOR_FILE_CHUNK_SIZE / 4,
+                                TENSOR_FILE_CHUNK_SIZE / 4 + 3,
+                                TENSOR_FILE_CHUNK_SIZE / 2 + 12345};
+    for (bool compress : {false, true}) {
+      for (size_t num : nums) {
+        std::vector<float> src = activations(num);
+        std::string file_name = dir_ + "/data";
+        ASSERT_EQ(MLUOP_STATUS_SUCCESS,
+                  mluop::writeTensorFile(file_name, src.data(),
+                                         num * sizeof(float), compress));
+        std::vector<float> dst(num + 1, -1.0f);
+        ASSERT_EQ(MLUOP_STATUS_SUCCESS,
+                  mluop::readTensorFile(file_name, dst.data(),
+                                        num * sizeof(float)));
+        EXPECT_EQ(0, memcmp(src.data(), dst.data(), num * sizeof(float)));
+        EXPECT_EQ(-1.0f, dst[num]);
+        // a prefix of the tensor can be read too
+        if (num > 1) {
+          std::vector<float> prefix(num / 2);
+          ASSERT_EQ(MLUOP_STATUS_SUCCESS,
+                    mluop::readTensorFile(file_name, prefix.data(),
+                                          prefix.size() * sizeof(float)));
+          EXPECT_EQ(0, memcmp(src.data(), prefix.data(),
+                              prefix.size() * sizeof(float)));
+        }
+      }
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in tensor_file";
+  }
+}
+
+TEST_F(tensor_file, plain_binary_file) {
+  try {
+    std::vector<float> src = activations(4096);
+    std::string file_name = dir_ + "/plain";
+    std::ofstream file(file_name, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(src.data()),
+               src.size() * sizeof(float));
+    file.close();
+    std::vector<float> dst(src.size());
+    ASSERT_EQ(MLUOP_STATUS_SUCCESS,
+              mluop::readTensorFile(file_name, dst.data(),
+                                    dst.size() * sizeof(float)));
+    EXPECT_EQ(src, dst);
+    std::vector<float> larger(src.size() + 1);
+    EXPECT_NE(MLUOP_STATUS_SUCCESS,
+              mluop::readTensorFile(file_name, larger.data(),
+                                    larger.size() * sizeof(float)));
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in tensor_file";
+  }
+}
+
+TEST_F(tensor_file, broken_file) {
+  try {
+    size_t num = TENSOR_FILE_CHUNK_SIZE / 2;
+    std::vector<float> src = activations(num);
+    std::string file_name = dir_ + "/broken";
+    ASSERT_EQ(MLUOP_STATUS_SUCCESS,
+              mluop::writeTensorFile(file_name, src.data(),
+                                     num * sizeof(float), true));
+    ASSERT_EQ(0, truncate(file_name.c_str(), fileSize(file_name) - 100));
+    std::vector<float> dst(num);
+    EXPECT_NE(MLUOP_STATUS_SUCCESS,
+              mluop::readTensorFile(file_name, dst.data(),
+                                    num * sizeof(float)));
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in tensor_file";
+  }
+}
+
+// Compares the value_f text of prototxt with the binary files, for a tensor
+// of MLUOP_TENSOR_FILE_BENCH_NUM floats, 4M by default. Being a benchmark it
+// is disabled, pass --gtest_also_run_disabled_tests to print the numbers.
+TEST_F(tensor_file, DISABLED_benchmark) {
+  try {
+    size_t num = 4 << 20;
+    const char *env = std::getenv("MLUOP_TENSOR_FILE_BENCH_NUM");
+    if (env != nullptr) {
+      num = std::strtoull(env, nullptr, 10);
+    }
+    std::vector<float> src = activations(num);
+    std::vector<float> dst(num);
+    size_t bytes = num * sizeof(float);
+
+    std::string text_name = dir_ + "/text";
+    auto start = std::chrono::steady_clock::now();
+    {
+      std::ofstream text(text_name);
+      std::string prefix =
+          mluop::gen_case::PbNode::get_dtype_value_string(MLUOP_DTYPE_FLOAT);
+      for (size_t i = 0; i < num; ++i) {
+        text << prefix
+             << mluop::gen_case::PbNode::get_data_string(MLUOP_DTYPE_FLOAT,
+                                                         src.data(), i)
+             << "\n";
+      }
+    }
+    double text_write = secondsSince(start);
+    std::cout << "[tensor_file] " << bytes / 1e6 << " MB of float, text: "
+              << fileSize(text_name) / 1e6 << " MB, write " << text_write
+              << " s" << std::endl;
+
+    for (bool compress : {false, true}) {
+      if (compress && !mluop::tensorFileCompressionSupported()) {
+        std::cout << "[tensor_file] zstd: not built with MLUOP_BUILD_ZSTD"
+                  << std::endl;
+        continue;
+      }
+      std::string file_name = dir_ + (compress ? "/zstd" : "/raw");
+      start = std::chrono::steady_clock::now();
+      ASSERT_EQ(MLUOP_STATUS_SUCCESS,
+                mluop::writeTensorFile(file_name, src.data(), bytes, compress));
+      double write = secondsSince(start);
+      start = std::chrono::steady_clock::now();
+      ASSERT_EQ(MLUOP_STATUS_SUCCESS,
+                mluop::readTensorFile(file_name, dst.data(), bytes));
+      double read = secondsSince(start);
+      ASSERT_EQ(src, dst);
+      std::cout << "[tensor_file] " << (compress ? "zstd" : "raw") << ": "
+                << fileSize(file_name) / 1e6 << " MB, write " << write
+                << " s, read " << read << " s" << std::endl;
+    }
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in tensor_file";
+  }
+}
+}  // namespace mluopapitest
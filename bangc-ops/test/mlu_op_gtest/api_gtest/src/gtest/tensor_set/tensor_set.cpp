@@ -0,0 +1,166 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/logging.h"
+#include "core/tensor.h"
+#include "gtest/gtest.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+class tensor_set : public testing::Test {
+ public:
+  void TearDown() {
+    if (set_ != NULL) {
+      MLUOP_CHECK(mluOpDestroyTensorSetDescriptor(set_));
+      set_ = NULL;
+    }
+  }
+
+ protected:
+  // a set of [layer_num, direction] members, member i has i % 7 + 1 floats
+  // times `scale`.
+  void createSet(int layer_num, int direction, int scale) {
+    int set_dims[2] = {layer_num, direction};
+    MLUOP_CHECK(mluOpCreateTensorSetDescriptor(&set_, 2, set_dims));
+    for (int l = 0; l < layer_num; ++l) {
+      for (int d = 0; d < direction; ++d) {
+        int index[2] = {l, d};
+        int dims[2] = {(l * direction + d) % 7 + 1, scale};
+        MLUOP_CHECK(mluOpInitTensorSetMemberDescriptor(
+            set_, 2, index, MLUOP_LAYOUT_ARRAY, MLUOP_DTYPE_FLOAT, 2, dims));
+      }
+    }
+  }
+
+  // the offset of member `index`, summing the sizes of the members before it.
+  size_t refOffset(int index) {
+    size_t offset = 0;
+    for (int i = 0; i < index; ++i) {
+      size_t size = 0;
+      set_->tensor_set[i]->tensorSize(size);
+      offset += size;
+    }
+    return offset;
+  }
+
+  mluOpTensorSetDescriptor_t set_ = NULL;
+};
+
+TEST_F(tensor_set, offsets) {
+  try {
+    createSet(5, 2, 3);
+    char *base = NULL;
+    for (int l = 0; l < 5; ++l) {
+      for (int d = 0; d < 2; ++d) {
+        int index[2] = {l, d};
+        mluOpTensorDescriptor_t desc = NULL;
+        void *addr = NULL;
+        MLUOP_CHECK(mluOpGetTensorAndDataFromTensorSet(set_, 2, index, base,
+                                                       &desc, &addr));
+        EXPECT_EQ((size_t)((char *)addr - base), refOffset(l * 2 + d));
+        EXPECT_EQ(desc, set_->tensor_set[l * 2 + d].get());
+      }
+    }
+    int size = 0;
+    MLUOP_CHECK(mluOpGetTensorSetDescriptorSize(set_, &size));
+    EXPECT_EQ((size_t)size, refOffset(10));
+
+    // changing a member moves the offsets after it.
+    int index[2] = {1, 0};
+    int dims[1] = {100};
+    MLUOP_CHECK(mluOpInitTensorSetMemberDescriptor(
+        set_, 2, index, MLUOP_LAYOUT_ARRAY, MLUOP_DTYPE_HALF, 1, dims));
+    std::vector<size_t> offsets = set_->getDataOffsets();
+    ASSERT_EQ(offsets.size(), (size_t)10);
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(offsets[i], refOffset(i));
+    }
+    MLUOP_CHECK(mluOpGetTensorSetDescriptorSize(set_, &size));
+    EXPECT_EQ((size_t)size, refOffset(10));
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in tensor_set";
+  }
+}
+
+TEST_F(tensor_set, offsets_past_2GB) {
+  try {
+    // 8 members of 1 to 7 GB, offsets and the size do not fit in int.
+    createSet(4, 2, 1 << 28);
+    std::vector<size_t> offsets = set_->getDataOffsets();
+    for (int i = 0; i < 8; ++i) {
+      EXPECT_EQ(offsets[i], refOffset(i));
+    }
+    EXPECT_GT(offsets[7], (size_t)INT32_MAX);
+    int size = 0;
+    EXPECT_EQ(mluOpGetTensorSetDescriptorSize(set_, &size),
+              MLUOP_STATUS_NOT_SUPPORTED);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in tensor_set";
+  }
+}
+
+// Looks up every member of a 10k member set through the prefix sums, and
+// times it against summing the sizes before each member as the lookup did
+// before. A benchmark, so disabled; --gtest_also_run_disabled_tests runs it.
+TEST_F(tensor_set, DISABLED_lookup_10k_members) {
+  try {
+    const int layer_num = 5000;
+    createSet(layer_num, 2, 16);
+    auto elapsed = [](std::chrono::steady_clock::time_point start) {
+      return std::chrono::duration<double, std::micro>(
+                 std::chrono::steady_clock::now() - start)
+          .count();
+    };
+    char *base = NULL;
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int l = 0; l < layer_num; ++l) {
+      for (int d = 0; d < 2; ++d) {
+        int index[2] = {l, d};
+        mluOpTensorDescriptor_t desc = NULL;
+        void *addr = NULL;
+        MLUOP_CHECK(mluOpGetTensorAndDataFromTensorSet(set_, 2, index, base,
+                                                       &desc, &addr));
+        checksum += (char *)addr - base;
+      }
+    }
+    double prefix = elapsed(start);
+
+    size_t ref_checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < layer_num * 2; ++i) {
+      ref_checksum += refOffset(i);
+    }
+    double scanned = elapsed(start);
+    EXPECT_EQ(checksum, ref_checksum);
+    std::cout << "[tensor_set] look up " << layer_num * 2
+              << " members, prefix sums: " << prefix
+              << " us, summed per lookup: " << scanned << " us" << std::endl;
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in tensor_set";
+  }
+}
+}  // namespace mluopapitest
@@ -0,0 +1,143 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "api_test_tools.h"
+#include "core/context.h"
+#include "core/logging.h"
+#include "core/runtime/device.h"
+#include "gtest/gtest.h"
+#include "kernels/kernel.h"
+#include "kernels/unary_op/unary_op_host.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+class virtual_device : public testing::Test {
+ public:
+  void TearDown() { MLUOP_CHECK(mluOpSetVirtualDevice(NULL)); }
+
+ protected:
+  const std::string profile_path_ = "./mluop_virtual_device_profile.txt";
+};
+
+TEST_F(virtual_device, preset) {
+  try {
+    mluOpHandle_t handle = NULL;
+    MLUOP_CHECK(mluOpSetVirtualDevice("mlu290"));
+    MLUOP_CHECK(mluOpCreate(&handle));
+    EXPECT_TRUE(handle->is_virtual_device);
+    EXPECT_EQ(handle->arch, MLUOP_MLU290);
+    EXPECT_EQ(mluop::runtime::getClusterLimitCapability(handle), 16);
+    EXPECT_EQ(mluop::runtime::getCoreNumOfEachUnionCapability(handle), 4);
+    EXPECT_EQ(mluop::runtime::getJobLimitCapabilityCnrtFuncType(handle),
+              CNRT_FUNC_TYPE_UNION16);
+    EXPECT_EQ(mluop::runtime::getMaxParallelJobNum(handle,
+                                                   CNRT_FUNC_TYPE_BLOCK),
+              64);
+    EXPECT_EQ(mluop::runtime::getMaxParallelJobNum(handle,
+                                                   CNRT_FUNC_TYPE_UNION4),
+              4);
+    MLUOP_CHECK(mluOpUpdateContextInformation(handle));
+
+    // host side planning works without a device.
+    mluOpTensorDescriptor_t x_desc = NULL;
+    int dims[2] = {1024, 1024};
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&x_desc));
+    MLUOP_CHECK(mluOpSetTensorDescriptor(x_desc, MLUOP_LAYOUT_ARRAY,
+                                         MLUOP_DTYPE_FLOAT, 2, dims));
+    cnrtDim3_t k_dim;
+    cnrtFunctionType_t k_type;
+    unaryOpPolicyFunc(handle, x_desc, &k_dim, &k_type);
+    EXPECT_EQ(k_type, CNRT_FUNC_TYPE_UNION1);
+    EXPECT_EQ(k_dim.x, 4u);
+    EXPECT_EQ(k_dim.y, 16u);
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(x_desc));
+    MLUOP_CHECK(mluOpDestroy(handle));
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in virtual_device";
+  }
+}
+
+TEST_F(virtual_device, profile_file) {
+  try {
+    std::ofstream profile(profile_path_);
+    profile << "# MLU370 restricted to two clusters\n"
+            << "preset = MLU370\n"
+            << "capability_cluster_num = 2  # cnSetCtxConfigParam\n"
+            << "job_num_block = 6\n";
+    profile.close();
+
+    mluOpHandle_t handle = NULL;
+    MLUOP_CHECK(mluOpSetVirtualDevice(profile_path_.c_str()));
+    MLUOP_CHECK(mluOpCreate(&handle));
+    EXPECT_EQ(handle->arch, MLUOP_MLU370);
+    EXPECT_EQ(handle->cluster_num, 8);
+    EXPECT_EQ(handle->nram_size, 768 * 1024 - REM_FOR_STACK);
+    EXPECT_EQ(mluop::runtime::getClusterLimitCapability(handle), 2);
+    EXPECT_EQ(mluop::runtime::getJobLimitCapabilityCnrtFuncType(handle),
+              CNRT_FUNC_TYPE_UNION2);
+    EXPECT_EQ(mluop::runtime::getMaxParallelJobNum(handle,
+                                                   CNRT_FUNC_TYPE_BLOCK),
+              6);
+    EXPECT_EQ(mluop::runtime::getMaxParallelJobNum(handle,
+                                                   CNRT_FUNC_TYPE_UNION1),
+              2);
+    EXPECT_EQ(mluop::runtime::getMaxParallelJobNum(handle,
+                                                   CNRT_FUNC_TYPE_UNION4),
+              0);
+    MLUOP_CHECK(mluOpDestroy(handle));
+    std::remove(profile_path_.c_str());
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in virtual_device";
+  }
+}
+
+TEST_F(virtual_device, bad_profile) {
+  try {
+    EXPECT_TRUE(MLUOP_STATUS_BAD_PARAM ==
+                mluOpSetVirtualDevice("./not_exist_profile.txt"));
+
+    std::ofstream profile(profile_path_);
+    profile << "name = MLU270\n"
+            << "cluster_num = 4\n"
+            << "core_num_per_cluster = 4\n"
+            << "nram_size = 524288\n"
+            << "capability_cluster_num = 8\n";
+    profile.close();
+    // more clusters are visible than the device has.
+    EXPECT_TRUE(MLUOP_STATUS_BAD_PARAM ==
+                mluOpSetVirtualDevice(profile_path_.c_str()));
+
+    profile.open(profile_path_);
+    profile << "preset = MLU270\n"
+            << "ipu_num = 16\n";
+    profile.close();
+    EXPECT_TRUE(MLUOP_STATUS_BAD_PARAM ==
+                mluOpSetVirtualDevice(profile_path_.c_str()));
+    std::remove(profile_path_.c_str());
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in virtual_device";
+  }
+}
+}  // namespace mluopapitest
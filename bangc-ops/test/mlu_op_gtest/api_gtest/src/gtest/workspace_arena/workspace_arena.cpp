@@ -0,0 +1,175 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <cstdint>
+#include <string>
+#include "api_test_tools.h"
+#include "core/context.h"
+#include "core/logging.h"
+#include "core/runtime/workspace_arena.h"
+#include "gtest/gtest.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+// Hands out fake device addresses and records how the arena uses it, so the
+// bookkeeping of WorkspaceArena can be checked without touching MLU memory.
+class FakeDeviceAllocator : public mluop::runtime::DeviceAllocator {
+ public:
+  mluOpStatus_t allocate(size_t size, void **ptr) override {
+    *ptr = (void *)next_address_;
+    next_address_ += size + 0x1000;
+    alloc_count_++;
+    alloc_bytes_ += size;
+    return MLUOP_STATUS_SUCCESS;
+  }
+  mluOpStatus_t deallocate(void *ptr) override {
+    free_count_++;
+    return MLUOP_STATUS_SUCCESS;
+  }
+  mluOpStatus_t synchronize(cnrtQueue_t queue) override {
+    sync_count_++;
+    return MLUOP_STATUS_SUCCESS;
+  }
+
+  int alloc_count_ = 0;
+  int free_count_ = 0;
+  int sync_count_ = 0;
+  size_t alloc_bytes_ = 0;
+
+ private:
+  uintptr_t next_address_ = 0x10000;
+};
+
+class workspace_arena : public testing::Test {
+ protected:
+  FakeDeviceAllocator allocator_;
+  cnrtQueue_t queue_ = NULL;
+};
+
+TEST_F(workspace_arena, bump_allocate) {
+  try {
+    mluop::runtime::WorkspaceArena arena(&allocator_, 1 << 20);
+    void *ptr0 = NULL;
+    void *ptr1 = NULL;
+    EXPECT_TRUE(MLUOP_STATUS_SUCCESS == arena.reserve(1024, queue_));
+    EXPECT_TRUE(MLUOP_STATUS_SUCCESS == arena.allocate(100, &ptr0, queue_));
+    EXPECT_TRUE(MLUOP_STATUS_SUCCESS == arena.allocate(200, &ptr1, queue_));
+    EXPECT_EQ((char *)ptr1 - (char *)ptr0, WORKSPACE_ARENA_ALIGN_SIZE);
+    EXPECT_EQ(arena.used(), 384u);
+    EXPECT_EQ(arena.capacity(), 1024u);
+    EXPECT_EQ(allocator_.alloc_count_, 1);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in workspace_arena";
+  }
+}
+
+TEST_F(workspace_arena, reset_reuses_block) {
+  try {
+    mluop::runtime::WorkspaceArena arena(&allocator_, 1 << 20);
+    void *ptr0 = NULL;
+    void *ptr1 = NULL;
+    EXPECT_TRUE(MLUOP_STATUS_SUCCESS == arena.allocate(512, &ptr0, queue_));
+    EXPECT_TRUE(MLUOP_STATUS_SUCCESS == arena.reset(queue_));
+    EXPECT_EQ(arena.used(), 0u);
+    EXPECT_TRUE(MLUOP_STATUS_SUCCESS == arena.allocate(512, &ptr1, queue_));
+    EXPECT_EQ(ptr0, ptr1);
+    EXPECT_EQ(allocator_.alloc_count_, 1);
+    EXPECT_EQ(allocator_.sync_count_, 0);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in workspace_arena";
+  }
+}
+
+TEST_F(workspace_arena, grow_and_merge_to_high_water_mark) {
+  try {
+    mluop::runtime::WorkspaceArena arena(&allocator_, 1 << 20);
+    void *ptr = NULL;
+    EXPECT_TRUE(MLUOP_STATUS_SUCCESS == arena.reserve(512, queue_));
+    EXPECT_TRUE(MLUOP_STATUS_SUCCESS == arena.allocate(200, &ptr, queue_));
+    // does not fit, the 512 bytes block is retired but still in use.
+    EXPECT_TRUE(MLUOP_STATUS_SUCCESS == arena.allocate(512, &ptr, queue_));
+    EXPECT_EQ(allocator_.alloc_count_, 2);
+    EXPECT_EQ(allocator_.free_count_, 0);
+    EXPECT_EQ(arena.capacity(), 1024u);
+    EXPECT_EQ(arena.highWaterMark(), 768u);
+
+    // the retired block is freed after the queue is synchronized.
+    EXPECT_TRUE(MLUOP_STATUS_SUCCESS == arena.reset(queue_));
+    EXPECT_EQ(allocator_.sync_count_, 1);
+    EXPECT_EQ(allocator_.free_count_, 1);
+
+    // the high-water mark fits into one block now.
+    EXPECT_TRUE(MLUOP_STATUS_SUCCESS == arena.allocate(768, &ptr, queue_));
+    EXPECT_EQ(allocator_.alloc_count_, 2);
+
+    EXPECT_TRUE(MLUOP_STATUS_SUCCESS == arena.release(queue_));
+    EXPECT_EQ(allocator_.free_count_, 2);
+    EXPECT_EQ(arena.capacity(), 0u);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in workspace_arena";
+  }
+}
+
+TEST_F(workspace_arena, ALLOC_FAILED_overflow_limit) {
+  try {
+    mluop::runtime::WorkspaceArena arena(&allocator_, 1024);
+    void *ptr = NULL;
+    EXPECT_TRUE(MLUOP_STATUS_SUCCESS == arena.allocate(1024, &ptr, queue_));
+    EXPECT_TRUE(MLUOP_STATUS_ALLOC_FAILED ==
+                arena.allocate(1, &ptr, queue_));
+    EXPECT_TRUE(ptr == NULL);
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in workspace_arena";
+  }
+}
+
+TEST_F(workspace_arena, handle_enable_and_disable) {
+  try {
+    mluOpHandle_t handle = NULL;
+    size_t capacity = 0;
+    size_t high_water_mark = 0;
+    MLUOP_CHECK(mluOpCreate(&handle));
+    MLUOP_CHECK(mluOpEnableWorkspaceArena(handle, 4096));
+    MLUOP_CHECK(
+        mluOpGetWorkspaceArenaInfo(handle, &capacity, &high_water_mark));
+    EXPECT_EQ(capacity, 4096u);
+    EXPECT_EQ(high_water_mark, 0u);
+    MLUOP_CHECK(mluOpDisableWorkspaceArena(handle));
+    MLUOP_CHECK(
+        mluOpGetWorkspaceArenaInfo(handle, &capacity, &high_water_mark));
+    EXPECT_EQ(capacity, 0u);
+    MLUOP_CHECK(mluOpDestroy(handle));
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in workspace_arena";
+  }
+}
+
+TEST_F(workspace_arena, BAD_PARAM_handle_null) {
+  try {
+    EXPECT_TRUE(MLUOP_STATUS_BAD_PARAM ==
+                mluOpEnableWorkspaceArena(NULL, 4096));
+    EXPECT_TRUE(MLUOP_STATUS_BAD_PARAM == mluOpDisableWorkspaceArena(NULL));
+  } catch (const std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in workspace_arena";
+  }
+}
+}  // namespace mluopapitest
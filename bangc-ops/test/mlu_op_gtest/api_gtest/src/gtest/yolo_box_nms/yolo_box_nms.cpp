@@ -0,0 +1,140 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <iostream>
+#include <vector>
+#include "api_test_tools.h"
+#include "core/logging.h"
+#include "core/tensor.h"
+#include "gtest/gtest.h"
+#include "mlu_op.h"
+
+namespace mluopapitest {
+class yolo_box_nms : public testing::Test {
+ public:
+  void SetUp() {
+    setDevice("MLU370");
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&x_desc_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&img_size_desc_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&anchors_desc_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&output_desc_));
+    MLUOP_CHECK(mluOpCreateTensorDescriptor(&output_num_desc_));
+    // 2 images of 3 anchors, 4 classes on a 5 x 6 grid.
+    setDesc(x_desc_, MLUOP_DTYPE_FLOAT, {2, 27, 5, 6});
+    setDesc(img_size_desc_, MLUOP_DTYPE_INT32, {2, 2});
+    setDesc(anchors_desc_, MLUOP_DTYPE_INT32, {6});
+    setDesc(output_desc_, MLUOP_DTYPE_FLOAT, {2, 10, 6});
+    setDesc(output_num_desc_, MLUOP_DTYPE_INT32, {2});
+  }
+
+  void TearDown() {
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(x_desc_));
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(img_size_desc_));
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(anchors_desc_));
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(output_desc_));
+    MLUOP_CHECK(mluOpDestroyTensorDescriptor(output_num_desc_));
+    MLUOP_CHECK(mluOpDestroy(handle_));
+    MLUOP_CHECK(mluOpSetVirtualDevice(NULL));
+  }
+
+ protected:
+  // a handle of a virtual device, MLU370 has 8 clusters of 4 cores.
+  void setDevice(const char *device) {
+    if (handle_ != NULL) {
+      MLUOP_CHECK(mluOpDestroy(handle_));
+    }
+    MLUOP_CHECK(mluOpSetVirtualDevice(device));
+    MLUOP_CHECK(mluOpCreate(&handle_));
+  }
+
+  void setDesc(mluOpTensorDescriptor_t desc, mluOpDataType_t dtype,
+               std::vector<int> dims) {
+    MLUOP_CHECK(mluOpSetTensorDescriptor(desc, MLUOP_LAYOUT_ARRAY, dtype,
+                                         dims.size(), dims.data()));
+  }
+
+  // calls with NULL data, the parameters are checked before any launch.
+  mluOpStatus_t compute(float score_thresh) {
+    return mluOpYoloBoxNms(handle_, x_desc_, NULL, img_size_desc_, NULL,
+                           anchors_desc_, NULL, 4, 0.01, 8, true, 1.0, false,
+                           0.5, score_thresh, 0.45, 10, NULL, 0, output_desc_,
+                           NULL, output_num_desc_, NULL);
+  }
+
+  mluOpHandle_t handle_ = NULL;
+  mluOpTensorDescriptor_t x_desc_ = NULL;
+  mluOpTensorDescriptor_t img_size_desc_ = NULL;
+  mluOpTensorDescriptor_t anchors_desc_ = NULL;
+  mluOpTensorDescriptor_t output_desc_ = NULL;
+  mluOpTensorDescriptor_t output_num_desc_ = NULL;
+};
+
+TEST_F(yolo_box_nms, workspace_size) {
+  try {
+    size_t size = 0;
+    // a core per image: the decoded cells and the candidates of a class,
+    // 13 rows of 3 * 5 * 6 boxes, and 3 rows of 4 * 10 kept boxes.
+    EXPECT_EQ(MLUOP_STATUS_SUCCESS,
+              mluOpGetYoloBoxNmsWorkspaceSize(handle_, x_desc_, anchors_desc_,
+                                              4, 10, &size));
+    EXPECT_EQ(2 * (13 * 90 + 3 * 40) * 4, size);
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM,
+              mluOpGetYoloBoxNmsWorkspaceSize(handle_, x_desc_, anchors_desc_,
+                                              4, 0, &size));
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM,
+              mluOpGetYoloBoxNmsWorkspaceSize(handle_, x_desc_, anchors_desc_,
+                                              0, 10, &size));
+    setDesc(x_desc_, MLUOP_DTYPE_FLOAT, {2, 27, 30});
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM,
+              mluOpGetYoloBoxNmsWorkspaceSize(handle_, x_desc_, anchors_desc_,
+                                              4, 10, &size));
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in yolo_box_nms";
+  }
+}
+
+TEST_F(yolo_box_nms, param_check) {
+  try {
+    // the shapes are valid, then the NULL pointers are caught.
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute(0.05));
+    // a cell below conf_thresh scores 0 and must not pass score_thresh.
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute(-0.1));
+    setDesc(output_desc_, MLUOP_DTYPE_FLOAT, {2, 10, 4});
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute(0.05));
+    setDesc(output_desc_, MLUOP_DTYPE_FLOAT, {2, 10, 6});
+    setDesc(output_num_desc_, MLUOP_DTYPE_FLOAT, {2});
+    EXPECT_EQ(MLUOP_STATUS_BAD_PARAM, compute(0.05));
+    setDesc(output_num_desc_, MLUOP_DTYPE_INT32, {2});
+    setDevice("MLU270");
+    EXPECT_EQ(MLUOP_STATUS_ARCH_MISMATCH, compute(0.05));
+    setDevice("MLU370");
+    // an empty batch has nothing to write.
+    setDesc(x_desc_, MLUOP_DTYPE_FLOAT, {0, 27, 5, 6});
+    setDesc(img_size_desc_, MLUOP_DTYPE_INT32, {0, 2});
+    setDesc(output_desc_, MLUOP_DTYPE_FLOAT, {0, 10, 6});
+    setDesc(output_num_desc_, MLUOP_DTYPE_INT32, {0});
+    EXPECT_EQ(MLUOP_STATUS_SUCCESS, compute(0.05));
+  } catch (std::exception &e) {
+    FAIL() << "MLUOPAPITEST: catched " << e.what() << " in yolo_box_nms";
+  }
+}
+}  // namespace mluopapitest
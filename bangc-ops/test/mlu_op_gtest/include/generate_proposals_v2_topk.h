@@ -0,0 +1,129 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef TEST_MLU_OP_GTEST_INCLUDE_GENERATE_PROPOSALS_V2_TOPK_H_
+#define TEST_MLU_OP_GTEST_INCLUDE_GENERATE_PROPOSALS_V2_TOPK_H_
+#include <float.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#define TOPK_RADIX_BITS 8
+#define TOPK_RADIX_BINS (1 << TOPK_RADIX_BITS)
+
+/* maps a score to a key with the same order as the scores, -0.0 and 0.0 get
+ * the same key. The device kernel searches the same keys in 4-bit digits to
+ * find the k-th score of mluOpGenerateProposalsV2.
+ * */
+inline uint32_t generateProposalsV2ScoreKey(const float score) {
+  uint32_t bits = 0;
+  const float value = score == 0.0f ? 0.0f : score;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/* the pre_nms_top_n stage of mluOpGenerateProposalsV2 as a repeated max
+ * scan: k times the first max score of scores is picked and replaced by
+ * -FLT_MAX. index gets the k picked indices in picking order.
+ * */
+inline void generateProposalsV2TopKByMaxScan(const float *scores, const int n,
+                                             const int k, int32_t *index) {
+  if (n <= 0) {
+    return;
+  }
+  std::vector<float> temp_scores(scores, scores + n);
+  for (int top_id = 0; top_id < k; ++top_id) {
+    int max_score_id = 0;
+    for (int i = 1; i < n; ++i) {
+      if (temp_scores[i] > temp_scores[max_score_id]) {
+        max_score_id = i;
+      }
+    }
+    temp_scores[max_score_id] = -FLT_MAX;
+    index[top_id] = max_score_id;
+  }
+}
+
+/* the same result as generateProposalsV2TopKByMaxScan in O(n + k * log(k)):
+ * a radix select finds the k-th score, the scores above it and the first
+ * scores equal to it are compacted, then sorted by score descending and
+ * index ascending. Falls back to the max scan when a score is NaN or not
+ * above -FLT_MAX, where the scan does not follow that order.
+ * */
+inline void generateProposalsV2TopK(const float *scores, const int n,
+                                    const int k, int32_t *index) {
+  if (n <= 0 || k <= 0) {
+    return;
+  }
+  for (int i = 0; i < n; ++i) {
+    if (std::isnan(scores[i]) || scores[i] <= -FLT_MAX) {
+      generateProposalsV2TopKByMaxScan(scores, n, k, index);
+      return;
+    }
+  }
+
+  std::vector<uint32_t> keys(n);
+  for (int i = 0; i < n; ++i) {
+    keys[i] = generateProposalsV2ScoreKey(scores[i]);
+  }
+
+  // select the k-th largest key digit by digit, remain is the rank of it
+  // among the keys sharing the selected prefix.
+  const int top_num = std::min(k, n);
+  uint32_t prefix = 0;
+  uint32_t prefix_mask = 0;
+  int remain = top_num;
+  for (int shift = 32 - TOPK_RADIX_BITS; shift >= 0;
+       shift -= TOPK_RADIX_BITS) {
+    int hist[TOPK_RADIX_BINS] = {0};
+    for (int i = 0; i < n; ++i) {
+      if ((keys[i] & prefix_mask) == prefix) {
+        ++hist[(keys[i] >> shift) & (TOPK_RADIX_BINS - 1)];
+      }
+    }
+    int digit = TOPK_RADIX_BINS - 1;
+    while (hist[digit] < remain) {
+      remain -= hist[digit];
+      --digit;
+    }
+    prefix |= (uint32_t)digit << shift;
+    prefix_mask |= (uint32_t)(TOPK_RADIX_BINS - 1) << shift;
+  }
+
+  // keys above the k-th key, and the first `remain` keys equal to it.
+  int top_id = 0;
+  for (int i = 0; i < n; ++i) {
+    if (keys[i] > prefix) {
+      index[top_id++] = i;
+    } else if (keys[i] == prefix && remain > 0) {
+      index[top_id++] = i;
+      --remain;
+    }
+  }
+  std::sort(index, index + top_num, [&keys](int32_t a, int32_t b) {
+    return keys[a] != keys[b] ? keys[a] > keys[b] : a < b;
+  });
+}
+#endif  // TEST_MLU_OP_GTEST_INCLUDE_GENERATE_PROPOSALS_V2_TOPK_H_
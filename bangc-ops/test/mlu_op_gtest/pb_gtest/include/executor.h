@@ -49,16 +49,8 @@ namespace mluoptest {
 
 const int interface_time_repeat = 4;
 
-// io bandwidth GB/s
-const float IO_BANDWIDTH_MLU220 = 25.6;
-const float IO_BANDWIDTH_MLU270 = 102.4;
-const float IO_BANDWIDTH_MLU290 = 1024;
-const float IO_BANDWIDTH_MLU370 = 307.2;
-
-// mlu270 mlu220 mlu290 ct peak compute force is same;
-const int CT_PEAK_FLOAT16_COMPUTE_FORCE = 64;
-const int CT_PEAK_FLOAT32_COMPUTE_FORCE = 32;
-const int CT_PEAK_ELSE_COMPUTE_FORCE = 64;
+// io bandwidth and ct peak compute force come from the library cost model,
+// see core/runtime/cost_model.h.
 
 const int LT_PEAK_INT4_INT4_COMPUTE_FORCE_270_290 = 2 * 8192;
 const int LT_PEAK_INT8_INT4_COMPUTE_FORCE_270_290 = 2 * 4096;
@@ -322,6 +314,11 @@ class Executor {
                    int off = 0);
 
   virtual int64_t getTheoryOps() { return -1; }
+  // theory ops of the library cost model of the op, see mluOpGetOpCostModel.
+  // descs are the tensors in the order of the op api, -1 if the op has no
+  // cost function.
+  int64_t getCostModelTheoryOps(
+      const std::vector<mluOpTensorDescriptor_t> &descs);
   virtual int64_t getTheoryIoSize();
   virtual std::vector<int> getCriterionsUse() { return criterions_use_; }
 
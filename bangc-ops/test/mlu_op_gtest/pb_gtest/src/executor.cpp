@@ -29,6 +29,7 @@
 #include <utility>
 #include "executor.h"
 #include "time.h"
+#include "core/runtime/cost_model.h"
 #include "core/runtime/device.h"
 
 #define GTEST_DEBUG_ENABLE 0
@@ -384,19 +385,9 @@ double Executor::getCtPeakComputeForce() {
               "but now input num is < 1.");
 
   // ct peak compute force
-  auto cluster_num =
-      mluop::runtime::getClusterLimitCapability(exe_context_->handle);
-  auto core_num = exe_context_->handle->core_num_per_cluster;
-  switch (parser_->inputs()[0].dtype) {
-    case MLUOP_DTYPE_HALF:
-    case MLUOP_DTYPE_INT16:
-      return CT_PEAK_FLOAT16_COMPUTE_FORCE * cluster_num * core_num;
-    case MLUOP_DTYPE_FLOAT:
-    case MLUOP_DTYPE_INT32:
-      return CT_PEAK_FLOAT32_COMPUTE_FORCE * cluster_num * core_num;
-    default:
-      return CT_PEAK_FLOAT32_COMPUTE_FORCE * cluster_num * core_num;
-  }
+  return mluop::runtime::getPeakComputeForce(exe_context_->handle,
+                                             parser_->inputs()[0].dtype) /
+         (1000 * 1000 * 1000);
 }
 
 double Executor::getLtPeakComputeForce() {
@@ -475,30 +466,31 @@ int64_t Executor::getTheoryIoSize() {
 }
 
 double Executor::getIoBandwidth() {
-  double io_bandwidth = -1;
-  auto platform = exe_context_->handle->arch;
-  switch (platform) {
-    case MLUOP_MLU220:
-      io_bandwidth = IO_BANDWIDTH_MLU220;
-      break;
-    case MLUOP_MLU270:
-      io_bandwidth = IO_BANDWIDTH_MLU270;
-      break;
-    case MLUOP_MLU290:
-      io_bandwidth = IO_BANDWIDTH_MLU290;
-      break;
-    case MLUOP_MLU370:
-      io_bandwidth = IO_BANDWIDTH_MLU370;
-      break;
-    default:
-      LOG(WARNING) << "Executor: got unsupported arch when get io bandwidth.";
+  double io_bandwidth = mluop::runtime::getIoBandwidth(exe_context_->handle);
+  if (io_bandwidth < 0) {
+    LOG(WARNING) << "Executor: got unsupported arch when get io bandwidth.";
   }
-  auto cluster_num =
-      mluop::runtime::getClusterLimitCapability(exe_context_->handle);
   VLOG(4) << "Executor: io bandwidth is " << io_bandwidth << " GB/s";
   return io_bandwidth;
 }
 
+int64_t Executor::getCostModelTheoryOps(
+    const std::vector<mluOpTensorDescriptor_t> &descs) {
+  mluOpOpCost_t cost;
+  mluOpStatus_t status = mluOpGetOpCostModel(
+      exe_context_->handle, parser_->getOpName().c_str(), (int)descs.size(),
+      descs.data(), &cost);
+  if (status != MLUOP_STATUS_SUCCESS) {
+    LOG(WARNING) << "Executor: " << parser_->getOpName()
+                 << " has no cost model, status is "
+                 << mluOpGetErrorString(status) << ".";
+    return -1;
+  }
+  VLOG(4) << "Executor: cost model estimates " << cost.theory_ops << " ops, "
+          << cost.theory_io_bytes << " bytes, " << cost.latency_us << " us";
+  return cost.theory_ops;
+}
+
 // create tensor desc
 // and put them in 1 vector, but output tensor's is_output is true.
 // and saved desc in MetaTensor's tensor and ctx->tensors
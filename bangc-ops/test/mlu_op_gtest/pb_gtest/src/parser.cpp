@@ -29,6 +29,7 @@
 #include <functional>
 #include "pb_test_tools.h"
 #include "parser.h"
+#include "core/tensor_file.h"
 
 namespace mluoptest {
 
@@ -570,14 +571,13 @@ void Parser::getTensorValueRandom(Tensor *pt, float *data, size_t count) {
   }
 }
 
-// get value by random data param
+// get value by data file, plain binary file and chunked file dumped by
+// MLUOP_GEN_CASE_DUMP_DATA_FILE=2 are both supported.
 void Parser::getTensorValueByFile(Tensor *pt, float *data, size_t count) {
-  // readDataFromFile(pt->path(), data, count);
   auto cur_pb_path = pb_path_ + pt->path();
-  std::ifstream fin(cur_pb_path, std::ios::in | std::ios::binary);
   size_t tensor_length = count * getTensorSize(pt);
-  fin.read((char *)data, tensor_length);
-  if (!fin) {
+  if (MLUOP_STATUS_SUCCESS !=
+      mluop::readTensorFile(cur_pb_path, data, tensor_length)) {
     LOG(ERROR) << "read data in file failed.";
     throw std::invalid_argument(std::string(__FILE__) + "+" +
                                 std::to_string(__LINE__));
@@ -21,6 +21,7 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  *************************************************************************/
 #include "pb_test_tools.h"
+#include "core/tool.h"
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -468,9 +469,8 @@ size_t proc_usage_peak() {
 }
 
 void arrayCastFloatToHalf(int16_t *dst, float *src, int num) {
-  for (int i = 0; i < num; ++i) {
-    dst[i] = cvtFloatToHalf(src[i]);
-  }
+  // same as cvtFloatToHalf element by element.
+  arrayCastFloat32ToHalf(src, dst, num > 0 ? num : 0);
 }
 
 void arrayCastFloatToInt64(int64_t *dst, float *src, int num) {
@@ -480,9 +480,8 @@ void arrayCastFloatToInt64(int64_t *dst, float *src, int num) {
 }
 
 void arrayCastHalfToFloat(float *dst, int16_t *src, int num) {
-  for (int i = 0; i < num; ++i) {
-    dst[i] = cvtHalfToFloat(src[i]);
-  }
+  // same as cvtHalfToFloat element by element.
+  arrayCastHalfToFloat32(src, dst, num > 0 ? num : 0);
 }
 
 template <typename T1, typename T2>
@@ -37,6 +37,29 @@ void BallQueryExecutor::paramCheck() {
               "[BallQueryExecutor] output number is wrong. ");
 }
 
+void BallQueryExecutor::workspaceMalloc() {
+  if (!parser_->getProtoNode()->ball_query_param().use_grid()) {
+    return;
+  }
+  auto new_xyz_desc = tensor_desc_[0].tensor;
+  auto xyz_desc = tensor_desc_[1].tensor;
+  MLUOP_CHECK(mluOpGetBallQueryGridWorkspaceSize(
+      handle_, new_xyz_desc, xyz_desc, &workspace_size_));
+  VLOG(4) << "Malloc workspace space.";
+  void *temp = mlu_runtime_.allocate(workspace_size_);
+  workspace_.push_back(temp);
+  VLOG(4) << "Malloc addr: " << temp << " , size: " << workspace_size_;
+  eva_->setMluWorkspaceSize(workspace_size_);
+}
+
+void BallQueryExecutor::workspaceFree() {
+  if (!workspace_.empty() && workspace_[0]) {
+    VLOG(4) << "Free device workspace space.";
+    GTEST_CHECK(CNRT_RET_SUCCESS == mlu_runtime_.deallocate(workspace_[0]));
+    workspace_[0] = nullptr;
+  }
+}
+
 void BallQueryExecutor::compute() {
   auto new_xyz_desc = tensor_desc_[0].tensor;
   auto new_xyz_ptr = data_vector_[0].device_ptr;
@@ -54,9 +77,16 @@ void BallQueryExecutor::compute() {
   size_t output_total_bytes = data_vector_[2].count * sizeof(int32_t);
   GTEST_CHECK(CNRT_RET_SUCCESS == cnrtMemset(idx_ptr, 0, output_total_bytes));
   interface_timer_.start();
-  MLUOP_CHECK(mluOpBallQuery(handle_, new_xyz_desc, new_xyz_ptr, xyz_desc,
-                             xyz_ptr, min_radius_, max_radius_, nsample_,
-                             idx_desc, idx_ptr));
+  if (parser_->getProtoNode()->ball_query_param().use_grid()) {
+    MLUOP_CHECK(mluOpBallQueryGrid(handle_, new_xyz_desc, new_xyz_ptr,
+                                   xyz_desc, xyz_ptr, min_radius_, max_radius_,
+                                   nsample_, workspace_[0], workspace_size_,
+                                   idx_desc, idx_ptr));
+  } else {
+    MLUOP_CHECK(mluOpBallQuery(handle_, new_xyz_desc, new_xyz_ptr, xyz_desc,
+                               xyz_ptr, min_radius_, max_radius_, nsample_,
+                               idx_desc, idx_ptr));
+  }
   interface_timer_.stop();
   data_vector_[2].is_output = true;
 }
@@ -30,9 +30,11 @@ namespace mluoptest {
 class BallQueryExecutor : public Executor {
  public:
   BallQueryExecutor() {}
-  ~BallQueryExecutor() {}
+  ~BallQueryExecutor() { workspaceFree(); }
 
   void paramCheck();
+  void workspaceMalloc() override;
+  void workspaceFree() override;
   void compute();
   void cpuCompute();
   int64_t getTheoryOps() override;
@@ -41,6 +43,7 @@ class BallQueryExecutor : public Executor {
   float min_radius_;
   float max_radius_;
   int nsample_;
+  size_t workspace_size_ = 0;
 };
 }  // namespace mluoptest
 
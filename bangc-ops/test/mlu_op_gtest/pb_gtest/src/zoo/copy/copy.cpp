@@ -75,7 +75,8 @@ void CopyExecutor::cpuCompute() {
 }
 
 int64_t CopyExecutor::getTheoryOps() {
-  int64_t theory_ops = parser_->input(0)->total_count;
+  int64_t theory_ops = getCostModelTheoryOps(
+      {tensor_desc_[0].tensor, tensor_desc_[1].tensor});
   VLOG(4) << "getTheoryOps: " << theory_ops << " ops";
   return theory_ops;
 }
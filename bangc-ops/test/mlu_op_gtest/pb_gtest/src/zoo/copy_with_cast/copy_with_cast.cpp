@@ -0,0 +1,112 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "copy_with_cast.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace mluoptest {
+
+void CopyWithCastExecutor::paramCheck() {
+  GTEST_CHECK(parser_->inputs().size() == 1,
+              "copy_with_cast input number is wrong.");
+  GTEST_CHECK(parser_->outputs().size() == 1,
+              "copy_with_cast output number is wrong.");
+}
+
+void CopyWithCastExecutor::compute() {
+  VLOG(4) << "CopyWithCastExecutor compute ";
+
+  auto input_desc = tensor_desc_[0].tensor;
+  auto output_desc = tensor_desc_[1].tensor;
+  auto dev_input = data_vector_[0].device_ptr;
+  auto dev_output = data_vector_[1].device_ptr;
+
+  VLOG(4) << "call mluOpCopyWithCast()";
+  interface_timer_.start();
+  MLUOP_CHECK(mluOpCopyWithCast(handle_, input_desc, dev_input, output_desc,
+                                dev_output));
+  interface_timer_.stop();
+}
+
+// rounds value to an integer as the kernel does for round_mode, NaN becomes
+// zero and the result saturates to [low, high].
+static float roundToInteger(const float value,
+                            const mluOpQuantizeRoundMode_t round_mode,
+                            const double low, const double high) {
+  if (std::isnan(value)) {
+    return 0;
+  }
+  double result = 0;
+  switch (round_mode) {
+    case MLUOP_ROUND_HALF_UP:
+      result = std::floor((double)value + 0.5);
+      break;
+    case MLUOP_ROUND_HALF_OFF_ZERO:
+      result = std::round((double)value);
+      break;
+    default:
+      result = std::nearbyint((double)value);
+      break;
+  }
+  return (float)(result < low ? low : (result > high ? high : result));
+}
+
+void CopyWithCastExecutor::cpuCompute() {
+  auto count = parser_->input(0)->shape_count;
+  auto output_dtype = parser_->output(0)->dtype;
+  mluOpQuantizeRoundMode_t round_mode;
+  MLUOP_CHECK(mluOpGetQuantizeRoundMode(handle_, &round_mode));
+
+  // inputs are fed as the values the device sees, so only integer outputs
+  // need rounding here. half outputs are compared within the error threshold.
+  float *host_input = cpu_fp32_input_[0];
+  float *host_output = cpu_fp32_output_[0];
+  for (int i = 0; i < count; ++i) {
+    switch (output_dtype) {
+      case MLUOP_DTYPE_INT8:
+        host_output[i] =
+            roundToInteger(host_input[i], round_mode, INT8_MIN, INT8_MAX);
+        break;
+      case MLUOP_DTYPE_INT16:
+        host_output[i] =
+            roundToInteger(host_input[i], round_mode, INT16_MIN, INT16_MAX);
+        break;
+      case MLUOP_DTYPE_INT32:
+        host_output[i] =
+            roundToInteger(host_input[i], round_mode, INT32_MIN, INT32_MAX);
+        break;
+      default:
+        host_output[i] = host_input[i];
+        break;
+    }
+  }
+}
+
+int64_t CopyWithCastExecutor::getTheoryOps() {
+  int64_t theory_ops = parser_->input(0)->shape_count;
+  VLOG(4) << "getTheoryOps: " << theory_ops << " ops";
+  return theory_ops;
+}
+
+}  // namespace mluoptest
@@ -170,7 +170,8 @@ void DivExecutor::expand_compute_cpu(std::vector<int> shape_a,
 }
 
 int64_t DivExecutor::getTheoryOps() {
-  int64_t theory_ops = parser_->output(0)->total_count;
+  int64_t theory_ops = getCostModelTheoryOps(
+      {tensor_desc_[0].tensor, tensor_desc_[1].tensor, tensor_desc_[2].tensor});
   VLOG(4) << "getTheoryOps: " << theory_ops << " ops";
   return theory_ops;
 }
@@ -141,7 +141,8 @@ void ExpandExecutor::cpuCompute() {
 }
 
 int64_t ExpandExecutor::getTheoryOps() {
-  int64_t theory_ops = parser_->getOutputDataCount(0);
+  int64_t theory_ops = getCostModelTheoryOps(
+      {tensor_desc_[0].tensor, tensor_desc_[1].tensor});
   VLOG(4) << "getTheoryOps: " << theory_ops << " ops";
   return theory_ops;
 }
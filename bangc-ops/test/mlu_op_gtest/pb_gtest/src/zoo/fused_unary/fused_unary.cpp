@@ -0,0 +1,115 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "fused_unary.h"
+
+#include <cmath>
+#include <vector>
+
+namespace mluoptest {
+
+void FusedUnaryExecutor::paramCheck() {
+  if (parser_->getInputNum() != 1) {
+    LOG(ERROR) << "fused_unary input number is wrong.";
+  }
+  if (parser_->getOutputNum() != 1) {
+    LOG(ERROR) << "fused_unary output number is wrong.";
+  }
+  if (!parser_->getProtoNode()->has_fused_unary_param()) {
+    LOG(ERROR) << "fused_unary lose fused_unary_param.";
+  }
+}
+
+std::vector<mluOpFusedUnaryStep_t> FusedUnaryExecutor::getSteps() {
+  auto param = parser_->getProtoNode()->fused_unary_param();
+  std::vector<mluOpFusedUnaryStep_t> steps(param.step_size());
+  for (int i = 0; i < param.step_size(); ++i) {
+    steps[i].type = (mluOpFusedUnaryStepType_t)(param.step(i).type());
+    steps[i].scalar = param.step(i).scalar();
+  }
+  return steps;
+}
+
+void FusedUnaryExecutor::compute() {
+  VLOG(4) << "FusedUnaryExecutor compute ";
+
+  auto input_tensor = tensor_desc_[0].tensor;
+  auto input_dev = data_vector_[0].device_ptr;
+  auto output_tensor = tensor_desc_[1].tensor;
+  auto output_dev = data_vector_[1].device_ptr;
+  auto steps = getSteps();
+  VLOG(4) << "call mluOpFusedUnary() with " << steps.size() << " steps";
+  interface_timer_.start();
+  MLUOP_CHECK(mluOpFusedUnary(handle_, (int)steps.size(), steps.data(),
+                              input_tensor, input_dev, output_tensor,
+                              output_dev));
+  interface_timer_.stop();
+
+  data_vector_[1].is_output = true;
+}
+
+void FusedUnaryExecutor::cpuCompute() {
+  assert(parser_->getInputNum() == 1);
+  assert(parser_->getOutputNum() == 1);
+  auto count = parser_->getInputDataCount(0);
+  auto steps = getSteps();
+
+  // half data is computed in float on device, so one float pass is the
+  // baseline for both dtypes.
+  for (int i = 0; i < count; ++i) {
+    float value = cpu_fp32_input_[0][i];
+    for (const auto &step : steps) {
+      switch (step.type) {
+        case MLUOP_FUSED_UNARY_ABS:
+          value = fabs(value);
+          break;
+        case MLUOP_FUSED_UNARY_LOG:
+          value = log(value) * step.scalar;
+          break;
+        case MLUOP_FUSED_UNARY_SQRT:
+          value = sqrt(value);
+          break;
+        case MLUOP_FUSED_UNARY_MUL_SCALAR:
+          value = value * step.scalar;
+          break;
+        case MLUOP_FUSED_UNARY_ADD_SCALAR:
+          value = value + step.scalar;
+          break;
+        case MLUOP_FUSED_UNARY_DIV_SCALAR:
+          value = value / step.scalar;
+          break;
+        default:
+          assert(0);
+      }
+    }
+    cpu_fp32_output_[0][i] = value;
+  }
+}
+
+int64_t FusedUnaryExecutor::getTheoryOps() {
+  int64_t theory_ops =
+      parser_->getInputDataCount(0) * (int64_t)getSteps().size();
+  VLOG(4) << "getTheoryOps: " << theory_ops << " ops";
+  return theory_ops;
+}
+
+}  // namespace mluoptest
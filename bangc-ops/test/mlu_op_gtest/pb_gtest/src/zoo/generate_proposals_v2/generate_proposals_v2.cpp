@@ -180,14 +180,17 @@ void GenerateProposalsV2Executor::cpuCompute() {
 }
 
 int64_t GenerateProposalsV2Executor::getTheoryOps() {
-  VLOG(4) << "getTheoryOps";
-  //   int dims = parser_->getMetaTensor("input1").tensor->dims[0];
-  auto tensor_scores = parser_->getMetaTensor("input1").tensor;
-  const int N = tensor_scores->dims[0];
-  const int H = tensor_scores->dims[1];
-  const int W = tensor_scores->dims[2];
-  const int A = tensor_scores->dims[3];
-  int64_t theory_ops = 39 * N * A * H * W;
+  // the prototxt holds anchors before variances and img_shape last, the api
+  // takes scores, deltas, img_shape, anchors and variances.
+  int64_t theory_ops = getCostModelTheoryOps(
+      {parser_->getMetaTensor("input1").tensor,
+       parser_->getMetaTensor("input2").tensor,
+       parser_->getMetaTensor("input5").tensor,
+       parser_->getMetaTensor("input3").tensor,
+       parser_->getMetaTensor("input4").tensor,
+       parser_->getMetaTensor("output1").tensor,
+       parser_->getMetaTensor("output2").tensor,
+       parser_->getMetaTensor("output3").tensor});
   VLOG(4) << "getTheoryOps: " << theory_ops << " ops";
   return theory_ops;
 }
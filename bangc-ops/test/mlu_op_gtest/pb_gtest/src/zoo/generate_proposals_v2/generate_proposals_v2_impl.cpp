@@ -27,6 +27,9 @@
 
 #include <algorithm>
 #include <iostream>
+#include <vector>
+
+#include "generate_proposals_v2_topk.h"
 
 using namespace std;  // NOLINT
 
@@ -224,16 +227,13 @@ void ProposalForOneImage(T *scores_slice, T *bbox_deltas_slice,
   T *out_scores_buf = new T[pre_nms_num];
   T *out_box_buf = new T[pre_nms_num * 4];
   T *out_area_buf = new T[pre_nms_num];
-  T *temp_scores = new T[HWA];
-  memcpy(temp_scores, scores_slice, HWA * sizeof(T));
-  // top k, creatbox, filter box
+  // top k in the order of the repeated max scan, creatbox, filter box
+  std::vector<int32_t> top_index(pre_nms_num);
+  generateProposalsV2TopK(scores_slice, HWA, pre_nms_num, top_index.data());
   for (int top_id = 0; top_id < pre_nms_num; ++top_id) {
-    int max_score_id = top_id;
+    int max_score_id = top_index[top_id];
     T max_score = scores_slice[max_score_id];
 
-    findMaxScore(temp_scores, HWA, &max_score, &max_score_id);
-    temp_scores[max_score_id] = FLOAT_MIN;
-
     creatAndFilterProposalsBox<T>(
         anchors_slice, bbox_deltas_slice, im_shape_slice, variances_slice,
         out_scores_buf, out_box_buf, out_area_buf, A, H, W, min_size, max_score,
@@ -298,12 +298,10 @@ void ProposalForOneImage(T *scores_slice, T *bbox_deltas_slice,
   delete[] out_scores_buf;
   delete[] out_box_buf;
   delete[] out_area_buf;
-  delete[] temp_scores;
 
   out_scores_buf = nullptr;
   out_box_buf = nullptr;
   out_area_buf = nullptr;
-  temp_scores = nullptr;
 }
 
 void generateProposalsV2CPUImpl(
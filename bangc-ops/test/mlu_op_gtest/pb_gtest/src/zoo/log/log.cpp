@@ -79,7 +79,8 @@ void LogExecutor::cpuCompute() {
 }
 
 int64_t LogExecutor::getTheoryOps() {
-  int64_t theory_ops = parser_->getInputDataCount(0);
+  int64_t theory_ops = getCostModelTheoryOps(
+      {tensor_desc_[0].tensor, tensor_desc_[1].tensor});
   VLOG(4) << "getTheoryOps: " << theory_ops << " ops";
   return theory_ops;
 }
@@ -130,7 +130,7 @@ float intersectArea(Point *ps1, int n1, Point *ps2, int n2) {
   return res;
 }
 
-float iouPoly(vector<float> p, vector<float> q) {
+float iouPoly(const vector<float> &p, const vector<float> &q) {
   Point ps1[MAXN], ps2[MAXN];
   int n1 = 4;
   int n2 = 4;
@@ -154,35 +154,64 @@ float iouPoly(vector<float> p, vector<float> q) {
   return iou;
 }
 
-bool campareValue(const pair<vector<float>, int> &a,
-                  const pair<vector<float>, int> &b) {
-  return (*(a.first.end() - 1) > *(b.first.end() - 1));
+// The axis aligned bounds and the area of a box. Two boxes of non zero area
+// with disjoint bounds do not intersect, so their iou is 0.
+struct Bounds {
+  float x_min, y_min, x_max, y_max;
+  bool has_area;
+};
+
+Bounds getBounds(const vector<float> &p) {
+  Point ps[MAXN];
+  Bounds bounds = {p[0], p[1], p[0], p[1], false};
+  for (int i = 0; i < 4; i++) {
+    ps[i] = Point(p[i * 2], p[i * 2 + 1]);
+    bounds.x_min = min(bounds.x_min, ps[i].x);
+    bounds.y_min = min(bounds.y_min, ps[i].y);
+    bounds.x_max = max(bounds.x_max, ps[i].x);
+    bounds.y_max = max(bounds.y_max, ps[i].y);
+  }
+  bounds.has_area = area(ps, 4) != 0;
+  return bounds;
 }
 
+bool isDisjoint(const Bounds &a, const Bounds &b) {
+  return a.has_area && b.has_area &&
+         (a.x_max < b.x_min || b.x_max < a.x_min || a.y_max < b.y_min ||
+          b.y_max < a.y_min);
+}
+
+// Greedy suppression in score order, a suppressed box is only marked so the
+// cost stays O(N^2) iou computations at most, boxes with disjoint bounds are
+// skipped when the threshold is positive.
 vector<int> PolyNmsImpl(vector<vector<float>> &p, const float thresh) {
-  vector<pair<vector<float>, int>> vp;
-  for (int i = 0; i < p.size(); i++) {
-    vp.push_back(make_pair(p[i], i));
+  const int n = p.size();
+  vector<int> order(n);
+  vector<Bounds> bounds(n);
+  for (int i = 0; i < n; i++) {
+    order[i] = i;
+    bounds[i] = getBounds(p[i]);
   }
+  stable_sort(order.begin(), order.end(),
+              [&](int a, int b) { return p[a][8] > p[b][8]; });
 
-  sort(vp.begin(), vp.end(), campareValue);
-
+  vector<bool> suppressed(n, false);
   vector<int> keep;
-  while (vp.size()) {
-    keep.push_back(vp.begin()->second);
-    auto box = vp.begin()->first;
-    auto box_index = vp.begin()->second;
-    vp.erase(vp.begin());
-    for (int i = 0; i < vp.size(); i++) {
-      float iou = iouPoly(box, vp[i].first);
-      if (iou > thresh) {
-        vp.erase(vp.begin() + i);
-        i--;
+  for (int i = 0; i < n; i++) {
+    const int box_index = order[i];
+    if (suppressed[box_index]) continue;
+    keep.push_back(box_index);
+    for (int j = i + 1; j < n; j++) {
+      const int other = order[j];
+      if (suppressed[other]) continue;
+      if (thresh > 0 && isDisjoint(bounds[box_index], bounds[other])) continue;
+      if (iouPoly(p[box_index], p[other]) > thresh) {
+        suppressed[other] = true;
       }
     }
   }
 
-  sort(keep.begin(), keep.end(), [&](int a, int b) { return a < b; });
+  sort(keep.begin(), keep.end());
   return keep;
 }
 }  // namespace PNMS
@@ -131,12 +131,8 @@ void PolyNmsExecutor::cpuCompute() {
 }
 
 int64_t PolyNmsExecutor::getTheoryOps() {
-  VLOG(4) << "getTheoryOps";
-  int64_t theory_ops = 21650;
-  int dims = parser_->getMetaTensor("input1").tensor->dims[0];
-  theory_ops = theory_ops * dims * dims;
-  int64_t sort_ops = dims * dims - dims;
-  theory_ops += sort_ops;
+  int64_t theory_ops = getCostModelTheoryOps(
+      {tensor_desc_[0].tensor, tensor_desc_[1].tensor});
   VLOG(4) << "getTheoryOps: " << theory_ops << " ops";
   return theory_ops;
 }
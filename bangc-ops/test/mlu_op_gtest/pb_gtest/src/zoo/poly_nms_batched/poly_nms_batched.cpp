@@ -0,0 +1,155 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "poly_nms_batched.h"
+
+#include <vector>
+
+#include "../poly_nms/pnms_impl.h"
+
+using namespace PNMS;  // NOLINT
+
+namespace mluoptest {
+void PolyNmsBatchedExecutor::paramCheck() {
+  if (!parser_->getProtoNode()->has_poly_nms_batched_param()) {
+    LOG(ERROR) << "Lose poly_nms_batched_param. ";
+  }
+  // the class ids are optional when every box is in one class.
+  GTEST_CHECK(parser_->inputs().size() == 1 || parser_->inputs().size() == 2,
+              "[PolyNmsBatchedExecutor] input number is wrong. ");
+  GTEST_CHECK(parser_->outputs().size() == 2,
+              "[PolyNmsBatchedExecutor] output number is wrong. ");
+}
+
+void PolyNmsBatchedExecutor::workspaceMalloc() {
+  int class_num =
+      parser_->getProtoNode()->poly_nms_batched_param().class_num();
+  auto tensor_boxes = parser_->getMetaTensor("input1").tensor;
+  MLUOP_CHECK(mluOpGetPolyNmsBatchedWorkspaceSize(handle_, tensor_boxes,
+                                                  class_num, &workspace_size_));
+  VLOG(4) << "Malloc workspace space.";
+  void *temp = mlu_runtime_.allocate(workspace_size_);
+  workspace_.push_back(temp);
+  VLOG(4) << "Malloc addr: " << temp << " , size: " << workspace_size_;
+  eva_->setMluWorkspaceSize(workspace_size_);
+
+  // the rows are only written up to the kept boxes of an image.
+  void *output_ptr = parser_->getMetaTensor("output1").dev_origin_ptr;
+  size_t output_size = parser_->getMetaTensor("output1").size_in_bytes;
+  GTEST_CHECK(CNRT_RET_SUCCESS == cnrtMemset(output_ptr, 0, output_size));
+}
+
+void PolyNmsBatchedExecutor::workspaceFree() {
+  if (!workspace_.empty() && workspace_[0]) {
+    VLOG(4) << "Free device workspace space.";
+    GTEST_CHECK(CNRT_RET_SUCCESS == mlu_runtime_.deallocate(workspace_[0]));
+    workspace_[0] = nullptr;
+  }
+}
+
+void PolyNmsBatchedExecutor::compute() {
+  float iou_threshold =
+      parser_->getProtoNode()->poly_nms_batched_param().iou_threshold();
+  int class_num =
+      parser_->getProtoNode()->poly_nms_batched_param().class_num();
+  VLOG(4) << "[mluOpPolyNmsBatched] iou_threshold: " << iou_threshold
+          << ", class_num: " << class_num;
+
+  // get tensor by name (in prototxt)
+  auto tensor_boxes = parser_->getMetaTensor("input1").tensor;
+  auto boxes_ptr = parser_->getMetaTensor("input1").dev_ptr;
+  mluOpTensorDescriptor_t tensor_class_ids = NULL;
+  void *class_ids_ptr = NULL;
+  if (parser_->inputs().size() == 2) {
+    tensor_class_ids = parser_->getMetaTensor("input2").tensor;
+    class_ids_ptr = parser_->getMetaTensor("input2").dev_ptr;
+  }
+  auto tensor_output = parser_->getMetaTensor("output1").tensor;
+  auto output_ptr = parser_->getMetaTensor("output1").dev_ptr;
+  auto tensor_output_size = parser_->getMetaTensor("output2").tensor;
+  auto output_size_ptr = parser_->getMetaTensor("output2").dev_ptr;
+
+  interface_timer_.start();
+  VLOG(4) << "[mluOpPolyNmsBatched] call mluOpPolyNmsBatched()";
+  MLUOP_CHECK(mluOpPolyNmsBatched(
+      handle_, tensor_boxes, boxes_ptr, tensor_class_ids, class_ids_ptr,
+      class_num, iou_threshold, workspace_[0], workspace_size_, tensor_output,
+      output_ptr, tensor_output_size, output_size_ptr));
+  interface_timer_.stop();
+  VLOG(4) << "[mluOpPolyNmsBatched] mluOpPolyNmsBatched end.";
+}
+
+void PolyNmsBatchedExecutor::cpuCompute() {
+  float iou_thresh =
+      parser_->getProtoNode()->poly_nms_batched_param().iou_threshold();
+  int class_num =
+      parser_->getProtoNode()->poly_nms_batched_param().class_num();
+  auto tensor_boxes = parser_->getMetaTensor("input1").tensor;
+  int batch_num = tensor_boxes->dims[0];
+  int box_num = tensor_boxes->dims[1];
+
+  float *boxes = parser_->getMetaTensor("input1").cpu_ptr;
+  float *class_ids = NULL;
+  if (parser_->inputs().size() == 2) {
+    class_ids = parser_->getMetaTensor("input2").cpu_ptr;
+  }
+  float *output = parser_->getMetaTensor("output1").cpu_ptr;
+  float *output_size = parser_->getMetaTensor("output2").cpu_ptr;
+
+  // greedy nms of every (image, class) group, the kept box ids of the groups
+  // of an image are packed in class order, ascending inside a group.
+  for (int b = 0; b < batch_num; ++b) {
+    int keep_offset = 0;
+    for (int c = 0; c < class_num; ++c) {
+      vector<int> members;
+      vector<vector<float>> group_boxes;
+      for (int i = 0; i < box_num; ++i) {
+        int box_class =
+            class_ids == NULL ? 0 : (int)class_ids[b * box_num + i];
+        if (box_class != c) {
+          continue;
+        }
+        const float *box = boxes + ((size_t)b * box_num + i) * 9;
+        members.push_back(i);
+        group_boxes.push_back(vector<float>(box, box + 9));
+      }
+      vector<int> keep = PolyNmsImpl(group_boxes, iou_thresh);
+      for (int k = 0; k < keep.size(); ++k) {
+        output[b * box_num + keep_offset + k] = members[keep[k]];
+      }
+      output_size[b * class_num + c] = keep.size();
+      keep_offset += keep.size();
+    }
+  }
+  VLOG(4) << "[mluOpPolyNmsBatched] cpu compute end.";
+}
+
+int64_t PolyNmsBatchedExecutor::getTheoryOps() {
+  int64_t theory_ops = getCostModelTheoryOps(
+      {parser_->getMetaTensor("input1").tensor,
+       parser_->getMetaTensor("output1").tensor,
+       parser_->getMetaTensor("output2").tensor});
+  VLOG(4) << "getTheoryOps: " << theory_ops << " ops";
+  return theory_ops;
+}
+
+}  // namespace mluoptest
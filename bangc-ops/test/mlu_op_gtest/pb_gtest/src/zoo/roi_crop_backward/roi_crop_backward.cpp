@@ -173,8 +173,8 @@ void RoiCropBackwardExecutor::cpuCompute() {
 }
 
 int64_t RoiCropBackwardExecutor::getTheoryOps() {
-  const int cp_count = 8;
-  theory_ops_ = parser_->getInputDataCount(0) * cp_count;
+  theory_ops_ = getCostModelTheoryOps(
+      {tensor_desc_[0].tensor, tensor_desc_[1].tensor, tensor_desc_[2].tensor});
   VLOG(4) << "[RoiCropBackwardExecutor] getTheoryOps: " << theory_ops_
           << " ops.";
   return theory_ops_;
@@ -170,8 +170,8 @@ void RoiCropForwardExecutor::cpuCompute() {
 }
 
 int64_t RoiCropForwardExecutor::getTheoryOps() {
-  const int cp_count = 7;
-  theory_ops_ = parser_->getInputDataCount(0) * cp_count;
+  theory_ops_ = getCostModelTheoryOps(
+      {tensor_desc_[0].tensor, tensor_desc_[1].tensor, tensor_desc_[2].tensor});
   VLOG(4) << "[RoiCropForwardExecutor] getTheoryOps: " << theory_ops_
           << " ops.";
   return theory_ops_;
@@ -61,7 +61,8 @@ void SqrtExecutor::cpuCompute() {
 }
 
 int64_t SqrtExecutor::getTheoryOps() {
-  int64_t theory_ops = parser_->getInputDataCount(0);
+  int64_t theory_ops = getCostModelTheoryOps(
+      {tensor_desc_[0].tensor, tensor_desc_[1].tensor});
   VLOG(4) << "getTheoryOps: " << theory_ops << " ops";
   return theory_ops;
 }
@@ -60,8 +60,8 @@ void SqrtBackwardExecutor::cpuCompute() {
 }
 
 int64_t SqrtBackwardExecutor::getTheoryOps() {
-  int cp_count = 2;
-  int64_t theory_ops = parser_->getInputDataCount(0);
+  int64_t theory_ops = getCostModelTheoryOps(
+      {tensor_desc_[0].tensor, tensor_desc_[1].tensor, tensor_desc_[2].tensor});
   VLOG(4) << "getTheoryOps: " << theory_ops << " ops";
   return theory_ops;
 }
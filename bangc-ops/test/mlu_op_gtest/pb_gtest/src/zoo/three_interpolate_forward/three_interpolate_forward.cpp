@@ -81,7 +81,9 @@ void ThreeInterpolateForwardExecutor::cpuCompute() {
 }
 
 int64_t ThreeInterpolateForwardExecutor::getTheoryOps() {
-  int64_t theory_ops = parser_->getOutputDataCount(0) * 5;
+  int64_t theory_ops = getCostModelTheoryOps(
+      {tensor_desc_[0].tensor, tensor_desc_[1].tensor, tensor_desc_[2].tensor,
+       tensor_desc_[3].tensor});
   VLOG(4) << "getTheoryOps: " << theory_ops << " ops";
   return theory_ops;
 }
@@ -222,8 +222,9 @@ void YoloBoxExecutor::cpuCompute() {
 }
 
 int64_t YoloBoxExecutor::getTheoryOps() {
-  const int cp_count = 30;
-  int64_t theory_ops0_ = parser_->getInputDataCount(0) * cp_count;
+  int64_t theory_ops0_ = getCostModelTheoryOps(
+      {tensor_desc_[0].tensor, tensor_desc_[1].tensor, tensor_desc_[2].tensor,
+       tensor_desc_[3].tensor, tensor_desc_[4].tensor});
   VLOG(4) << "[YoloBoxExecutor] getTheoryOps: " << theory_ops0_ << " ops.";
   return theory_ops0_;
 }
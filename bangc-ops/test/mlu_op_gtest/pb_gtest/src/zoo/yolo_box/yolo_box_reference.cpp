@@ -0,0 +1,202 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "yolo_box_reference.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace mluoptest {
+namespace {
+float sigmoid(const float x) { return 1.0 / (1.0 + std::exp(-x)); }
+
+// the index of an entry of anchor an_idx in the planes of one image.
+int getEntryIndex(const int an_idx, const int hw_idx, const int an_num,
+                  const int an_stride, const int stride, const int entry,
+                  const bool iou_aware) {
+  if (iou_aware) {
+    return an_idx * an_stride + (an_num + entry) * stride + hw_idx;
+  } else {
+    return an_idx * an_stride + entry * stride + hw_idx;
+  }
+}
+
+float getConfidence(const float *x, const int an_idx, const int hw_idx,
+                    const int an_num, const int an_stride, const int stride,
+                    const bool iou_aware, const float iou_aware_factor) {
+  const int obj_idx = getEntryIndex(an_idx, hw_idx, an_num, an_stride, stride,
+                                    4, iou_aware);
+  float conf = sigmoid(x[obj_idx]);
+  if (iou_aware) {
+    const float iou = sigmoid(x[an_idx * stride + hw_idx]);
+    conf = pow(conf, static_cast<float>(1. - iou_aware_factor)) *
+           pow(iou, static_cast<float>(iou_aware_factor));
+  }
+  return conf;
+}
+
+// the (x1, y1, x2, y2) box of the cell (l, k) of anchor an_idx.
+void getDetectionBox(const float *x, const float *anchors, const int l,
+                     const int k, const int an_idx, const int h, const int w,
+                     const int an_num, const int an_stride, const int stride,
+                     const bool iou_aware, const int downsample_ratio,
+                     const float img_height, const float img_width,
+                     const float scale, const bool clip_bbox, float *box) {
+  const float bias = -0.5 * (scale - 1);
+  const int input_size_h = downsample_ratio * h;
+  const int input_size_w = downsample_ratio * w;
+  const int index = getEntryIndex(an_idx, k * w + l, an_num, an_stride, stride,
+                                  0, iou_aware);
+  const float center_x =
+      (l + sigmoid(x[index]) * scale + bias) * img_width / w;
+  const float center_y =
+      (k + sigmoid(x[index + stride]) * scale + bias) * img_height / h;
+  const float box_w = std::exp(x[index + 2 * stride]) * anchors[2 * an_idx] *
+                      img_width / input_size_w;
+  const float box_h = std::exp(x[index + 3 * stride]) *
+                      anchors[2 * an_idx + 1] * img_height / input_size_h;
+
+  box[0] = center_x - box_w / 2;
+  box[1] = center_y - box_h / 2;
+  box[2] = center_x + box_w / 2;
+  box[3] = center_y + box_h / 2;
+  if (clip_bbox) {
+    box[0] = box[0] > 0 ? box[0] : static_cast<float>(0);
+    box[1] = box[1] > 0 ? box[1] : static_cast<float>(0);
+    box[2] = box[2] < img_width - 1 ? box[2] : img_width - 1;
+    box[3] = box[3] < img_height - 1 ? box[3] : img_height - 1;
+  }
+}
+
+// whether box is dropped by the kept box max_box, the same comparison as the
+// suppression of the device kernel.
+bool isSuppressed(const float *max_box, const float *box,
+                  const float nms_thresh) {
+  const float inter_w = std::max(
+      std::min(max_box[2], box[2]) - std::max(max_box[0], box[0]), 0.0f);
+  const float inter_h = std::max(
+      std::min(max_box[3], box[3]) - std::max(max_box[1], box[1]), 0.0f);
+  const float inter = inter_w * inter_h;
+  const float max_area = (max_box[2] - max_box[0]) * (max_box[3] - max_box[1]);
+  const float area = (box[2] - box[0]) * (box[3] - box[1]);
+  return inter > (area + max_area - inter) * nms_thresh;
+}
+
+struct KeptBox {
+  float score;
+  int label;
+  int cell;
+};
+}  // namespace
+
+int yoloBoxNmsReference(const float *x, const float img_height,
+                        const float img_width, const float *anchors,
+                        const int h, const int w, const int an_num,
+                        const int class_num, const float conf_thresh,
+                        const int downsample_ratio, const bool clip_bbox,
+                        const float scale, const bool iou_aware,
+                        const float iou_aware_factor, const float score_thresh,
+                        const float nms_thresh, const int keep_top_k,
+                        float *output) {
+  const int stride = h * w;
+  const int an_stride = (class_num + 5) * stride;
+  const int box_num = an_num * stride;
+
+  // the cells passing conf_thresh in (anchor, h, w) order, and their boxes.
+  std::vector<int> cells;
+  std::vector<float> confs(box_num, 0.0f);
+  std::vector<float> boxes(4 * box_num, 0.0f);
+  for (int j = 0; j < an_num; j++) {
+    for (int k = 0; k < h; k++) {
+      for (int l = 0; l < w; l++) {
+        const int cell = j * stride + k * w + l;
+        confs[cell] = getConfidence(x, j, k * w + l, an_num, an_stride, stride,
+                                    iou_aware, iou_aware_factor);
+        if (confs[cell] < conf_thresh) {
+          continue;
+        }
+        getDetectionBox(x, anchors, l, k, j, h, w, an_num, an_stride, stride,
+                        iou_aware, downsample_ratio, img_height, img_width,
+                        scale, clip_bbox, boxes.data() + 4 * cell);
+        cells.push_back(cell);
+      }
+    }
+  }
+
+  std::vector<KeptBox> kept;
+  std::vector<KeptBox> candidates;
+  std::vector<bool> suppressed;
+  for (int ci = 0; ci < class_num; ci++) {
+    candidates.clear();
+    for (const int cell : cells) {
+      const int hw_idx = cell % stride;
+      const int label_idx = getEntryIndex(cell / stride, hw_idx, an_num,
+                                          an_stride, stride, 5, iou_aware);
+      const float score =
+          confs[cell] * sigmoid(x[label_idx + ci * stride]);
+      if (score > score_thresh) {
+        candidates.push_back({score, ci, cell});
+      }
+    }
+    // the cells are ascending, so equal scores stay lowest cell first.
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const KeptBox &a, const KeptBox &b) {
+                       return a.score > b.score;
+                     });
+    suppressed.assign(candidates.size(), false);
+    int class_kept_num = 0;
+    for (size_t i = 0; i < candidates.size(); i++) {
+      if (suppressed[i]) {
+        continue;
+      }
+      kept.push_back(candidates[i]);
+      if (++class_kept_num == keep_top_k) {
+        break;
+      }
+      const float *max_box = boxes.data() + 4 * candidates[i].cell;
+      for (size_t j = i + 1; j < candidates.size(); j++) {
+        if (!suppressed[j] &&
+            isSuppressed(max_box, boxes.data() + 4 * candidates[j].cell,
+                         nms_thresh)) {
+          suppressed[j] = true;
+        }
+      }
+    }
+  }
+
+  // kept is in class order, so equal scores stay lowest class first.
+  std::stable_sort(kept.begin(), kept.end(),
+                   [](const KeptBox &a, const KeptBox &b) {
+                     return a.score > b.score;
+                   });
+  const int output_num = std::min(static_cast<int>(kept.size()), keep_top_k);
+  for (int i = 0; i < output_num; i++) {
+    float *row = output + 6 * i;
+    row[0] = kept[i].label;
+    row[1] = kept[i].score;
+    std::copy(boxes.data() + 4 * kept[i].cell,
+              boxes.data() + 4 * kept[i].cell + 4, row + 2);
+  }
+  return output_num;
+}
+}  // namespace mluoptest
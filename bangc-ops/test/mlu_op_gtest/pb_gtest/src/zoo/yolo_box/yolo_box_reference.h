@@ -0,0 +1,50 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef TEST_MLU_OP_GTEST_PB_GTEST_SRC_ZOO_YOLO_BOX_YOLO_BOX_REFERENCE_H_
+#define TEST_MLU_OP_GTEST_PB_GTEST_SRC_ZOO_YOLO_BOX_YOLO_BOX_REFERENCE_H_
+
+namespace mluoptest {
+
+/* the reference of mluOpYoloBoxNms on one image. x of shape [c, h, w] holds
+ * an_num anchors of (x, y, w, h, objectness, class_num logits) planes, after
+ * an_num iou planes when iou_aware is true, and anchors of shape [an_num * 2]
+ * is (width, height). The cells are decoded as by mluOpYoloBox, a cell is a
+ * candidate of a class when its confidence is not below conf_thresh and its
+ * score is above score_thresh. Every class is suppressed greedily, the
+ * highest score first and the lowest cell first among equal scores, a
+ * candidate is dropped when its intersection with a kept box is above
+ * nms_thresh times their union. Writes the keep_top_k best kept boxes, by
+ * score and then by class, as (label, score, x1, y1, x2, y2) rows of output
+ * and returns their number.
+ * */
+int yoloBoxNmsReference(const float *x, const float img_height,
+                        const float img_width, const float *anchors,
+                        const int h, const int w, const int an_num,
+                        const int class_num, const float conf_thresh,
+                        const int downsample_ratio, const bool clip_bbox,
+                        const float scale, const bool iou_aware,
+                        const float iou_aware_factor, const float score_thresh,
+                        const float nms_thresh, const int keep_top_k,
+                        float *output);
+}  // namespace mluoptest
+#endif  // TEST_MLU_OP_GTEST_PB_GTEST_SRC_ZOO_YOLO_BOX_YOLO_BOX_REFERENCE_H_
@@ -0,0 +1,133 @@
+/*************************************************************************
+ * Copyright (C) [2022] by Cambricon, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include "yolo_box_nms.h"
+
+#include "../yolo_box/yolo_box_reference.h"
+
+namespace mluoptest {
+void YoloBoxNmsExecutor::paramCheck() {
+  if (!parser_->getProtoNode()->has_yolo_box_nms_param()) {
+    LOG(ERROR) << "Lose yolo_box_nms_param. ";
+  }
+  GTEST_CHECK(parser_->inputs().size() == 3,
+              "[YoloBoxNmsExecutor] input number is wrong. ");
+  GTEST_CHECK(parser_->outputs().size() == 2,
+              "[YoloBoxNmsExecutor] output number is wrong. ");
+}
+
+void YoloBoxNmsExecutor::workspaceMalloc() {
+  auto param = parser_->getProtoNode()->yolo_box_nms_param();
+  auto tensor_x = parser_->getMetaTensor("input1").tensor;
+  auto tensor_anchors = parser_->getMetaTensor("input3").tensor;
+  MLUOP_CHECK(mluOpGetYoloBoxNmsWorkspaceSize(
+      handle_, tensor_x, tensor_anchors, param.class_num(),
+      param.keep_top_k(), &workspace_size_));
+  VLOG(4) << "Malloc workspace space.";
+  void *temp = mlu_runtime_.allocate(workspace_size_);
+  workspace_.push_back(temp);
+  VLOG(4) << "Malloc addr: " << temp << " , size: " << workspace_size_;
+  eva_->setMluWorkspaceSize(workspace_size_);
+
+  // the rows after the kept boxes of an image are not written.
+  void *output_ptr = parser_->getMetaTensor("output1").dev_origin_ptr;
+  size_t output_size = parser_->getMetaTensor("output1").size_in_bytes;
+  GTEST_CHECK(CNRT_RET_SUCCESS == cnrtMemset(output_ptr, 0, output_size));
+}
+
+void YoloBoxNmsExecutor::workspaceFree() {
+  if (!workspace_.empty() && workspace_[0]) {
+    VLOG(4) << "Free device workspace space.";
+    GTEST_CHECK(CNRT_RET_SUCCESS == mlu_runtime_.deallocate(workspace_[0]));
+    workspace_[0] = nullptr;
+  }
+}
+
+void YoloBoxNmsExecutor::compute() {
+  VLOG(4) << "[YoloBoxNmsExecutor] call compute() begin.";
+  auto param = parser_->getProtoNode()->yolo_box_nms_param();
+  // get tensor by name (in prototxt)
+  auto tensor_x = parser_->getMetaTensor("input1").tensor;
+  auto x_ptr = parser_->getMetaTensor("input1").dev_ptr;
+  auto tensor_img_size = parser_->getMetaTensor("input2").tensor;
+  auto img_size_ptr = parser_->getMetaTensor("input2").dev_ptr;
+  auto tensor_anchors = parser_->getMetaTensor("input3").tensor;
+  auto anchors_ptr = parser_->getMetaTensor("input3").dev_ptr;
+  auto tensor_output = parser_->getMetaTensor("output1").tensor;
+  auto output_ptr = parser_->getMetaTensor("output1").dev_ptr;
+  auto tensor_output_num = parser_->getMetaTensor("output2").tensor;
+  auto output_num_ptr = parser_->getMetaTensor("output2").dev_ptr;
+
+  interface_timer_.start();
+  MLUOP_CHECK(mluOpYoloBoxNms(
+      handle_, tensor_x, x_ptr, tensor_img_size, img_size_ptr, tensor_anchors,
+      anchors_ptr, param.class_num(), param.conf_thresh(),
+      param.downsample_ratio(), param.clip_bbox(), param.scale_x_y(),
+      param.iou_aware(), param.iou_aware_factor(), param.score_thresh(),
+      param.nms_thresh(), param.keep_top_k(), workspace_[0], workspace_size_,
+      tensor_output, output_ptr, tensor_output_num, output_num_ptr));
+  interface_timer_.stop();
+  VLOG(4) << "[YoloBoxNmsExecutor] call compute() end.";
+}
+
+void YoloBoxNmsExecutor::cpuCompute() {
+  VLOG(4) << "[YoloBoxNmsExecutor] call cpuCompute() begin.";
+  auto param = parser_->getProtoNode()->yolo_box_nms_param();
+  auto tensor_x = parser_->getMetaTensor("input1").tensor;
+  const int n = tensor_x->dims[0];
+  const int c = tensor_x->dims[1];
+  const int h = tensor_x->dims[2];
+  const int w = tensor_x->dims[3];
+  const int an_num =
+      mluOpGetTensorElementNum(parser_->getMetaTensor("input3").tensor) / 2;
+  const int keep_top_k = param.keep_top_k();
+
+  float *x = parser_->getMetaTensor("input1").cpu_ptr;
+  float *img_size = parser_->getMetaTensor("input2").cpu_ptr;
+  float *anchors = parser_->getMetaTensor("input3").cpu_ptr;
+  float *output = parser_->getMetaTensor("output1").cpu_ptr;
+  float *output_num = parser_->getMetaTensor("output2").cpu_ptr;
+
+  // every image is decoded and suppressed on its own.
+  for (int i = 0; i < n; i++) {
+    output_num[i] = yoloBoxNmsReference(
+        x + (size_t)i * c * h * w, img_size[2 * i], img_size[2 * i + 1],
+        anchors, h, w, an_num, param.class_num(), param.conf_thresh(),
+        param.downsample_ratio(), param.clip_bbox(), param.scale_x_y(),
+        param.iou_aware(), param.iou_aware_factor(), param.score_thresh(),
+        param.nms_thresh(), keep_top_k, output + (size_t)i * keep_top_k * 6);
+  }
+  VLOG(4) << "[YoloBoxNmsExecutor] call cpuCompute() end.";
+}
+
+int64_t YoloBoxNmsExecutor::getTheoryOps() {
+  int64_t theory_ops = getCostModelTheoryOps(
+      {parser_->getMetaTensor("input1").tensor,
+       parser_->getMetaTensor("input2").tensor,
+       parser_->getMetaTensor("input3").tensor,
+       parser_->getMetaTensor("output1").tensor,
+       parser_->getMetaTensor("output2").tensor});
+  VLOG(4) << "[YoloBoxNmsExecutor] getTheoryOps: " << theory_ops << " ops.";
+  return theory_ops;
+}
+
+}  // namespace mluoptest